@@ -44,13 +44,16 @@ void GLCanvasCubeTest(void);
 #endif
 void HboxTest(void);
 void IdleTest(void);
+void ImageBenchTest(void);
 void LabelTest(void);
 void FlatLabelTest(void);
 void ListTest(void);
+void ListBenchTest(void);
 void FlatListTest(void);
 void MatrixTest(void);
 void MatrixCbModeTest(void);
 void MatrixCbsTest(void);
+void MatrixBenchTest(void);
 void MdiTest(void);
 void VboxTest(void);
 void GridBoxTest(void);
@@ -81,6 +84,10 @@ void PreDialogsTest(void);
 void PlotTest(void);
 #ifdef MGLPLOT_TEST
 void MglPlotTest(void);
+void MglPlotBenchTest(void);
+#endif
+#ifdef TUIO_TEST
+void TuioBenchTest(void);
 #endif
 void GetParamTest(void);
 void ClassInfo(void);
@@ -173,19 +180,23 @@ static TestItems test_list[] = {
   { "Help", HelpTest },
   {"Hbox", HboxTest},
   {"Idle", IdleTest},
+  {"ImageBench", ImageBenchTest},
   {"Label", LabelTest},
   { "FlatLabel", FlatLabelTest },
   { "Link", LinkTest },
   {"List", ListTest},
+  {"ListBench", ListBenchTest},
   {"FlatList", FlatListTest},
   {"Matrix", MatrixTest},
   {"MatrixCbMode", MatrixCbModeTest},
   {"MatrixCbs", MatrixCbsTest},
+  {"MatrixBench", MatrixBenchTest},
   { "MatrixList", MatrixListTest },
   { "Mdi", MdiTest },
   {"Menu", MenuTest},
 #ifdef MGLPLOT_TEST
   {"MglPlot", MglPlotTest},
+  {"MglPlotBench", MglPlotBenchTest},
   { "MglPlotModes", MglPlotModesTest },
   { "MglLabel", MglLabelTest },
 #endif
@@ -214,6 +225,9 @@ static TestItems test_list[] = {
   { "FlatToggle", FlatToggleTest },
   { "Tray", TrayTest },
   {"Tree", TreeTest},
+#ifdef TUIO_TEST
+  {"TuioBench", TuioBenchTest},
+#endif
   {"FlatTree", FlatTreeTest},
   {"Val", ValTest},
   { "FlatVal", FlatValTest },
@@ -51,6 +51,8 @@ SRC += label.c
 SRC += canvas.c
 SRC += frame.c
 SRC += idle.c
+SRC += image_bench.c
+SRC += list_bench.c
 SRC += button.c
 SRC += flatbutton.c
 SRC += flatframe.c
@@ -142,6 +144,7 @@ SRC += gauge.c
 SRC += matrix.c
 SRC += matrix_cbs.c
 SRC += matrix_cbmode.c
+SRC += matrix_bench.c
 SRC += matrixlist.c
 
 LINKER = g++
@@ -159,6 +162,7 @@ endif
 
 DEFINES += MGLPLOT_TEST
 SRC += mglplot.c
+SRC += mglplot_bench.c
 SRC += mathglsamples.c
 SRC += mgllabel.c
 ifneq ($(findstring Win, $(TEC_SYSNAME)), )
@@ -167,6 +171,14 @@ else
   SLIB += $(IUP_LIB)/libiup_mglplot.a
 endif
 
+DEFINES += TUIO_TEST
+SRC += tuio_bench.c
+ifneq ($(findstring Win, $(TEC_SYSNAME)), )
+  LIBS += iuptuio ws2_32 winmm
+else
+  SLIB += $(IUP_LIB)/libiuptuio.a
+endif
+
 #NO_WEBBROWSER_TEST=Yes
 ifndef NO_WEBBROWSER_TEST
   SRC += webbrowser.c webbrowser_editor.c rt_editor_images.c
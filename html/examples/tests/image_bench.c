@@ -0,0 +1,208 @@
+/* IupImage resampling benchmark.
+   Scales RGBA images with the RESIZE attribute, as done for HiDPI stock images,
+   and with a copy of the previous double precision bilinear interpolation,
+   then prints one CSV line per case:
+   "bench,src,dst,repeat,msec,reference_msec,max_diff".
+   Reductions in both directions use a box filter in the library, so max_diff
+   is expected to be larger than 1 only for them.
+   The standalone version accepts "width height" of the large image in the command line. */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "iup.h"
+
+
+#define BENCH_ICON_COUNT 500
+
+static double bench_time(void)
+{
+#ifdef TIME_UTC
+  struct timespec ts;
+  timespec_get(&ts, TIME_UTC);
+  return (double)ts.tv_sec * 1000.0 + (double)ts.tv_nsec / 1.0e6;
+#else
+  return (double)clock() * 1000.0 / CLOCKS_PER_SEC;
+#endif
+}
+
+/* previous implementation, used as reference */
+static void bench_resize_reference(int src_width, int src_height, unsigned char *src_map, int dst_width, int dst_height, unsigned char *dst_map, int depth)
+{
+  unsigned char *line_mapl, *line_maph;
+  double t, u, src_x, src_y, factor;
+  int xl, yl, xh, yh, x, y, c;
+  unsigned char *fhh, *fll, *fhl, *flh;
+
+  int *XL = (int*)malloc(dst_width * sizeof(int));
+  double *T = (double*)malloc(dst_width * sizeof(double));
+
+  factor = (double)src_width / (double)dst_width;
+  for (x = 0; x < dst_width; x++)
+  {
+    src_x = x * factor;
+    xl = (int)(src_x);
+    T[x] = src_x - xl;
+    XL[x] = xl;
+  }
+
+  factor = (double)src_height / (double)dst_height;
+
+  for (y = 0; y < dst_height; y++)
+  {
+    src_y = y * factor;
+    yl = (int)(src_y);
+    yh = (yl == src_height - 1) ? yl : yl + 1;
+    u = src_y - yl;
+
+    line_mapl = src_map + (size_t)yl * src_width * depth;
+    line_maph = src_map + (size_t)yh * src_width * depth;
+
+    for (x = 0; x < dst_width; x++)
+    {
+      xl = XL[x];
+      xh = (xl == src_width - 1) ? xl : xl + 1;
+      t = T[x];
+
+      fll = line_mapl + xl * depth;
+      fhl = line_mapl + xh * depth;
+      flh = line_maph + xl * depth;
+      fhh = line_maph + xh * depth;
+
+      for (c = 0; c < depth; c++)
+        dst_map[c] = (unsigned char)(u * t * (fhh[c] - flh[c] - fhl[c] + fll[c]) + t * (fhl[c] - fll[c]) + u * (flh[c] - fll[c]) + fll[c]);
+
+      dst_map += depth;
+    }
+  }
+
+  free(XL);
+  free(T);
+}
+
+static unsigned char* bench_image_data(int width, int height)
+{
+  unsigned char* data = (unsigned char*)malloc((size_t)width * height * 4);
+  int x, y;
+
+  for (y = 0; y < height; y++)
+  {
+    for (x = 0; x < width; x++)
+    {
+      unsigned char* p = data + ((size_t)y * width + x) * 4;
+      p[0] = (unsigned char)((x * 255) / width);
+      p[1] = (unsigned char)((y * 255) / height);
+      p[2] = (unsigned char)(((x / 4 + y / 4) % 2) * 255);
+      p[3] = (unsigned char)(((x + y) * 7) % 256);
+    }
+  }
+
+  return data;
+}
+
+static int bench_max_diff(unsigned char* data1, unsigned char* data2, size_t size)
+{
+  int max_diff = 0;
+  size_t i;
+
+  for (i = 0; i < size; i++)
+  {
+    int diff = abs((int)data1[i] - (int)data2[i]);
+    if (diff > max_diff)
+      max_diff = diff;
+  }
+
+  return max_diff;
+}
+
+static void bench_resize(const char* name, int src_width, int src_height, int dst_width, int dst_height, int repeat)
+{
+  unsigned char* src_data = bench_image_data(src_width, src_height);
+  unsigned char* ref_data = (unsigned char*)malloc((size_t)dst_width * dst_height * 4);
+  double start, msec, ref_msec;
+  int i, max_diff = 0;
+
+  start = bench_time();
+  for (i = 0; i < repeat; i++)
+  {
+    /* creating the image copies the data, as for each stock image */
+    Ihandle* image = IupImageRGBA(src_width, src_height, src_data);
+    IupSetStrf(image, "RESIZE", "%dx%d", dst_width, dst_height);
+
+    if (i == repeat - 1)
+    {
+      bench_resize_reference(src_width, src_height, src_data, dst_width, dst_height, ref_data, 4);
+      max_diff = bench_max_diff((unsigned char*)IupGetAttribute(image, "WID"), ref_data, (size_t)dst_width * dst_height * 4);
+    }
+
+    IupDestroy(image);
+  }
+  msec = bench_time() - start;
+
+  start = bench_time();
+  for (i = 0; i < repeat; i++)
+  {
+    unsigned char* data = (unsigned char*)malloc((size_t)src_width * src_height * 4);
+    memcpy(data, src_data, (size_t)src_width * src_height * 4);
+    bench_resize_reference(src_width, src_height, data, dst_width, dst_height, ref_data, 4);
+    free(data);
+  }
+  ref_msec = bench_time() - start;
+
+  printf("%s,%dx%d,%dx%d,%d,%.3f,%.3f,%d\n", name, src_width, src_height, dst_width, dst_height, repeat, msec, ref_msec, max_diff);
+  fflush(stdout);
+
+  free(src_data);
+  free(ref_data);
+}
+
+static void bench_sizes(int width, int height)
+{
+  if (width <= 0 || height <= 0)
+  {
+    width = 1920;
+    height = 1080;
+  }
+
+  printf("bench,src,dst,repeat,msec,reference_msec,max_diff\n");
+
+  /* HiDPI scaling of stock images */
+  bench_resize("icon", 16, 16, 24, 24, BENCH_ICON_COUNT);
+  bench_resize("icon", 16, 16, 32, 32, BENCH_ICON_COUNT);
+  bench_resize("icon", 24, 24, 36, 36, BENCH_ICON_COUNT);
+  bench_resize("icon", 24, 24, 48, 48, BENCH_ICON_COUNT);
+  bench_resize("icon", 48, 48, 24, 24, BENCH_ICON_COUNT);
+
+  /* large images */
+  bench_resize("enlarge", width, height, (width * 4) / 3, (height * 4) / 3, 5);
+  bench_resize("enlarge", width, height, width * 2, height * 2, 5);
+  bench_resize("reduce", width, height, width / 4, height / 4, 5);
+  bench_resize("stretch", width, height, width / 2, height * 2, 5);
+}
+
+void ImageBenchTest(void)
+{
+  bench_sizes(0, 0);
+}
+
+#ifndef BIG_TEST
+int main(int argc, char* argv[])
+{
+  int width = 0, height = 0;
+
+  IupOpen(&argc, &argv);
+
+  if (argc == 3)
+  {
+    width = atoi(argv[1]);
+    height = atoi(argv[2]);
+  }
+
+  bench_sizes(width, height);
+
+  IupClose();
+
+  return EXIT_SUCCESS;
+}
+#endif
@@ -0,0 +1,148 @@
+/* IupList bulk loading benchmark.
+   Loads the same items in a mapped list, in a plain list and in a dropdown,
+   one at a time with APPENDITEM, at once with APPENDITEMS and SETITEMS,
+   and with the numbered items set before map, then prints one CSV line per case:
+   "bench,items,dropdown,msec,count".
+   The standalone version accepts the number of items in the command line. */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "iup.h"
+
+
+static double bench_time(void)
+{
+#ifdef TIME_UTC
+  struct timespec ts;
+  timespec_get(&ts, TIME_UTC);
+  return (double)ts.tv_sec * 1000.0 + (double)ts.tv_nsec / 1.0e6;
+#else
+  return (double)clock() * 1000.0 / CLOCKS_PER_SEC;
+#endif
+}
+
+static char* bench_items(int count)
+{
+  char* items = (char*)malloc((size_t)count * 20 + 1);
+  char* p = items;
+  int i;
+
+  for (i = 1; i <= count; i++)
+    p += sprintf(p, "Item %d\n", i);
+
+  return items;
+}
+
+static Ihandle* bench_list(int dropdown)
+{
+  Ihandle* list = IupList(NULL);
+  if (dropdown)
+    IupSetAttribute(list, "DROPDOWN", "YES");
+  IupSetAttribute(list, "VISIBLELINES", "10");
+  IupSetAttribute(list, "VISIBLECOLUMNS", "10");
+  return list;
+}
+
+static Ihandle* bench_dialog(Ihandle* list)
+{
+  Ihandle* dlg = IupDialog(list);
+  IupMap(dlg);  /* not shown, but the native list exists */
+  return dlg;
+}
+
+static void bench_end(const char* name, Ihandle* list, int count, int dropdown, double start)
+{
+  double msec = bench_time() - start;
+  printf("%s,%d,%d,%.3f,%s\n", name, count, dropdown, msec, IupGetAttribute(list, "COUNT"));
+  fflush(stdout);
+}
+
+static void bench_load(int count, int dropdown)
+{
+  char* items = bench_items(count);
+  char buffer[50];
+  Ihandle *list, *dlg;
+  double start;
+  int i;
+
+  list = bench_list(dropdown);
+  dlg = bench_dialog(list);
+  start = bench_time();
+  for (i = 1; i <= count; i++)
+  {
+    sprintf(buffer, "Item %d", i);
+    IupSetAttribute(list, "APPENDITEM", buffer);
+  }
+  bench_end("appenditem", list, count, dropdown, start);
+  IupDestroy(dlg);
+
+  list = bench_list(dropdown);
+  dlg = bench_dialog(list);
+  start = bench_time();
+  IupSetAttribute(list, "APPENDITEMS", items);
+  bench_end("appenditems", list, count, dropdown, start);
+
+  /* replaces the items loaded above */
+  start = bench_time();
+  IupSetAttribute(list, "SETITEMS", items);
+  bench_end("setitems", list, count, dropdown, start);
+  IupDestroy(dlg);
+
+  list = bench_list(dropdown);
+  start = bench_time();
+  for (i = 1; i <= count; i++)
+  {
+    sprintf(buffer, "Item %d", i);
+    IupSetStrAttributeId(list, "", i, buffer);
+  }
+  dlg = bench_dialog(list);
+  bench_end("initial", list, count, dropdown, start);
+  IupDestroy(dlg);
+
+  free(items);
+}
+
+static void bench_sizes(int count)
+{
+  printf("bench,items,dropdown,msec,count\n");
+
+  if (count > 0)
+  {
+    bench_load(count, 0);
+    bench_load(count, 1);
+  }
+  else
+  {
+    bench_load(1000, 0);
+    bench_load(1000, 1);
+    bench_load(10000, 0);
+    bench_load(10000, 1);
+    bench_load(100000, 0);
+    bench_load(100000, 1);
+  }
+}
+
+void ListBenchTest(void)
+{
+  bench_sizes(0);
+}
+
+#ifndef BIG_TEST
+int main(int argc, char* argv[])
+{
+  int count = 0;
+
+  IupOpen(&argc, &argv);
+
+  if (argc == 2)
+    count = atoi(argv[1]);
+
+  bench_sizes(count);
+
+  IupClose();
+
+  return EXIT_SUCCESS;
+}
+#endif
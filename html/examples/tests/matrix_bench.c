@@ -0,0 +1,278 @@
+/* IupMatrixEx benchmark.
+   Runs each operation on matrices of several sizes and prints one CSV line per
+   operation: "bench,lines,columns,repeat,msec".
+   The standalone version accepts "lines columns" in the command line. */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "iup.h"
+#include "iupcontrols.h"
+
+
+#define BENCH_REPEAT 10
+
+typedef struct _BenchTimer
+{
+  const char* name;
+  int repeat;
+  clock_t start;
+} BenchTimer;
+
+static void bench_start(BenchTimer* timer, const char* name, int repeat)
+{
+  timer->name = name;
+  timer->repeat = repeat;
+  timer->start = clock();
+}
+
+static void bench_end(BenchTimer* timer, int num_lin, int num_col)
+{
+  double msec = (double)(clock() - timer->start) * 1000.0 / CLOCKS_PER_SEC;
+  printf("%s,%d,%d,%d,%.3f\n", timer->name, num_lin, num_col, timer->repeat, msec);
+  fflush(stdout);
+}
+
+static void bench_fill(Ihandle* mat, int num_lin, int num_col)
+{
+  char buffer[50];
+  int lin, col;
+
+  for (col = 1; col <= num_col; col++)
+  {
+    sprintf(buffer, "Col %d", col);
+    IupSetStrAttributeId2(mat, "", 0, col, buffer);
+  }
+
+  for (lin = 1; lin <= num_lin; lin++)
+  {
+    sprintf(buffer, "Lin %d", lin);
+    IupSetStrAttributeId2(mat, "", lin, 0, buffer);
+
+    for (col = 1; col <= num_col; col++)
+    {
+      /* mixed numeric and text columns, pseudo random so sort has work to do */
+      int value = (lin * 7919 + col * 104729) % 100003;
+      if (col % 2)
+        sprintf(buffer, "%d.%02d", value, lin % 100);
+      else
+        sprintf(buffer, "text %d", value);
+      IupSetStrAttributeId2(mat, "", lin, col, buffer);
+    }
+  }
+}
+
+static void bench_run(Ihandle* mat, int num_lin, int num_col)
+{
+  BenchTimer timer;
+  char buffer[50];
+  char* data;
+  int i, lin;
+
+  IupSetInt(mat, "NUMLIN", num_lin);
+  IupSetInt(mat, "NUMCOL", num_col);
+
+  /* the initial values are not recorded for undo */
+  IupSetAttribute(mat, "UNDOREDO", "No");
+
+  bench_start(&timer, "fill", 1);
+  bench_fill(mat, num_lin, num_col);
+  bench_end(&timer, num_lin, num_col);
+
+  IupSetAttribute(mat, "UNDOREDO", "Yes");
+
+  /* numeric columns use the formatting cache */
+  for (i = 1; i <= num_col; i += 2)
+  {
+    IupSetAttributeId(mat, "NUMERICQUANTITY", i, "None");
+    IupSetAttributeId(mat, "NUMERICFORMAT", i, "%.3f");
+  }
+
+  bench_start(&timer, "redraw", BENCH_REPEAT);
+  for (i = 0; i < BENCH_REPEAT; i++)
+    IupSetAttribute(mat, "REDRAW", "ALL");
+  bench_end(&timer, num_lin, num_col);
+
+  bench_start(&timer, "scroll", num_lin / 10 + 1);
+  for (lin = 1; lin <= num_lin; lin += 10)
+  {
+    sprintf(buffer, "%d:1", lin);
+    IupSetStrAttribute(mat, "ORIGIN", buffer);
+  }
+  IupSetAttribute(mat, "ORIGIN", "1:1");
+  bench_end(&timer, num_lin, num_col);
+
+  bench_start(&timer, "fittotext", num_col);
+  for (i = 1; i <= num_col; i++)
+  {
+    sprintf(buffer, "C%d", i);
+    IupSetStrAttribute(mat, "FITTOTEXT", buffer);
+  }
+  bench_end(&timer, num_lin, num_col);
+
+  bench_start(&timer, "sort_numeric", 2);
+  IupSetAttribute(mat, "SORTCOLUMNORDER", "ASCENDING");
+  IupSetAttributeId(mat, "SORTCOLUMN", 1, "ALL");
+  IupSetAttribute(mat, "SORTCOLUMNORDER", "DESCENDING");
+  IupSetAttributeId(mat, "SORTCOLUMN", 1, "ALL");
+  bench_end(&timer, num_lin, num_col);
+
+  bench_start(&timer, "sort_text", 2);
+  IupSetAttribute(mat, "SORTCOLUMNORDER", "ASCENDING");
+  IupSetAttributeId(mat, "SORTCOLUMN", 2, "ALL");
+  IupSetAttribute(mat, "SORTCOLUMNORDER", "DESCENDING");
+  IupSetAttributeId(mat, "SORTCOLUMN", 2, "ALL");
+  IupSetAttributeId(mat, "SORTCOLUMN", 2, "RESET");
+  bench_end(&timer, num_lin, num_col);
+
+  bench_start(&timer, "find", BENCH_REPEAT);
+  IupSetAttribute(mat, "FINDMATCHWHOLECELL", "No");
+  for (i = 0; i < BENCH_REPEAT; i++)
+  {
+    IupSetAttribute(mat, "FOCUSCELL", "1:1");
+    IupSetAttribute(mat, "FIND", "not found");
+  }
+  bench_end(&timer, num_lin, num_col);
+
+  bench_start(&timer, "findall", 1);
+  IupSetAttribute(mat, "FINDALL", "12");
+  bench_end(&timer, num_lin, num_col);
+
+  bench_start(&timer, "findindex", BENCH_REPEAT);
+  IupSetAttribute(mat, "FINDINDEX", "Yes");
+  for (i = 0; i < BENCH_REPEAT; i++)
+  {
+    IupSetAttribute(mat, "FOCUSCELL", "1:1");
+    IupSetAttribute(mat, "FIND", "not found");
+  }
+  IupSetAttribute(mat, "FINDINDEX", "No");
+  bench_end(&timer, num_lin, num_col);
+
+  bench_start(&timer, "copy", 1);
+  IupSetAttribute(mat, "COPYDATA", "ALL");
+  bench_end(&timer, num_lin, num_col);
+
+  data = IupGetAttribute(mat, "COPYDATA");
+  if (data)
+  {
+    data = strdup(data);
+    IupSetAttribute(mat, "COPYDATA", NULL);
+
+    bench_start(&timer, "paste", 1);
+    IupSetAttribute(mat, "FOCUSCELL", "1:1");
+    IupSetAttribute(mat, "PASTEDATA", data);
+    bench_end(&timer, num_lin, num_col);
+
+    free(data);
+  }
+
+  bench_start(&timer, "undo", 2);
+  IupSetAttribute(mat, "UNDO", "1");
+  IupSetAttribute(mat, "REDO", "1");
+  bench_end(&timer, num_lin, num_col);
+  IupSetAttribute(mat, "UNDOCLEAR", "Yes");
+
+  bench_start(&timer, "export_txt", 1);
+  IupSetAttribute(mat, "FILEFORMAT", "TXT");
+  IupSetAttribute(mat, "COPYFILE", "matrix_bench.txt");
+  bench_end(&timer, num_lin, num_col);
+
+  bench_start(&timer, "export_csv", 1);
+  IupSetAttribute(mat, "FILEFORMAT", "CSV");
+  IupSetAttribute(mat, "COPYFILE", "matrix_bench.csv");
+  bench_end(&timer, num_lin, num_col);
+
+  bench_start(&timer, "export_html", 1);
+  IupSetAttribute(mat, "FILEFORMAT", "HTML");
+  IupSetAttribute(mat, "COPYFILE", "matrix_bench.html");
+  bench_end(&timer, num_lin, num_col);
+  IupSetAttribute(mat, "FILEFORMAT", NULL);
+
+  remove("matrix_bench.txt");
+  remove("matrix_bench.csv");
+  remove("matrix_bench.html");
+
+  bench_start(&timer, "merge", num_lin / 4);
+  for (lin = 1; lin + 1 <= num_lin; lin += 4)
+  {
+    sprintf(buffer, "%d:2", lin + 1);
+    IupSetStrAttributeId2(mat, "MERGE", lin, 1, buffer);
+  }
+  bench_end(&timer, num_lin, num_col);
+
+  bench_start(&timer, "redraw_merged", BENCH_REPEAT);
+  for (i = 0; i < BENCH_REPEAT; i++)
+    IupSetAttribute(mat, "REDRAW", "ALL");
+  bench_end(&timer, num_lin, num_col);
+
+  bench_start(&timer, "addlin", BENCH_REPEAT);
+  for (i = 0; i < BENCH_REPEAT; i++)
+    IupSetAttribute(mat, "ADDLIN", "1");
+  bench_end(&timer, num_lin, num_col);
+
+  bench_start(&timer, "dellin", BENCH_REPEAT);
+  for (i = 0; i < BENCH_REPEAT; i++)
+    IupSetAttribute(mat, "DELLIN", "1");
+  bench_end(&timer, num_lin, num_col);
+
+  /* clear all, so the next size starts from an empty matrix */
+  IupSetAttribute(mat, "NUMLIN", "0");
+  IupSetAttribute(mat, "NUMCOL", "0");
+}
+
+static void bench_sizes(int num_lin, int num_col)
+{
+  Ihandle *dlg, *mat;
+
+  mat = IupMatrixEx();
+  IupSetAttribute(mat, "RASTERSIZE", "800x600");
+
+  dlg = IupDialog(mat);
+  IupSetAttribute(dlg, "TITLE", "IupMatrixEx Benchmark");
+
+  /* drawing requires a mapped matrix */
+  IupShowXY(dlg, IUP_CENTER, IUP_CENTER);
+  IupFlush();
+
+  printf("bench,lines,columns,repeat,msec\n");
+
+  if (num_lin > 0 && num_col > 0)
+    bench_run(mat, num_lin, num_col);
+  else
+  {
+    bench_run(mat, 100, 10);
+    bench_run(mat, 1000, 20);
+    bench_run(mat, 10000, 20);
+    bench_run(mat, 100000, 10);
+  }
+
+  IupDestroy(dlg);
+}
+
+void MatrixBenchTest(void)
+{
+  bench_sizes(0, 0);
+}
+
+#ifndef BIG_TEST
+int main(int argc, char* argv[])
+{
+  int num_lin = 0, num_col = 0;
+
+  IupOpen(&argc, &argv);
+  IupControlsOpen();
+
+  if (argc == 3)
+  {
+    num_lin = atoi(argv[1]);
+    num_col = atoi(argv[2]);
+  }
+
+  bench_sizes(num_lin, num_col);
+
+  IupClose();
+
+  return EXIT_SUCCESS;
+}
+#endif
@@ -0,0 +1,171 @@
+/* IupMglPlot rasterization benchmark.
+   Renders planar and volumetric datasets to an RGB image using several values
+   of the THREADS attribute and prints one CSV line per render:
+   "bench,size,threads,repeat,msec".
+   The standalone version accepts "width height" in the command line. */
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <time.h>
+
+#include "iup.h"
+#include "iup_mglplot.h"
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+#define BENCH_REPEAT 5
+
+static int bench_threads[] = { 1, 2, 4, 8, 0 };
+#define BENCH_THREADS_COUNT (int)(sizeof(bench_threads) / sizeof(int))
+
+static double bench_time(void)
+{
+  /* wall time, the CPU time of clock() would add the time of all threads */
+#ifdef TIME_UTC
+  struct timespec ts;
+  timespec_get(&ts, TIME_UTC);
+  return (double)ts.tv_sec * 1000.0 + (double)ts.tv_nsec / 1.0e6;
+#else
+  return (double)clock() * 1000.0 / CLOCKS_PER_SEC;
+#endif
+}
+
+static void bench_planar_data(Ihandle* plot, int ds, int n, int m)
+{
+  double* data = (double*)malloc(n * m * sizeof(double));
+  int i, j;
+
+  for (j = 0; j < m; j++)
+  {
+    for (i = 0; i < n; i++)
+    {
+      double x = i / (n - 1.);
+      double y = j / (m - 1.);
+      data[i + n*j] = 0.6*sin(2 * M_PI*x)*sin(3 * M_PI*y) + 0.4*cos(3 * M_PI*x*y);
+    }
+  }
+
+  IupMglPlotSetData(plot, ds, data, n, m, 1);
+  free(data);
+}
+
+static void bench_render(Ihandle* plot, const char* name, const char* size, int width, int height, unsigned char* image)
+{
+  int t, i;
+
+  for (t = 0; t < BENCH_THREADS_COUNT; t++)
+  {
+    double start;
+
+    IupSetInt(plot, "THREADS", bench_threads[t]);
+
+    start = bench_time();
+    for (i = 0; i < BENCH_REPEAT; i++)
+      IupMglPlotPaintTo(plot, "RGB", width, height, 0, image);
+
+    printf("%s,%s,%d,%d,%.3f\n", name, size, IupGetInt(plot, "THREADS"), BENCH_REPEAT, bench_time() - start);
+    fflush(stdout);
+  }
+}
+
+static void bench_planar(Ihandle* plot, const char* ds_mode, int n, int m, int width, int height, unsigned char* image)
+{
+  char size[50];
+  int ds;
+
+  IupSetAttribute(plot, "CLEAR", "Yes");
+  ds = IupMglPlotNewDataSet(plot, 1);
+  bench_planar_data(plot, ds, n, m);
+
+  IupSetAttribute(plot, "DS_MODE", ds_mode);
+  IupSetAttribute(plot, "ROTATE", "40:0:60");
+  IupSetAttribute(plot, "LIGHT", "YES");
+  IupSetAttribute(plot, "BOX", "YES");
+
+  sprintf(size, "%dx%d", n, m);
+  bench_render(plot, ds_mode, size, width, height, image);
+}
+
+static void bench_volume(Ihandle* plot, const char* ds_mode, int n, int m, int l, int width, int height, unsigned char* image)
+{
+  char size[50];
+  int ds;
+
+  IupSetAttribute(plot, "CLEAR", "Yes");
+  ds = IupMglPlotNewDataSet(plot, 1);
+  IupMglPlotSetFromFormula(plot, ds, "-2*((2*x-1)^2 + (2*y-1)^2 + (2*z-1)^4 - (2*z-1)^2 - 0.1)", n, m, l);
+
+  IupSetAttribute(plot, "DS_MODE", ds_mode);
+  IupSetAttribute(plot, "ROTATE", "40:0:60");
+  IupSetAttribute(plot, "LIGHT", "YES");
+  IupSetAttribute(plot, "TRANSPARENT", "YES");
+  IupSetAttribute(plot, "BOX", "YES");
+
+  sprintf(size, "%dx%dx%d", n, m, l);
+  bench_render(plot, ds_mode, size, width, height, image);
+}
+
+static void bench_sizes(int width, int height)
+{
+  unsigned char* image;
+  Ihandle* plot;
+
+  if (width <= 0 || height <= 0)
+  {
+    width = 800;
+    height = 600;
+  }
+
+  image = (unsigned char*)malloc(width * height * 3);
+
+  /* IupMglPlotPaintTo uses the MathGL rasterizer, no need to map the plot */
+  plot = IupMglPlot();
+  IupSetAttribute(plot, "SUPPRESSWARNING", "Yes");
+
+  printf("bench,size,threads,repeat,msec\n");
+
+  bench_planar(plot, "PLANAR_SURFACE", 100, 100, width, height, image);
+  bench_planar(plot, "PLANAR_SURFACE", 400, 400, width, height, image);
+  bench_planar(plot, "PLANAR_DENSITY", 400, 400, width, height, image);
+  bench_planar(plot, "PLANAR_CONTOUR", 400, 400, width, height, image);
+
+  bench_volume(plot, "VOLUME_ISOSURFACE", 60, 50, 40, width, height, image);
+  bench_volume(plot, "VOLUME_ISOSURFACE", 120, 100, 80, width, height, image);
+  bench_volume(plot, "VOLUME_DENSITY", 120, 100, 80, width, height, image);
+  bench_volume(plot, "VOLUME_CLOUD", 60, 50, 40, width, height, image);
+
+  /* restore the automatic number of threads */
+  IupSetAttribute(plot, "THREADS", "0");
+
+  IupDestroy(plot);
+  free(image);
+}
+
+void MglPlotBenchTest(void)
+{
+  bench_sizes(0, 0);
+}
+
+#ifndef BIG_TEST
+int main(int argc, char* argv[])
+{
+  int width = 0, height = 0;
+
+  IupOpen(&argc, &argv);
+  IupMglPlotOpen();
+
+  if (argc == 3)
+  {
+    width = atoi(argv[1]);
+    height = atoi(argv[2]);
+  }
+
+  bench_sizes(width, height);
+
+  IupClose();
+
+  return EXIT_SUCCESS;
+}
+#endif
@@ -0,0 +1,289 @@
+/* IupTuioClient latency benchmark.
+   Replays synthetic TUIO 1.1 cursor frames to an IupTuioClient in the same process
+   using UDP loopback, and measures the time from sending each frame until its
+   TOUCH_CB is called in the main loop. Each frame replaces all the cursors by new
+   ones, so the session ID identifies the frame. Prints one CSV line per run:
+   "bench,frames,cursors,interval,received,avg_msec,max_msec,dropped".
+   Accepts "port frames cursors interval" in the command line.
+   Must be linked with the iuptuio library. */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#ifdef WIN32
+#include <winsock2.h>
+#else
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <unistd.h>
+#endif
+
+#include "iup.h"
+#include "iuptuio.h"
+
+
+#define BENCH_MAX_PACKET 4096
+
+typedef struct _BenchReplay
+{
+  int port, frames, cursors, interval;
+  int frame;      /* next frame to be sent */
+  int received;   /* number of cursors received with DOWN */
+  double* sent;   /* send time of each frame */
+  double total, max;
+#ifdef WIN32
+  SOCKET sock;
+#else
+  int sock;
+#endif
+  struct sockaddr_in addr;
+} BenchReplay;
+
+static double bench_time(void)
+{
+  /* wall time, the events are received in another thread */
+#ifdef TIME_UTC
+  struct timespec ts;
+  timespec_get(&ts, TIME_UTC);
+  return (double)ts.tv_sec * 1000.0 + (double)ts.tv_nsec / 1.0e6;
+#else
+  return (double)clock() * 1000.0 / CLOCKS_PER_SEC;
+#endif
+}
+
+/* OSC encoding, all values are big endian and padded to 4 bytes */
+
+static int osc_int(unsigned char* buffer, int pos, int value)
+{
+  unsigned int v = (unsigned int)value;
+  buffer[pos] = (unsigned char)(v >> 24);
+  buffer[pos + 1] = (unsigned char)(v >> 16);
+  buffer[pos + 2] = (unsigned char)(v >> 8);
+  buffer[pos + 3] = (unsigned char)v;
+  return pos + 4;
+}
+
+static int osc_float(unsigned char* buffer, int pos, float value)
+{
+  int v;
+  memcpy(&v, &value, 4);
+  return osc_int(buffer, pos, v);
+}
+
+static int osc_string(unsigned char* buffer, int pos, const char* str)
+{
+  int len = (int)strlen(str) + 1;  /* includes the terminator */
+  memcpy(buffer + pos, str, len);
+  pos += len;
+  while (pos % 4)
+    buffer[pos++] = 0;
+  return pos;
+}
+
+/* starts a bundle element, returns the position of its size */
+static int osc_message_begin(unsigned char* buffer, int pos, const char* cmd, const char* types)
+{
+  pos += 4;
+  pos = osc_string(buffer, pos, "/tuio/2Dcur");
+  pos = osc_string(buffer, pos, types);
+  pos = osc_string(buffer, pos, cmd);
+  return pos;
+}
+
+static int osc_message_end(unsigned char* buffer, int start, int pos)
+{
+  osc_int(buffer, start, pos - start - 4);
+  return pos;
+}
+
+static int bench_build_frame(BenchReplay* replay, unsigned char* buffer, int frame, int alive)
+{
+  char types[BENCH_MAX_PACKET / 16];
+  int pos, start, c;
+
+  /* bundle with an immediate time tag */
+  pos = osc_string(buffer, 0, "#bundle");
+  pos = osc_int(buffer, pos, 0);
+  pos = osc_int(buffer, pos, 1);
+
+  /* alive */
+  strcpy(types, ",s");
+  for (c = 0; c < alive; c++)
+    strcat(types, "i");
+  start = pos;
+  pos = osc_message_begin(buffer, pos, "alive", types);
+  for (c = 0; c < alive; c++)
+    pos = osc_int(buffer, pos, frame * replay->cursors + c + 1);
+  pos = osc_message_end(buffer, start, pos);
+
+  /* set, session ID, position, speed and acceleration */
+  for (c = 0; c < alive; c++)
+  {
+    float x = (float)(c + 1) / (replay->cursors + 1);
+    float y = (float)(frame % 100) / 100.0f;
+
+    start = pos;
+    pos = osc_message_begin(buffer, pos, "set", ",sifffff");
+    pos = osc_int(buffer, pos, frame * replay->cursors + c + 1);
+    pos = osc_float(buffer, pos, x);
+    pos = osc_float(buffer, pos, y);
+    pos = osc_float(buffer, pos, 0);
+    pos = osc_float(buffer, pos, 0);
+    pos = osc_float(buffer, pos, 0);
+    pos = osc_message_end(buffer, start, pos);
+  }
+
+  /* fseq, must be incremented */
+  start = pos;
+  pos = osc_message_begin(buffer, pos, "fseq", ",si");
+  pos = osc_int(buffer, pos, frame + 1);
+  pos = osc_message_end(buffer, start, pos);
+
+  return pos;
+}
+
+static void bench_send_frame(BenchReplay* replay, int frame, int alive)
+{
+  unsigned char buffer[BENCH_MAX_PACKET];
+  int size = bench_build_frame(replay, buffer, frame, alive);
+
+  if (alive)
+    replay->sent[frame] = bench_time();
+
+  sendto(replay->sock, (const char*)buffer, size, 0, (struct sockaddr*)&replay->addr, sizeof(replay->addr));
+}
+
+static int bench_touch_cb(Ihandle* ih, int id, int x, int y, char* state)
+{
+  BenchReplay* replay = (BenchReplay*)IupGetAttribute(ih, "_BENCH_REPLAY");
+
+  if (state[0] == 'D')
+  {
+    int frame = (id - 1) / replay->cursors;
+    if (frame >= 0 && frame < replay->frames)
+    {
+      double msec = bench_time() - replay->sent[frame];
+      replay->total += msec;
+      if (msec > replay->max)
+        replay->max = msec;
+      replay->received++;
+    }
+  }
+
+  (void)x;
+  (void)y;
+  return IUP_DEFAULT;
+}
+
+static int bench_timer_cb(Ihandle* timer)
+{
+  BenchReplay* replay = (BenchReplay*)IupGetAttribute(timer, "_BENCH_REPLAY");
+
+  if (replay->frame < replay->frames)
+    bench_send_frame(replay, replay->frame++, replay->cursors);
+  else if (replay->frame == replay->frames)
+  {
+    /* remove the last cursors */
+    bench_send_frame(replay, replay->frame++, 0);
+  }
+  else
+  {
+    /* wait one more interval for the last events */
+    IupSetAttribute(timer, "RUN", "NO");
+    IupExitLoop();
+  }
+
+  return IUP_DEFAULT;
+}
+
+static void bench_replay(int port, int frames, int cursors, int interval)
+{
+  BenchReplay replay;
+  Ihandle *client, *timer;
+#ifdef WIN32
+  WSADATA wsa_data;
+#endif
+
+  if (port <= 0) port = 3333;
+  if (frames <= 0) frames = 1000;
+  if (cursors <= 0) cursors = 5;
+  if (cursors > 50) cursors = 50;  /* must fit in one packet */
+  if (interval <= 0) interval = 10;
+
+  memset(&replay, 0, sizeof(BenchReplay));
+  replay.port = port;
+  replay.frames = frames;
+  replay.cursors = cursors;
+  replay.interval = interval;
+  replay.sent = (double*)calloc(frames, sizeof(double));
+
+#ifdef WIN32
+  WSAStartup(MAKEWORD(2, 2), &wsa_data);
+#endif
+
+  replay.sock = socket(AF_INET, SOCK_DGRAM, 0);
+  replay.addr.sin_family = AF_INET;
+  replay.addr.sin_port = htons((unsigned short)port);
+  replay.addr.sin_addr.s_addr = inet_addr("127.0.0.1");
+
+  client = IupTuioClient(port);
+  IupSetAttribute(client, "_BENCH_REPLAY", (char*)&replay);
+  IupSetCallback(client, "TOUCH_CB", (Icallback)bench_touch_cb);
+  IupSetAttribute(client, "CONNECT", "YES");
+
+  timer = IupTimer();
+  IupSetInt(timer, "TIME", interval);
+  IupSetAttribute(timer, "_BENCH_REPLAY", (char*)&replay);
+  IupSetCallback(timer, "ACTION_CB", bench_timer_cb);
+  IupSetAttribute(timer, "RUN", "YES");
+
+  IupMainLoop();
+
+  printf("bench,frames,cursors,interval,received,avg_msec,max_msec,dropped\n");
+  printf("replay,%d,%d,%d,%d,%.3f,%.3f,%s\n", frames, cursors, interval, replay.received,
+         replay.received ? replay.total / replay.received : 0.0, replay.max, IupGetAttribute(client, "DROPPEDEVENTS"));
+  fflush(stdout);
+
+  IupSetAttribute(client, "CONNECT", "NO");
+  IupDestroy(timer);
+  IupDestroy(client);
+
+#ifdef WIN32
+  closesocket(replay.sock);
+  WSACleanup();
+#else
+  close(replay.sock);
+#endif
+  free(replay.sent);
+}
+
+void TuioBenchTest(void)
+{
+  IupTuioOpen();
+
+  bench_replay(0, 0, 0, 0);
+}
+
+#ifndef BIG_TEST
+int main(int argc, char* argv[])
+{
+  int port = 0, frames = 0, cursors = 0, interval = 0;
+
+  IupOpen(&argc, &argv);
+  IupTuioOpen();
+
+  if (argc > 1) port = atoi(argv[1]);
+  if (argc > 2) frames = atoi(argv[2]);
+  if (argc > 3) cursors = atoi(argv[3]);
+  if (argc > 4) interval = atoi(argv[4]);
+
+  bench_replay(port, frames, cursors, interval);
+
+  IupClose();
+
+  return EXIT_SUCCESS;
+}
+#endif
@@ -35,6 +35,11 @@ void IupMglPlotInsert1D(Ihandle* ih, int ds_index, int sample_index, const char*
 void IupMglPlotInsert2D(Ihandle* ih, int ds_index, int sample_index, const double* x, const double* y, int count);
 void IupMglPlotInsert3D(Ihandle* ih, int ds_index, int sample_index, const double* x, const double* y, const double* z, int count);
 
+/* Linear Data Only */
+void IupMglPlotAddSamples1D(Ihandle* ih, int ds_index, const char** names, const double* y, int count);
+void IupMglPlotAddSamples2D(Ihandle* ih, int ds_index, const double* x, const double* y, int count);
+void IupMglPlotAddSamples3D(Ihandle* ih, int ds_index, const double* x, const double* y, const double* z, int count);
+
 /* Linear Data Only */
 void IupMglPlotSet1D(Ihandle* ih, int ds_index, const char** names, const double* y, int count);
 void IupMglPlotSet2D(Ihandle* ih, int ds_index, const double* x, const double* y, int count);
@@ -44,6 +49,7 @@ void IupMglPlotSetFormula(Ihandle* ih, int ds_index, const char* formulaX, const
 /* Linear (dim=1), Planar (dim=1), Volumetric (dim=1) */
 void IupMglPlotSetData(Ihandle* ih, int ds_index, const double* data, int count_x, int count_y, int count_z);
 void IupMglPlotLoadData(Ihandle* ih, int ds_index, const char* filename, int count_x, int count_y, int count_z);
+int  IupMglPlotLoadRawData(Ihandle* ih, int ds_index, const char* filename, const char* data_type, int count_x, int count_y, int count_z, int step);
 void IupMglPlotSetFromFormula(Ihandle* ih, int ds_index, const char* formula, int count_x, int count_y, int count_z);
 
 /* Only inside callbacks */
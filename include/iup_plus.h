@@ -1070,6 +1070,10 @@ namespace Iup
     void Insert2D(int ds_index, int sample_index, const double* x, const double* y, int count) { IupMglPlotInsert2D(ih, ds_index, sample_index, x, y, count); }
     void Insert3D(int ds_index, int sample_index, const double* x, const double* y, const double* z, int count) { IupMglPlotInsert3D(ih, ds_index, sample_index, x, y, z, count); }
 
+    void AddSamples1D(int ds_index, const char** names, const double* y, int count) { IupMglPlotAddSamples1D(ih, ds_index, names, y, count); }
+    void AddSamples2D(int ds_index, const double* x, const double* y, int count) { IupMglPlotAddSamples2D(ih, ds_index, x, y, count); }
+    void AddSamples3D(int ds_index, const double* x, const double* y, const double* z, int count) { IupMglPlotAddSamples3D(ih, ds_index, x, y, z, count); }
+
     void Set1D(int ds_index, const char** names, const double* y, int count) { IupMglPlotSet1D(ih, ds_index, names, y, count); }
     void Set2D(int ds_index, const double* x, const double* y, int count) { IupMglPlotSet2D(ih, ds_index, x, y, count); }
     void Set3D(int ds_index, const double* x, const double* y, const double* z, int count) { IupMglPlotSet3D(ih, ds_index, x, y, z, count); }
@@ -1077,6 +1081,7 @@ namespace Iup
 
     void SetData(int ds_index, const double* data, int count_x, int count_y, int count_z) { IupMglPlotSetData(ih, ds_index, data, count_x, count_y, count_z); }
     void LoadData(int ds_index, const char* filename, int count_x, int count_y, int count_z) { IupMglPlotLoadData(ih, ds_index, filename, count_x, count_y, count_z); }
+    int LoadRawData(int ds_index, const char* filename, const char* data_type, int count_x, int count_y, int count_z, int step) { return IupMglPlotLoadRawData(ih, ds_index, filename, data_type, count_x, count_y, count_z, step); }
     void SetFromFormula(int ds_index, const char* formula, int count_x, int count_y, int count_z) { IupMglPlotSetFromFormula(ih, ds_index, formula, count_x, count_y, count_z); }
 
     void Transform(double x, double y, double z, int &ix, int &iy) { IupMglPlotTransform(ih, x, y, z, &ix, &iy); }
@@ -722,6 +722,13 @@ void iupdrvListAppendItem(Ihandle* ih, const char* value)
 	
 }
 
+void iupdrvListAppendItems(Ihandle* ih, const char** values, int count)
+{
+  int i;
+  for (i = 0; i < count; i++)
+    iupdrvListAppendItem(ih, values[i]);
+}
+
 void iupdrvListInsertItem(Ihandle* ih, int pos, const char* value)
 {
 	IupCocoaListSubType sub_type = cocoaListGetSubType(ih);
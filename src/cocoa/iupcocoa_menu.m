@@ -608,6 +608,7 @@ void iupCocoaMenuSetApplicationMenu(Ihandle* ih)
 		ih->data->menu = menu;
 		
 		menu->parent = ih;    /* use this to create a menu bar instead of a popup menu */
+		iupAttribInheritCacheInvalidate(menu);
 		
 		ih->data->ignore_resize = 1;
 		IupMap(menu);     /* this will automatically add the menu to the dialog */
@@ -85,6 +85,13 @@ void iupdrvListAppendItem(Ihandle* ih, const char* value)
 	
 }
 
+void iupdrvListAppendItems(Ihandle* ih, const char** values, int count)
+{
+  int i;
+  for (i = 0; i < count; i++)
+    iupdrvListAppendItem(ih, values[i]);
+}
+
 void iupdrvListInsertItem(Ihandle* ih, int pos, const char* value)
 {
 
@@ -129,6 +129,13 @@ void iupdrvListAppendItem(Ihandle* ih, const char* value)
     emjsList_AppendItem(ih->handle->handleID, sub_type, value);
 }
 
+void iupdrvListAppendItems(Ihandle* ih, const char** values, int count)
+{
+  int i;
+  for (i = 0; i < count; i++)
+    iupdrvListAppendItem(ih, values[i]);
+}
+
 void iupdrvListInsertItem(Ihandle* ih, int pos, const char* value)
 {
 
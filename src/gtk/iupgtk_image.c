@@ -232,6 +232,17 @@ void* iupdrvImageCreateImage(Ihandle *ih, const char* bgcolor, int make_inactive
   }
   else /* bpp == 32 or bpp == 24 */
   {
+    unsigned char* inactive_data = NULL;
+
+    /* the inactive data of identical images is computed only once */
+    if (make_inactive)
+      inactive_data = iupImageGetInactiveData(ih, bg_r, bg_g, bg_b, 1);
+    if (inactive_data)
+    {
+      imgdata = inactive_data;
+      make_inactive = 0;
+    }
+
     for (y=0; y<ih->currentheight; y++)
     {
       pixline_data = pixdata + y * rowstride;
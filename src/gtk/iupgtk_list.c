@@ -140,6 +140,59 @@ void iupdrvListAppendItem(Ihandle* ih, const char* value)
   iupAttribSet(ih, "_IUPLIST_IGNORE_ACTION", NULL);
 }
 
+void iupdrvListAppendItems(Ihandle* ih, const char** values, int count)
+{
+  GtkTreeModel *model = gtkListGetModel(ih);
+  GList* selected_rows = NULL;
+  GtkTreeIter iter;
+  int i, active = -1;
+
+  iupAttribSet(ih, "_IUPLIST_IGNORE_ACTION", "1");
+
+  /* detach the model, so the view is not updated for each row */
+  g_object_ref(model);
+  if (ih->data->is_dropdown)
+  {
+    active = gtk_combo_box_get_active((GtkComboBox*)ih->handle);
+    gtk_combo_box_set_model((GtkComboBox*)ih->handle, NULL);
+  }
+  else
+  {
+    GtkTreeSelection* selection = gtk_tree_view_get_selection(GTK_TREE_VIEW(ih->handle));
+    selected_rows = gtk_tree_selection_get_selected_rows(selection, NULL);
+    gtk_tree_view_set_model((GtkTreeView*)ih->handle, NULL);
+  }
+
+  for (i = 0; i < count; i++)
+    gtk_list_store_insert_with_values(GTK_LIST_STORE(model), &iter, -1, IUPGTK_LIST_TEXT, iupgtkStrConvertToSystem(values[i]), 
+                                                                        IUPGTK_LIST_IMAGE, NULL, -1);
+
+  /* attach again and restore the previous selection, existing items were not moved */
+  if (ih->data->is_dropdown)
+  {
+    gtk_combo_box_set_model((GtkComboBox*)ih->handle, model);
+    gtk_combo_box_set_active((GtkComboBox*)ih->handle, active);
+  }
+  else
+  {
+    GtkTreeSelection* selection;
+    GList* rr;
+
+    gtk_tree_view_set_model((GtkTreeView*)ih->handle, model);
+
+    selection = gtk_tree_view_get_selection(GTK_TREE_VIEW(ih->handle));
+    for (rr = selected_rows; rr != NULL; rr = rr->next)
+    {
+      gtk_tree_selection_select_path(selection, (GtkTreePath*)rr->data);
+      gtk_tree_path_free((GtkTreePath*)rr->data);
+    }
+    g_list_free(selected_rows);
+  }
+  g_object_unref(model);
+
+  iupAttribSet(ih, "_IUPLIST_IGNORE_ACTION", NULL);
+}
+
 void iupdrvListInsertItem(Ihandle* ih, int pos, const char* value)
 {
   GtkTreeModel *model = gtkListGetModel(ih);
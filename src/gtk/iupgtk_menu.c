@@ -311,7 +311,10 @@ static int gtkMenuMapMethod(Ihandle* ih)
 static void gtkMenuUnMapMethod(Ihandle* ih)
 {
   if (iupMenuIsMenuBar(ih))
+  {
     ih->parent = NULL;
+    iupAttribInheritCacheInvalidate(ih);
+  }
 
   iupdrvBaseUnMapMethod(ih);
 }
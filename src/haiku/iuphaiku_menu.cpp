@@ -93,7 +93,10 @@ static int haikuMenuMapMethod(Ihandle* ih)
 static void gtkMenuUnMapMethod(Ihandle* ih)
 {
   if (iupMenuIsMenuBar(ih))
+  {
     ih->parent = NULL;
+    iupAttribInheritCacheInvalidate(ih);
+  }
 
   iupdrvBaseUnMapMethod(ih);
 }
@@ -73,6 +73,26 @@ IUP_SDK_API void* iupArrayReleaseData(Iarray* iarray)
   return data; 
 }
 
+static int iArrayGrow(Iarray* iarray, int add_count)
+{
+  int old_count = iarray->max_count;
+
+  /* grow geometrically, by half of the current size, 
+     so successive increments do not realloc each time,
+     but at least by the start count and by the requested count */
+  int grow_count = iarray->max_count/2;
+  if (grow_count < iarray->start_count) grow_count = iarray->start_count;
+  if (grow_count < add_count) grow_count = add_count;
+
+  iarray->max_count += grow_count;
+  iarray->data = realloc(iarray->data, iarray->elem_size*iarray->max_count);
+  iupASSERT(iarray->data!=NULL);
+  if (!iarray->data)
+    return 0;
+  memset((unsigned char*)iarray->data + iarray->elem_size*old_count, 0, iarray->elem_size*(iarray->max_count-old_count));
+  return 1;
+}
+
 IUP_SDK_API void* iupArrayInc(Iarray* iarray)
 {
   iupASSERT(iarray!=NULL);
@@ -80,13 +100,8 @@ IUP_SDK_API void* iupArrayInc(Iarray* iarray)
     return NULL;
   if (iarray->count >= iarray->max_count)
   {
-    int old_count = iarray->max_count;
-    iarray->max_count += iarray->start_count;
-    iarray->data = realloc(iarray->data, iarray->elem_size*iarray->max_count);
-    iupASSERT(iarray->data!=NULL);
-    if (!iarray->data)
+    if (!iArrayGrow(iarray, 1))
       return NULL;
-    memset((unsigned char*)iarray->data + iarray->elem_size*old_count, 0, iarray->elem_size*(iarray->max_count-old_count));
   }
   iarray->count++;
   return iarray->data;
@@ -99,13 +114,8 @@ IUP_SDK_API void* iupArrayAdd(Iarray* iarray, int add_count)
     return NULL;
   if (iarray->count+add_count > iarray->max_count)
   {
-    int old_count = iarray->max_count;
-    iarray->max_count += add_count;
-    iarray->data = realloc(iarray->data, iarray->elem_size*iarray->max_count);
-    iupASSERT(iarray->data!=NULL);
-    if (!iarray->data)
+    if (!iArrayGrow(iarray, add_count))
       return NULL;
-    memset((unsigned char*)iarray->data + iarray->elem_size*old_count, 0, iarray->elem_size*(iarray->max_count-old_count));
   }
   iarray->count += add_count;
   return iarray->data;
@@ -151,3 +161,11 @@ IUP_SDK_API int iupArrayCount(Iarray* iarray)
     return 0;
   return iarray->count;
 }
+
+IUP_SDK_API int iupArrayMaxCount(Iarray* iarray)
+{
+  iupASSERT(iarray!=NULL);
+  if (!iarray)
+    return 0;
+  return iarray->max_count;
+}
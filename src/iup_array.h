@@ -23,7 +23,8 @@ typedef struct _Iarray Iarray;
 
 /** Creates an array with an initial room for elements, and the element size.
  * The array count starts at 0. And the maximum number of elements starts at the given count.
- * The maximum number of elements is increased by the start_max_count, every time it needs more memory.
+ * Every time it needs more memory, the maximum number of elements is increased by half of its current value,
+ * but at least by the start_max_count and by the number of elements being added.
  * Data is always initialized with zeros.
  * Must call \ref iupArrayInc, \ref iupArrayAdd or \ref iupArrayInsert to properly increase the number of elements.
  * \ingroup iarray */
@@ -43,7 +44,7 @@ IUP_SDK_API void* iupArrayReleaseData(Iarray* iarray);
 
 /** Increments the number of elements in the array.
  * The array count starts at 0. 
- * If the maximum number of elements is reached, the memory allocated is increased by the initial start count.
+ * If the maximum number of elements is reached, the memory allocated is increased as described in \ref iupArrayCreate.
  * Data is always initialized with zeros.
  * Returns the pointer that contains the array.
  * \ingroup iarray */
@@ -51,7 +52,7 @@ IUP_SDK_API void* iupArrayInc(Iarray* iarray);
 
 /** Increments the number of elements in the array by a given count.
  * New space is allocated at the end of the array.
- * If the maximum number of elements is reached, the memory allocated is increased by the given count.
+ * If the maximum number of elements is reached, the memory allocated is increased as described in \ref iupArrayCreate.
  * Data is always initialized with zeros.
  * Returns the pointer that contains the array.
  * \ingroup iarray */
@@ -59,7 +60,7 @@ IUP_SDK_API void* iupArrayAdd(Iarray* iarray, int add_count);
 
 /** Increments the number of elements in the array by a given count
  * and moves the data so the new space starts at index.
- * If the maximum number of elements is reached, the memory allocated is increased by the given count.
+ * If the maximum number of elements is reached, the memory allocated is increased as described in \ref iupArrayCreate.
  * Data is always initialized with zeros.
  * Returns the pointer that contains the array.
  * \ingroup iarray */
@@ -74,6 +75,10 @@ IUP_SDK_API void iupArrayRemove(Iarray* iarray, int index, int remove_count);
  * \ingroup iarray */
 IUP_SDK_API int iupArrayCount(Iarray* iarray);
 
+/** Returns the number of elements allocated for the array, including the unused ones.
+ * \ingroup iarray */
+IUP_SDK_API int iupArrayMaxCount(Iarray* iarray);
+
 
 
 #ifdef __cplusplus
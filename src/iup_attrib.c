@@ -20,6 +20,7 @@
 #include "iup_attrib.h"
 #include "iup_assert.h"
 #include "iup_varg.h"
+#include "iup_thread.h"
 
 
 #define iupATTRIB_LANGUAGE_STRING(_v)  (_v && _v[0] == '_' && _v[1] == '@') 
@@ -36,6 +37,174 @@
   }
 
 
+/* Cache of the inherited values found in the parents.
+   When a non internal attribute is changed at an element only the entries with that name
+   in its subtree are removed, and when the parent of an element changes all the entries
+   of its subtree are removed. Internal attributes are not cached.
+   A read changes the cache, so it is used only in the main thread,
+   other threads search the parents directly. */
+#define IATTRIB_INHERIT_CACHE_SIZE 8
+#define IATTRIB_INHERIT_NAME_SIZE 32
+
+struct _IattribInheritCache {
+  struct {
+    char name[IATTRIB_INHERIT_NAME_SIZE];  /* empty name is an empty entry */
+    char* value;
+  } entry[IATTRIB_INHERIT_CACHE_SIZE];
+  int next;
+};
+
+static unsigned int iattrib_inherit_names = 0;  /* one bit for each name hash already cached in any element */
+
+static unsigned int iAttribInheritCacheNameBit(const char* name)
+{
+  unsigned int hash = 0;
+  while (*name)
+    hash = hash * 31 + (unsigned char)*name++;
+  return 1u << (hash % 32);
+}
+
+static void iAttribInheritCacheClear(Ihandle* ih, const char* name)
+{
+  IattribInheritCache* cache = ih->inherit_cache;
+  if (cache)
+  {
+    int i;
+    for (i = 0; i < IATTRIB_INHERIT_CACHE_SIZE; i++)
+    {
+      if (!name || iupStrEqual(cache->entry[i].name, name))
+        cache->entry[i].name[0] = 0;
+    }
+  }
+}
+
+static Ihandle* iAttribInheritCacheMenuBar(Ihandle* ih)
+{
+  /* the menu bar is not in the child list of the dialog, but its parent is the dialog */
+  if (ih->iclass->nativetype == IUP_TYPEDIALOG)
+  {
+    char* value = iupAttribGet(ih, "MENU");
+    if (value)
+    {
+      Ihandle* menu = IupGetHandle(value);
+      if (menu && menu->parent == ih)
+        return menu;
+    }
+  }
+  return NULL;
+}
+
+static void iAttribInheritCacheNotifyChildren(Ihandle* ih, const char* name)
+{
+  /* same traversal of iAttribNotifyChildren, 
+     but for any attribute and stops only where the attribute is defined */
+  Ihandle* child = ih->firstchild;
+  while (child)
+  {
+    if (!name || !iupTableGet(child->attrib, name))
+    {
+      iAttribInheritCacheClear(child, name);
+      iAttribInheritCacheNotifyChildren(child, name);
+    }
+
+    child = child->brother;
+  }
+
+  child = iAttribInheritCacheMenuBar(ih);
+  if (child && (!name || !iupTableGet(child->attrib, name)))
+  {
+    iAttribInheritCacheClear(child, name);
+    iAttribInheritCacheNotifyChildren(child, name);
+  }
+}
+
+static void iAttribInheritCacheCheck(Ihandle* ih, const char* name)
+{
+  if (!iupATTRIB_ISINTERNAL(name) && (iattrib_inherit_names & iAttribInheritCacheNameBit(name)))
+    iAttribInheritCacheNotifyChildren(ih, name);
+}
+
+void iupAttribInheritCacheInvalidate(Ihandle* ih)
+{
+  if (iattrib_inherit_names)
+  {
+    iAttribInheritCacheClear(ih, NULL);
+    iAttribInheritCacheNotifyChildren(ih, NULL);
+  }
+}
+
+void iupAttribInheritCacheNotify(Ihandle* ih, const char* name)
+{
+  if (name)
+    iAttribInheritCacheCheck(ih, name);
+  else if (iattrib_inherit_names)
+    iAttribInheritCacheNotifyChildren(ih, NULL);
+}
+
+void iupAttribInheritCacheRelease(Ihandle* ih)
+{
+  if (ih->inherit_cache)
+  {
+    free(ih->inherit_cache);
+    ih->inherit_cache = NULL;
+  }
+}
+
+static char* iAttribGetFromParents(Ihandle* ih, const char* name)
+{
+  Ihandle* parent = ih->parent;
+  while (parent)
+  {
+    char* value = iupAttribGet(parent, name);
+    if (value)
+      return value;
+
+    parent = parent->parent;
+  }
+
+  return NULL;
+}
+
+static char* iAttribGetInheritFromParent(Ihandle* ih, const char* name)
+{
+  IattribInheritCache* cache;
+  char* value;
+  int i;
+
+  if (!iupThreadIsMain())
+    return iAttribGetFromParents(ih, name);
+
+  cache = ih->inherit_cache;
+  if (cache)
+  {
+    for (i = 0; i < IATTRIB_INHERIT_CACHE_SIZE; i++)
+    {
+      if (cache->entry[i].name[0] && iupStrEqual(cache->entry[i].name, name))
+        return cache->entry[i].value;
+    }
+  }
+
+  value = iAttribGetFromParents(ih, name);
+
+  if (strlen(name) < IATTRIB_INHERIT_NAME_SIZE)
+  {
+    if (!cache)
+    {
+      cache = (IattribInheritCache*)calloc(1, sizeof(IattribInheritCache));
+      ih->inherit_cache = cache;
+    }
+
+    i = cache->next;
+    strcpy(cache->entry[i].name, name);
+    cache->entry[i].value = value;
+    cache->next = (i + 1) % IATTRIB_INHERIT_CACHE_SIZE;
+
+    iattrib_inherit_names |= iAttribInheritCacheNameBit(name);
+  }
+
+  return value;
+}
+
 void iupAttribSetTheme(Ihandle* ih, Ihandle* theme)
 {
   /* theme is a IupUser, we assume all attributes are strings */
@@ -327,7 +496,10 @@ void iupAttribUpdate(Ihandle* ih)
       iAttribNotifyChildren(ih, name, value);
 
     if (store == 0)
+    {
       iupTableRemove(ih->attrib, name); /* remove from the table according to the class SetAttribute */
+      iAttribInheritCacheCheck(ih, name);
+    }
   }
 
   free(name_array);
@@ -774,16 +946,7 @@ IUP_API char* IupGetAttribute(Ihandle *ih, const char* name)
       value = iupAttribGet(ih, name);
 
     if (!value && inherit)
-    {
-      while (!value)
-      {
-        ih = ih->parent;
-        if (!ih)
-          break;
-
-        value = iupAttribGet(ih, name);
-      }
-    }
+      value = iAttribGetInheritFromParent(ih, name);
 
     if (!value)
       value = def_value;
@@ -1093,6 +1256,8 @@ IUP_SDK_API char* iupAttribGetClassObjectId2(Ihandle* ih, const char* name, int
 
 IUP_SDK_API void iupAttribSet(Ihandle* ih, const char* name, const char* value)
 {
+  iAttribInheritCacheCheck(ih, name);
+
   if (!value)
     iupTableRemove(ih->attrib, name);
   else
@@ -1101,6 +1266,8 @@ IUP_SDK_API void iupAttribSet(Ihandle* ih, const char* name, const char* value)
 
 IUP_SDK_API void iupAttribSetStr(Ihandle* ih, const char* name, const char* value)
 {
+  iAttribInheritCacheCheck(ih, name);
+
   if (!value)
     iupTableRemove(ih->attrib, name);
   else
@@ -1512,7 +1679,7 @@ static int iAttribToken(char* env_buffer)
   }
 }
 
-IUP_SDK_API void iupAttribParse(Ihandle *ih, const char* str, int save_led_info)
+void iupAttribParseFunc(const char* str, IattribParseFunc func, void* user_data)
 {
   char env_buffer[256];
   char* name=NULL;
@@ -1532,15 +1699,7 @@ IUP_SDK_API void iupAttribParse(Ihandle *ih, const char* str, int save_led_info)
     case IUPLEX_TK_COMMA:
       if (name)
       {
-        IupStoreAttribute(ih, name, value);
-
-        if (save_led_info)
-        {
-          char led_name[200] = "_IUPLED_SAVED_";
-          strcat(led_name, name);
-          iupAttribSet(ih, led_name, "1");
-        }
-
+        func(user_data, name, value);
         free(name);
       }
       if (end)
@@ -1566,6 +1725,33 @@ IUP_SDK_API void iupAttribParse(Ihandle *ih, const char* str, int save_led_info)
   }
 }
 
+typedef struct _IattribParseData {
+  Ihandle* ih;
+  int save_led_info;
+} IattribParseData;
+
+static void iAttribParseStore(void* user_data, const char* name, const char* value)
+{
+  IattribParseData* data = (IattribParseData*)user_data;
+
+  IupStoreAttribute(data->ih, name, value);
+
+  if (data->save_led_info)
+  {
+    char led_name[200] = "_IUPLED_SAVED_";
+    strcat(led_name, name);
+    iupAttribSet(data->ih, led_name, "1");
+  }
+}
+
+IUP_SDK_API void iupAttribParse(Ihandle *ih, const char* str, int save_led_info)
+{
+  IattribParseData data;
+  data.ih = ih;
+  data.save_led_info = save_led_info;
+  iupAttribParseFunc(str, iAttribParseStore, &data);
+}
+
 IUP_API Ihandle* IupSetAttributes(Ihandle *ih, const char* str)
 {
   iupASSERT(iupObjectCheck(ih));
@@ -220,6 +220,13 @@ IUP_SDK_API char* iupAttribGetLocal(Ihandle* ih, const char* name);
  *\ingroup attrib */
 IUP_SDK_API void iupAttribParse(Ihandle *ih, const char* str, int save_led_info);
 
+typedef void (*IattribParseFunc)(void* user_data, const char* name, const char* value);
+
+/** Parse a string of attributes calling func for each name and value, in order.
+ * value can be NULL. Used to record the attributes of a precompiled LED.
+ *\ingroup attrib */
+void iupAttribParseFunc(const char* str, IattribParseFunc func, void* user_data);
+
 /** Return all saved attributes.
  *\ingroup attrib */
 IUP_SDK_API int iupAttribGetAllSaved(Ihandle* ih, char** names, int n);
@@ -264,6 +271,17 @@ void iupAttribUpdateFromParent(Ihandle* ih);
  * Called only after the element is mapped, and after the children are mapped. */
 void iupAttribUpdateChildren(Ihandle* ih);
 
+/* Invalidates the cache of inherited values of the element and of all its children.
+   Called when the parent of the element changes. */
+void iupAttribInheritCacheInvalidate(Ihandle* ih);
+
+/* Invalidates the cache of inherited values of all the children of the element, for the given attribute,
+   or for all attributes if name is NULL. Called when attributes are changed directly in the table. */
+void iupAttribInheritCacheNotify(Ihandle* ih, const char* name);
+
+/* Releases the cache of inherited values of the element. Called only when the element is destroyed. */
+void iupAttribInheritCacheRelease(Ihandle* ih);
+
 /* Parse attributes from theme and set at element.
    Called only in Create and when a theme is explicitly set */
 void iupAttribSetTheme(Ihandle* ih, Ihandle* theme);
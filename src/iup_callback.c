@@ -10,6 +10,7 @@
 #include "iup.h"
 
 #include "iup_object.h"
+#include "iup_attrib.h"
 #include "iup_assert.h"
 #include "iup_varg.h"
 
@@ -64,6 +65,8 @@ IUP_API Icallback IupSetCallback(Ihandle *ih, const char *name, Icallback func)
   if (!name) 
     return NULL;
 
+  iupAttribInheritCacheNotify(ih, name);
+
   if (!func)
     iupTableRemove(ih->attrib, name);
   else
@@ -62,6 +62,7 @@ static void iChildTreeDetach(Ihandle* parent, Ihandle* child)
         
       child->brother = NULL;
       child->parent = NULL;
+      iupAttribInheritCacheInvalidate(child);
       return;
     }
 
@@ -111,6 +112,8 @@ static void iChildTreeInsert(Ihandle* parent, Ihandle* ref_child, Ihandle* child
   Ihandle *c, 
           *c_prev = NULL;
 
+  iupAttribInheritCacheInvalidate(child);
+
   if (parent->firstchild == NULL)
   {
     parent->firstchild = child;
@@ -222,6 +225,7 @@ IUP_API Ihandle* IupInsert(Ihandle* parent, Ihandle* ref_child, Ihandle* child)
 IUP_SDK_API void iupChildTreeAppend(Ihandle* parent, Ihandle* child)
 {
   child->parent = parent;
+  iupAttribInheritCacheInvalidate(child);
 
   if (parent->firstchild == NULL)
     parent->firstchild = child;
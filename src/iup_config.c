@@ -368,6 +368,8 @@ IUP_API void IupConfigCopy(Ihandle* ih1, Ihandle* ih2, const char* exclude_prefi
 
     name = iupTableNext(ih1->attrib);
   }
+
+  iupAttribInheritCacheNotify(ih2, NULL);
 }
 
 /******************************************************************/
@@ -442,10 +444,12 @@ static int iConfigItemRecent_CB(Ihandle* ih_item)
     Ihandle* ih = (Ihandle*)IupGetAttribute(ih_item, "_IUP_CONFIG");
     IupSetStrAttribute(ih, "TITLE", IupGetAttribute(ih_item, "RECENTFILENAME"));  /* backward compatibility */
     ih->parent = ih_item;
+    iupAttribInheritCacheInvalidate(ih);
 
     recent_cb(ih);
 
     ih->parent = NULL;
+    iupAttribInheritCacheInvalidate(ih);
     IupSetAttribute(ih, "TITLE", NULL);
   }
   return IUP_DEFAULT;
@@ -465,10 +469,12 @@ static int iConfigListRecent_CB(Ihandle* list, char *text, int item, int state)
       Ihandle* ih = (Ihandle*)IupGetAttribute(list, "_IUP_CONFIG");
       IupSetStrAttribute(ih, "RECENTFILENAME", text);
       ih->parent = list;
+      iupAttribInheritCacheInvalidate(ih);
 
       recent_cb(ih);
 
       ih->parent = NULL;
+      iupAttribInheritCacheInvalidate(ih);
       IupSetAttribute(ih, "RECENTFILENAME", NULL);
     }
 
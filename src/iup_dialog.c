@@ -1334,6 +1334,7 @@ static int iDialogSetMenuAttrib(Ihandle* ih, const char* value)
     ih->data->menu = menu;
 
     menu->parent = ih;    /* use this to create a menu bar instead of a popup menu */
+    iupAttribInheritCacheInvalidate(menu);
 
     ih->data->ignore_resize = 1;
     IupMap(menu);     /* this will automatically add the menu to the dialog */
@@ -1176,6 +1176,7 @@ static void iChildTreeInsertFirst(Ihandle* ih, Ihandle* child)
   }
 
   ih->firstchild = child;
+  iupAttribInheritCacheInvalidate(child);
 }
 
 IUP_SDK_API int iupFlatScrollBarCreate(Ihandle* ih)
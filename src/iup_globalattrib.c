@@ -21,6 +21,8 @@
 #include "iup_str.h"
 #include "iup_strmessage.h"
 #include "iup_attrib.h"
+#include "iup_image.h"
+#include "iup_register.h"
 
 
 static Itable *iglobal_table = NULL;
@@ -133,6 +135,11 @@ static void iGlobalSet(const char *name, const char *value, int store)
       iupdrvWarpPointer(x, y);
     return;
   }
+  if (iupStrEqual(name, "IMAGECACHERESET"))
+  {
+    iupImageResetCacheStats();
+    return;
+  }
   if (iupStrEqual(name, "MOUSEBUTTON"))
   {
     int x, y, status;
@@ -226,6 +233,14 @@ IUP_API char* IupGetGlobal(const char *name)
     return iupdrvLocaleInfo();
   if (iupStrEqual(name, "SCROLLBARSIZE"))
     return iupStrReturnInt(iupdrvGetScrollbarSize());
+  if (iupStrEqual(name, "CLASSREGISTERTIME"))
+    return iupRegisterGetClassTimeGlobalAttrib();
+  if (iupStrEqualPartial(name, "IMAGECACHE") || iupStrEqualPartial(name, "IMAGEDATACACHE"))
+  {
+    value = iupImageGetCacheGlobalAttrib(name);
+    if (value)
+      return value;
+  }
 
   value = iupdrvGetGlobal(name);
 
@@ -21,62 +21,163 @@
 #include "iup_array.h"
 
 
+/* Bilinear interpolation is done in fixed point, weights have 7 bits of precision
+   so all intermediate values fit in 16 bits. The vertical pass is done first,
+   then the horizontal pass. The SIMD and the scalar versions produce the same result. */
+#define IRESIZE_SHIFT 7
+#define IRESIZE_ONE   (1 << IRESIZE_SHIFT)
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define IRESIZE_SSE2
+#include <emmintrin.h>
+
+static void iDataResizeLineRGBA_SSE2(int dst_width, const unsigned char *line_mapl, const unsigned char *line_maph, const int *XL, const int *XH, const int *T, int u, unsigned char *dst_map)
+{
+  __m128i zero = _mm_setzero_si128();
+  __m128i wl = _mm_set1_epi16((short)(IRESIZE_ONE - u));
+  __m128i wh = _mm_set1_epi16((short)u);
+  int x;
+
+  for (x = 0; x < dst_width; x++)
+  {
+    int ll, hl, lh, hh, t = T[x];
+    __m128i l, h, v, w;
+
+    memcpy(&ll, line_mapl + XL[x] * 4, 4);
+    memcpy(&hl, line_mapl + XH[x] * 4, 4);
+    memcpy(&lh, line_maph + XL[x] * 4, 4);
+    memcpy(&hh, line_maph + XH[x] * 4, 4);
+
+    /* [x low 4 channels, x high 4 channels] as 16 bits */
+    l = _mm_unpacklo_epi8(_mm_unpacklo_epi32(_mm_cvtsi32_si128(ll), _mm_cvtsi32_si128(hl)), zero);
+    h = _mm_unpacklo_epi8(_mm_unpacklo_epi32(_mm_cvtsi32_si128(lh), _mm_cvtsi32_si128(hh)), zero);
+
+    /* vertical */
+    v = _mm_srli_epi16(_mm_add_epi16(_mm_mullo_epi16(l, wl), _mm_mullo_epi16(h, wh)), IRESIZE_SHIFT);
+
+    /* horizontal */
+    w = _mm_set_epi16((short)t, (short)t, (short)t, (short)t, (short)(IRESIZE_ONE - t), (short)(IRESIZE_ONE - t), (short)(IRESIZE_ONE - t), (short)(IRESIZE_ONE - t));
+    v = _mm_mullo_epi16(v, w);
+    v = _mm_srli_epi16(_mm_add_epi16(v, _mm_srli_si128(v, 8)), IRESIZE_SHIFT);
+
+    ll = _mm_cvtsi128_si32(_mm_packus_epi16(v, zero));
+    memcpy(dst_map, &ll, 4);
+    dst_map += 4;
+  }
+}
+#endif
+
+static void iDataResizeLine(int dst_width, const unsigned char *line_mapl, const unsigned char *line_maph, const int *XL, const int *XH, const int *T, int u, unsigned char *dst_map, int depth)
+{
+  int x, c;
+
+  for (x = 0; x < dst_width; x++)
+  {
+    const unsigned char *fll = line_mapl + XL[x] * depth;
+    const unsigned char *fhl = line_mapl + XH[x] * depth;
+    const unsigned char *flh = line_maph + XL[x] * depth;
+    const unsigned char *fhh = line_maph + XH[x] * depth;
+    int t = T[x];
+
+    for (c = 0; c < depth; c++)
+    {
+      int vl = (fll[c] * (IRESIZE_ONE - u) + flh[c] * u) >> IRESIZE_SHIFT;
+      int vh = (fhl[c] * (IRESIZE_ONE - u) + fhh[c] * u) >> IRESIZE_SHIFT;
+      dst_map[c] = (unsigned char)((vl * (IRESIZE_ONE - t) + vh * t) >> IRESIZE_SHIFT);
+    }
+
+    dst_map += depth;
+  }
+}
+
 static void iDataResizeRGBA(int src_width, int src_height, unsigned char *src_map, int dst_width, int dst_height, unsigned char *dst_map, int depth)
 {
   /* Do bilinear interpolation */
 
   unsigned char *line_mapl, *line_maph;
-  double t, u, src_x, src_y, factor;
-  int xl, yl, xh, yh, x, y;
-  unsigned char *fhh, *fll, *fhl, *flh;
+  int x, y, yl, yh, u;
 
-  int *XL = (int*)malloc(dst_width * sizeof(int));
-  double *T = (double*)malloc(dst_width * sizeof(double));
+  int *XL = (int*)malloc(3 * dst_width * sizeof(int));
+  int *XH = XL + dst_width;
+  int *T = XH + dst_width;
 
-  factor = (double)src_width / (double)dst_width;
+  /* positions and weights are computed in 16.16 fixed point, in 64 bits because the position
+     does not fit in an int for widths above 32767. Each position is computed directly,
+     so the truncation error of the factor is not accumulated along large lines. */
   for (x = 0; x < dst_width; x++)
   {
-    src_x = x * factor;
-    xl = (int)(src_x);
-    T[x] = src_x - xl;
-    XL[x] = xl;
+    long long src_x = ((long long)x * src_width << 16) / dst_width;
+    XL[x] = (int)(src_x >> 16);
+    XH[x] = (XL[x] == src_width - 1) ? XL[x] : XL[x] + 1;
+    T[x] = (int)((src_x & 0xFFFF) >> (16 - IRESIZE_SHIFT));
   }
 
-  factor = (double)src_height / (double)dst_height;
-
   for (y = 0; y < dst_height; y++)
   {
-    src_y = y * factor;
-    yl = (int)(src_y);
+    long long src_y = ((long long)y * src_height << 16) / dst_height;
+    yl = (int)(src_y >> 16);
     yh = (yl == src_height - 1) ? yl : yl + 1;
-    u = src_y - yl;
+    u = (int)((src_y & 0xFFFF) >> (16 - IRESIZE_SHIFT));
+
+    line_mapl = src_map + (size_t)yl * src_width * depth;
+    line_maph = src_map + (size_t)yh * src_width * depth;
+
+#ifdef IRESIZE_SSE2
+    if (depth == 4)
+      iDataResizeLineRGBA_SSE2(dst_width, line_mapl, line_maph, XL, XH, T, u, dst_map);
+    else
+#endif
+      iDataResizeLine(dst_width, line_mapl, line_maph, XL, XH, T, u, dst_map, depth);
+
+    dst_map += (size_t)dst_width * depth;
+  }
 
-    line_mapl = src_map + yl * src_width * depth;
-    line_maph = src_map + yh * src_width * depth;
+  free(XL);
+}
+
+static void iDataReduceRGBA(int src_width, int src_height, unsigned char *src_map, int dst_width, int dst_height, unsigned char *dst_map, int depth)
+{
+  /* Do box filtering, each destination pixel is the average of the source pixels it covers */
+
+  int x, y, c, sx, sy;
+  unsigned int sum[4];
+
+  int *X0 = (int*)malloc((dst_width + 1) * sizeof(int));
+  for (x = 0; x <= dst_width; x++)
+    X0[x] = (int)(((long long)x * src_width) / dst_width);
+
+  for (y = 0; y < dst_height; y++)
+  {
+    int y0 = (int)(((long long)y * src_height) / dst_height);
+    int y1 = (int)(((long long)(y + 1) * src_height) / dst_height);
 
     for (x = 0; x < dst_width; x++)
     {
-      xl = XL[x];
-      xh = (xl == src_width - 1) ? xl : xl + 1;
-      t = T[x];
+      int x0 = X0[x];
+      int x1 = X0[x + 1];
+      int count = (x1 - x0) * (y1 - y0);
 
-      fll = line_mapl + xl * depth;
-      fhl = line_mapl + xh * depth;
-      flh = line_maph + xl * depth;
-      fhh = line_maph + xh * depth;
+      sum[0] = sum[1] = sum[2] = sum[3] = 0;
 
-      dst_map[0] = (unsigned char)(u * t * (fhh[0] - flh[0] - fhl[0] + fll[0]) + t * (fhl[0] - fll[0]) + u * (flh[0] - fll[0]) + fll[0]);
-      dst_map[1] = (unsigned char)(u * t * (fhh[1] - flh[1] - fhl[1] + fll[1]) + t * (fhl[1] - fll[1]) + u * (flh[1] - fll[1]) + fll[1]);
-      dst_map[2] = (unsigned char)(u * t * (fhh[2] - flh[2] - fhl[2] + fll[2]) + t * (fhl[2] - fll[2]) + u * (flh[2] - fll[2]) + fll[2]);
-      if (depth == 4)
-        dst_map[3] = (unsigned char)(u * t * (fhh[3] - flh[3] - fhl[3] + fll[3]) + t * (fhl[3] - fll[3]) + u * (flh[3] - fll[3]) + fll[3]);
+      for (sy = y0; sy < y1; sy++)
+      {
+        unsigned char *src = src_map + ((size_t)sy * src_width + x0) * depth;
+        for (sx = x0; sx < x1; sx++)
+        {
+          for (c = 0; c < depth; c++)
+            sum[c] += src[c];
+          src += depth;
+        }
+      }
+
+      for (c = 0; c < depth; c++)
+        dst_map[c] = (unsigned char)((sum[c] + count / 2) / count);
 
       dst_map += depth;
     }
   }
 
-  free(XL);
-  free(T);
+  free(X0);
 }
 
 static void iDataStretchMap(int src_width, int src_height, unsigned char *src_map, int dst_width, int dst_height, unsigned char *dst_map)
@@ -110,6 +211,224 @@ static void iDataStretchMap(int src_width, int src_height, unsigned char *src_ma
   free(XTab);
 }
 
+/**************************************************************************************************/
+
+
+/* Process-wide cache of computed image data (scaled pixels and inactive pixels).
+   It is shared by all images, controls and drivers. Entries are indexed by a data id of the
+   source image, a serial number that is never reused, so an entry can not be returned for
+   other pixels. The id is replaced when the pixels change (resize, RESHAPE and CLEARCACHE).
+   Entries are copies of the data, so they can be evicted at any time.
+   The least recently used entries are removed when the memory budget is exceeded. */
+
+#define IIMAGE_DATACACHE_DEFAULT_SIZE 8192  /* in Kbytes */
+
+typedef struct _IimageDataEntry
+{
+  char key[100];
+  unsigned char* data;
+  int size;
+  struct _IimageDataEntry *prev, *next;  /* most recently used first */
+} IimageDataEntry;
+
+static struct {
+  Itable* table;
+  IimageDataEntry *first, *last;
+  long long memory;
+  int count, hits, misses;
+} iimage_data_cache = { NULL, NULL, NULL, 0, 0, 0, 0 };
+
+static int iimage_data_last_id = 0;
+
+static void iImageDataCacheUnlink(IimageDataEntry* entry)
+{
+  if (entry->prev) entry->prev->next = entry->next;
+  else iimage_data_cache.first = entry->next;
+  if (entry->next) entry->next->prev = entry->prev;
+  else iimage_data_cache.last = entry->prev;
+  entry->prev = NULL;
+  entry->next = NULL;
+}
+
+static void iImageDataCacheLinkFirst(IimageDataEntry* entry)
+{
+  entry->prev = NULL;
+  entry->next = iimage_data_cache.first;
+  if (iimage_data_cache.first) iimage_data_cache.first->prev = entry;
+  iimage_data_cache.first = entry;
+  if (!iimage_data_cache.last) iimage_data_cache.last = entry;
+}
+
+static void iImageDataCacheRemove(IimageDataEntry* entry)
+{
+  iImageDataCacheUnlink(entry);
+  iupTableRemove(iimage_data_cache.table, entry->key);
+  iimage_data_cache.memory -= entry->size;
+  iimage_data_cache.count--;
+  free(entry->data);
+  free(entry);
+}
+
+static long long iImageDataCacheMaxMemory(void)
+{
+  int size = IIMAGE_DATACACHE_DEFAULT_SIZE;
+  char* value = IupGetGlobal("IMAGEDATACACHESIZE");
+  if (value)
+    iupStrToInt(value, &size);
+  if (size < 0) size = 0;
+  return (long long)size * 1024;
+}
+
+static void iImageDataCacheFinish(void)
+{
+  while (iimage_data_cache.first)
+    iImageDataCacheRemove(iimage_data_cache.first);
+
+  if (iimage_data_cache.table)
+  {
+    iupTableDestroy(iimage_data_cache.table);
+    iimage_data_cache.table = NULL;
+  }
+}
+
+static unsigned char* iImageDataCacheGet(const char* key)
+{
+  IimageDataEntry* entry;
+
+  if (!iimage_data_cache.table)
+    return NULL;
+
+  entry = (IimageDataEntry*)iupTableGet(iimage_data_cache.table, key);
+  if (!entry)
+  {
+    iimage_data_cache.misses++;
+    return NULL;
+  }
+
+  iimage_data_cache.hits++;
+
+  if (entry != iimage_data_cache.first)
+  {
+    iImageDataCacheUnlink(entry);
+    iImageDataCacheLinkFirst(entry);
+  }
+
+  return entry->data;
+}
+
+static unsigned char* iImageDataCacheAdd(const char* key, const unsigned char* data, int size)
+{
+  /* stores a copy of the data, returns the stored copy or NULL if it does not fit in the budget */
+  long long max_memory = iImageDataCacheMaxMemory();
+  IimageDataEntry* entry;
+
+  if (size > max_memory)
+    return NULL;
+
+  if (!iimage_data_cache.table)
+    iimage_data_cache.table = iupTableCreate(IUPTABLE_STRINGINDEXED);
+
+  while (iimage_data_cache.last && iimage_data_cache.memory + size > max_memory)
+    iImageDataCacheRemove(iimage_data_cache.last);
+
+  entry = (IimageDataEntry*)malloc(sizeof(IimageDataEntry));
+  if (!entry)
+    return NULL;
+  entry->data = (unsigned char*)malloc(size);
+  if (!entry->data)
+  {
+    free(entry);
+    return NULL;
+  }
+
+  memcpy(entry->data, data, size);
+  entry->size = size;
+  iupStrCopyN(entry->key, sizeof(entry->key), key);
+
+  iupTableSet(iimage_data_cache.table, entry->key, entry, IUPTABLE_POINTER);
+  iImageDataCacheLinkFirst(entry);
+  iimage_data_cache.memory += size;
+  iimage_data_cache.count++;
+
+  return entry->data;
+}
+
+static void iImageDataCacheKey(char* key, char type, Ihandle* ih, int size, const char* extra)
+{
+  int data_id = iupAttribGetInt(ih, "_IUPIMAGE_DATAID");
+  if (!data_id)
+  {
+    iimage_data_last_id++;
+    data_id = iimage_data_last_id;
+    iupAttribSetInt(ih, "_IUPIMAGE_DATAID", data_id);
+  }
+
+  sprintf(key, "%c:%d:%dx%dx%d:%.60s", type, data_id, ih->currentwidth, ih->currentheight, size, extra);
+}
+
+static void iImageDataChanged(Ihandle* ih)
+{
+  /* a new id is created in the next cache access */
+  iupAttribSet(ih, "_IUPIMAGE_DATAID", NULL);
+}
+
+unsigned char* iupImageGetInactiveData(Ihandle* ih, unsigned char bg_r, unsigned char bg_g, unsigned char bg_b, int blend_alpha)
+{
+  unsigned char* imgdata = (unsigned char*)iupAttribGet(ih, "WID");
+  int channels = iupAttribGetInt(ih, "CHANNELS");
+  int i, count = ih->currentwidth * ih->currentheight;
+  unsigned char *data, *cached;
+  char key[100], extra[30];
+
+  if (!imgdata || iupAttribGetInt(ih, "BPP") == 8 || count * channels > iImageDataCacheMaxMemory())
+    return NULL;
+
+  sprintf(extra, "I%d,%d,%d,%d", (int)bg_r, (int)bg_g, (int)bg_b, blend_alpha);
+  iImageDataCacheKey(key, 'I', ih, count * channels, extra);
+
+  cached = iImageDataCacheGet(key);
+  if (cached)
+    return cached;
+
+  data = (unsigned char*)malloc(count * channels);
+  if (!data)
+    return NULL;
+  memcpy(data, imgdata, count * channels);
+
+  for (i = 0; i < count; i++)
+  {
+    unsigned char *r = data + i * channels,
+                  *g = r + 1,
+                  *b = g + 1;
+
+    if (channels == 4 && blend_alpha && r[3] != 255)
+    {
+      *r = iupALPHABLEND(*r, bg_r, r[3]);
+      *g = iupALPHABLEND(*g, bg_g, r[3]);
+      *b = iupALPHABLEND(*b, bg_b, r[3]);
+    }
+
+    iupImageColorMakeInactive(r, g, b, bg_r, bg_g, bg_b);
+  }
+
+  cached = iImageDataCacheAdd(key, data, count * channels);
+  free(data);
+  return cached;
+}
+
+static char* iImageDataCacheGetGlobalAttrib(const char* name)
+{
+  if (iupStrEqual(name, "IMAGEDATACACHEHITS"))
+    return iupStrReturnInt(iimage_data_cache.hits);
+  if (iupStrEqual(name, "IMAGEDATACACHEMISSES"))
+    return iupStrReturnInt(iimage_data_cache.misses);
+  if (iupStrEqual(name, "IMAGEDATACACHECOUNT"))
+    return iupStrReturnInt(iimage_data_cache.count);
+  if (iupStrEqual(name, "IMAGEDATACACHEMEMORY"))
+    return iupStrReturnStrf("%lld", iimage_data_cache.memory);
+  return NULL;
+}
+
 static void iImageResize(Ihandle* ih, int new_width, int new_height)
 {
   unsigned char* imgdata = (unsigned char*)iupAttribGet(ih, "WID");
@@ -117,17 +436,34 @@ static void iImageResize(Ihandle* ih, int new_width, int new_height)
   int bpp = iupAttribGetInt(ih, "BPP");
   int count = new_width*new_height*channels;
   unsigned char* new_imgdata = (unsigned char *)malloc(count);
+  unsigned char* cached;
+  char key[100], extra[30];
 
-  if (bpp == 8)
-    iDataStretchMap(ih->currentwidth, ih->currentheight, imgdata, new_width, new_height, new_imgdata);
+  /* the scaled data of identical images is computed only once */
+  sprintf(extra, "S%dx%d", new_width, new_height);
+  iImageDataCacheKey(key, 'S', ih, ih->currentwidth*ih->currentheight*channels, extra);
+
+  cached = iImageDataCacheGet(key);
+  if (cached)
+    memcpy(new_imgdata, cached, count);
   else
-    iDataResizeRGBA(ih->currentwidth, ih->currentheight, imgdata, new_width, new_height, new_imgdata, channels);
+  {
+    if (bpp == 8)
+      iDataStretchMap(ih->currentwidth, ih->currentheight, imgdata, new_width, new_height, new_imgdata);
+    else if (new_width <= ih->currentwidth && new_height <= ih->currentheight)
+      iDataReduceRGBA(ih->currentwidth, ih->currentheight, imgdata, new_width, new_height, new_imgdata, channels);
+    else
+      iDataResizeRGBA(ih->currentwidth, ih->currentheight, imgdata, new_width, new_height, new_imgdata, channels);
+
+    iImageDataCacheAdd(key, new_imgdata, count);
+  }
 
   ih->currentwidth = new_width;
   ih->currentheight = new_height;
 
   free(imgdata);
   iupAttribSet(ih, "WID", (char*)new_imgdata);
+  iImageDataChanged(ih);
 }
 
 
@@ -166,6 +502,8 @@ void iupImageStockFinish(void)
 
   iupTableDestroy(istock_table);
   istock_table = NULL;
+
+  iImageDataCacheFinish();
 }
 
 IUP_SDK_API void iupImageStockSet(const char *name, iupImageStockCreateFunc func, const char* native_name)
@@ -629,6 +967,57 @@ void* iupImageGetCursor(const char* name)
   return cursor;
 }
 
+/* Statistics of the native image cache, shared by all images and all controls */
+static struct {
+  int hits, misses;
+  int count;         /* number of native images currently in the cache */
+  long long memory;  /* estimated memory used by them, in bytes */
+} iimage_cache_stats = { 0, 0, 0, 0 };
+
+static void iImageCacheStatsAdd(Ihandle* ih, const char* cache_name)
+{
+  /* the size is stored for each entry, because the image can be resized after the native image is created */
+  int size = ih->currentwidth * ih->currentheight * 4;
+  char size_name[120];
+  sprintf(size_name, "_IUPCACHESIZE%.100s", cache_name);
+  iupAttribSetInt(ih, size_name, size);
+  iimage_cache_stats.count++;
+  iimage_cache_stats.memory += size;
+}
+
+static void iImageCacheStatsRemove(Ihandle* ih, const char* cache_name)
+{
+  char size_name[120];
+  sprintf(size_name, "_IUPCACHESIZE%.100s", cache_name);
+  iimage_cache_stats.count--;
+  iimage_cache_stats.memory -= iupAttribGetInt(ih, size_name);
+  iupAttribSet(ih, size_name, NULL);
+}
+
+char* iupImageGetCacheGlobalAttrib(const char* name)
+{
+  if (iupStrEqualPartial(name, "IMAGEDATACACHE"))
+    return iImageDataCacheGetGlobalAttrib(name);
+
+  if (iupStrEqual(name, "IMAGECACHEHITS"))
+    return iupStrReturnInt(iimage_cache_stats.hits);
+  if (iupStrEqual(name, "IMAGECACHEMISSES"))
+    return iupStrReturnInt(iimage_cache_stats.misses);
+  if (iupStrEqual(name, "IMAGECACHECOUNT"))
+    return iupStrReturnInt(iimage_cache_stats.count);
+  if (iupStrEqual(name, "IMAGECACHEMEMORY"))
+    return iupStrReturnStrf("%lld", iimage_cache_stats.memory);
+  return NULL;
+}
+
+void iupImageResetCacheStats(void)
+{
+  iimage_cache_stats.hits = 0;
+  iimage_cache_stats.misses = 0;
+  iimage_data_cache.hits = 0;
+  iimage_data_cache.misses = 0;
+}
+
 void* iupImageGetImage(const char* name, Ihandle* ih_parent, int make_inactive, const char* bgcolor)
 {
   char cache_name[100] = "_IUPIMAGE_IMAGE";
@@ -696,7 +1085,12 @@ void* iupImageGetImage(const char* name, Ihandle* ih_parent, int make_inactive,
   /* Check for an already created native image */
   handle = (void*)iupAttribGet(ih, cache_name);
   if (handle)
+  {
+    iimage_cache_stats.hits++;
     return handle;
+  }
+
+  iimage_cache_stats.misses++;
 
   if (ih_parent && iupAttribGetStr(ih_parent, "FLAT_ALPHA"))
     iupAttribSet(ih, "FLAT_ALPHA", "1");
@@ -716,6 +1110,8 @@ void* iupImageGetImage(const char* name, Ihandle* ih_parent, int make_inactive,
 
   /* save the native image in the cache */
   iupAttribSet(ih, cache_name, (char*)handle);
+  if (handle)
+    iImageCacheStatsAdd(ih, cache_name);
 
   return handle;
 }
@@ -868,7 +1264,15 @@ void iupImageRemoveFromCache(Ihandle* ih, void* handle)
       cur_handle = iupTableGetCurr(ih->attrib);
       if (cur_handle == handle)
       {
-        iupTableRemoveCurr(ih->attrib);
+        if (iupStrEqualPartial(name, "_IUPIMAGE_IMAGE"))
+        {
+          char cache_name[100];
+          iupStrCopyN(cache_name, sizeof(cache_name), name);
+          iupTableRemoveCurr(ih->attrib);
+          iImageCacheStatsRemove(ih, cache_name);
+        }
+        else
+          iupTableRemoveCurr(ih->attrib);
         return;
       }
     }
@@ -882,6 +1286,9 @@ static void iImageClearCache(Ihandle* ih)
   char *name;
   void* handle;
 
+  /* the pixels may have been changed */
+  iImageDataChanged(ih);
+
   handle = iupAttribGet(ih, "_IUPIMAGE_MASK");
   if (handle)
   {
@@ -912,8 +1319,16 @@ static void iImageClearCache(Ihandle* ih)
       handle = iupTableGetCurr(ih->attrib);
       if (handle)
       {
+        char size_name[120];
+        sprintf(size_name, "_IUPCACHESIZE%.100s", name);
+
         iupdrvImageDestroy(handle, IUPIMAGE_IMAGE);
         iupTableSetCurr(ih->attrib, NULL, IUPTABLE_POINTER);
+
+        /* only a lookup, does not change the traversal,
+           the size attribute is kept and will be replaced when the entry is created again */
+        iimage_cache_stats.count--;
+        iimage_cache_stats.memory -= iupAttribGetInt(ih, size_name);
       }
     }
 
@@ -1000,6 +1415,7 @@ static int iImageSetReshapeAttrib(Ihandle *ih, const char* value)
 
     ih->currentwidth = w;
     ih->currentheight = h;
+    iImageDataChanged(ih);
   }
   return 0;
 }
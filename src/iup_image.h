@@ -27,6 +27,13 @@ void* iupImageGetCursor(const char* name);
 void* iupImageGetImage(const char* name, Ihandle* parent, int make_inactive, const char* bgcolor);
 void iupImageGetInfo(const char* name, int *w, int *h, int *bpp);
 void iupImageRemoveFromCache(Ihandle* ih, void* handle);
+char* iupImageGetCacheGlobalAttrib(const char* name);  /* IMAGECACHE* global attributes */
+void iupImageResetCacheStats(void);
+
+/* Returns the RGB(A) data of the image already converted to inactive, shared by identical images.
+   If blend_alpha is set, transparent pixels are first blended with the background.
+   The returned data is valid until the next call, returns NULL for 8 bpp images or if it does not fit in the data cache. */
+unsigned char* iupImageGetInactiveData(Ihandle* ih, unsigned char bg_r, unsigned char bg_g, unsigned char bg_b, int blend_alpha);
 
 typedef struct _iupColor { 
   unsigned char r, g, b, a; 
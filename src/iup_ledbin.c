@@ -0,0 +1,753 @@
+/** \file
+ * \brief precompiled LED loader, writer and compile cache
+ *
+ * See Copyright Notice in "iup.h"
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#ifndef WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#endif
+
+#include "iup.h"
+
+#include "iup_object.h"
+#include "iup_class.h"
+#include "iup_attrib.h"
+#include "iup_str.h"
+#include "iup_table.h"
+#include "iup_array.h"
+#include "iup_register.h"
+#include "iup_ledlex.h"
+#include "iup_ledbin.h"
+
+
+/**************************************************************************/
+/* Loader                                                                 */
+/**************************************************************************/
+
+static char iledbin_errormsg[1024];
+
+static const char* iLedBinError(const char* filename, const char* msg, const char* name)
+{
+  char str[512], short_name[400];
+  iupStrCopyN(short_name, sizeof(short_name), name? name: "");
+  sprintf(str, msg, short_name);
+  sprintf(iledbin_errormsg, "led(%.400s):\n  -bad input in precompiled LED\n  -%s\n", filename, str);
+  return iledbin_errormsg;
+}
+
+static const unsigned char* iLedBinMapFile(const char* filename, size_t *size)
+{
+#ifndef WIN32
+  /* the file is mapped, strings are used directly from the file pages */
+  struct stat st;
+  void* data;
+  int fd = open(filename, O_RDONLY);
+  if (fd < 0)
+    return NULL;
+
+  if (fstat(fd, &st) != 0 || st.st_size == 0)
+  {
+    close(fd);
+    return NULL;
+  }
+
+  data = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (data == MAP_FAILED)
+    return NULL;
+
+  *size = (size_t)st.st_size;
+  return (const unsigned char*)data;
+#else
+  unsigned char* data;
+  FILE* file = fopen(filename, "rb");
+  if (!file)
+    return NULL;
+
+  fseek(file, 0, SEEK_END);
+  *size = (size_t)ftell(file);
+  fseek(file, 0, SEEK_SET);
+
+  data = (unsigned char*)malloc(*size + 1);
+  if (!data || fread(data, 1, *size, file) != *size)
+  {
+    if (data) free(data);
+    fclose(file);
+    return NULL;
+  }
+
+  fclose(file);
+  return data;
+#endif
+}
+
+static void iLedBinUnmapFile(const unsigned char* data, size_t size)
+{
+#ifndef WIN32
+  munmap((void*)data, size);
+#else
+  (void)size;
+  free((void*)data);
+#endif
+}
+
+static int iLedBinCheckHeader(const unsigned char* data, size_t size)
+{
+  const IledbHeader* header = (const IledbHeader*)data;
+  size_t total;
+
+  if (size < sizeof(IledbHeader) ||
+      memcmp(header->magic, ILEDB_MAGIC, sizeof(header->magic)) != 0 ||
+      header->byte_order != ILEDB_BYTE_ORDER ||
+      header->version != ILEDB_VERSION ||
+      header->string_size % 4 != 0)
+    return 0;
+
+  total = sizeof(IledbHeader) + (size_t)header->string_count * sizeof(unsigned int) +
+          (size_t)header->string_size + (size_t)header->code_count * sizeof(int);
+  if (total != size)
+    return 0;
+
+  /* the last string must be terminated */
+  if (header->string_count && data[sizeof(IledbHeader) + header->string_count * sizeof(unsigned int) + header->string_size - 1] != 0)
+    return 0;
+
+  return 1;
+}
+
+typedef struct _IledbLoad {
+  const char* filename;
+  const unsigned int* offsets;
+  const char* strings;
+  unsigned int string_count, string_size;
+  Iarray* slots;
+} IledbLoad;
+
+static const char* iLedBinString(IledbLoad* load, int index)
+{
+  if (index < 0 || (unsigned int)index >= load->string_count || load->offsets[index] >= load->string_size)
+    return NULL;
+  return load->strings + load->offsets[index];
+}
+
+static void iLedBinAddSlot(Iarray* slots, Ihandle* ih)
+{
+  Ihandle** data = (Ihandle**)iupArrayInc(slots);
+  data[iupArrayCount(slots) - 1] = ih;
+}
+
+static Ihandle* iLedBinSlot(IledbLoad* load, int slot)
+{
+  if (slot < 0 || slot >= iupArrayCount(load->slots))
+    return NULL;
+  return ((Ihandle**)iupArrayGetData(load->slots))[slot];
+}
+
+/* converts a parameter to the format of the class, the same conversions of the text parser */
+static const char* iLedBinParam(IledbLoad* load, char format, int type, int value, void** param)
+{
+  const char* str = NULL;
+
+  if (type == ILEDB_PARAM_STR || type == ILEDB_PARAM_WORD)
+  {
+    str = iLedBinString(load, value);
+    if (!str)
+      return iLedBinError(load->filename, "invalid string", NULL);
+  }
+
+  switch (format)
+  {
+  case 's':
+    if (type != ILEDB_PARAM_STR)
+      return iLedBinError(load->filename, "string expected", NULL);
+    *param = (void*)str;
+    return NULL;
+
+  case 'a':
+    if (type != ILEDB_PARAM_WORD)
+      return iLedBinError(load->filename, "identifier expected", NULL);
+    *param = (void*)str;
+    return NULL;
+
+  case 'b':
+  case 'c':
+    {
+      unsigned int b = 0;
+      if (type == ILEDB_PARAM_INT)
+        b = (unsigned int)value;
+      else if (type == ILEDB_PARAM_WORD)
+        sscanf(str, "%u", &b);
+      else
+        return iLedBinError(load->filename, "number expected", NULL);
+      if (b > 255) b = 255;
+      *param = (void*)(unsigned long)b;
+      return NULL;
+    }
+
+  case 'i':
+  case 'j':
+    {
+      int i = 0;
+      if (type == ILEDB_PARAM_INT)
+        i = value;
+      else if (type == ILEDB_PARAM_WORD)
+        sscanf(str, "%d", &i);
+      else
+        return iLedBinError(load->filename, "number expected", NULL);
+      *param = (void*)(unsigned long)i;
+      return NULL;
+    }
+
+  case 'f':
+    {
+      float f = 0;
+      unsigned int bits;
+      if (type == ILEDB_PARAM_FLOAT)
+        memcpy(&f, &value, sizeof(float));
+      else if (type == ILEDB_PARAM_INT)
+        f = (float)value;
+      else if (type == ILEDB_PARAM_WORD)
+        sscanf(str, "%f", &f);
+      else
+        return iLedBinError(load->filename, "number expected", NULL);
+      memcpy(&bits, &f, sizeof(float));
+      *param = (void*)(unsigned long)bits;
+      return NULL;
+    }
+
+  case 'g':
+  case 'h':
+    if (type == ILEDB_PARAM_NULL)
+      *param = NULL;
+    else if (type == ILEDB_PARAM_ELEM)
+    {
+      *param = iLedBinSlot(load, value);
+      if (!*param)
+        return iLedBinError(load->filename, "invalid element", NULL);
+    }
+    else if (type == ILEDB_PARAM_WORD)
+    {
+      *param = IupGetHandle(str);
+      if (!*param)
+        return iLedBinError(load->filename, "handle name '%s' not defined", str);
+    }
+    else
+      return iLedBinError(load->filename, "element expected", NULL);
+    return NULL;
+  }
+
+  return iLedBinError(load->filename, "invalid parameter", NULL);
+}
+
+static const char* iLedBinCreate(IledbLoad* load, Iclass* ic, const int* code, int param_count, Ihandle** ih)
+{
+  const char* format = ic->format;
+  int i, num_format = format? (int)strlen(format): 0;
+  int array = num_format && (format[num_format - 1] == 'j' || format[num_format - 1] == 'g' || format[num_format - 1] == 'c');
+  void** params;
+
+  if (num_format == 0)
+  {
+    if (param_count)
+      return iLedBinError(load->filename, "too many parameters for %s", ic->name);
+
+    *ih = iupObjectCreate(ic, NULL);
+    return NULL;
+  }
+
+  if (param_count > num_format && !array)
+    return iLedBinError(load->filename, "too many parameters for %s", ic->name);
+
+  params = (void**)calloc(param_count + num_format + 1, sizeof(void*));
+
+  for (i = 0; i < param_count; i++)
+  {
+    char p_format = (i < num_format)? format[i]: format[num_format - 1];
+    const char* err = iLedBinParam(load, p_format, code[2 * i], code[2 * i + 1], params + i);
+    if (err)
+    {
+      free(params);
+      return err;
+    }
+  }
+
+  /* only a missing element is allowed, for empty containers */
+  for (; i < num_format; i++)
+  {
+    if (format[i] != 'g' && format[i] != 'h')
+    {
+      free(params);
+      return iLedBinError(load->filename, "too few parameters for %s", ic->name);
+    }
+  }
+
+  params[param_count] = NULL;
+  *ih = iupObjectCreate(ic, params);
+
+  free(params);
+  return NULL;
+}
+
+static const char* iLedBinExecute(IledbLoad* load, const int* code, int code_count)
+{
+  int pc = 0;
+
+  while (pc < code_count)
+  {
+    int op = code[pc++];
+
+    switch (op)
+    {
+    case ILEDB_OP_ELEM:
+      {
+        char class_name[50];
+        const char* name;
+        const char* err;
+        Iclass* ic;
+        Ihandle* ih = NULL;
+        int i, param_count, attr_count;
+
+        if (pc + 2 > code_count)
+          return iLedBinError(load->filename, "unexpected end of code", NULL);
+
+        name = iLedBinString(load, code[pc++]);
+        if (!name)
+          return iLedBinError(load->filename, "invalid string", NULL);
+        iupStrCopyN(class_name, sizeof(class_name), name);
+        ic = iupRegisterFindClass(class_name);
+        if (!ic)
+          return iLedBinError(load->filename, "unknown class %s", class_name);
+
+        param_count = code[pc++];
+        if (param_count < 0 || pc + 2 * param_count + 1 > code_count)
+          return iLedBinError(load->filename, "unexpected end of code", NULL);
+
+        err = iLedBinCreate(load, ic, code + pc, param_count, &ih);
+        if (err)
+          return err;
+        if (!ih)
+          return iLedBinError(load->filename, "failed to create %s", class_name);
+        pc += 2 * param_count;
+
+        attr_count = code[pc++];
+        if (attr_count < 0 || pc + 2 * attr_count > code_count)
+          return iLedBinError(load->filename, "unexpected end of code", NULL);
+
+        for (i = 0; i < attr_count; i++)
+        {
+          const char* attr_name = iLedBinString(load, code[pc]);
+          const char* attr_value = (code[pc + 1] == ILEDB_NONE)? NULL: iLedBinString(load, code[pc + 1]);
+          if (!attr_name || (!attr_value && code[pc + 1] != ILEDB_NONE))
+            return iLedBinError(load->filename, "invalid string", NULL);
+
+          IupStoreAttribute(ih, attr_name, attr_value);
+          pc += 2;
+        }
+
+        iLedBinAddSlot(load->slots, ih);
+        break;
+      }
+
+    case ILEDB_OP_GET:
+      {
+        const char* name;
+        Ihandle* ih;
+
+        if (pc + 1 > code_count)
+          return iLedBinError(load->filename, "unexpected end of code", NULL);
+
+        name = iLedBinString(load, code[pc++]);
+        if (!name)
+          return iLedBinError(load->filename, "invalid string", NULL);
+
+        ih = IupGetHandle(name);
+        if (!ih)
+          return iLedBinError(load->filename, "handle name '%s' not defined", name);
+
+        iLedBinAddSlot(load->slots, ih);
+        break;
+      }
+
+    case ILEDB_OP_NAME:
+      {
+        const char* name;
+        Ihandle* ih;
+
+        if (pc + 2 > code_count)
+          return iLedBinError(load->filename, "unexpected end of code", NULL);
+
+        ih = iLedBinSlot(load, code[pc++]);
+        name = iLedBinString(load, code[pc++]);
+        if (!ih || !name)
+          return iLedBinError(load->filename, "invalid element name", NULL);
+
+        IupSetHandle(name, ih);
+        break;
+      }
+
+    default:
+      return iLedBinError(load->filename, "invalid instruction", NULL);
+    }
+  }
+
+  return NULL;
+}
+
+int iupLedBinIsBinary(const char* filename)
+{
+  char magic[8];
+  int ret = 0;
+  FILE* file = fopen(filename, "rb");
+  if (!file)
+    return 0;
+
+  if (fread(magic, 1, sizeof(magic), file) == sizeof(magic) && memcmp(magic, ILEDB_MAGIC, sizeof(magic)) == 0)
+    ret = 1;
+
+  fclose(file);
+  return ret;
+}
+
+const char* iupLedBinLoad(const char* filename)
+{
+  const IledbHeader* header;
+  const unsigned char* data;
+  const char* err;
+  IledbLoad load;
+  size_t size = 0;
+
+  data = iLedBinMapFile(filename, &size);
+  if (!data)
+    return iLedBinError(filename, "cannot open file", NULL);
+
+  if (!iLedBinCheckHeader(data, size))
+  {
+    iLedBinUnmapFile(data, size);
+    return iLedBinError(filename, "invalid header or size", NULL);
+  }
+
+  header = (const IledbHeader*)data;
+  load.filename = filename;
+  load.offsets = (const unsigned int*)(data + sizeof(IledbHeader));
+  load.strings = (const char*)(load.offsets + header->string_count);
+  load.string_count = header->string_count;
+  load.string_size = header->string_size;
+  load.slots = iupArrayCreate(50, sizeof(Ihandle*));
+
+  err = iLedBinExecute(&load, (const int*)(load.strings + load.string_size), (int)header->code_count);
+
+  iupArrayDestroy(load.slots);
+  iLedBinUnmapFile(data, size);
+  return err;
+}
+
+
+/**************************************************************************/
+/* Writer, records the text parser                                        */
+/**************************************************************************/
+
+struct _IledbWriter {
+  Itable* string_table;  /* string index + 1, by string */
+  Iarray* strings;       /* char */
+  Iarray* offsets;       /* unsigned int */
+  Iarray* code;          /* int */
+  Iarray* slots;         /* Ihandle*, element of each slot */
+  int attr_count_pos;    /* position of the attribute count of the last element */
+  int error;             /* something could not be recorded, the file will not be saved */
+};
+
+IledbWriter* iupLedBinWriterCreate(void)
+{
+  IledbWriter* writer = (IledbWriter*)calloc(1, sizeof(IledbWriter));
+  writer->string_table = iupTableCreate(IUPTABLE_STRINGINDEXED);
+  writer->strings = iupArrayCreate(1024, sizeof(char));
+  writer->offsets = iupArrayCreate(100, sizeof(unsigned int));
+  writer->code = iupArrayCreate(1024, sizeof(int));
+  writer->slots = iupArrayCreate(100, sizeof(Ihandle*));
+  writer->attr_count_pos = -1;
+  return writer;
+}
+
+void iupLedBinWriterDestroy(IledbWriter* writer)
+{
+  iupTableDestroy(writer->string_table);
+  iupArrayDestroy(writer->strings);
+  iupArrayDestroy(writer->offsets);
+  iupArrayDestroy(writer->code);
+  iupArrayDestroy(writer->slots);
+  free(writer);
+}
+
+static void iLedBinWriterCode(IledbWriter* writer, int value)
+{
+  int* code = (int*)iupArrayInc(writer->code);
+  code[iupArrayCount(writer->code) - 1] = value;
+}
+
+static int iLedBinWriterString(IledbWriter* writer, const char* str)
+{
+  /* identical strings are stored once */
+  int index = (int)(size_t)iupTableGet(writer->string_table, str);
+  if (!index)
+  {
+    int len = (int)strlen(str) + 1;
+    int offset = iupArrayCount(writer->strings);
+    unsigned int* offsets = (unsigned int*)iupArrayInc(writer->offsets);
+    char* strings = (char*)iupArrayAdd(writer->strings, len);
+
+    index = iupArrayCount(writer->offsets);
+    offsets[index - 1] = (unsigned int)offset;
+    memcpy(strings + offset, str, len);
+
+    iupTableSet(writer->string_table, str, (void*)(size_t)index, IUPTABLE_POINTER);
+  }
+
+  return index - 1;
+}
+
+static int iLedBinWriterFindSlot(IledbWriter* writer, Ihandle* ih)
+{
+  /* parameters are usually the last elements created */
+  Ihandle** slots = (Ihandle**)iupArrayGetData(writer->slots);
+  int i;
+  for (i = iupArrayCount(writer->slots) - 1; i >= 0; i--)
+  {
+    if (slots[i] == ih)
+      return i;
+  }
+  writer->error = 1;
+  return -1;
+}
+
+void iupLedBinRecordElem(IledbWriter* writer, Ihandle* ih, Iclass* ic, void** params, int count)
+{
+  const char* format = ic->format;
+  int i, num_format = format? (int)strlen(format): 0;
+
+  if (!ih)
+  {
+    writer->error = 1;
+    return;
+  }
+
+  iLedBinWriterCode(writer, ILEDB_OP_ELEM);
+  iLedBinWriterCode(writer, iLedBinWriterString(writer, ic->name));
+  iLedBinWriterCode(writer, count);
+
+  for (i = 0; i < count; i++)
+  {
+    /* an array is always the last parameter */
+    char p_format = (i < num_format)? format[i]: format[num_format - 1];
+
+    switch (p_format)
+    {
+    case 's':
+      iLedBinWriterCode(writer, ILEDB_PARAM_STR);
+      iLedBinWriterCode(writer, iLedBinWriterString(writer, (char*)params[i]));
+      break;
+    case 'a':
+      iLedBinWriterCode(writer, ILEDB_PARAM_WORD);
+      iLedBinWriterCode(writer, iLedBinWriterString(writer, (char*)params[i]));
+      break;
+    case 'b':
+    case 'c':
+    case 'i':
+    case 'j':
+      iLedBinWriterCode(writer, ILEDB_PARAM_INT);
+      iLedBinWriterCode(writer, (int)(unsigned long)params[i]);
+      break;
+    case 'f':
+      iLedBinWriterCode(writer, ILEDB_PARAM_FLOAT);
+      iLedBinWriterCode(writer, (int)(unsigned long)params[i]);
+      break;
+    case 'g':
+    case 'h':
+      if (params[i])
+      {
+        iLedBinWriterCode(writer, ILEDB_PARAM_ELEM);
+        iLedBinWriterCode(writer, iLedBinWriterFindSlot(writer, (Ihandle*)params[i]));
+      }
+      else
+      {
+        iLedBinWriterCode(writer, ILEDB_PARAM_NULL);
+        iLedBinWriterCode(writer, 0);
+      }
+      break;
+    default:
+      writer->error = 1;
+      iLedBinWriterCode(writer, ILEDB_PARAM_NULL);
+      iLedBinWriterCode(writer, 0);
+      break;
+    }
+  }
+
+  writer->attr_count_pos = iupArrayCount(writer->code);
+  iLedBinWriterCode(writer, 0);
+
+  iLedBinAddSlot(writer->slots, ih);
+}
+
+static void iLedBinWriterAttrib(void* user_data, const char* name, const char* value)
+{
+  IledbWriter* writer = (IledbWriter*)user_data;
+  int* code;
+
+  iLedBinWriterCode(writer, iLedBinWriterString(writer, name));
+  iLedBinWriterCode(writer, value? iLedBinWriterString(writer, value): ILEDB_NONE);
+
+  code = (int*)iupArrayGetData(writer->code);
+  code[writer->attr_count_pos]++;
+}
+
+void iupLedBinRecordAttribs(IledbWriter* writer, const char* attr)
+{
+  /* must be called right after the element is recorded */
+  if (writer->attr_count_pos < 0)
+  {
+    writer->error = 1;
+    return;
+  }
+
+  iupAttribParseFunc(attr, iLedBinWriterAttrib, writer);
+}
+
+void iupLedBinRecordGet(IledbWriter* writer, Ihandle* ih, const char* name)
+{
+  iLedBinWriterCode(writer, ILEDB_OP_GET);
+  iLedBinWriterCode(writer, iLedBinWriterString(writer, name));
+  iLedBinAddSlot(writer->slots, ih);
+  writer->attr_count_pos = -1;
+}
+
+void iupLedBinRecordName(IledbWriter* writer, Ihandle* ih, const char* name)
+{
+  int slot = iLedBinWriterFindSlot(writer, ih);
+  iLedBinWriterCode(writer, ILEDB_OP_NAME);
+  iLedBinWriterCode(writer, slot);
+  iLedBinWriterCode(writer, iLedBinWriterString(writer, name));
+  writer->attr_count_pos = -1;
+}
+
+static int iLedBinGetSourceInfo(const char* source_filename, unsigned int *source_size, unsigned int *source_time)
+{
+  struct stat st;
+  if (stat(source_filename, &st) != 0)
+    return 0;
+  *source_size = (unsigned int)st.st_size;
+  *source_time = (unsigned int)st.st_mtime;
+  return 1;
+}
+
+int iupLedBinWriterSave(IledbWriter* writer, const char* filename, const char* source_filename)
+{
+  IledbHeader header;
+  FILE* file;
+  int string_size, pad = 0, ret;
+
+  if (writer->error)
+    return 0;
+
+  memset(&header, 0, sizeof(IledbHeader));
+  memcpy(header.magic, ILEDB_MAGIC, sizeof(header.magic));
+  header.byte_order = ILEDB_BYTE_ORDER;
+  header.version = ILEDB_VERSION;
+  if (source_filename && !iLedBinGetSourceInfo(source_filename, &header.source_size, &header.source_time))
+    return 0;
+
+  string_size = iupArrayCount(writer->strings);
+  if (string_size % 4)
+    pad = 4 - string_size % 4;
+
+  header.string_count = (unsigned int)iupArrayCount(writer->offsets);
+  header.string_size = (unsigned int)(string_size + pad);
+  header.code_count = (unsigned int)iupArrayCount(writer->code);
+
+  file = fopen(filename, "wb");
+  if (!file)
+    return 0;
+
+  fwrite(&header, sizeof(IledbHeader), 1, file);
+  fwrite(iupArrayGetData(writer->offsets), sizeof(unsigned int), header.string_count, file);
+  fwrite(iupArrayGetData(writer->strings), 1, string_size, file);
+  if (pad)
+  {
+    char zeros[4] = { 0, 0, 0, 0 };
+    fwrite(zeros, 1, pad, file);
+  }
+  fwrite(iupArrayGetData(writer->code), sizeof(int), header.code_count, file);
+
+  ret = !ferror(file);
+  fclose(file);
+
+  if (!ret)
+    remove(filename);  /* an incomplete file would be rejected anyway */
+  return ret;
+}
+
+
+/**************************************************************************/
+/* Compile cache                                                          */
+/**************************************************************************/
+
+char* iupLedBinGetCacheFilename(const char* filename)
+{
+  /* returns NULL if the cache is disabled */
+  char* dir = IupGetGlobal("LEDCACHEDIR");
+  char *title, *cache_title, *cache_filename;
+  unsigned int hash = 2166136261U;  /* FNV-1a of the file name, files with the same title in different folders */
+  const char* p;
+
+  if (!dir || dir[0] == 0)
+    return NULL;
+
+  for (p = filename; *p; p++)
+  {
+    hash ^= (unsigned char)*p;
+    hash *= 16777619U;
+  }
+
+  title = iupStrFileGetTitle(filename);
+  cache_title = (char*)malloc(strlen(title) + 20);
+  sprintf(cache_title, "%s.%08x.ledb", title, hash);
+
+  cache_filename = iupStrFileMakeFileName(dir, cache_title);
+
+  free(title);
+  free(cache_title);
+  return cache_filename;
+}
+
+int iupLedBinIsCacheValid(const char* cache_filename, const char* source_filename)
+{
+  IledbHeader header;
+  unsigned int source_size, source_time;
+  int ret = 0;
+  FILE* file;
+
+  if (!iLedBinGetSourceInfo(source_filename, &source_size, &source_time))
+    return 0;
+
+  file = fopen(cache_filename, "rb");
+  if (!file)
+    return 0;
+
+  if (fread(&header, sizeof(IledbHeader), 1, file) == 1 &&
+      memcmp(header.magic, ILEDB_MAGIC, sizeof(header.magic)) == 0 &&
+      header.byte_order == ILEDB_BYTE_ORDER &&
+      header.version == ILEDB_VERSION &&
+      header.source_size == source_size &&
+      header.source_time == source_time)
+    ret = 1;
+
+  fclose(file);
+  return ret;
+}
@@ -0,0 +1,61 @@
+/** \file
+ * \brief precompiled LED format (not exported API).
+ * Shared by the library loader and by ledc. Must not depend on other IUP headers.
+ *
+ * See Copyright Notice in "iup.h"
+ */
+
+#ifndef __IUP_LEDBIN_H
+#define __IUP_LEDBIN_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Layout of the file, all values are 32 bits in the native byte order:
+     IledbHeader
+     unsigned int offset[string_count]    offset of each string in the string data
+     char strings[string_size]            NUL terminated strings, padded to 4 bytes
+     int code[code_count]                 instructions
+
+   Instructions are executed in order, elements are created after their children,
+   exactly as the text parser does. Each ELEM and GET instruction defines a new slot,
+   numbered from 0, that can be used as a parameter of the following elements. */
+
+#define ILEDB_MAGIC       "IUPLEDB"   /* 8 bytes, including the terminator */
+#define ILEDB_BYTE_ORDER  0x01020304
+#define ILEDB_VERSION     1
+
+typedef struct _IledbHeader
+{
+  char magic[8];
+  unsigned int byte_order;    /* ILEDB_BYTE_ORDER as written by the compiler */
+  unsigned int version;       /* ILEDB_VERSION */
+  unsigned int source_size;   /* size of the text LED, used only by the compile cache */
+  unsigned int source_time;   /* modification time of the text LED, used only by the compile cache */
+  unsigned int string_count;
+  unsigned int string_size;
+  unsigned int code_count;
+} IledbHeader;
+
+/* instructions */
+#define ILEDB_OP_ELEM   1  /* class, param_count, param_count*(type, value), attr_count, attr_count*(name, value) */
+#define ILEDB_OP_GET    2  /* name: the slot is the element with that name, must be already defined */
+#define ILEDB_OP_NAME   3  /* slot, name: sets the name of the element */
+
+/* parameter types, parameters are converted to the format of the class when loaded */
+#define ILEDB_PARAM_NULL   0  /* empty container, value is ignored */
+#define ILEDB_PARAM_STR    1  /* string index, a quoted string */
+#define ILEDB_PARAM_WORD   2  /* string index, an identifier: a number, an action name or an element name */
+#define ILEDB_PARAM_INT    3  /* integer value */
+#define ILEDB_PARAM_FLOAT  4  /* float value, same bits */
+#define ILEDB_PARAM_ELEM   5  /* slot index */
+
+#define ILEDB_NONE  (-1)  /* string index of NULL attribute values */
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
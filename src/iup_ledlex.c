@@ -24,7 +24,7 @@ static struct          /* lexical variables */
 {
   const char* filename;   /* file name */
   const char* buffer, *p_buffer;
-  FILE* file;             /* file handle */
+  char* file_buffer;      /* file contents, loaded at once */
   int token;              /* lookahead iLexToken */
   char name[40960];       /* lexical identifier value */
   float number;           /* lexical number value */
@@ -32,6 +32,35 @@ static struct          /* lexical variables */
   Iclass *ic;             /* control class when func is CONTROL_ */
 } ilex = { NULL, NULL, NULL, NULL, 0, "", 0, 0, NULL };
 
+static char* iLexLoadFile(const char* filename)
+{
+  /* the whole file is read in one block,
+     so the lexer does not call the C library for each character */
+  size_t size, count;
+  char* buffer;
+  FILE* file = fopen(filename, "r");
+  if (!file)
+    return NULL;
+
+  fseek(file, 0, SEEK_END);
+  size = (size_t)ftell(file);
+  fseek(file, 0, SEEK_SET);
+
+  buffer = (char*)malloc(size + 1);
+  if (!buffer)
+  {
+    fclose(file);
+    return NULL;
+  }
+
+  /* in text mode the number of bytes read can be smaller than the file size */
+  count = fread(buffer, 1, size, file);
+  buffer[count] = 0;
+
+  fclose(file);
+  return buffer;
+}
+
 static int iLexGetChar (void);
 static int iLexToken(int *erro);
 static int iLexCapture (const char* dlm);
@@ -50,10 +79,12 @@ int iupLexStart(const char* filename, const char *buffer)      /* initialize lex
   }
   else
   {
-    ilex.file = fopen(filename, "r");
-    if (!ilex.file)
+    ilex.file_buffer = iLexLoadFile(filename);
+    if (!ilex.file_buffer)
       return iupLexError(IUPLEX_ERR_FILENOTOPENED, filename);
     ilex.filename = filename;
+    ilex.buffer = ilex.file_buffer;
+    ilex.p_buffer = ilex.file_buffer;
   }
   ilex.line = 1;
   return iupLexAdvance();
@@ -66,36 +97,26 @@ const char* iupLexFilename(void)
 
 void iupLexClose(void)
 {
-  if (ilex.file)
-    fclose(ilex.file);
+  if (ilex.file_buffer)
+    free(ilex.file_buffer);
 
   memset(&ilex, 0, sizeof(ilex));
 }
 
 static void iLexUngetc(int c)
 {
-  if (ilex.file)
-    ungetc(c, ilex.file);
-  else
-  {
-    if (c != EOF && ilex.buffer < ilex.p_buffer)
-      ilex.p_buffer--;
-  }
+  if (c != EOF && ilex.buffer < ilex.p_buffer)
+    ilex.p_buffer--;
 }
 
 static int iLexGetc(void)
 {
-  if (ilex.file)
-    return getc(ilex.file);
-  else
-  {
-    int ret;
-    if (*(ilex.p_buffer) == 0)
-      return EOF;
-    ret = (unsigned char)*(ilex.p_buffer);
-    ilex.p_buffer++;
-    return ret;
-  }
+  int ret;
+  if (*(ilex.p_buffer) == 0)
+    return EOF;
+  ret = (unsigned char)*(ilex.p_buffer);
+  ilex.p_buffer++;
+  return ret;
 }
 
 int iupLexLookAhead(void)
@@ -370,7 +391,7 @@ int iupLexError (int n, ...)
   }
   va_end(va);
 
-  if (ilex.file || ilex.filename)
+  if (ilex.filename)
     sprintf(ilex_erromsg, "led(%s):\n  -bad input at line %d\n  -%s\n", ilex.filename, ilex.line, msg);
   else
   {
@@ -50,6 +50,21 @@ int     iupLexGetLine    (void);
 
 IUP_SDK_API const char* iupLoadLed(const char *filename, const char *buffer, int save_info);
 
+/* precompiled LED, see iup_ledbin.h */
+int         iupLedBinIsBinary(const char* filename);
+const char* iupLedBinLoad(const char* filename);
+char*       iupLedBinGetCacheFilename(const char* filename);
+int         iupLedBinIsCacheValid(const char* cache_filename, const char* source_filename);
+
+typedef struct _IledbWriter IledbWriter;
+IledbWriter* iupLedBinWriterCreate(void);
+void         iupLedBinWriterDestroy(IledbWriter* writer);
+void         iupLedBinRecordElem(IledbWriter* writer, Ihandle* ih, Iclass* ic, void** params, int count);
+void         iupLedBinRecordAttribs(IledbWriter* writer, const char* attr);
+void         iupLedBinRecordGet(IledbWriter* writer, Ihandle* ih, const char* name);
+void         iupLedBinRecordName(IledbWriter* writer, Ihandle* ih, const char* name);
+int          iupLedBinWriterSave(IledbWriter* writer, const char* filename, const char* source_filename);
+
 
 #ifdef __cplusplus
 }
@@ -28,6 +28,7 @@ static int iParseError (int err, char *s);
 
 static int iparse_error = 0;
 static int iparse_saveinfo = 0;
+static IledbWriter* iparse_writer = NULL;  /* records the loaded elements for the compile cache */
 #define IPARSE_RETURN_IF_ERROR(_e)        {iparse_error=(_e); if (iparse_error) return NULL;}
 #define IPARSE_RETURN_IF_ERROR_FREE(_e, _x)   {iparse_error=(_e); if (iparse_error) { if (_x) free(_x); return NULL;} }
 
@@ -60,11 +61,39 @@ IUP_SDK_API const char* iupLoadLed(const char *filename, const char *buffer, int
 
 IUP_API char* IupLoad(const char *filename)
 {
+  const char* error;
+  char* cache_filename;
+
   iupASSERT(filename != NULL);
   if (!filename)
     return "invalid file name";
 
-  return (char*)iupLoadLed(filename, NULL, 0);  /* no save info */
+  /* precompiled with "ledc -b" */
+  if (iupLedBinIsBinary(filename))
+    return (char*)iupLedBinLoad(filename);
+
+  cache_filename = iupLedBinGetCacheFilename(filename);
+  if (!cache_filename)
+    return (char*)iupLoadLed(filename, NULL, 0);  /* no save info */
+
+  /* compiled in the first load, then loaded without parsing while the text is not changed */
+  if (iupLedBinIsCacheValid(cache_filename, filename))
+  {
+    error = iupLedBinLoad(cache_filename);
+    free(cache_filename);
+    return (char*)error;
+  }
+
+  iparse_writer = iupLedBinWriterCreate();
+
+  error = iupLoadLed(filename, NULL, 0);  /* no save info */
+  if (!error)
+    iupLedBinWriterSave(iparse_writer, cache_filename, filename);
+
+  iupLedBinWriterDestroy(iparse_writer);
+  iparse_writer = NULL;
+  free(cache_filename);
+  return (char*)error;
 }
 
 IUP_API char* IupLoadBuffer(const char *buffer)
@@ -121,6 +150,9 @@ static void* iParseExp(void)
 
       IupSetHandle(nm, ih);
 
+      if (iparse_writer)
+        iupLedBinRecordName(iparse_writer, ih, nm);
+
       if (iparse_saveinfo && nm)
       {
         int line = iupLexGetLine();
@@ -144,6 +176,8 @@ static void* iParseExp(void)
         iupAttribSetStr(ih, "_IUPLED_NOTDEF_NAME", nm);
       }
     }
+    else if (iparse_writer)
+      iupLedBinRecordGet(iparse_writer, ih, nm);
   }
 
   if (nm) free(nm);
@@ -216,7 +250,12 @@ static Ihandle* iParseControl(Iclass *ic)
 {
   const char *format = ic->format;
   if (!format || format[0] == 0)
-    return iupObjectCreate(ic, NULL); 
+  {
+    Ihandle* new_control = iupObjectCreate(ic, NULL);
+    if (iparse_writer)
+      iupLedBinRecordElem(iparse_writer, new_control, ic, NULL, 0);
+    return new_control;
+  }
   else
   { 
     Ihandle *new_control;
@@ -279,6 +318,9 @@ static Ihandle* iParseControl(Iclass *ic)
     params[i] = NULL;
     new_control = iupObjectCreate(ic, params);
 
+    if (iparse_writer)
+      iupLedBinRecordElem(iparse_writer, new_control, ic, params, i);
+
     if (iparse_saveinfo)
     {
       for (i = 0; i < num_format; i++)
@@ -334,6 +376,9 @@ static Ihandle* iParseFunction(Iclass *ic)
 
   if (attr)
   {
+    if (iparse_writer)
+      iupLedBinRecordAttribs(iparse_writer, attr);
+
     iupAttribParse(ih, attr, iparse_saveinfo);
     free(attr);
     attr = NULL;
@@ -191,15 +191,25 @@ int iupListGetPosAttrib(Ihandle* ih, int pos)
 
 void iupListSetInitialItems(Ihandle* ih)
 {
-  char *value;
-  int i = 1;
-  while ((value = iupAttribGetId(ih, "", i))!=NULL)
-  {
-    iupdrvListAppendItem(ih, value);
-    iupAttribSetId(ih, "", i, NULL);
+  const char** values;
+  int i, count = 0;
 
-    i++;
-  }
+  while (iupAttribGetId(ih, "", count+1))
+    count++;
+
+  if (count == 0)
+    return;
+
+  /* add all items at once, the strings are still stored in the attributes */
+  values = (const char**)malloc(count * sizeof(char*));
+  for (i = 0; i < count; i++)
+    values[i] = iupAttribGetId(ih, "", i+1);
+
+  iupdrvListAppendItems(ih, values, count);
+  free(values);
+
+  for (i = 1; i <= count; i++)
+    iupAttribSetId(ih, "", i, NULL);
 }
 
 char* iupListGetSpacingAttrib(Ihandle* ih)
@@ -274,6 +284,54 @@ static int iListSetAppendItemAttrib(Ihandle* ih, const char* value)
   return 0;
 }
 
+static void iListAppendItems(Ihandle* ih, const char* value)
+{
+  int len, i, count = iupStrLineCount(value, (int)strlen(value));
+  char* buffer = iupStrDup(value);
+  const char** values = (const char**)malloc(count * sizeof(char*));
+  char* line = buffer;
+
+  for (i = 0; i < count; i++)
+  {
+    char* next = (char*)iupStrNextLine(line, &len);
+    line[len] = 0;
+    values[i] = line;
+    line = next;
+  }
+
+  /* ignore the empty line after the last line end */
+  if (count > 0 && values[count-1][0] == 0)
+    count--;
+
+  if (count > 0)
+    iupdrvListAppendItems(ih, values, count);
+
+  free(values);
+  free(buffer);
+}
+
+static int iListSetAppendItemsAttrib(Ihandle* ih, const char* value)
+{
+  if (!ih->handle)  /* do not do the action before map, and ignore the call */
+    return 0;
+  if (value)
+    iListAppendItems(ih, value);
+  return 0;
+}
+
+static int iListSetSetItemsAttrib(Ihandle* ih, const char* value)
+{
+  if (!ih->handle)  /* do not do the action before map, and ignore the call */
+    return 0;
+
+  iupdrvListRemoveAllItems(ih);
+  iupAttribSet(ih, "_IUPLIST_OLDVALUE", NULL);
+
+  if (value)
+    iListAppendItems(ih, value);
+  return 0;
+}
+
 static int iListSetInsertItemAttrib(Ihandle* ih, int id, const char* value)
 {
   if (!ih->handle)  /* do not do the action before map, and ignore the call */
@@ -1110,6 +1168,8 @@ Iclass* iupListNewClass(void)
 
   iupClassRegisterAttributeId(ic, "INSERTITEM", NULL, iListSetInsertItemAttrib, IUPAF_WRITEONLY | IUPAF_NOT_MAPPED | IUPAF_NO_INHERIT);
   iupClassRegisterAttribute(ic, "APPENDITEM", NULL, iListSetAppendItemAttrib, NULL, NULL, IUPAF_WRITEONLY | IUPAF_NOT_MAPPED | IUPAF_NO_INHERIT);
+  iupClassRegisterAttribute(ic, "APPENDITEMS", NULL, iListSetAppendItemsAttrib, NULL, NULL, IUPAF_WRITEONLY | IUPAF_NOT_MAPPED | IUPAF_NO_INHERIT);
+  iupClassRegisterAttribute(ic, "SETITEMS", NULL, iListSetSetItemsAttrib, NULL, NULL, IUPAF_WRITEONLY | IUPAF_NOT_MAPPED | IUPAF_NO_INHERIT);
   iupClassRegisterAttribute(ic, "REMOVEITEM", NULL, iListSetRemoveItemAttrib, NULL, NULL, IUPAF_WRITEONLY | IUPAF_NOT_MAPPED | IUPAF_NO_INHERIT);
 
   iupClassRegisterAttribute(ic, "VALUEMASKED", NULL, iListSetValueMaskedAttrib, NULL, NULL, IUPAF_WRITEONLY | IUPAF_NO_INHERIT);
@@ -17,6 +17,7 @@ void iupdrvListAddBorders(Ihandle* ih, int *w, int *h);
 void iupdrvListAddItemSpace(Ihandle* ih, int *h);
 int iupdrvListGetCount(Ihandle* ih);
 void iupdrvListAppendItem(Ihandle* ih, const char* value);
+void iupdrvListAppendItems(Ihandle* ih, const char** values, int count);  /* same as calling iupdrvListAppendItem for each value */
 void iupdrvListInsertItem(Ihandle* ih, int pos, const char* value);
 void iupdrvListRemoveItem(Ihandle* ih, int pos);
 void iupdrvListRemoveAllItems(Ihandle* ih);
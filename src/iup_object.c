@@ -39,6 +39,7 @@ static Ihandle* iHandleCreate(void)
 static void iHandleDestroy(Ihandle* ih)
 {
   iupTableDestroy(ih->attrib);
+  iupAttribInheritCacheRelease(ih);
   memset(ih, 0, sizeof(Ihandle));
   free(ih);
 }
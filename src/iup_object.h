@@ -96,6 +96,7 @@ typedef struct _InativeHandle InativeHandle;
 /** Each control may define its own structure in its private module.
  * \ingroup object */
 typedef struct _IcontrolData IcontrolData;
+typedef struct _IattribInheritCache IattribInheritCache;
 /** IcontrolData allocation utility.
  * \ingroup object */
 #define iupALLOCCTRLDATA() ((IcontrolData*)calloc(1, sizeof(IcontrolData)))
@@ -130,6 +131,7 @@ struct Ihandle_
   Ihandle* firstchild;   /**< first child control in the hierarchy tree */
   Ihandle* brother;      /**< next control inside parent */
   IcontrolData* data;    /**< private control data. automatically freed if not NULL in destroy */
+  IattribInheritCache* inherit_cache; /**< cache of the inherited attributes found in the parents, see iup_attrib.c */
 };
 
 
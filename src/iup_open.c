@@ -24,6 +24,7 @@
 #include "iup_dlglist.h"
 #include "iup_assert.h"
 #include "iup_strmessage.h"
+#include "iup_thread.h"
 
 
 static int iup_opened = 0;
@@ -46,6 +47,7 @@ IUP_API int IupOpen(int *argc, char ***argv)
     argv = &iup_dummy_argv;
   }
 
+  iupThreadInit();
   iupNamesInit();
   iupFuncInit();
   iupStrMessageInit();
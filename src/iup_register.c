@@ -15,18 +15,45 @@
 #include "iup_object.h"
 #include "iup_register.h"
 #include "iup_stdcontrols.h"
+#include "iup_str.h"
+#include "iup_timer.h"
 
 
 static Itable *iregister_table = NULL;   /* table indexed by name containing Iclass* address */
+static Itable *ipending_table = NULL;    /* table indexed by name containing the function that creates the class, 
+                                            the class is created only when first used */
+static Itable *itime_table = NULL;       /* table indexed by name containing the class creation time */
+static double itime_nested = 0;          /* time spent creating the parent classes of the class being created */
+
+typedef struct _IregisterPending {
+  iupRegisterNewClassFunc new_class;
+  int is_internal;
+} IregisterPending;
 
 void iupRegisterInit(void)
 {
   iregister_table = iupTableCreate(IUPTABLE_STRINGINDEXED);
+  ipending_table = iupTableCreate(IUPTABLE_STRINGINDEXED);
+  itime_table = iupTableCreate(IUPTABLE_STRINGINDEXED);
 }
 
 void iupRegisterFinish(void)
 {
-  char* name = iupTableFirst(iregister_table);
+  char* name = iupTableFirst(ipending_table);
+  while (name)
+  {
+    IregisterPending* pending = (IregisterPending*)iupTableGetCurr(ipending_table);
+    free(pending);
+    name = iupTableNext(ipending_table);
+  }
+
+  iupTableDestroy(ipending_table);
+  ipending_table = NULL;
+
+  iupTableDestroy(itime_table);
+  itime_table = NULL;
+
+  name = iupTableFirst(iregister_table);
   while (name)
   {
     Iclass* ic = (Iclass*)iupTableGetCurr(iregister_table);
@@ -38,11 +65,61 @@ void iupRegisterFinish(void)
   iregister_table = NULL;
 }
 
+static Iclass* iRegisterCreatePending(const char* name)
+{
+  IregisterPending* pending = (IregisterPending*)iupTableGet(ipending_table, name);
+  if (pending)
+  {
+    Iclass* ic;
+    double start, elapsed, nested;
+    double outer_nested = itime_nested;
+
+    iupTableRemove(ipending_table, name);
+
+    /* creating a class also creates its pending parent, 
+       which is timed in its own entry, so do not count it here */
+    itime_nested = 0;
+    start = iupTimerGetWallTime();
+    ic = pending->new_class();
+    elapsed = iupTimerGetWallTime() - start;
+    nested = itime_nested;
+    itime_nested = outer_nested + elapsed;
+
+    if (!ic)
+    {
+      free(pending);
+      return NULL;
+    }
+
+    iupTableSet(itime_table, ic->name, (void*)iupStrReturnStrf("%.3f", elapsed - nested), IUPTABLE_STRING);
+
+    ic->is_internal = pending->is_internal;
+    free(pending);
+
+    iupTableSet(iregister_table, ic->name, (void*)ic, IUPTABLE_POINTER);
+    return ic;
+  }
+
+  return NULL;
+}
+
+static void iRegisterCreateAllPending(void)
+{
+  char* name = iupTableFirst(ipending_table);
+  while (name)
+  {
+    iRegisterCreatePending(name);  /* will remove the current entry, so restart the iteration */
+    name = iupTableFirst(ipending_table);
+  }
+}
+
 IUP_API int IupGetAllClasses(char** list, int n)
 {
   int i = 0;
   char* name;
 
+  iRegisterCreateAllPending();
+
   if (!list || n==0 || n==-1)
     return iupTableCount(iregister_table);
 
@@ -62,18 +139,44 @@ IUP_API int IupGetAllClasses(char** list, int n)
 
 IUP_SDK_API Iclass* iupRegisterFindClass(const char* name)
 {
-  return (Iclass*)iupTableGet(iregister_table, name);
+  Iclass* ic = (Iclass*)iupTableGet(iregister_table, name);
+  if (!ic && name)
+    ic = iRegisterCreatePending(name);
+  return ic;
 }
 
-static void iupRegisterClassInternal(Iclass* ic)
+static void iRegisterRemovePending(const char* name)
 {
-  Iclass* old_ic = (Iclass*)iupTableGet(iregister_table, ic->name);
+  IregisterPending* pending = (IregisterPending*)iupTableGet(ipending_table, name);
+  if (pending)
+  {
+    iupTableRemove(ipending_table, name);
+    free(pending);
+  }
+}
+
+static void iRegisterClassLazy(const char* name, iupRegisterNewClassFunc new_class, int is_internal)
+{
+  IregisterPending* pending;
+
+  Iclass* old_ic = (Iclass*)iupTableGet(iregister_table, name);
   if (old_ic)
+  {
+    iupTableRemove(iregister_table, name);
     iupClassRelease(old_ic);
+  }
 
-  ic->is_internal = 1;
+  iRegisterRemovePending(name);
 
-  iupTableSet(iregister_table, ic->name, (void*)ic, IUPTABLE_POINTER);
+  pending = (IregisterPending*)malloc(sizeof(IregisterPending));
+  pending->new_class = new_class;
+  pending->is_internal = is_internal;
+  iupTableSet(ipending_table, name, (void*)pending, IUPTABLE_POINTER);
+}
+
+IUP_SDK_API void iupRegisterClassLazy(const char* name, iupRegisterNewClassFunc new_class)
+{
+  iRegisterClassLazy(name, new_class, 0);
 }
 
 IUP_SDK_API void iupRegisterClass(Iclass* ic)
@@ -82,9 +185,37 @@ IUP_SDK_API void iupRegisterClass(Iclass* ic)
   if (old_ic)
     iupClassRelease(old_ic);
 
+  iRegisterRemovePending(ic->name);
+
   iupTableSet(iregister_table, ic->name, (void*)ic, IUPTABLE_POINTER);
 }
 
+char* iupRegisterGetClassTimeGlobalAttrib(void)
+{
+  /* list of the classes already created, one per line as "name=milliseconds" */
+  char *name, *str, *p;
+  int size = 1;
+
+  name = iupTableFirst(itime_table);
+  while (name)
+  {
+    size += (int)strlen(name) + (int)strlen((char*)iupTableGetCurr(itime_table)) + 2;
+    name = iupTableNext(itime_table);
+  }
+
+  str = iupStrGetMemory(size);
+  p = str;
+
+  name = iupTableFirst(itime_table);
+  while (name)
+  {
+    p += sprintf(p, "%s=%s\n", name, (char*)iupTableGetCurr(itime_table));
+    name = iupTableNext(itime_table);
+  }
+
+  return str;
+}
+
 void iupRegisterUpdateClasses(void)
 {
   char* name = iupTableFirst(iregister_table);
@@ -101,77 +232,77 @@ void iupRegisterUpdateClasses(void)
 
 void iupRegisterInternalClasses(void)
 {
-  iupRegisterClassInternal(iupDialogNewClass());
-  iupRegisterClassInternal(iupMessageDlgNewClass());
-  iupRegisterClassInternal(iupColorDlgNewClass());
-  iupRegisterClassInternal(iupFontDlgNewClass());
-  iupRegisterClassInternal(iupFileDlgNewClass());
-  iupRegisterClassInternal(iupProgressDlgNewClass());
-  iupRegisterClassInternal(iupParamBoxNewClass());
-  iupRegisterClassInternal(iupParamNewClass());
-
-  iupRegisterClassInternal(iupTimerNewClass());
-  iupRegisterClassInternal(iupImageNewClass());
-  iupRegisterClassInternal(iupImageRGBNewClass());
-  iupRegisterClassInternal(iupImageRGBANewClass());
-  iupRegisterClassInternal(iupUserNewClass());
-  iupRegisterClassInternal(iupClipboardNewClass());
-  iupRegisterClassInternal(iupThreadNewClass());
-
-  iupRegisterClassInternal(iupRadioNewClass());
-  iupRegisterClassInternal(iupFillNewClass());
-  iupRegisterClassInternal(iupHboxNewClass());
-  iupRegisterClassInternal(iupVboxNewClass());
-  iupRegisterClassInternal(iupZboxNewClass());
-  iupRegisterClassInternal(iupCboxNewClass());
-  iupRegisterClassInternal(iupSboxNewClass());
-  iupRegisterClassInternal(iupNormalizerNewClass());
-  iupRegisterClassInternal(iupSplitNewClass());
-  iupRegisterClassInternal(iupExpanderNewClass());
-  iupRegisterClassInternal(iupDetachBoxNewClass());
-
-  iupRegisterClassInternal(iupMenuNewClass());
-  iupRegisterClassInternal(iupItemNewClass());
-  iupRegisterClassInternal(iupSeparatorNewClass());
-  iupRegisterClassInternal(iupSubmenuNewClass());
-
-  iupRegisterClassInternal(iupLabelNewClass());
-  iupRegisterClassInternal(iupButtonNewClass());
-  iupRegisterClassInternal(iupToggleNewClass());
-  iupRegisterClassInternal(iupCanvasNewClass());
-  iupRegisterClassInternal(iupFrameNewClass());
-  iupRegisterClassInternal(iupTextNewClass());
-  iupRegisterClassInternal(iupMultilineNewClass());
-  iupRegisterClassInternal(iupListNewClass());
-  iupRegisterClassInternal(iupFlatLabelNewClass());
-  iupRegisterClassInternal(iupFlatButtonNewClass());
-  iupRegisterClassInternal(iupFlatToggleNewClass());
-  iupRegisterClassInternal(iupFlatSeparatorNewClass());
-  iupRegisterClassInternal(iupDropButtonNewClass());
-  iupRegisterClassInternal(iupCalendarNewClass());
-  iupRegisterClassInternal(iupDatePickNewClass());
-  iupRegisterClassInternal(iupSpaceNewClass());
-
-  iupRegisterClassInternal(iupProgressBarNewClass());
-  iupRegisterClassInternal(iupValNewClass());
-  iupRegisterClassInternal(iupTabsNewClass());
-  iupRegisterClassInternal(iupSpinNewClass());
-  iupRegisterClassInternal(iupSpinboxNewClass());
-  iupRegisterClassInternal(iupTreeNewClass());
-  iupRegisterClassInternal(iupScrollBoxNewClass());
-  iupRegisterClassInternal(iupBackgroundBoxNewClass());
-  iupRegisterClassInternal(iupLinkNewClass());
-  iupRegisterClassInternal(iupGridBoxNewClass());
-  iupRegisterClassInternal(iupAnimatedLabelNewClass());
-  iupRegisterClassInternal(iupFlatFrameNewClass());
-  iupRegisterClassInternal(iupFlatTabsNewClass());
-  iupRegisterClassInternal(iupFlatScrollBoxNewClass());
-  iupRegisterClassInternal(iupDialNewClass());
-  iupRegisterClassInternal(iupGaugeNewClass());
-  iupRegisterClassInternal(iupColorbarNewClass());
-  iupRegisterClassInternal(iupColorBrowserNewClass());
-  iupRegisterClassInternal(iupMultiBoxNewClass());
-  iupRegisterClassInternal(iupFlatListNewClass());
-  iupRegisterClassInternal(iupFlatValNewClass());
-  iupRegisterClassInternal(iupFlatTreeNewClass());
+  iRegisterClassLazy("dialog", iupDialogNewClass, 1);
+  iRegisterClassLazy("messagedlg", iupMessageDlgNewClass, 1);
+  iRegisterClassLazy("colordlg", iupColorDlgNewClass, 1);
+  iRegisterClassLazy("fontdlg", iupFontDlgNewClass, 1);
+  iRegisterClassLazy("filedlg", iupFileDlgNewClass, 1);
+  iRegisterClassLazy("progressdlg", iupProgressDlgNewClass, 1);
+  iRegisterClassLazy("parambox", iupParamBoxNewClass, 1);
+  iRegisterClassLazy("param", iupParamNewClass, 1);
+
+  iRegisterClassLazy("timer", iupTimerNewClass, 1);
+  iRegisterClassLazy("image", iupImageNewClass, 1);
+  iRegisterClassLazy("imagergb", iupImageRGBNewClass, 1);
+  iRegisterClassLazy("imagergba", iupImageRGBANewClass, 1);
+  iRegisterClassLazy("user", iupUserNewClass, 1);
+  iRegisterClassLazy("clipboard", iupClipboardNewClass, 1);
+  iRegisterClassLazy("thread", iupThreadNewClass, 1);
+
+  iRegisterClassLazy("radio", iupRadioNewClass, 1);
+  iRegisterClassLazy("fill", iupFillNewClass, 1);
+  iRegisterClassLazy("hbox", iupHboxNewClass, 1);
+  iRegisterClassLazy("vbox", iupVboxNewClass, 1);
+  iRegisterClassLazy("zbox", iupZboxNewClass, 1);
+  iRegisterClassLazy("cbox", iupCboxNewClass, 1);
+  iRegisterClassLazy("sbox", iupSboxNewClass, 1);
+  iRegisterClassLazy("normalizer", iupNormalizerNewClass, 1);
+  iRegisterClassLazy("split", iupSplitNewClass, 1);
+  iRegisterClassLazy("expander", iupExpanderNewClass, 1);
+  iRegisterClassLazy("detachbox", iupDetachBoxNewClass, 1);
+
+  iRegisterClassLazy("menu", iupMenuNewClass, 1);
+  iRegisterClassLazy("item", iupItemNewClass, 1);
+  iRegisterClassLazy("separator", iupSeparatorNewClass, 1);
+  iRegisterClassLazy("submenu", iupSubmenuNewClass, 1);
+
+  iRegisterClassLazy("label", iupLabelNewClass, 1);
+  iRegisterClassLazy("button", iupButtonNewClass, 1);
+  iRegisterClassLazy("toggle", iupToggleNewClass, 1);
+  iRegisterClassLazy("canvas", iupCanvasNewClass, 1);
+  iRegisterClassLazy("frame", iupFrameNewClass, 1);
+  iRegisterClassLazy("text", iupTextNewClass, 1);
+  iRegisterClassLazy("multiline", iupMultilineNewClass, 1);
+  iRegisterClassLazy("list", iupListNewClass, 1);
+  iRegisterClassLazy("flatlabel", iupFlatLabelNewClass, 1);
+  iRegisterClassLazy("flatbutton", iupFlatButtonNewClass, 1);
+  iRegisterClassLazy("flattoggle", iupFlatToggleNewClass, 1);
+  iRegisterClassLazy("flatseparator", iupFlatSeparatorNewClass, 1);
+  iRegisterClassLazy("dropbutton", iupDropButtonNewClass, 1);
+  iRegisterClassLazy("calendar", iupCalendarNewClass, 1);
+  iRegisterClassLazy("datepick", iupDatePickNewClass, 1);
+  iRegisterClassLazy("space", iupSpaceNewClass, 1);
+
+  iRegisterClassLazy("progressbar", iupProgressBarNewClass, 1);
+  iRegisterClassLazy("val", iupValNewClass, 1);
+  iRegisterClassLazy("tabs", iupTabsNewClass, 1);
+  iRegisterClassLazy("spin", iupSpinNewClass, 1);
+  iRegisterClassLazy("spinbox", iupSpinboxNewClass, 1);
+  iRegisterClassLazy("tree", iupTreeNewClass, 1);
+  iRegisterClassLazy("scrollbox", iupScrollBoxNewClass, 1);
+  iRegisterClassLazy("backgroundbox", iupBackgroundBoxNewClass, 1);
+  iRegisterClassLazy("link", iupLinkNewClass, 1);
+  iRegisterClassLazy("gridbox", iupGridBoxNewClass, 1);
+  iRegisterClassLazy("animatedlabel", iupAnimatedLabelNewClass, 1);
+  iRegisterClassLazy("flatframe", iupFlatFrameNewClass, 1);
+  iRegisterClassLazy("flattabs", iupFlatTabsNewClass, 1);
+  iRegisterClassLazy("flatscrollbox", iupFlatScrollBoxNewClass, 1);
+  iRegisterClassLazy("dial", iupDialNewClass, 1);
+  iRegisterClassLazy("gauge", iupGaugeNewClass, 1);
+  iRegisterClassLazy("colorbar", iupColorbarNewClass, 1);
+  iRegisterClassLazy("colorbrowser", iupColorBrowserNewClass, 1);
+  iRegisterClassLazy("multibox", iupMultiBoxNewClass, 1);
+  iRegisterClassLazy("flatlist", iupFlatListNewClass, 1);
+  iRegisterClassLazy("flatval", iupFlatValNewClass, 1);
+  iRegisterClassLazy("flattree", iupFlatTreeNewClass, 1);
 }
@@ -27,6 +27,15 @@ IUP_SDK_API Iclass* iupRegisterFindClass(const char* name);
 /** Register a class.
  * \ingroup register */
 IUP_SDK_API void iupRegisterClass(Iclass* ic);
+
+/** Function that creates a new class. Used in \ref iupRegisterClassLazy.
+ * \ingroup register */
+typedef Iclass* (*iupRegisterNewClassFunc)(void);
+
+/** Register a class by name, but the class is created only when first used
+ * by \ref iupRegisterFindClass. The given name must be the same name of the created class.
+ * \ingroup register */
+IUP_SDK_API void iupRegisterClassLazy(const char* name, iupRegisterNewClassFunc new_class);
                                      
                                      
 /* Register the internal classes. Called only from IupOpen. */
@@ -40,6 +49,9 @@ void iupRegisterUpdateClasses(void);
 void iupRegisterInit(void);
 void iupRegisterFinish(void);
 
+/* Returns the creation time of the classes already created. Used by the CLASSREGISTERTIME global attribute. */
+char* iupRegisterGetClassTimeGlobalAttrib(void);
+
 
 #ifdef __cplusplus
 }
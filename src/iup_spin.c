@@ -167,6 +167,8 @@ static int iSpinCreateMethod(Ihandle* ih, void** params)
   bt_up->parent = ih;
   bt_up->brother = bt_down;
   bt_down->parent = ih;
+  iupAttribInheritCacheInvalidate(bt_up);
+  iupAttribInheritCacheInvalidate(bt_down);
   
   /* avoid inheritance from parent */
   IupSetAttribute(ih, "GAP",    "0");
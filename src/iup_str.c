@@ -16,6 +16,12 @@
 #include <locale.h>
 #include <ctype.h>
 
+#ifdef WIN32
+#include <windows.h>
+#else
+#include <pthread.h>
+#endif
+
 #include "iup_export.h"
 #include "iup_str.h"
 
@@ -329,137 +335,229 @@ static char *iStrDupUntilNoCase(char **str, char sep)
   }
 }
 
-IUP_SDK_API char *iupStrGetLargeMem(int *size)
-{
+/* The return buffers are kept per thread, so attributes can be
+   retrieved from secondary threads without corrupting the main thread results.
+   They are stored in a thread local storage key whose destructor frees them
+   when the thread exits, for any thread, not only IupThread. */
+
 #define LARGE_MAX_BUFFERS 10
 #define LARGE_SIZE SHRT_MAX
-  static char buffers[LARGE_MAX_BUFFERS][LARGE_SIZE];
-  static int buffers_index = -1;
-  char* ret_str;
+#define SMALL_MAX_BUFFERS 100
+#define SMALL_SIZE 80  /* maximum for iupStrReturnFloat and iupStrReturnDouble */
+#define MAX_BUFFERS 50
 
-  /* init buffers array */
-  if (buffers_index == -1)
+typedef struct _IstrBuffers {
+  char* large_buffers[LARGE_MAX_BUFFERS];  /* allocated on demand */
+  int large_index;
+
+  char small_buffers[SMALL_MAX_BUFFERS][SMALL_SIZE];
+  int small_index;
+
+  char* buffers[MAX_BUFFERS];
+  int buffers_sizes[MAX_BUFFERS];
+  int buffers_index;
+} IstrBuffers;
+
+static void iStrDestroyBuffers(IstrBuffers* str_buffers)
+{
+  int i;
+
+  for (i = 0; i < MAX_BUFFERS; i++)
   {
-    int i;
-    /* clear all memory */
-    for (i=0; i<LARGE_MAX_BUFFERS; i++)
-      memset(buffers[i], 0, sizeof(char)*LARGE_SIZE);
+    if (str_buffers->buffers[i])
+      free(str_buffers->buffers[i]);
+  }
+
+  for (i = 0; i < LARGE_MAX_BUFFERS; i++)
+  {
+    if (str_buffers->large_buffers[i])
+      free(str_buffers->large_buffers[i]);
+  }
+
+  free(str_buffers);
+}
+
+#ifdef WIN32
+static DWORD istr_buffers_key = FLS_OUT_OF_INDEXES;
+static INIT_ONCE istr_buffers_once = INIT_ONCE_STATIC_INIT;
+
+static void WINAPI iStrBuffersDestructor(void* data)
+{
+  if (data)
+    iStrDestroyBuffers((IstrBuffers*)data);
+}
+
+static BOOL CALLBACK iStrBuffersKeyCreate(PINIT_ONCE once, void* param, void** context)
+{
+  istr_buffers_key = FlsAlloc(iStrBuffersDestructor);
+  (void)once;
+  (void)param;
+  (void)context;
+  return TRUE;
+}
+
+#define iStrBuffersKeyInit() InitOnceExecuteOnce(&istr_buffers_once, iStrBuffersKeyCreate, NULL, NULL)
+#define iStrBuffersKeyGet() ((IstrBuffers*)FlsGetValue(istr_buffers_key))
+#define iStrBuffersKeySet(_str_buffers) FlsSetValue(istr_buffers_key, _str_buffers)
+#else
+static pthread_key_t istr_buffers_key;
+static pthread_once_t istr_buffers_once = PTHREAD_ONCE_INIT;
+
+static void iStrBuffersDestructor(void* data)
+{
+  iStrDestroyBuffers((IstrBuffers*)data);  /* called only for non NULL values */
+}
+
+static void iStrBuffersKeyCreate(void)
+{
+  pthread_key_create(&istr_buffers_key, iStrBuffersDestructor);
+}
+
+#define iStrBuffersKeyInit() pthread_once(&istr_buffers_once, iStrBuffersKeyCreate)
+#define iStrBuffersKeyGet() ((IstrBuffers*)pthread_getspecific(istr_buffers_key))
+#define iStrBuffersKeySet(_str_buffers) pthread_setspecific(istr_buffers_key, _str_buffers)
+#endif
+
+static IstrBuffers* iStrGetBuffers(void)
+{
+  IstrBuffers* str_buffers;
+
+  iStrBuffersKeyInit();
+
+  str_buffers = iStrBuffersKeyGet();
+  if (!str_buffers)
+  {
+    str_buffers = (IstrBuffers*)calloc(1, sizeof(IstrBuffers));
+    iStrBuffersKeySet(str_buffers);
+  }
+  return str_buffers;
+}
+
+static void iStrFreeBuffers(void)
+{
+  IstrBuffers* str_buffers;
 
-    buffers_index = 0;
+  iStrBuffersKeyInit();
+
+  str_buffers = iStrBuffersKeyGet();
+  if (str_buffers)
+  {
+    iStrBuffersKeySet(NULL);
+    iStrDestroyBuffers(str_buffers);
   }
+}
+
+IUP_SDK_API char *iupStrGetLargeMem(int *size)
+{
+  IstrBuffers* str_buffers = iStrGetBuffers();
+  char* ret_str;
+
+  if (!str_buffers->large_buffers[str_buffers->large_index])
+    str_buffers->large_buffers[str_buffers->large_index] = (char*)malloc(LARGE_SIZE);
 
   /* DON'T clear memory everytime because the buffer is too large */
-  ret_str = buffers[buffers_index];
+  ret_str = str_buffers->large_buffers[str_buffers->large_index];
   ret_str[0] = 0;
 
-  buffers_index++;
-  if (buffers_index == LARGE_MAX_BUFFERS)
-    buffers_index = 0;
+  str_buffers->large_index++;
+  if (str_buffers->large_index == LARGE_MAX_BUFFERS)
+    str_buffers->large_index = 0;
 
   if (size) *size = LARGE_SIZE;
   return ret_str;
-#undef LARGE_MAX_BUFFERS
-#undef LARGE_SIZE 
 }
 
 static char* iupStrGetSmallMem(void)
 {
-#define SMALL_MAX_BUFFERS 100
-#define SMALL_SIZE 80  /* maximum for iupStrReturnFloat and iupStrReturnDouble */
-  static char buffers[SMALL_MAX_BUFFERS][SMALL_SIZE];
-  static int buffers_index = -1;
+  IstrBuffers* str_buffers = iStrGetBuffers();
   char* ret_str;
 
-  /* init buffers array */
-  if (buffers_index == -1)
-  {
-    int i;
-    /* clear all memory */
-    for (i = 0; i<SMALL_MAX_BUFFERS; i++)
-      memset(buffers[i], 0, sizeof(char)*SMALL_SIZE);
-    
-    buffers_index = 0;
-  }
-
   /* always clear memory before returning a new buffer */
-  memset(buffers[buffers_index], 0, SMALL_SIZE);
-  ret_str = buffers[buffers_index];
+  ret_str = str_buffers->small_buffers[str_buffers->small_index];
+  memset(ret_str, 0, SMALL_SIZE);
 
-  buffers_index++;
-  if (buffers_index == SMALL_MAX_BUFFERS)
-    buffers_index = 0;
+  str_buffers->small_index++;
+  if (str_buffers->small_index == SMALL_MAX_BUFFERS)
+    str_buffers->small_index = 0;
 
   return ret_str;
-#undef SMALL_MAX_BUFFERS
-#undef SMALL_SIZE 
 }
 
 IUP_SDK_API char *iupStrGetMemory(int size)
 {
-#define MAX_BUFFERS 50
-  static char* buffers[MAX_BUFFERS];
-  static int buffers_sizes[MAX_BUFFERS];
-  static int buffers_index = -1;
-
   if (size == -1) /* Frees memory */
   {
-    int i;
-    buffers_index = -1;
-    for (i = 0; i < MAX_BUFFERS; i++)
-    {
-      if (buffers[i]) 
-      {
-        free(buffers[i]);
-        buffers[i] = NULL;
-      }
-      buffers_sizes[i] = 0;
-    }
+    iStrFreeBuffers();
     return NULL;
   }
   else
   {
+    IstrBuffers* str_buffers = iStrGetBuffers();
+    int index = str_buffers->buffers_index;
     char* ret_str;
 
-    /* init buffers array */
-    if (buffers_index == -1)
-    {
-      memset(buffers, 0, sizeof(char*)*MAX_BUFFERS);
-      memset(buffers_sizes, 0, sizeof(int)*MAX_BUFFERS);
-      buffers_index = 0;
-    }
-
     /* first alocation */
-    if (!(buffers[buffers_index]))
+    if (!(str_buffers->buffers[index]))
     {
-      buffers_sizes[buffers_index] = size+1;
-      buffers[buffers_index] = (char*)malloc(buffers_sizes[buffers_index]);
+      str_buffers->buffers_sizes[index] = size+1;
+      str_buffers->buffers[index] = (char*)malloc(str_buffers->buffers_sizes[index]);
     }
-    else if (buffers_sizes[buffers_index] < size+1)  /* reallocate if necessary */
+    else if (str_buffers->buffers_sizes[index] < size+1)  /* reallocate if necessary */
     {
-      buffers_sizes[buffers_index] = size+1;
-      buffers[buffers_index] = (char*)realloc(buffers[buffers_index], buffers_sizes[buffers_index]);
+      str_buffers->buffers_sizes[index] = size+1;
+      str_buffers->buffers[index] = (char*)realloc(str_buffers->buffers[index], str_buffers->buffers_sizes[index]);
     }
 
-    /* always clear memory before returning a new buffer */
-    memset(buffers[buffers_index], 0, buffers_sizes[buffers_index]);
-    ret_str = buffers[buffers_index];
+    /* always clear memory before returning a new buffer, 
+       but only the requested size, the buffer can be much larger */
+    ret_str = str_buffers->buffers[index];
+    memset(ret_str, 0, size+1);
 
-    buffers_index++;
-    if (buffers_index == MAX_BUFFERS)
-      buffers_index = 0;
+    str_buffers->buffers_index++;
+    if (str_buffers->buffers_index == MAX_BUFFERS)
+      str_buffers->buffers_index = 0;
 
     return ret_str;
   }
-#undef MAX_BUFFERS
 }
 
+#undef LARGE_MAX_BUFFERS
+#undef LARGE_SIZE 
+#undef SMALL_MAX_BUFFERS
+#undef SMALL_SIZE 
+#undef MAX_BUFFERS
+
 IUP_SDK_API char* iupStrReturnStrf(const char* format, ...)
 {
-  char* str = iupStrGetMemory(10240);
+  char buffer[256];
+  char* str;
+  int size;
   va_list arglist;
+
+  /* format first in a local buffer to compute the necessary size */
   va_start(arglist, format);
-  vsnprintf(str, 10240, format, arglist);
+  size = vsnprintf(buffer, sizeof(buffer), format, arglist);
   va_end(arglist);
+
+  if (size < 0)  /* old vsnprintf implementations do not return the necessary size */
+  {
+    str = iupStrGetMemory(10240);
+    va_start(arglist, format);
+    vsnprintf(str, 10240, format, arglist);
+    va_end(arglist);
+    return str;
+  }
+
+  str = iupStrGetMemory(size);
+  if (size < (int)sizeof(buffer))
+    memcpy(str, buffer, size + 1);
+  else
+  {
+    va_start(arglist, format);
+    vsnprintf(str, size + 1, format, arglist);
+    va_end(arglist);
+  }
+
   return str;
 }
 
@@ -1776,7 +1874,7 @@ int iupStrIsAscii(const char* str)
   return 1;
 }
 
-static char* iStrSetLocale(const char* decimal_symbol)
+static int iStrNeedSetLocale(const char* decimal_symbol)
 {
   if (decimal_symbol)
   {
@@ -1786,22 +1884,25 @@ static char* iStrSetLocale(const char* decimal_symbol)
     struct lconv* locale_info = localeconv();
     if (locale_info->decimal_point[0] != decimal_symbol[0])
 #endif
-    {
-      char* old_locale = setlocale(LC_NUMERIC, NULL);
+      return decimal_symbol[0] == '.' || decimal_symbol[0] == ',';
+  }
 
-      if (decimal_symbol[0] == '.')
-      {
-        old_locale = iupStrDup(old_locale);  /* must be before another setlocale */
-        setlocale(LC_NUMERIC, "en-US");
-        return old_locale;
-      }
-      else if (decimal_symbol[0] == ',')
-      {
-        old_locale = iupStrDup(old_locale);  /* must be before another setlocale */
-        setlocale(LC_NUMERIC, "pt-BR");
-        return old_locale;
-      }
-    }
+  return 0;
+}
+
+static char* iStrSetLocale(const char* decimal_symbol)
+{
+  if (iStrNeedSetLocale(decimal_symbol))
+  {
+    char* old_locale = setlocale(LC_NUMERIC, NULL);
+    old_locale = iupStrDup(old_locale);  /* must be before another setlocale */
+
+    if (decimal_symbol[0] == '.')
+      setlocale(LC_NUMERIC, "en-US");
+    else
+      setlocale(LC_NUMERIC, "pt-BR");
+
+    return old_locale;
   }
 
   return NULL;
@@ -1816,14 +1917,69 @@ static void iStrResetLocale(char* old_locale)
   }
 }
 
+static char iStrGetLocaleDecimal(void)
+{
+#ifdef __ANDROID__
+  return '.';
+#else
+  struct lconv* locale_info = localeconv();
+  if (locale_info->decimal_point[0] == 0 || locale_info->decimal_point[1] != 0)
+    return 0;  /* multi-byte decimal point, can not be replaced */
+  return locale_info->decimal_point[0];
+#endif
+}
+
+static int iStrCanReplaceDecimal(const char* decimal_symbol, char locale_decimal)
+{
+  /* same conditions of iStrSetLocale, 
+     but the decimal point is replaced instead of calling setlocale twice,
+     which is slow and not thread safe */
+  if (!decimal_symbol || !locale_decimal)
+    return 0;
+  if (decimal_symbol[0] != '.' && decimal_symbol[0] != ',')
+    return 0;
+  return locale_decimal != decimal_symbol[0];
+}
+
 IUP_SDK_API int iupStrToDoubleLocale(const char *str, double *d, const char* decimal_symbol)
 {
   int ret, locale_set = 0;
   char* old_locale;
+  char locale_decimal;
 
   if (!str) 
     return 0;
 
+  locale_decimal = iStrGetLocaleDecimal();
+  if (iStrCanReplaceDecimal(decimal_symbol, locale_decimal))
+  {
+    char buffer[80];
+    int i = 0;
+
+    while (str[i] && i < 79)
+    {
+      char c = str[i];
+      if (c == locale_decimal)
+        break;  /* not a decimal point for the given symbol, the number ends here */
+      if (c == decimal_symbol[0])
+        c = locale_decimal;
+      buffer[i] = c;
+      i++;
+    }
+
+    if (str[i] == 0 || str[i] == locale_decimal)
+    {
+      buffer[i] = 0;
+
+      if (sscanf(buffer, "%lf", d) != 1)
+        return 0;
+
+      return 2;
+    }
+
+    /* too long, use the locale */
+  }
+
   old_locale = iStrSetLocale(decimal_symbol);
   if (old_locale) locale_set = 1;
 
@@ -1840,15 +1996,119 @@ IUP_SDK_API int iupStrToDoubleLocale(const char *str, double *d, const char* dec
     return 1;
 }
 
+static const char* iStrCopyFormatText(char* *str, const char* format)
+{
+  /* copy the format text up to the conversion, replacing "%%" by '%',
+     if str is NULL just skip the text */
+  while (*format)
+  {
+    if (*format == '%')
+    {
+      if (*(format + 1) != '%')
+        return format;
+      format++;
+    }
+
+    if (str)
+    {
+      **str = *format;
+      (*str)++;
+    }
+    format++;
+  }
+
+  return NULL;
+}
+
+static const char* iStrFindFormatDouble(const char* format, const char* *spec_end)
+{
+  /* returns the start of the only conversion in the format, 
+     when it is a floating point conversion and there is no thousands grouping */
+  const char* spec_start;
+
+  if (strchr(format, '\''))
+    return NULL;
+
+  spec_start = iStrCopyFormatText(NULL, format);
+  if (!spec_start)
+    return NULL;
+
+  *spec_end = spec_start + 1;
+  while (**spec_end && !strchr("eEfFgGaA", **spec_end))
+    (*spec_end)++;
+
+  if (**spec_end == 0 || *spec_end - spec_start + 1 >= 50)
+    return NULL;
+
+  if (iStrCopyFormatText(NULL, *spec_end + 1) != NULL)
+    return NULL;  /* another conversion in the format */
+
+  return spec_start;
+}
+
 IUP_SDK_API void iupStrPrintfDoubleLocale(char *str, const char *format, double d, const char* decimal_symbol)
 {
-  char* old_locale = iStrSetLocale(decimal_symbol);
+  char* old_locale;
+  char locale_decimal = iStrGetLocaleDecimal();
+
+  if (iStrCanReplaceDecimal(decimal_symbol, locale_decimal))
+  {
+    const char* spec_end;
+    const char* spec_start = iStrFindFormatDouble(format, &spec_end);
+    if (spec_start)
+    {
+      char spec[50];
+      char* number = str;
+      char* end;
+      int len = (int)(spec_end - spec_start + 1);
+
+      iStrCopyFormatText(&number, format);
+
+      memcpy(spec, spec_start, len);
+      spec[len] = 0;
+
+      /* format only the number, then replace the decimal point */
+      end = number + sprintf(number, spec, d);
+      while (number < end)
+      {
+        if (*number == locale_decimal)
+          *number = decimal_symbol[0];
+        number++;
+      }
+
+      iStrCopyFormatText(&end, spec_end + 1);
+      *end = 0;
+      return;
+    }
+  }
+
+  if (!iStrCopyFormatText(NULL, format))
+  {
+    /* no conversion, the locale is not used */
+    sprintf(str, format, d);
+    return;
+  }
+
+  old_locale = iStrSetLocale(decimal_symbol);
 
   sprintf(str, format, d);
 
   iStrResetLocale(old_locale);
 }
 
+IUP_SDK_API int iupStrPrintfDoubleLocaleIsThreadSafe(const char *format, const char* decimal_symbol)
+{
+  const char* spec_end;
+
+  if (iStrCanReplaceDecimal(decimal_symbol, iStrGetLocaleDecimal()) && iStrFindFormatDouble(format, &spec_end))
+    return 1;
+
+  if (!iStrCopyFormatText(NULL, format))
+    return 1;
+
+  return !iStrNeedSetLocale(decimal_symbol);
+}
+
 #ifdef WIN32
 #include <windows.h>
 #else
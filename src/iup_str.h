@@ -107,12 +107,14 @@ IUP_SDK_API void iupStrCopyN(char* dst_str, int dst_max_size, const char* src_st
 
 /** Returns a buffer with the specified size+1. \n
  * The buffer is resused after 50 calls. It must NOT be freed.
- * Use size=-1 to free all the internal buffers.
+ * Buffers are kept per thread, calls from different threads do not share them.
+ * They are freed when the thread exits.
+ * Use size=-1 to free all the internal buffers of the current thread.
  * \ingroup str */
 IUP_SDK_API char* iupStrGetMemory(int size);
 
 /** Returns a very large buffer to be used in unknown size string construction.
- * Use snprintf or vsnprintf with the given size.
+ * Use snprintf or vsnprintf with the given size. Buffers are kept per thread.
  * \ingroup str */
 IUP_SDK_API char* iupStrGetLargeMem(int *size);
 
@@ -160,6 +162,7 @@ IUP_SDK_API int iupStrIsAscii(const char* str);
 
 
 /** Returns combined values in a formatted string using \ref iupStrGetMemory.
+ * The buffer is allocated with the size of the formatted string.
  * This is not supposed to be used for very large strings,
  * just for combinations of numeric data or constant strings.
  * \ingroup str */
@@ -226,6 +229,11 @@ IUP_SDK_API int iupStrGetFormatPrecision(const char* format);
  * \ingroup str */
 IUP_SDK_API void iupStrPrintfDoubleLocale(char *str, const char *format, double d, const char* decimal_symbol);
 
+/** Returns non zero if \ref iupStrPrintfDoubleLocale does not need to change the locale 
+ * for the given format and decimal symbol, so it can be called from several threads at the same time.
+ * \ingroup str */
+IUP_SDK_API int iupStrPrintfDoubleLocaleIsThreadSafe(const char *format, const char* decimal_symbol);
+
 
 /** Extract RGB components from the string. Returns 0 or 1.
  * \ingroup str */
@@ -32,16 +32,56 @@
 #include "iup_str.h"
 #include "iup_register.h"
 #include "iup_stdcontrols.h"
+#include "iup_thread.h"
 
 
+#ifdef IUP_USE_GTK
+static GThread* iThreadMain = NULL;
+#elif defined(WIN32)
+static DWORD iThreadMainId = 0;
+#endif
+
+void iupThreadInit(void)
+{
+#ifdef IUP_USE_GTK
+  iThreadMain = g_thread_self();
+#elif defined(WIN32)
+  iThreadMainId = GetCurrentThreadId();
+#endif
+}
+
+int iupThreadIsMain(void)
+{
+#ifdef IUP_USE_GTK
+  return g_thread_self() == iThreadMain;
+#elif defined(WIN32)
+  return GetCurrentThreadId() == iThreadMainId;
+#else
+  return 1;
+#endif
+}
+
+#if defined(IUP_USE_GTK) && !defined(OLD_GLIB)
+/* held while a thread is created and stored in the THREAD attribute, 
+   so the new thread does not read the attributes while they are changed */
+static GMutex iThreadStartMutex;
+#endif
+
 static int iThreadSetJoinAttrib(Ihandle* ih, const char* value)
 {
 #ifdef IUP_USE_GTK
   GThread* thread = (GThread*)iupAttribGet(ih, "THREAD");
-  g_thread_join(thread);
+  if (thread)
+  {
+#ifndef OLD_GLIB
+    g_thread_ref(thread);  /* join releases a reference, keep the one in the THREAD attribute, released by START or destroy */
+#endif
+    g_thread_join(thread);
+  }
 #elif defined(WIN32)
   HANDLE thread = (HANDLE)iupAttribGet(ih, "THREAD");
-  WaitForSingleObject(thread, INFINITE);
+  if (thread)
+    WaitForSingleObject(thread, INFINITE);
 #endif
 
   (void)value;
@@ -124,7 +164,13 @@ static void* ClientThreadFunc(void* obj)
 #endif
 {
   Ihandle* ih = (Ihandle*)obj;
-  Icallback cb = IupGetCallback(ih, "THREAD_CB");
+  Icallback cb;
+#if defined(IUP_USE_GTK) && !defined(OLD_GLIB)
+  /* wait until START stored the thread */
+  g_mutex_lock(&iThreadStartMutex);
+  g_mutex_unlock(&iThreadStartMutex);
+#endif
+  cb = IupGetCallback(ih, "THREAD_CB");
   if (cb)
     cb(ih);
   return 0;
@@ -141,6 +187,7 @@ static int iThreadSetStartAttrib(Ihandle* ih, const char* value)
 #ifdef OLD_GLIB
     thread = g_thread_create(ClientThreadFunc, ih, FALSE, NULL);
 #else
+    g_mutex_lock(&iThreadStartMutex);
     thread = g_thread_new(name, ClientThreadFunc, ih);
 #endif
     old_thread = (GThread*)iupAttribGet(ih, "THREAD");
@@ -148,12 +195,17 @@ static int iThreadSetStartAttrib(Ihandle* ih, const char* value)
     if (old_thread) g_thread_unref(old_thread);
 #endif
     iupAttribSet(ih, "THREAD", (char*)thread);
+#ifndef OLD_GLIB
+    g_mutex_unlock(&iThreadStartMutex);
+#endif
 #elif defined(WIN32)
     DWORD threadId;
-    HANDLE thread = CreateThread(0, 0, ClientThreadFunc, ih, 0, &threadId);
+    /* suspended until stored, so the new thread does not read the attributes while they are changed */
+    HANDLE thread = CreateThread(0, 0, ClientThreadFunc, ih, CREATE_SUSPENDED, &threadId);
     HANDLE old_thread = (HANDLE)iupAttribGet(ih, "THREAD");
     if (old_thread) CloseHandle(old_thread);
     iupAttribSet(ih, "THREAD", (char*)thread);
+    ResumeThread(thread);
 #endif
   }
 
@@ -0,0 +1,28 @@
+/** \file
+ * \brief Thread Utilities (not exported API)
+ *
+ * See Copyright Notice in "iup.h"
+ */
+ 
+#ifndef __IUP_THREAD_H 
+#define __IUP_THREAD_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+/* Stores the calling thread as the main thread.
+   Called only by IupOpen. */
+void iupThreadInit(void);
+
+/* Returns non zero if called from the thread that called IupOpen.
+   Always returns 1 where IupThread is not supported. */
+int iupThreadIsMain(void);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -7,6 +7,12 @@
 #include <stdio.h>
 #include <stdlib.h>
 
+#ifdef WIN32
+#include <windows.h>
+#else
+#include <time.h>
+#endif
+
 #include "iup.h"
 #include "iupcbs.h"
 
@@ -17,6 +23,21 @@
 #include "iup_attrib.h"
 
 
+IUP_SDK_API double iupTimerGetWallTime(void)
+{
+  /* monotonic, and unlike clock() it does not include the time of other threads */
+#ifdef WIN32
+  LARGE_INTEGER count, frequency;
+  QueryPerformanceCounter(&count);
+  QueryPerformanceFrequency(&frequency);
+  return ((double)count.QuadPart * 1000.0) / (double)frequency.QuadPart;
+#else
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (double)ts.tv_sec * 1000.0 + (double)ts.tv_nsec / 1.0e6;
+#endif
+}
+
 long long iupTimerGetLongLong(Ihandle* ih, const char* name)
 {
   long long i = 0;
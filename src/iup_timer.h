@@ -18,6 +18,10 @@ void iupdrvTimerInitClass(Iclass* ic);
 
 long long iupTimerGetLongLong(Ihandle* ih, const char* name);
 
+/* Returns the wall clock time in milliseconds, from an arbitrary start.
+   Used to measure elapsed time, can be called from any thread. */
+IUP_SDK_API double iupTimerGetWallTime(void);
+
 
 #ifdef __cplusplus
 }
@@ -298,46 +298,161 @@ int iupTreeForEach(Ihandle* ih, iupTreeNodeFunc func, void* userdata)
   return 1;
 }
 
-int iupTreeFindNodeId(Ihandle* ih, InodeHandle* node_handle)
+#define ITREE_HASH_MINSIZE 64
+
+static unsigned int iTreeHashPointer(void* key)
 {
-  /* Unoptimized version:
-  int i;
-  for (i = 0; i < ih->data->node_count; i++)
+  size_t h = (size_t)key;
+  h ^= h >> 16;
+  h *= 0x45d9f3b;
+  h ^= h >> 16;
+  return (unsigned int)h;
+}
+
+static void* iTreeHashKey(Ihandle* ih, int id, int is_userdata)
+{
+  if (is_userdata)
+    return ih->data->node_cache[id].userdata;
+  else
+    return (void*)ih->data->node_cache[id].node_handle;
+}
+
+static void iTreeHashInvalidate(ItreeHash* hash, int id)
+{
+  /* nodes from id to the end changed, they will be added again when searched */
+  if (hash->count > id)
+    hash->count = id;
+}
+
+static void iTreeHashInsert(ItreeHash* hash, void* key, int id)
+{
+  unsigned int mask = (unsigned int)hash->size - 1;
+  unsigned int i = iTreeHashPointer(key) & mask;
+
+  while (hash->slots[i])
+    i = (i + 1) & mask;
+
+  hash->slots[i] = id + 1;
+  hash->used++;
+}
+
+static void iTreeHashAdd(Ihandle* ih, ItreeHash* hash, int id, int is_userdata)
+{
+  void* key = iTreeHashKey(ih, id, is_userdata);
+
+  if (!key)
+    return;
+
+  if ((hash->used + 1) * 2 > hash->size)
   {
-    if (ih->data->node_cache[i].node_handle == node_handle)
-      return i;
+    /* rebuild only with the valid nodes, old entries are discarded */
+    int i, count = hash->count;
+
+    if (!hash->size || count * 4 > hash->size)
+    {
+      int new_size = hash->size ? hash->size : ITREE_HASH_MINSIZE;
+      while (count * 4 > new_size)
+        new_size *= 2;
+
+      hash->slots = (int*)realloc(hash->slots, new_size * sizeof(int));
+      hash->size = new_size;
+    }
+
+    memset(hash->slots, 0, hash->size * sizeof(int));
+    hash->used = 0;
+
+    for (i = 0; i < count; i++)
+    {
+      void* k = iTreeHashKey(ih, i, is_userdata);
+      if (k)
+        iTreeHashInsert(hash, k, i);
+    }
   }
-  */
-  InodeData *node_cache = ih->data->node_cache;
-  while(node_cache->node_handle != node_handle && 
-        node_cache->node_handle != NULL)   /* the cache always have zeros at the end */
-    node_cache++;
-
-  if (node_cache->node_handle != NULL)
-    return (int)(node_cache - ih->data->node_cache);
-  else
+
+  iTreeHashInsert(hash, key, id);
+}
+
+static int iTreeHashFind(Ihandle* ih, ItreeHash* hash, void* key, int is_userdata)
+{
+  int id, old_count;
+
+  if (hash->size)
+  {
+    unsigned int mask = (unsigned int)hash->size - 1;
+    unsigned int i = iTreeHashPointer(key) & mask;
+
+    while (hash->slots[i])
+    {
+      id = hash->slots[i] - 1;
+      if (id < hash->count && id < ih->data->node_count &&
+          iTreeHashKey(ih, id, is_userdata) == key)
+        return id;
+
+      i = (i + 1) & mask;
+    }
+  }
+
+  /* not in the table, search the remaining nodes adding them to the table */
+  old_count = hash->count;
+  for (id = hash->count; id < ih->data->node_count; id++)
+  {
+    iTreeHashAdd(ih, hash, id, is_userdata);
+    hash->count = id + 1;
+
+    if (iTreeHashKey(ih, id, is_userdata) == key)
+      return id;
+  }
+
+  /* the node_cache may have been changed directly by the driver, 
+     so before failing check the nodes that were supposed to be in the table */
+  for (id = 0; id < old_count && id < ih->data->node_count; id++)
+  {
+    if (iTreeHashKey(ih, id, is_userdata) == key)
+    {
+      iTreeHashInvalidate(hash, 0);
+      return id;
+    }
+  }
+
+  return -1;
+}
+
+static void iTreeHashRelease(ItreeHash* hash)
+{
+  if (hash->slots)
+    free(hash->slots);
+  memset(hash, 0, sizeof(ItreeHash));
+}
+
+static void iTreeInvalidateHash(Ihandle* ih, int id)
+{
+  iTreeHashInvalidate(&ih->data->node_hash, id);
+  iTreeHashInvalidate(&ih->data->userdata_hash, id);
+}
+
+int iupTreeFindNodeId(Ihandle* ih, InodeHandle* node_handle)
+{
+  if (!node_handle)
     return -1;
+
+  return iTreeHashFind(ih, &ih->data->node_hash, (void*)node_handle, 0);
 }
 
 static int iTreeFindUserDataId(Ihandle* ih, void* userdata)
 {
-  /* Unoptimized version:
-  int i;
-  for (i = 0; i < ih->data->node_count; i++)
+  if (!userdata)
   {
-    if (ih->data->node_cache[i].userdata == userdata)
-      return i;
-  }
-  */
-  InodeData *node_cache = ih->data->node_cache;
-  while(node_cache->userdata != userdata && 
-        node_cache->node_handle != NULL)   /* the cache always have zeros at the end */
-    node_cache++;
-
-  if (node_cache->node_handle != NULL)
-    return (int)(node_cache - ih->data->node_cache);
-  else
+    /* many nodes can have NULL userdata, return the first one */
+    int i;
+    for (i = 0; i < ih->data->node_count; i++)
+    {
+      if (ih->data->node_cache[i].userdata == NULL)
+        return i;
+    }
     return -1;
+  }
+
+  return iTreeHashFind(ih, &ih->data->userdata_hash, userdata, 1);
 }
 
 InodeHandle* iupTreeGetNode(Ihandle* ih, int id)
@@ -365,6 +480,9 @@ static void iTreeAddToCache(Ihandle* ih, int id, InodeHandle* node_handle)
 
   /* node_count here already contains the final count */
 
+  /* nodes after id will be shifted, when adding at the end nothing changes */
+  iTreeInvalidateHash(ih, id);
+
   if (id == ih->data->node_count-1)
     ih->data->node_cache[id].node_handle = node_handle;
   else
@@ -384,10 +502,13 @@ void iupTreeIncCacheMem(Ihandle* ih)
 
   if (ih->data->node_count+10 > ih->data->node_cache_max)
   {
+    /* grow geometrically, so adding many nodes does not realloc at each few nodes */
     int old_node_cache_max = ih->data->node_cache_max;
-    ih->data->node_cache_max += 20;
+    ih->data->node_cache_max *= 2;
+    if (ih->data->node_cache_max < ih->data->node_count+10)
+      ih->data->node_cache_max = ih->data->node_count+10;
     ih->data->node_cache = realloc(ih->data->node_cache, ih->data->node_cache_max*sizeof(InodeData));
-    memset(ih->data->node_cache+old_node_cache_max, 0, 20*sizeof(InodeData));
+    memset(ih->data->node_cache+old_node_cache_max, 0, (ih->data->node_cache_max-old_node_cache_max)*sizeof(InodeData));
   }
 }
 
@@ -440,6 +561,8 @@ void iupTreeDelFromCache(Ihandle* ih, int id, int count)
 
   /* node_count here already contains the final count */
 
+  iTreeInvalidateHash(ih, id);
+
   /* remove id+count */
   remain_count = ih->data->node_count-id;
   memmove(ih->data->node_cache+id, ih->data->node_cache+id+count, remain_count*sizeof(InodeData));
@@ -470,6 +593,8 @@ void iupTreeCopyMoveCache(Ihandle* ih, int id_src, int id_dst, int count, int is
   /* node_count here contains the final count for a copy operation */
   iupTreeIncCacheMem(ih);
 
+  iTreeInvalidateHash(ih, id_src < id_dst? id_src: id_dst);
+
   /* add space for new nodes */
   remain_count = ih->data->node_count - (id_dst + count);
   memmove(ih->data->node_cache + id_dst+count, ih->data->node_cache + id_dst, remain_count * sizeof(InodeData));
@@ -683,14 +808,16 @@ static char* iTreeGetUserDataAttrib(Ihandle* ih, int id)
 
 static int iTreeSetUserDataAttrib(Ihandle* ih, int id, const char* value)
 {
-  if (id >= 0 && id < ih->data->node_count)
-    ih->data->node_cache[id].userdata = (void*)value;
-  else if (id == IUP_INVALID_ID && ih->data->node_count!=0)
+  if (id == IUP_INVALID_ID && ih->data->node_count!=0)
   {
     InodeHandle* node_handle = iupdrvTreeGetFocusNode(ih);
     id = iupTreeFindNodeId(ih, node_handle);
-    if (id >= 0 && id < ih->data->node_count)
-      ih->data->node_cache[id].userdata = (void*)value;
+  }
+
+  if (id >= 0 && id < ih->data->node_count)
+  {
+    ih->data->node_cache[id].userdata = (void*)value;
+    iTreeHashInvalidate(&ih->data->userdata_hash, id);
   }
   return 0;
 }
@@ -925,6 +1052,9 @@ static void iTreeDestroyMethod(Ihandle* ih)
 {
   if (ih->data->node_cache)
     free(ih->data->node_cache);
+
+  iTreeHashRelease(&ih->data->node_hash);
+  iTreeHashRelease(&ih->data->userdata_hash);
 }
 
 /*************************************************************************/
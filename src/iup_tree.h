@@ -47,6 +47,17 @@ typedef struct _InodeData
   void* userdata;
 } InodeData;
 
+/* Open addressing hash table that returns the id given the node handle or the userdata.
+   Only the nodes from 0 to count-1 are in the table, the others are added when searched. 
+   Entries are always checked against the node_cache, so old entries are simply ignored. */
+typedef struct _ItreeHash
+{
+  int* slots;   /* id+1 of the node, 0 is an empty slot */
+  int size,     /* always a power of 2 */
+      used,
+      count;
+} ItreeHash;
+
 typedef int (*iupTreeNodeFunc)(Ihandle* ih, InodeHandle* node_handle, int id, void* userdata);
 int iupTreeForEach(Ihandle* ih, iupTreeNodeFunc func, void* userdata);
 InodeHandle* iupTreeGetNode(Ihandle* ih, int id);
@@ -86,6 +97,9 @@ struct _IcontrolData
 
   InodeData *node_cache;   /* given the id returns node native handle and user_data */
   int node_cache_max, node_count;
+
+  ItreeHash node_hash;      /* given the native handle returns the id */
+  ItreeHash userdata_hash;  /* given the user_data returns the id */
 };
 
 
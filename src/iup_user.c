@@ -10,6 +10,7 @@
 #include "iup.h"
 
 #include "iup_object.h"
+#include "iup_attrib.h"
 #include "iup_stdcontrols.h"
 
 
@@ -17,6 +18,7 @@ static int iUserSetClearAttributesAttrib(Ihandle* ih, const char* value)
 {
   (void)value;
   iupTableClear(ih->attrib);
+  iupAttribInheritCacheNotify(ih, NULL);
   return 0;
 }
 
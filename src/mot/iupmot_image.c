@@ -159,6 +159,7 @@ void* iupdrvImageCreateImage(Ihandle *ih, const char* bgcolor, int make_inactive
   unsigned char bg_r=0, bg_g=0, bg_b=0;
   GC gc;
   Pixel color2pixel[256];
+  unsigned char *inactive_data = NULL;
 
   bpp = iupAttribGetInt(ih, "BPP");
 
@@ -188,6 +189,12 @@ void* iupdrvImageCreateImage(Ihandle *ih, const char* bgcolor, int make_inactive
       color2pixel[i] = iupmotColorGetPixel(colors[i].r, colors[i].g, colors[i].b);
     }
   }
+  else if (make_inactive)
+  {
+    /* the inactive data of identical images is computed only once,
+       it is already blended with the background */
+    inactive_data = iupImageGetInactiveData(ih, bg_r, bg_g, bg_b, 1);
+  }
 
   pixmap = XCreatePixmap(iupmot_display,
           RootWindow(iupmot_display,iupmot_screen),
@@ -203,6 +210,12 @@ void* iupdrvImageCreateImage(Ihandle *ih, const char* bgcolor, int make_inactive
       unsigned long p;
       if (bpp == 8)
         p = color2pixel[imgdata[y*width+x]];
+      else if (inactive_data)
+      {
+        int channels = (bpp==24)? 3: 4;
+        unsigned char *pixel_data = inactive_data + y*width*channels + x*channels;
+        p = iupmotColorGetPixel(*(pixel_data), *(pixel_data+1), *(pixel_data+2));
+      }
       else
       {
         int channels = (bpp==24)? 3: 4;
@@ -165,6 +165,13 @@ void iupdrvListAppendItem(Ihandle* ih, const char* value)
     motListAddItem(ih, -1, value);
 }
 
+void iupdrvListAppendItems(Ihandle* ih, const char** values, int count)
+{
+  int i;
+  for (i = 0; i < count; i++)
+    iupdrvListAppendItem(ih, values[i]);
+}
+
 void iupdrvListInsertItem(Ihandle* ih, int pos, const char* value)
 {
   if (iupAttribGetBoolean(ih, "SORT"))
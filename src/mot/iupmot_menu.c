@@ -149,6 +149,7 @@ static void motMenuUnMapMethod(Ihandle* ih)
   {
     XtDestroyWidget(ih->handle);
     ih->parent = NULL;
+    iupAttribInheritCacheInvalidate(ih);
   }
   else
     XtDestroyWidget(XtParent(ih->handle));  /* in this case the RowColumn widget is a child of a MenuShell. */
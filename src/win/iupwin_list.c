@@ -279,6 +279,24 @@ void iupdrvListAppendItem(Ihandle* ih, const char* value)
   winListSetItemData(ih, pos, value, NULL);
 }
 
+void iupdrvListAppendItems(Ihandle* ih, const char** values, int count)
+{
+  int i;
+
+  /* pre-allocate the internal storage and avoid redrawing at each item */
+  SendMessage(ih->handle, WM_SETREDRAW, FALSE, 0);
+  SendMessage(ih->handle, (ih->data->is_dropdown || ih->data->has_editbox)? CB_INITSTORAGE: LB_INITSTORAGE, count, count * 32);
+
+  for (i = 0; i < count; i++)
+  {
+    int pos = (int)SendMessage(ih->handle, WIN_ADDSTRING(ih), 0, (LPARAM)iupwinStrToSystem(values[i]));
+    winListSetItemData(ih, pos, values[i], NULL);
+  }
+
+  SendMessage(ih->handle, WM_SETREDRAW, TRUE, 0);
+  iupdrvPostRedraw(ih);
+}
+
 void iupdrvListInsertItem(Ihandle* ih, int pos, const char* value)
 {
   SendMessage(ih->handle, WIN_INSERTSTRING(ih), pos, (LPARAM)iupwinStrToSystem(value));
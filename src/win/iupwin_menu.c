@@ -362,6 +362,7 @@ static void winMenuUnMapMethod(Ihandle* ih)
   {
     SetMenu(ih->parent->handle, NULL);
     ih->parent = NULL;
+    iupAttribInheritCacheInvalidate(ih);
   }
 
   if (!iupMenuIsMenuBar(ih) && ih->parent)
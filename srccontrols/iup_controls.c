@@ -25,10 +25,10 @@ int IupControlsOpen(void)
   if (IupGetGlobal("_IUP_CONTROLS_OPEN"))
     return IUP_OPENED;
 
-  iupRegisterClass(iupCellsNewClass());
-  iupRegisterClass(iupMatrixNewClass());
-  iupRegisterClass(iupMatrixListNewClass());
-  iupRegisterClass(iupMatrixExNewClass());
+  iupRegisterClassLazy("cells", iupCellsNewClass);
+  iupRegisterClassLazy("matrix", iupMatrixNewClass);
+  iupRegisterClassLazy("matrixlist", iupMatrixListNewClass);
+  iupRegisterClassLazy("matrixex", iupMatrixExNewClass);
 
   IupSetGlobal("_IUP_CONTROLS_OPEN", "1");
 
@@ -26,10 +26,36 @@
 #include "iupmat_numlc.h"
 
 
+/* The prefix sums are valid only after the sizes are computed,
+   and until lines/columns are added or removed */
+#define iMatrixAuxHasPos(_p) ((_p)->pos && (_p)->pos_num == (_p)->num)
+
+static int iMatrixAuxFindPos(ImatLinColData *p, int start, int end, int value)
+{
+  /* binary search for the first index in [start, end] where pos[index+1] > value,
+     returns end+1 if there is none. pos is not decreasing. */
+  int low = start, high = end + 1;
+  while (low < high)
+  {
+    int mid = (low + high) / 2;
+    if (p->pos[mid + 1] > value)
+      high = mid;
+    else
+      low = mid + 1;
+  }
+  return low;
+}
+
 int iupMatrixAuxIsFullVisibleLast(ImatLinColData *p)
 {
   int i, sum = 0;
 
+  if (iMatrixAuxHasPos(p) && p->first <= p->last && p->last < p->num)
+  {
+    sum = p->pos[p->last + 1] - p->pos[p->first] - p->first_offset;
+    return (sum > p->current_visible_size)? 0: 1;
+  }
+
   for(i = p->first; i <= p->last; i++)
   {
     sum += p->dt[i].size;
@@ -88,11 +114,34 @@ void iupMatrixAuxAdjustFirstFromLast(ImatLinColData* p)
   /* adjust "first" according to "last" */
 
   i = p->last;
-  sum = p->dt[i].size;
-  while (i>p->num_noscroll && sum < p->current_visible_size)
+  if (iMatrixAuxHasPos(p) && i < p->num)
   {
-    i--;
-    sum += p->dt[i].size;
+    /* binary search for the last index where sum(index..last) >= current_visible_size */
+    int low = p->num_noscroll, high = i, end = p->pos[i + 1];
+    if (end - p->pos[i] >= p->current_visible_size || i <= low)
+      low = i;
+    else
+    {
+      while (low < high)
+      {
+        int mid = (low + high + 1) / 2;
+        if (end - p->pos[mid] >= p->current_visible_size)
+          low = mid;
+        else
+          high = mid - 1;
+      }
+    }
+    i = low;
+    sum = end - p->pos[i];
+  }
+  else
+  {
+    sum = p->dt[i].size;
+    while (i>p->num_noscroll && sum < p->current_visible_size)
+    {
+      i--;
+      sum += p->dt[i].size;
+    }
   }
 
   if (i == p->num_noscroll && sum < p->current_visible_size)
@@ -116,14 +165,26 @@ void iupMatrixAuxAdjustFirstFromScrollPos(ImatLinColData* p, int scroll_pos)
   int index, sp, offset = 0;
 
   sp = 0;
-  for(index = p->num_noscroll; index < p->num; index++)
+  if (iMatrixAuxHasPos(p))
+  {
+    int base = p->pos[p->num_noscroll];
+    index = iMatrixAuxFindPos(p, p->num_noscroll, p->num - 1, base + scroll_pos);
+    if (index < p->num)
+      offset = scroll_pos - (p->pos[index] - base);
+    else
+      sp = p->pos[p->num] - base;
+  }
+  else
   {
-    sp += p->dt[index].size;
-    if (sp > scroll_pos)
+    for(index = p->num_noscroll; index < p->num; index++)
     {
-      sp -= p->dt[index].size; /* get the previous value */
-      offset = scroll_pos - sp;
-      break;
+      sp += p->dt[index].size;
+      if (sp > scroll_pos)
+      {
+        sp -= p->dt[index].size; /* get the previous value */
+        offset = scroll_pos - sp;
+        break;
+      }
     }
   }
 
@@ -191,8 +252,13 @@ void iupMatrixAuxUpdateScrollPos(Ihandle* ih, int m)
 
   /* must check if it is a valid position */
   scroll_pos = 0;
-  for(i = p->num_noscroll; i < p->first; i++)
-    scroll_pos += p->dt[i].size;
+  if (iMatrixAuxHasPos(p) && p->first >= p->num_noscroll && p->first <= p->num)
+    scroll_pos = p->pos[p->first] - p->pos[p->num_noscroll];
+  else
+  {
+    for(i = p->num_noscroll; i < p->first; i++)
+      scroll_pos += p->dt[i].size;
+  }
   scroll_pos += p->first_offset;
 
   if (scroll_pos + p->current_visible_size > p->total_visible_size)
@@ -223,14 +289,22 @@ void iupMatrixAuxUpdateLast(ImatLinColData *p)
     /* Find which is the last column/line.
        Start in the first visible and continue adding the widths
        up to the visible size */
-    for(i = p->first; i < p->num; i++)
+    if (iMatrixAuxHasPos(p) && p->first < p->num)
     {
-      sum += p->dt[i].size;
-      if (i==p->first)
-        sum -= p->first_offset;
-
-      if(sum >= p->current_visible_size)
-        break;
+      /* first index where pos[i+1] - pos[first] - first_offset >= current_visible_size */
+      i = iMatrixAuxFindPos(p, p->first, p->num - 1, p->pos[p->first] + p->first_offset + p->current_visible_size - 1);
+    }
+    else
+    {
+      for(i = p->first; i < p->num; i++)
+      {
+        sum += p->dt[i].size;
+        if (i==p->first)
+          sum -= p->first_offset;
+
+        if(sum >= p->current_visible_size)
+          break;
+      }
     }
 
     if (i == p->num)
@@ -262,6 +336,9 @@ static void iMatrixAuxFillSizeVec(Ihandle* ih, int m)
   else
     p = &(ih->data->columns);
 
+  if (p->pos_num < p->num || !p->pos)
+    p->pos = (int*)realloc(p->pos, (p->num + 1)*sizeof(int));
+
   /* Calculate total width/height of the matrix and the width/height of each column */
   p->total_visible_size = 0;
   p->total_size = 0;
@@ -275,8 +352,12 @@ static void iMatrixAuxFillSizeVec(Ihandle* ih, int m)
     if (i >= p->num_noscroll)
       p->total_visible_size += p->dt[i].size;
 
+    p->pos[i] = p->total_size;
     p->total_size += p->dt[i].size;
   }
+
+  p->pos[p->num] = p->total_size;
+  p->pos_num = p->num;
 }
 
 static int iMatrixAuxUpdateVisibleSize(Ihandle* ih, int m)
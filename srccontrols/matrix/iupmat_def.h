@@ -91,14 +91,31 @@ typedef struct _ImatLinColData
 
   int total_size;   /* Sum of the widths/heights of all columns/lines */
 
+  int* pos;         /* Prefix sums of the sizes, pos[i] is the sum of the sizes from 0 to i-1, has num+1 elements */
+  int pos_num;      /* Number of columns/lines when pos was computed, pos is valid only if pos_num==num */
+
   int focus_cell;   /* index of the current cell */
 } ImatLinColData;
 
+typedef struct _ImatNumericCache
+{
+  double number;     /* value converted to the shown unit */
+  char* formatted;   /* formatted value, NULL if not computed */
+} ImatNumericCache;
+
 typedef struct _ImatNumericData
 {
   unsigned char quantity;
   unsigned char unit, unit_shown;
   unsigned char flags;  
+
+  /* cache of the displayed values, indexed by the stored line (not sorted), 
+     allocated when the first value is displayed */
+  ImatNumericCache* cache;
+  int cache_num;
+  char* cache_format;                /* format used when filled */
+  char cache_decimal;                /* decimal symbol used when filled */
+  unsigned char cache_quantity, cache_unit, cache_unit_shown;   /* quantity and units used when filled */
 } ImatNumericData;
 
 typedef struct _ImatMergedData
@@ -110,6 +127,13 @@ typedef struct _ImatMergedData
   unsigned char used;
 } ImatMergedData;
 
+typedef struct _ImatMergedIndex
+{
+  int start_lin;
+  int max_end_lin;   /* maximum end_lin of this and all previous entries */
+  int merged;
+} ImatMergedIndex;
+
 struct _IcontrolData
 {
   iupCanvas canvas; /* from IupCanvas (must reserve it) */
@@ -137,6 +161,9 @@ struct _IcontrolData
   int need_redraw;
   int inside_markedit_cb;   /* avoid recursion */
   int last_sort_col;
+  int values_change_count;  /* incremented when values change or are moved, used by IupMatrixEx */
+  int title_width, title_height;  /* size of the title column/line computed from all the titles, non callback mode only */
+  int title_width_count, title_height_count;  /* values_change_count when the title size was computed, -1 if not computed */
 
   /* attributes */
   int mark_continuous, mark_mode, mark_multiple;
@@ -144,6 +171,7 @@ struct _IcontrolData
   int use_title_size;   /* use title contents when calculating cell size */
   int limit_expand; /* limit expand to maximum size */
   int undo_redo, 
+      find_index,  /* notify IupMatrixEx when a cell value changes */
       flat,
       show_fill_value;
 
@@ -190,6 +218,13 @@ struct _IcontrolData
   /* merged ranges */
   ImatMergedData* merge_info;  /* must free if not NULL */
   int merge_info_max, merge_info_count;
+  int merge_info_free;         /* all the slots before it are used */
+
+  /* index of the merged ranges sorted by start line, rebuilt when a range changes */
+  ImatMergedIndex* merge_index;  /* must free if not NULL */
+  int merge_index_count, merge_index_valid;
+  int* merge_line;               /* ranges that contain merge_line_lin, sorted by start column, must free if not NULL */
+  int merge_line_count, merge_line_lin;
 };
 
 
@@ -44,6 +44,12 @@ void iupMatrixExSetCellValue(Ihandle* ih, int lin, int col, const char* value)
   iupMatrixModifyValue(ih, lin, col, value);
 }
 
+/* Exported to IupMatrixEx */
+int iupMatrixExGetValuesChangeCount(Ihandle* ih)
+{
+  return ih->data->values_change_count;
+}
+
 static int iMatrixInitNumericColumns(Ihandle* ih, int col)
 {
   if (!iupMATRIX_CHECK_COL(ih, col))
@@ -236,6 +242,7 @@ static int iMatrixSetSortColumnAttrib(Ihandle* ih, int col, const char* value)
   if (iupStrEqualNoCase(value, "RESET"))
   {
     ih->data->sort_has_index = 0;
+    ih->data->values_change_count++;
     iupAttribSetId(ih, "SORTSIGN", ih->data->last_sort_col, NULL);
     ih->data->last_sort_col = 0;
 
@@ -354,6 +361,7 @@ static int iMatrixSetSortColumnAttrib(Ihandle* ih, int col, const char* value)
 
   ih->data->sort_has_index = 1;
   ih->data->last_sort_col = col;
+  ih->data->values_change_count++;
   iupMatrixDraw(ih, 1);
   return 0;
 }
@@ -385,6 +393,15 @@ static char* iMatrixGetUndoRedoAttrib(Ihandle* ih)
   return iupStrReturnBoolean(ih->data->undo_redo); 
 }
 
+static int iMatrixSetFindIndexAttrib(Ihandle* ih, const char* value)
+{
+  if (iupStrBoolean(value))
+    ih->data->find_index = 1;
+  else 
+    ih->data->find_index = 0;
+  return 0;
+}
+
 void iupMatrixRegisterEx(Iclass* ic)
 {
   /* Undocumented features, will be exposed in IupMatrixEx */
@@ -414,5 +431,8 @@ void iupMatrixRegisterEx(Iclass* ic)
 
   /* IupMatrixEx Attributes - Undo/Redo */
   iupClassRegisterAttribute(ic, "UNDOREDO", iMatrixGetUndoRedoAttrib, iMatrixSetUndoRedoAttrib, NULL, NULL, IUPAF_NOT_MAPPED|IUPAF_NO_INHERIT);
+
+  /* IupMatrixEx Attributes - Find */
+  iupClassRegisterAttribute(ic, "FINDINDEX", NULL, iMatrixSetFindIndexAttrib, NULL, NULL, IUPAF_NOT_MAPPED|IUPAF_NO_INHERIT);
 }
 
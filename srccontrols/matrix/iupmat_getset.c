@@ -89,6 +89,7 @@ void iupMatrixSetValue(Ihandle* ih, int lin, int col, const char* value, int use
 {
   /* NOTICE: this function is NOT called before map */
   char* old_value = NULL;
+  int view_lin = lin;
 
   if (ih->data->undo_redo) old_value = iupMatrixGetValue(ih, lin, col);
 
@@ -110,6 +111,16 @@ void iupMatrixSetValue(Ihandle* ih, int lin, int col, const char* value, int use
       free(ih->data->cells[lin][col].value);
 
     ih->data->cells[lin][col].value = iupStrDup(value);
+
+    if (ih->data->numeric_columns && lin < ih->data->numeric_columns[col].cache_num)
+    {
+      ImatNumericCache* cache = &(ih->data->numeric_columns[col].cache[lin]);
+      if (cache->formatted)
+      {
+        free(cache->formatted);
+        cache->formatted = NULL;
+      }
+    }
   }
 
   if (user_edited)
@@ -122,6 +133,10 @@ void iupMatrixSetValue(Ihandle* ih, int lin, int col, const char* value, int use
       value_edit_cb(ih, lin, col, (char*)value);
   }
 
+  ih->data->values_change_count++;
+
+  if (ih->data->find_index) iupAttribSetClassObjectId2(ih, "FINDINDEXCELL", view_lin, col, NULL);
+
   ih->data->need_redraw = 1;
   if (lin == 0 || col == 0)
     ih->data->need_calcsize = 1;
@@ -149,6 +164,90 @@ static char* iMatrixGetValueText(Ihandle* ih, int lin, int col)
   return value;
 }
 
+void iupMatrixNumericCacheClear(Ihandle* ih, int col)
+{
+  ImatNumericData* numeric = &(ih->data->numeric_columns[col]);
+
+  if (numeric->cache)
+  {
+    int lin;
+    for (lin = 0; lin < numeric->cache_num; lin++)
+    {
+      if (numeric->cache[lin].formatted)
+        free(numeric->cache[lin].formatted);
+    }
+
+    free(numeric->cache);
+    numeric->cache = NULL;
+    numeric->cache_num = 0;
+  }
+
+  if (numeric->cache_format)
+  {
+    free(numeric->cache_format);
+    numeric->cache_format = NULL;
+  }
+}
+
+void iupMatrixNumericCacheClearAll(Ihandle* ih)
+{
+  if (ih->data->numeric_columns)
+  {
+    int col;
+    for (col = 0; col < ih->data->columns.num_alloc; col++)
+      iupMatrixNumericCacheClear(ih, col);
+  }
+}
+
+static ImatNumericCache* iMatrixGetNumericCache(Ihandle* ih, int lin, int col, const char* format, const char* decimal_symbol)
+{
+  ImatNumericData* numeric = &(ih->data->numeric_columns[col]);
+  char decimal = decimal_symbol? decimal_symbol[0]: 0;
+
+  /* here lin!=0 and values are stored in the cells */
+
+  if (lin != 0 && ih->data->sort_has_index)
+    lin = ih->data->sort_line_index[lin];
+
+  /* if the format, decimal symbol, quantity or units changed, the whole column must be formatted again */
+  if (numeric->cache &&
+      (!numeric->cache_format || !iupStrEqual(numeric->cache_format, format) ||
+       numeric->cache_decimal != decimal || numeric->cache_quantity != numeric->quantity ||
+       numeric->cache_unit != numeric->unit || numeric->cache_unit_shown != numeric->unit_shown))
+    iupMatrixNumericCacheClear(ih, col);
+
+  if (!numeric->cache)
+  {
+    numeric->cache_num = ih->data->lines.num;
+    numeric->cache = (ImatNumericCache*)calloc(numeric->cache_num, sizeof(ImatNumericCache));
+    numeric->cache_format = iupStrDup(format);
+    numeric->cache_decimal = decimal;
+    numeric->cache_quantity = numeric->quantity;
+    numeric->cache_unit = numeric->unit;
+    numeric->cache_unit_shown = numeric->unit_shown;
+  }
+
+  if (lin >= numeric->cache_num)
+    return NULL;
+
+  return &(numeric->cache[lin]);
+}
+
+static ImatNumericCache* iMatrixFindNumericCache(Ihandle* ih, int lin, int col)
+{
+  /* return a valid cached number, only if it exists */
+  ImatNumericData* numeric = &(ih->data->numeric_columns[col]);
+
+  if (lin != 0 && ih->data->sort_has_index)
+    lin = ih->data->sort_line_index[lin];
+
+  if (lin < numeric->cache_num && numeric->cache[lin].formatted && numeric->cache_quantity == numeric->quantity &&
+      numeric->cache_unit == numeric->unit && numeric->cache_unit_shown == numeric->unit_shown)
+    return &(numeric->cache[lin]);
+
+  return NULL;
+}
+
 double iupMatrixGetValueNumeric(Ihandle* ih, int lin, int col)
 {
   sIFniis translate_cb;
@@ -159,6 +258,14 @@ double iupMatrixGetValueNumeric(Ihandle* ih, int lin, int col)
   char* value = iMatrixGetValueText(ih, lin, col);
 
   translate_cb = (sIFniis)IupGetCallback(ih, "TRANSLATEVALUE_CB");
+
+  if (!translate_cb && !ih->data->callback_mode)
+  {
+    ImatNumericCache* cache = iMatrixFindNumericCache(ih, lin, col);
+    if (cache)
+      return cache->number;
+  }
+
   if (translate_cb)
     value = translate_cb(ih, lin, col, value);
 
@@ -248,13 +355,27 @@ static char* iMatrixGetValueNumericTitle(Ihandle* ih, int col, const char* value
   return (char*)value;
 }
 
-static char* iMatrixGetValueNumericFormatted(Ihandle* ih, int lin, int col, const char* value)
+static char* iMatrixGetValueNumericFormatted(Ihandle* ih, int lin, int col, const char* value, int use_cache)
 {
-  char *format = NULL;
+  char *format = NULL, *decimal_symbol;
+  ImatNumericCache* cache = NULL;
   double number;
 
   /* here lin!=0 */
 
+  if (use_cache && value)
+  {
+    if (ih->data->numeric_columns[col].flags & IMAT_HAS_FORMAT)
+      format = iupAttribGetId(ih, "NUMERICFORMAT", col);
+
+    if (format == NULL)
+      format = iupMatrixGetNumericFormatDef(ih);
+
+    cache = iMatrixGetNumericCache(ih, lin, col, format, IupGetAttribute(ih, "NUMERICDECIMALSYMBOL"));
+    if (cache && cache->formatted)
+      return cache->formatted;
+  }
+
   if (!value)
   {
     dIFnii getvalue_cb = (dIFnii)IupGetCallback(ih, "NUMERICGETVALUE_CB");
@@ -274,13 +395,25 @@ static char* iMatrixGetValueNumericFormatted(Ihandle* ih, int lin, int col, cons
     ih->data->numeric_columns[col].unit, /* from */
     ih->data->numeric_columns[col].unit_shown);  /* to */
 
-  if (ih->data->numeric_columns[col].flags & IMAT_HAS_FORMAT)
-    format = iupAttribGetId(ih, "NUMERICFORMAT", col);
+  if (!format)
+  {
+    if (ih->data->numeric_columns[col].flags & IMAT_HAS_FORMAT)
+      format = iupAttribGetId(ih, "NUMERICFORMAT", col);
+
+    if (format == NULL)
+      format = iupMatrixGetNumericFormatDef(ih);
+  }
 
-  if (format == NULL)
-    format = iupMatrixGetNumericFormatDef(ih);
+  decimal_symbol = IupGetAttribute(ih, "NUMERICDECIMALSYMBOL");  /* this will also check for global "DEFAULTDECIMALSYMBOL" */
+  iupStrPrintfDoubleLocale(ih->data->numeric_buffer_get, format, number, decimal_symbol);
+
+  if (cache)
+  {
+    cache->number = number;
+    cache->formatted = iupStrDup(ih->data->numeric_buffer_get);
+    return cache->formatted;
+  }
 
-  iupStrPrintfDoubleLocale(ih->data->numeric_buffer_get, format, number, IupGetAttribute(ih, "NUMERICDECIMALSYMBOL"));  /* this will also check for global "DEFAULTDECIMALSYMBOL" */
   return ih->data->numeric_buffer_get;
 }
 
@@ -304,7 +437,7 @@ char* iupMatrixGetValueDisplay(Ihandle* ih, int lin, int col)
       if (lin == 0)
         return iMatrixGetValueNumericTitle(ih, col, value);
       else
-        return iMatrixGetValueNumericFormatted(ih, lin, col, value);
+        return iMatrixGetValueNumericFormatted(ih, lin, col, value, !ih->data->callback_mode && !translate_cb);
     }
     else
       return value;
@@ -764,6 +897,13 @@ void iupMatrixGetCellAlign(Ihandle* ih, int lin, int col, int *col_alignment, in
   }
 }
 
+static int iMatrixCanCacheTitleSize(Ihandle* ih)
+{
+  /* the displayed titles must depend only on the stored values */
+  return ih->handle && !ih->data->callback_mode && !ih->data->numeric_columns && 
+         !IupGetCallback(ih, "TRANSLATEVALUE_CB");
+}
+
 int iupMatrixGetColumnWidth(Ihandle* ih, int col, int use_value)
 {
   int width = 0, pixels = 0;
@@ -784,7 +924,10 @@ int iupMatrixGetColumnWidth(Ihandle* ih, int col, int use_value)
     /* Use the titles to define the size */
     if (col == 0)
     {
-      if (!ih->data->callback_mode || ih->data->use_title_size)
+      int can_cache = iMatrixCanCacheTitleSize(ih);
+      if (can_cache && ih->data->title_width_count == ih->data->values_change_count)
+        width = ih->data->title_width;  /* titles did not change since last time */
+      else if (!ih->data->callback_mode || ih->data->use_title_size)
       {
         /* find the largest title */
         int lin, max_width = 0;
@@ -799,6 +942,12 @@ int iupMatrixGetColumnWidth(Ihandle* ih, int col, int use_value)
           }
         }
         width = max_width;
+
+        if (can_cache)
+        {
+          ih->data->title_width = width;
+          ih->data->title_width_count = ih->data->values_change_count;
+        }
       }
     }
     else if (ih->data->use_title_size && (col > 0 && col < ih->data->columns.num))
@@ -853,7 +1002,10 @@ int iupMatrixGetLineHeight(Ihandle* ih, int lin, int use_value)
     /* Use the titles to define the size */
     if (lin == 0)
     {
-      if (!ih->data->callback_mode || ih->data->use_title_size)
+      int can_cache = iMatrixCanCacheTitleSize(ih);
+      if (can_cache && ih->data->title_height_count == ih->data->values_change_count)
+        height = ih->data->title_height;  /* titles did not change since last time */
+      else if (!ih->data->callback_mode || ih->data->use_title_size)
       {
         /* find the highest title */
         int col, max_height = 0;
@@ -868,6 +1020,12 @@ int iupMatrixGetLineHeight(Ihandle* ih, int lin, int use_value)
           }
         }
         height = max_height;
+
+        if (can_cache)
+        {
+          ih->data->title_height = height;
+          ih->data->title_height_count = ih->data->values_change_count;
+        }
       }
     }
     else if (ih->data->use_title_size && (lin > 0 && lin < ih->data->lines.num))
@@ -1126,19 +1284,114 @@ int iupMatrixGetVisibleCellDim(Ihandle* ih, int lin, int col, int* x, int* y, in
   return visible;
 }
 
+static int iMatrixCompareMergedIndex(const void* elem1, const void* elem2)
+{
+  const ImatMergedIndex* index1 = (const ImatMergedIndex*)elem1;
+  const ImatMergedIndex* index2 = (const ImatMergedIndex*)elem2;
+  return index1->start_lin - index2->start_lin;
+}
+
+static void iMatrixMergeBuildIndex(Ihandle* ih)
+{
+  int merged, i, max_end_lin;
+
+  if (ih->data->merge_index)
+    free(ih->data->merge_index);
+  if (ih->data->merge_line)
+    free(ih->data->merge_line);
+
+  ih->data->merge_index = (ImatMergedIndex*)malloc(ih->data->merge_info_max * sizeof(ImatMergedIndex));
+  ih->data->merge_line = (int*)malloc(ih->data->merge_info_max * sizeof(int));
+
+  i = 0;
+  for (merged = 1; merged <= ih->data->merge_info_max; merged++)
+  {
+    ImatMergedData* merged_data = ih->data->merge_info + (merged - 1);
+    if (merged_data->used)
+    {
+      ih->data->merge_index[i].start_lin = merged_data->start_lin;
+      ih->data->merge_index[i].merged = merged;
+      i++;
+    }
+  }
+  ih->data->merge_index_count = i;
+
+  qsort(ih->data->merge_index, ih->data->merge_index_count, sizeof(ImatMergedIndex), iMatrixCompareMergedIndex);
+
+  max_end_lin = -1;
+  for (i = 0; i < ih->data->merge_index_count; i++)
+  {
+    int end_lin = ih->data->merge_info[ih->data->merge_index[i].merged - 1].end_lin;
+    if (end_lin > max_end_lin)
+      max_end_lin = end_lin;
+    ih->data->merge_index[i].max_end_lin = max_end_lin;
+  }
+
+  ih->data->merge_index_valid = 1;
+  ih->data->merge_line_lin = -1;
+  ih->data->merge_line_count = 0;
+}
+
+static void iMatrixMergeBuildLine(Ihandle* ih, int lin)
+{
+  int i, j, first, last, count = 0;
+  int* merge_line = ih->data->merge_line;
+
+  /* find the last range that starts at or before lin */
+  first = 0;
+  last = ih->data->merge_index_count - 1;
+  while (first <= last)
+  {
+    int mid = (first + last) / 2;
+    if (ih->data->merge_index[mid].start_lin <= lin)
+      first = mid + 1;
+    else
+      last = mid - 1;
+  }
+
+  /* walk back while some previous range can still contain lin */
+  for (i = last; i >= 0 && ih->data->merge_index[i].max_end_lin >= lin; i--)
+  {
+    int merged = ih->data->merge_index[i].merged;
+    ImatMergedData* merged_data = ih->data->merge_info + (merged - 1);
+    if (merged_data->end_lin >= lin)
+    {
+      /* insert sorted by start column, ranges in the same line do not overlap */
+      for (j = count; j > 0 && ih->data->merge_info[merge_line[j - 1] - 1].start_col > merged_data->start_col; j--)
+        merge_line[j] = merge_line[j - 1];
+      merge_line[j] = merged;
+      count++;
+    }
+  }
+
+  ih->data->merge_line_count = count;
+  ih->data->merge_line_lin = lin;
+}
+
+static void iMatrixMergeCheckLine(Ihandle* ih, int lin)
+{
+  if (!ih->data->merge_index_valid)
+    iMatrixMergeBuildIndex(ih);
+
+  if (lin != ih->data->merge_line_lin)
+    iMatrixMergeBuildLine(ih, lin);
+}
+
 int iupMatrixHasMerged(Ihandle* ih, int startLin, int endLin, int startCol, int endCol)
 {
-  int lin, col, merged;
+  int lin, i;
 
   if (!ih->data->merge_info_count)
     return 0;
 
   for (lin = startLin; lin <= endLin; lin++)
   {
-    for (col = startCol; col <= endCol; col++)
+    iMatrixMergeCheckLine(ih, lin);
+
+    for (i = 0; i < ih->data->merge_line_count; i++)
     {
-      merged = iupMatrixGetMerged(ih, lin, col);
-      if (merged)
+      ImatMergedData* merged_data = ih->data->merge_info + (ih->data->merge_line[i] - 1);
+      if (merged_data->start_col <= endCol && merged_data->end_col >= startCol)
         return 1;
     }
   }
@@ -1151,15 +1404,19 @@ static int iMatrixMergeAddRange(Ihandle* ih, int startLin, int endLin, int start
   int merged;
   ImatMergedData* merged_data;
 
+  ih->data->merge_index_valid = 0;
+
   if (!ih->data->merge_info)
   {
     ih->data->merge_info_max = 10;
     ih->data->merge_info = malloc(ih->data->merge_info_max * sizeof(ImatMergedData));
     memset(ih->data->merge_info, 0, ih->data->merge_info_max * sizeof(ImatMergedData));
+    ih->data->merge_info_free = 1;
   }
 
-  /* find an empty slot */
-  for (merged = 1; merged <= ih->data->merge_info_max; merged++)
+  /* find an empty slot, starting at the first that can be empty, 
+     so adding many ranges without removing any does not scan the used slots */
+  for (merged = ih->data->merge_info_free; merged <= ih->data->merge_info_max; merged++)
   {
     if (ih->data->merge_info[merged - 1].used == 0)
     {
@@ -1171,15 +1428,16 @@ static int iMatrixMergeAddRange(Ihandle* ih, int startLin, int endLin, int start
       merged_data->used = 1;
 
       ih->data->merge_info_count++;
+      ih->data->merge_info_free = merged + 1;
 
       return merged;
     }
   }
 
-  /* add more room */
-  ih->data->merge_info_max += 10;
+  /* add more room, geometrically so many ranges can be added fast */
+  ih->data->merge_info_max *= 2;
   ih->data->merge_info = realloc(ih->data->merge_info, ih->data->merge_info_max * sizeof(ImatMergedData));
-  memset(ih->data->merge_info + ih->data->merge_info_max - 10, 0, 10 * sizeof(ImatMergedData));
+  memset(ih->data->merge_info + (merged - 1), 0, (ih->data->merge_info_max - (merged - 1)) * sizeof(ImatMergedData));
 
   merged_data = ih->data->merge_info + (merged - 1);
   merged_data->start_lin = startLin;
@@ -1189,47 +1447,158 @@ static int iMatrixMergeAddRange(Ihandle* ih, int startLin, int endLin, int start
   merged_data->used = 1;
 
   ih->data->merge_info_count++;
+  ih->data->merge_info_free = merged + 1;
 
   return merged;
 }
 
 int iupMatrixGetMerged(Ihandle* ih, int lin, int col)
 {
-  return iupAttribGetIntId2(ih, "MERGED", lin, col);
+  int first, last;
+
+  if (!ih->data->merge_info_count)
+    return 0;
+
+  iMatrixMergeCheckLine(ih, lin);
+
+  /* find the last range that starts at or before col */
+  first = 0;
+  last = ih->data->merge_line_count - 1;
+  while (first <= last)
+  {
+    int mid = (first + last) / 2;
+    if (ih->data->merge_info[ih->data->merge_line[mid] - 1].start_col <= col)
+      first = mid + 1;
+    else
+      last = mid - 1;
+  }
+
+  if (last >= 0)
+  {
+    int merged = ih->data->merge_line[last];
+    if (ih->data->merge_info[merged - 1].end_col >= col)
+      return merged;
+  }
+
+  return 0;
 }
 
 void iupMatrixMergeRange(Ihandle* ih, int startLin, int endLin, int startCol, int endCol)
 {
-  int lin, col;
+  iMatrixMergeAddRange(ih, startLin, endLin, startCol, endCol);
+}
 
-  int merged = iMatrixMergeAddRange(ih, startLin, endLin, startCol, endCol);
+void iupMatrixMergeSplitRange(Ihandle* ih, int merged)
+{
+  ih->data->merge_info[merged - 1].used = 0;
+  ih->data->merge_info_count--;
+  ih->data->merge_index_valid = 0;
 
-  for (lin = startLin; lin <= endLin; lin++)
+  if (merged < ih->data->merge_info_free)
+    ih->data->merge_info_free = merged;
+}
+
+static int iMatrixMergeShift(int *start, int *end, int base, int count, int add)
+{
+  if (add)
   {
-    for (col = startCol; col <= endCol; col++)
+    /* new lines/columns, a range that contains base grows */
+    if (base < *start)
     {
-      iupAttribSetIntId2(ih, "MERGED", lin, col, merged);
+      *start += count;
+      *end += count;
     }
+    else if (base <= *end)
+      *end += count;
   }
-}
+  else
+  {
+    /* removed lines/columns from base to base+count-1 */
+    int del_end = base + count - 1;
+    int before = 0, inside = 0;
 
-void iupMatrixMergeSplitRange(Ihandle* ih, int merged)
-{
-  int lin, col;
-  int startLin, endLin, startCol, endCol;
+    if (base < *start)
+      before = (del_end < *start ? del_end : *start - 1) - base + 1;
 
-  iupMatrixGetMergedRect(ih, merged, &startLin, &endLin, &startCol, &endCol);
+    if (base <= *end && del_end >= *start)
+      inside = (del_end < *end ? del_end : *end) - (base > *start ? base : *start) + 1;
 
-  for (lin = startLin; lin <= endLin; lin++)
+    if (inside == *end - *start + 1)
+      return 0;  /* all removed */
+
+    *start -= before;
+    *end -= before + inside;
+  }
+
+  return 1;
+}
+
+static void iMatrixMergeShift2(Ihandle* ih, int base, int count, int add, int is_lin)
+{
+  int merged;
+  for (merged = 1; merged <= ih->data->merge_info_max; merged++)
   {
-    for (col = startCol; col <= endCol; col++)
+    ImatMergedData* merged_data = ih->data->merge_info + (merged - 1);
+    if (merged_data->used)
     {
-      iupAttribSetId2(ih, "MERGED", lin, col, NULL);
+      int ok;
+
+      if (is_lin)
+        ok = iMatrixMergeShift(&merged_data->start_lin, &merged_data->end_lin, base, count, add);
+      else
+        ok = iMatrixMergeShift(&merged_data->start_col, &merged_data->end_col, base, count, add);
+
+      /* check if not a range anymore */
+      if (!ok || (merged_data->start_lin == merged_data->end_lin &&
+                  merged_data->start_col == merged_data->end_col))
+      {
+        merged_data->used = 0;
+        ih->data->merge_info_count--;
+
+        if (merged < ih->data->merge_info_free)
+          ih->data->merge_info_free = merged;
+      }
     }
   }
 
-  ih->data->merge_info[merged - 1].used = 0;
-  ih->data->merge_info_count--;
+  ih->data->merge_index_valid = 0;
+}
+
+void iupMatrixMergeShiftLines(Ihandle* ih, int base, int count, int add)
+{
+  iMatrixMergeShift2(ih, base, count, add, 1);
+}
+
+void iupMatrixMergeShiftColumns(Ihandle* ih, int base, int count, int add)
+{
+  iMatrixMergeShift2(ih, base, count, add, 0);
+}
+
+void iupMatrixMergeRelease(Ihandle* ih)
+{
+  if (ih->data->merge_info)
+  {
+    free(ih->data->merge_info);
+    ih->data->merge_info = NULL;
+    ih->data->merge_info_max = 0;
+    ih->data->merge_info_count = 0;
+    ih->data->merge_info_free = 0;
+  }
+
+  if (ih->data->merge_index)
+  {
+    free(ih->data->merge_index);
+    ih->data->merge_index = NULL;
+  }
+
+  if (ih->data->merge_line)
+  {
+    free(ih->data->merge_line);
+    ih->data->merge_line = NULL;
+  }
+
+  ih->data->merge_index_count = 0;
+  ih->data->merge_index_valid = 0;
 }
 
 void iupMatrixGetMergedRect(Ihandle *ih, int merged, int *startLin, int *endLin, int *startCol, int *endCol)
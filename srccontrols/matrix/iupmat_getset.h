@@ -57,11 +57,17 @@ int  iupMatrixHasMerged(Ihandle* ih, int startLin, int endLin, int startCol, int
 void iupMatrixMergeRange(Ihandle* ih, int startLin, int endLin, int startCol, int endCol);
 void iupMatrixMergeSplitRange(Ihandle* ih, int merged);
 void iupMatrixGetMergedRect(Ihandle *ih, int merged, int *startLin, int *endLin, int *startCol, int *endCol);
+void iupMatrixMergeShiftLines(Ihandle* ih, int base, int count, int add);
+void iupMatrixMergeShiftColumns(Ihandle* ih, int base, int count, int add);
+void iupMatrixMergeRelease(Ihandle* ih);
 
 int iupMatrixCheckCellPos(Ihandle* ih, int lin, int col);
 
 char* iupMatrixGetNumericFormatDef(Ihandle* ih);
 
+void iupMatrixNumericCacheClear(Ihandle* ih, int col);
+void iupMatrixNumericCacheClearAll(Ihandle* ih);
+
 
 #ifdef __cplusplus
 }
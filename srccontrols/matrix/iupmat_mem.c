@@ -25,6 +25,7 @@
 
 #include "iupmat_def.h"
 #include "iupmat_mem.h"
+#include "iupmat_getset.h"
 
 
 static void iMatrixGetInitialValues(Ihandle* ih)
@@ -113,8 +114,23 @@ void iupMatrixMemRelease(Ihandle* ih)
     ih->data->lines.dt = NULL;
   }
 
+  if (ih->data->columns.pos)
+  {
+    free(ih->data->columns.pos);
+    ih->data->columns.pos = NULL;
+    ih->data->columns.pos_num = 0;
+  }
+
+  if (ih->data->lines.pos)
+  {
+    free(ih->data->lines.pos);
+    ih->data->lines.pos = NULL;
+    ih->data->lines.pos_num = 0;
+  }
+
   if (ih->data->numeric_columns)
   {
+    iupMatrixNumericCacheClearAll(ih);
     free(ih->data->numeric_columns);
     ih->data->numeric_columns = NULL;
   }
@@ -125,13 +141,7 @@ void iupMatrixMemRelease(Ihandle* ih)
     ih->data->sort_line_index = NULL;
   }
 
-  if (ih->data->merge_info)
-  {
-    free(ih->data->merge_info);
-    ih->data->merge_info = NULL;
-    ih->data->merge_info_max = 0;
-    ih->data->merge_info_count = 0;
-  }
+  iupMatrixMergeRelease(ih);
 }
 
 void iupMatrixMemReAllocLines(Ihandle* ih, int old_num, int num, int base)
@@ -165,6 +175,9 @@ void iupMatrixMemReAllocLines(Ihandle* ih, int old_num, int num, int base)
   if (old_num==num)
     return;
 
+  ih->data->lines.pos_num = 0;  /* sizes will be computed again */
+  iupMatrixNumericCacheClearAll(ih);  /* indexed by line */
+
   if (num>old_num) /* ADD */
   {
     diff_num = num-old_num;      /* size of the opened space */
@@ -189,6 +202,8 @@ void iupMatrixMemReAllocLines(Ihandle* ih, int old_num, int num, int base)
 
     /* reset sort indices */
     if (ih->data->sort_has_index) ih->data->sort_has_index = 0;
+
+    ih->data->values_change_count++;
   }
   else /* DEL */
   {
@@ -233,6 +248,8 @@ void iupMatrixMemReAllocLines(Ihandle* ih, int old_num, int num, int base)
 
     /* reset sort indices */
     if (ih->data->sort_has_index) ih->data->sort_has_index = 0;
+
+    ih->data->values_change_count++;
   }
 }
 
@@ -265,6 +282,9 @@ void iupMatrixMemReAllocColumns(Ihandle* ih, int old_num, int num, int base)
   if (old_num==num)
     return;
 
+  ih->data->values_change_count++;
+  ih->data->columns.pos_num = 0;  /* sizes will be computed again */
+
   if (num>old_num) /* ADD */
   {
     /*   even if (old_num-base)>(num-old_num) memmove will correctly copy the memory */
@@ -319,6 +339,13 @@ void iupMatrixMemReAllocColumns(Ihandle* ih, int old_num, int num, int base)
       }
     }
 
+    if (ih->data->numeric_columns)
+    {
+      int col;
+      for(col = base; col < end; col++)
+        iupMatrixNumericCacheClear(ih, col);
+    }
+
     /* move the old data to opened space from end to base */
     /*   even if (num-base)>(old_num-num) memmove will correctly copy the memory */
     if (shift_num)
@@ -30,6 +30,7 @@
 #include "iupmat_numlc.h"
 #include "iupmat_draw.h"
 #include "iupmat_aux.h"
+#include "iupmat_getset.h"
 
 
 /* Always preserve these attributes here because they are actually stored in the hash table.
@@ -87,7 +88,7 @@ static char* imatrix_col_attrib[IMAT_NUM_ATTRIB_COL] = {
   "FRAMEVERTCOLOR",
   "FRAMEHORIZCOLOR"};
 
-#define IMAT_NUM_ATTRIB_CELL 11
+#define IMAT_NUM_ATTRIB_CELL 10
 static char* imatrix_cell_attrib[IMAT_NUM_ATTRIB_CELL] = { 
   "BGCOLOR",   /* all use L:C */
   "FGCOLOR",
@@ -98,8 +99,7 @@ static char* imatrix_cell_attrib[IMAT_NUM_ATTRIB_CELL] = {
   "TOGGLEVALUE",
   "FRAMEHORIZCOLOR",
   "FRAMEVERTCOLOR",
-  "MARK",    /* must be at last */
-  "MERGED"}; /* must be at last */
+  "MARK"};   /* must be at last */
 
 void iupMatrixCopyLinAttributes(Ihandle* ih, int lin1, int lin2)
 {
@@ -163,100 +163,6 @@ void iupMatrixCopyColAttributes(Ihandle* ih, int col1, int col2)
   }
 }
 
-static void iMatrixCheckMergedLin(Ihandle* ih, int lin, int add)
-{
-  int merged;
-  for (merged = 1; merged <= ih->data->merge_info_max; merged++)
-  {
-    ImatMergedData* merged_data = ih->data->merge_info + (merged - 1);
-    if (merged_data->used)
-    {
-      if (add)
-      {
-        /* this is a new line */
-        if (lin < merged_data->start_lin)
-        {
-          merged_data->start_lin++;
-          merged_data->end_lin++;
-        }
-        else if (lin <= merged_data->end_lin)
-          merged_data->end_lin++;
-      }
-      else
-      {
-        /* this line was removed */
-        if (lin < merged_data->start_lin)
-        {
-          /* just move the range */
-          merged_data->start_lin--;
-          merged_data->end_lin--;
-        }
-        else if (lin <= merged_data->end_lin)
-        {
-          /* shrink the range, check if not a range anymore */
-          merged_data->end_lin--;
-
-          if (merged_data->start_lin == merged_data->end_lin &&
-              merged_data->start_col == merged_data->end_col)
-          {
-            merged_data->used = 0;
-            ih->data->merge_info_count--;
-
-            iupAttribSetId2(ih, "MERGED", merged_data->start_lin, merged_data->start_col, NULL);
-          }
-        }
-      }
-    }
-  }
-}
-
-static void iMatrixCheckMergedCol(Ihandle* ih, int col, int add)
-{
-  int merged;
-  for (merged = 1; merged <= ih->data->merge_info_max; merged++)
-  {
-    ImatMergedData* merged_data = ih->data->merge_info + (merged - 1);
-    if (merged_data->used)
-    {
-      if (add)
-      {
-        /* this is a new col */
-        if (col < merged_data->start_col)
-        {
-          merged_data->start_col++;
-          merged_data->end_col++;
-        }
-        else if (col <= merged_data->end_col)
-          merged_data->end_col++;
-      }
-      else
-      {
-        /* this col was removed */
-        if (col < merged_data->start_col)
-        {
-          /* just move the range */
-          merged_data->start_col--;
-          merged_data->end_col--;
-        }
-        else if (col <= merged_data->end_col)
-        {
-          /* shrink the range, check if not a range anymore */
-          merged_data->end_col--;
-
-          if (merged_data->start_lin == merged_data->end_lin &&
-              merged_data->start_col == merged_data->end_col)
-          {
-            merged_data->used = 0;
-            ih->data->merge_info_count--;
-
-            iupAttribSetId2(ih, "MERGED", merged_data->start_lin, merged_data->start_col, NULL);
-          }
-        }
-      }
-    }
-  }
-}
-
 static void iMatrixClearLinAttributes(Ihandle* ih, int lin, int add)
 {
   int a, col, num_attrib_cell;
@@ -271,7 +177,7 @@ static void iMatrixClearLinAttributes(Ihandle* ih, int lin, int add)
 
   num_attrib_cell = IMAT_NUM_ATTRIB_CELL;
   if (add)
-    num_attrib_cell -= 2; /* do not clear MARK and MERGED */
+    num_attrib_cell -= 1; /* do not clear MARK */
 
   for (a = 0; a < num_attrib_cell; a++)
   {
@@ -294,7 +200,7 @@ static void iMatrixClearColAttributes(Ihandle* ih, int col, int add)
 
   num_attrib_cell = IMAT_NUM_ATTRIB_CELL;
   if (add)
-    num_attrib_cell -= 2; /* do not clear MARK and MERGED */
+    num_attrib_cell -= 1; /* do not clear MARK */
 
   for (a = 0; a < num_attrib_cell; a++)
   {
@@ -335,10 +241,7 @@ static void iMatrixUpdateLineAttributes(Ihandle* ih, int base, int count, int ad
 
   /* check if a merged range was changed */
   if (ih->data->merge_info_count)
-  {
-    for (lin = base; lin < base + count; lin++)
-      iMatrixCheckMergedLin(ih, lin, add);
-  }
+    iupMatrixMergeShiftLines(ih, base, count, add);
 }
 
 static void iMatrixUpdateColumnAttributes(Ihandle* ih, int base, int count, int add)
@@ -372,10 +275,7 @@ static void iMatrixUpdateColumnAttributes(Ihandle* ih, int base, int count, int
   }
 
   if (ih->data->merge_info_count)
-  {
-    for (col = base; col < base + count; col++)
-      iMatrixCheckMergedCol(ih, col, add);
-  }
+    iupMatrixMergeShiftColumns(ih, base, count, add);
 }
 
 /**************************************************************************/
@@ -654,21 +654,110 @@ static int iMatrixSetFitToSizeAttrib(Ihandle* ih, const char* value)
   return 0;
 }
 
+typedef struct _ImatFitSample {
+  int len, index;
+} ImatFitSample;
+
+static int iMatrixFitGetSampleLen(const char* value, int height)
+{
+  /* for height the number of lines, for width the number of characters of the longest line */
+  int len = 0, max_len = 0, line_count = 1;
+  while (*value)
+  {
+    if (*value == '\n')
+    {
+      line_count++;
+      len = 0;
+    }
+    else
+    {
+      len++;
+      if (len > max_len)
+        max_len = len;
+    }
+    value++;
+  }
+  return height? line_count: max_len;
+}
+
+static int iMatrixFitGetSamples(Ihandle* ih, int index, int sample_max, ImatFitSample* samples, int height)
+{
+  /* keep the cells with the longest texts, only they will be measured */
+  int i, count = 0, min_pos = 0, num = height? ih->data->columns.num: ih->data->lines.num;
+
+  for (i = 0; i < num; i++)
+  {
+    char* value = height? iupMatrixGetValueDisplay(ih, index, i): iupMatrixGetValueDisplay(ih, i, index);
+    if (value && value[0])
+    {
+      int len = iMatrixFitGetSampleLen(value, height);
+
+      if (count < sample_max)
+      {
+        samples[count].len = len;
+        samples[count].index = i;
+        count++;
+      }
+      else if (len > samples[min_pos].len)
+      {
+        samples[min_pos].len = len;
+        samples[min_pos].index = i;
+      }
+      else
+        continue;
+
+      if (count == sample_max)
+      {
+        int s;
+        min_pos = 0;
+        for (s = 1; s < count; s++)
+        {
+          if (samples[s].len < samples[min_pos].len)
+            min_pos = s;
+        }
+      }
+    }
+  }
+
+  return count;
+}
+
 static void iMatrixFitColText(Ihandle* ih, int col)
 {
   /* find the largest cel in the col */
   int lin, max_width = 0, max;
+  int sample_max = iupAttribGetInt(ih, "FITTOTEXTSAMPLE");
 
-  for (lin = 0; lin < ih->data->lines.num; lin++)
+  if (sample_max > 0 && ih->data->lines.num > sample_max)
   {
-    char* title_value = iupMatrixGetValueDisplay(ih, lin, col);
-    if (title_value && title_value[0])
+    /* measure only the cells with more characters, 
+       the result is approximate for proportional fonts */
+    ImatFitSample* samples = (ImatFitSample*)malloc(sample_max * sizeof(ImatFitSample));
+    int i, count = iMatrixFitGetSamples(ih, col, sample_max, samples, 0);
+
+    for (i = 0; i < count; i++)
     {
       int w;
-      iupdrvFontGetMultiLineStringSize(ih, title_value, &w, NULL);
+      iupdrvFontGetMultiLineStringSize(ih, iupMatrixGetValueDisplay(ih, samples[i].index, col), &w, NULL);
       if (w > max_width)
         max_width = w;
     }
+
+    free(samples);
+  }
+  else
+  {
+    for (lin = 0; lin < ih->data->lines.num; lin++)
+    {
+      char* title_value = iupMatrixGetValueDisplay(ih, lin, col);
+      if (title_value && title_value[0])
+      {
+        int w;
+        iupdrvFontGetMultiLineStringSize(ih, title_value, &w, NULL);
+        if (w > max_width)
+          max_width = w;
+      }
+    }
   }
 
   max = iupAttribGetIntId(ih, "FITMAXWIDTH", col);
@@ -682,17 +771,37 @@ static void iMatrixFitLineText(Ihandle* ih, int line)
 {
   /* find the highest cel in the line */
   int col, max_height = 0, max;
+  int sample_max = iupAttribGetInt(ih, "FITTOTEXTSAMPLE");
 
-  for (col = 0; col < ih->data->columns.num; col++)
+  if (sample_max > 0 && ih->data->columns.num > sample_max)
   {
-    char* title_value = iupMatrixGetValueDisplay(ih, line, col);
-    if (title_value && title_value[0])
+    /* measure only the cells with more lines */
+    ImatFitSample* samples = (ImatFitSample*)malloc(sample_max * sizeof(ImatFitSample));
+    int i, count = iMatrixFitGetSamples(ih, line, sample_max, samples, 1);
+
+    for (i = 0; i < count; i++)
     {
       int h;
-      iupdrvFontGetMultiLineStringSize(ih, title_value, NULL, &h);
+      iupdrvFontGetMultiLineStringSize(ih, iupMatrixGetValueDisplay(ih, line, samples[i].index), NULL, &h);
       if (h > max_height)
         max_height = h;
     }
+
+    free(samples);
+  }
+  else
+  {
+    for (col = 0; col < ih->data->columns.num; col++)
+    {
+      char* title_value = iupMatrixGetValueDisplay(ih, line, col);
+      if (title_value && title_value[0])
+      {
+        int h;
+        iupdrvFontGetMultiLineStringSize(ih, title_value, NULL, &h);
+        if (h > max_height)
+          max_height = h;
+      }
+    }
   }
 
   max = iupAttribGetIntId(ih, "FITMAXHEIGHT", line);
@@ -1416,6 +1525,10 @@ static int iMatrixSetFontAttrib(Ihandle* ih, int lin, int col, const char* value
     if (!iupdrvSetFontAttrib(ih, value))
       return 0;
 
+    /* title sizes depend on the font */
+    ih->data->title_width_count = -1;
+    ih->data->title_height_count = -1;
+
     return 1;
   }
 
@@ -1489,6 +1602,15 @@ static int iMatrixSetMergeSplitAttrib(Ihandle* ih, const char* value)
   return 0;
 }
 
+static char* iMatrixGetMergedAttrib(Ihandle* ih, int lin, int col)
+{
+  int merged = iupMatrixGetMerged(ih, lin, col);
+  if (merged)
+    return iupStrReturnInt(merged);
+  else
+    return NULL;
+}
+
 static char* iMatrixGetMergedStartAttrib(Ihandle* ih, int lin, int col)
 {
   int merged = iupMatrixGetMerged(ih, lin, col);
@@ -1861,6 +1983,8 @@ static int iMatrixCreateMethod(Ihandle* ih, void **params)
   ih->data->mark_lin2 = -1;
   ih->data->mark_col2 = -1;
   ih->data->edit_hide_onfocus = 1;
+  ih->data->title_width_count = -1;
+  ih->data->title_height_count = -1;
 
   return IUP_NOERROR;
 }
@@ -2244,7 +2368,7 @@ Iclass* iupMatrixNewClass(void)
 
   iupClassRegisterAttributeId2(ic, "MERGE", iMatrixGetMergeAttrib, iMatrixSetMergeAttrib, IUPAF_NOT_MAPPED | IUPAF_NO_INHERIT);
   iupClassRegisterAttribute(ic, "MERGESPLIT", NULL, iMatrixSetMergeSplitAttrib, NULL, NULL, IUPAF_WRITEONLY | IUPAF_NOT_MAPPED | IUPAF_NO_INHERIT);
-  iupClassRegisterAttributeId2(ic, "MERGED", NULL, NULL, IUPAF_NO_INHERIT); /* internal, returns the merged range number */
+  iupClassRegisterAttributeId2(ic, "MERGED", iMatrixGetMergedAttrib, NULL, IUPAF_READONLY | IUPAF_NOT_MAPPED | IUPAF_NO_INHERIT); /* internal, returns the merged range number */
   iupClassRegisterAttributeId2(ic, "MERGEDSTART", iMatrixGetMergedStartAttrib, NULL, IUPAF_READONLY | IUPAF_NOT_MAPPED | IUPAF_NO_INHERIT);
   iupClassRegisterAttributeId2(ic, "MERGEDEND", iMatrixGetMergedEndAttrib, NULL, IUPAF_READONLY | IUPAF_NOT_MAPPED | IUPAF_NO_INHERIT);
 
@@ -2275,6 +2399,7 @@ Iclass* iupMatrixNewClass(void)
   iupClassRegisterAttributeId(ic, "RASTERHEIGHT", iMatrixGetRasterHeightAttrib, iMatrixSetSizeAttrib, IUPAF_NOT_MAPPED | IUPAF_NO_INHERIT);
   iupClassRegisterAttribute(ic, "FITTOSIZE", NULL, iMatrixSetFitToSizeAttrib, NULL, NULL, IUPAF_NOT_MAPPED | IUPAF_WRITEONLY | IUPAF_NO_INHERIT);
   iupClassRegisterAttribute(ic, "FITTOTEXT", NULL, iMatrixSetFitToTextAttrib, NULL, NULL, IUPAF_NOT_MAPPED | IUPAF_WRITEONLY | IUPAF_NO_INHERIT);
+  iupClassRegisterAttribute(ic, "FITTOTEXTSAMPLE", NULL, NULL, NULL, NULL, IUPAF_NOT_MAPPED | IUPAF_NO_INHERIT);
   iupClassRegisterAttributeId(ic, "FITMAXHEIGHT", NULL, NULL, IUPAF_NO_INHERIT);
   iupClassRegisterAttributeId(ic, "FITMAXWIDTH", NULL, NULL, IUPAF_NO_INHERIT);
   iupClassRegisterAttributeId(ic, "COPYLIN", NULL, iMatrixSetCopyLinAttrib, IUPAF_WRITEONLY | IUPAF_NO_INHERIT);
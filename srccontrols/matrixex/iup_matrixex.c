@@ -199,6 +199,12 @@ static int iMatrixExItemExport_CB(Ihandle* ih_item)
     info = "HTML file (table format)";
     extfilter = "HTML file (table format)|*.html;*.htm|All Files|*.*|";
   }
+  else if (iupStrEqual(IupGetAttribute(ih_item, "FILEFORMAT"), "CSV"))
+  {
+    filter = "*.csv";
+    info = "CSV file (comma separated values)";
+    extfilter = "CSV file (comma separated values)|*.csv|All Files|*.*|";
+  }
   else
   {
     filter = "*.txt";
@@ -677,6 +683,7 @@ static Ihandle* iMatrixExCreateMenuContext(Ihandle* ih, int lin, int col)
         IupSetCallbacks(IupSetAttributes(IupItem("Txt..." , NULL), "FILEFORMAT=TXT"),    "ACTION", iMatrixExItemExport_CB, NULL),
         IupSetCallbacks(IupSetAttributes(IupItem("LaTeX...", NULL), "FILEFORMAT=LaTeX"), "ACTION", iMatrixExItemExport_CB, NULL),
         IupSetCallbacks(IupSetAttributes(IupItem("Html..." , NULL), "FILEFORMAT=HTML"),  "ACTION", iMatrixExItemExport_CB, NULL),
+        IupSetCallbacks(IupSetAttributes(IupItem("Csv..."  , NULL), "FILEFORMAT=CSV"),   "ACTION", iMatrixExItemExport_CB, NULL),
         NULL)), "IMAGE=IUP_FileOpen"));
 
   if (!readonly)
@@ -835,6 +842,12 @@ static int iMatrixExSetShowDialogAttrib(Ihandle *ih, const char* value)
     iMatrixExItemExport_CB(ih);
     IupSetAttribute(ih, "FILEFORMAT", NULL);
   }
+  else if (iupStrEqualNoCase(value, "EXPORT_CSV"))
+  {
+    IupSetAttribute(ih, "FILEFORMAT", "CSV");
+    iMatrixExItemExport_CB(ih);
+    IupSetAttribute(ih, "FILEFORMAT", NULL);
+  }
   else if (!readonly && iupStrEqualNoCase(value, "IMPORT_TXT"))
     iMatrixExItemImport_CB(ih);
   else if (!readonly && iupStrEqualNoCase(value, "UNDOLIST"))
@@ -1062,6 +1075,8 @@ static void iMatrixExDestroyMethod(Ihandle* ih)
   if (matex_data->find_dlg)
     IupDestroy(matex_data->find_dlg);
 
+  iupMatrixExFindReleaseIndex(matex_data);
+
   if (matex_data->undo_stack)
   {
     iupAttribSetClassObject(ih, "UNDOCLEAR", NULL);
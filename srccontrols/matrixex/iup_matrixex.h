@@ -24,6 +24,7 @@ typedef struct _ImatExData
   Ihandle* busy_progress_dlg;
 
   Ihandle* find_dlg;
+  struct _ImatExFindIndex* find_index;
 
   Iarray* undo_stack;
   int undo_stack_pos;
@@ -32,6 +33,7 @@ typedef struct _ImatExData
 
 /* Busy */
 void iupMatrixExBusyStart(ImatExData* matex_data, int count, const char* busyname);
+void iupMatrixExBusyStartReadOnly(ImatExData* matex_data, int count, const char* busyname);
 int iupMatrixExBusyInc(ImatExData* matex_data);
 void iupMatrixExBusyEnd(ImatExData* matex_data);
 
@@ -45,6 +47,7 @@ void iupMatrixExSortShowDialog(ImatExData* matex_data);
 
 /* Find */
 void iupMatrixExFindShowDialog(ImatExData* matex_data);
+void iupMatrixExFindReleaseIndex(ImatExData* matex_data);
 
 /* Visible */
 int iupMatrixExIsColumnVisible(Ihandle* ih, int col);
@@ -67,6 +70,7 @@ void iupMatrixExRegisterSort(Iclass* ic);
 /* Implemented in IupMatrix */
 char* iupMatrixExGetCellValue(Ihandle* ih, int lin, int col, int display);
 void  iupMatrixExSetCellValue(Ihandle* ih, int lin, int col, const char* value);  /* NO numeric conversion */
+int   iupMatrixExGetValuesChangeCount(Ihandle* ih);
 
 
 #ifdef __cplusplus
@@ -68,7 +68,7 @@ static void iMatrixExBusyShowProgress(ImatExData* matex_data, int count, const c
   IupShowXY(matex_data->busy_progress_dlg, x, y);
 }
 
-void iupMatrixExBusyStart(ImatExData* matex_data, int count, const char* busyname)
+static void iMatrixExBusyStart(ImatExData* matex_data, int count, const char* busyname, int undo)
 {
   /* can not start a new one if already busy */
   iupASSERT(!matex_data->busy);
@@ -94,13 +94,24 @@ void iupMatrixExBusyStart(ImatExData* matex_data, int count, const char* busynam
     matex_data->busy = 2;
   }
 
-  if (iupStrBoolean(iupAttribGetClassObject(matex_data->ih, "UNDOREDO")))
+  if (undo && iupStrBoolean(iupAttribGetClassObject(matex_data->ih, "UNDOREDO")))
   {
     matex_data->busy_undo_block = 1;
     iupMatrixExUndoPushBegin(matex_data, busyname);
   }
 }
 
+void iupMatrixExBusyStart(ImatExData* matex_data, int count, const char* busyname)
+{
+  iMatrixExBusyStart(matex_data, count, busyname, 1);
+}
+
+void iupMatrixExBusyStartReadOnly(ImatExData* matex_data, int count, const char* busyname)
+{
+  /* for operations that do not change the cells, so no undo block is created */
+  iMatrixExBusyStart(matex_data, count, busyname, 0);
+}
+
 int iupMatrixExBusyInc(ImatExData* matex_data)
 {
   if (matex_data->busy)
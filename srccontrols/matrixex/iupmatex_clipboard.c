@@ -136,7 +136,7 @@ static int iMatrixExMarkedCellConsistent(const char* marked, int num_lin, int nu
 static void iMatrixExArrayAddChar(Iarray* data, char c)
 {
   int last_count = iupArrayCount(data);
-  char* str_data = (char*)iupArrayInc(data);
+  char* str_data = (char*)iupArrayAdd(data, 1);
   str_data[last_count] = c;
 }
 
@@ -154,23 +154,33 @@ static void iMatrixExArrayAddCell(ImatExData* matex_data, Iarray* data, int lin,
 
   if (value)
   {
-    int add_sep = 0;
     if (strchr(value, sep))
-      add_sep = 1;
-
-    if (add_sep)
-      iMatrixExArrayAddChar(data, '\"');
-
-    iMatrixExArrayAddStr(data, value);
-
-    if (add_sep)
-      iMatrixExArrayAddChar(data, '\"');
+    {
+      int add_count = (int)strlen(value);
+      int last_count = iupArrayCount(data);
+      char* str_data = (char*)iupArrayAdd(data, add_count + 2);
+      str_data[last_count] = '\"';
+      memcpy(str_data + last_count + 1, value, add_count);
+      str_data[last_count + 1 + add_count] = '\"';
+    }
+    else
+      iMatrixExArrayAddStr(data, value);
   }
   else
     iMatrixExArrayAddChar(data, ' ');
 }
 
-static void iMatrixExCopyGetDataMarkedCol(ImatExData* matex_data, Iarray* data, const char* marked, int num_lin, int num_col, char sep)
+static char* iMatrixExGetVisibleColumns(Ihandle* ih, int num_col)
+{
+  /* check the visibility only once for each column */
+  char* col_visible = (char*)malloc(num_col + 1);
+  int col;
+  for (col = 0; col <= num_col; col++)
+    col_visible[col] = (char)iupMatrixExIsColumnVisible(ih, col);
+  return col_visible;
+}
+
+static void iMatrixExCopyGetDataMarkedCol(ImatExData* matex_data, Iarray* data, const char* marked, int num_lin, int num_col, char sep, const char* col_visible)
 {
   int lin, col;
   int add_sep;
@@ -184,7 +194,7 @@ static void iMatrixExCopyGetDataMarkedCol(ImatExData* matex_data, Iarray* data,
       for(col = 1; col <= num_col; ++col)
       {
         /* only marked columns */
-        if (marked[col-1] == '1' && iupMatrixExIsColumnVisible(matex_data->ih, col))
+        if (marked[col-1] == '1' && col_visible[col])
         {
           if (add_sep)
             iMatrixExArrayAddChar(data, sep);
@@ -199,7 +209,7 @@ static void iMatrixExCopyGetDataMarkedCol(ImatExData* matex_data, Iarray* data,
   }
 }
 
-static void iMatrixExCopyGetDataMarkedLin(ImatExData* matex_data, Iarray* data, const char* marked, int num_lin, int num_col, char sep)
+static void iMatrixExCopyGetDataMarkedLin(ImatExData* matex_data, Iarray* data, const char* marked, int num_lin, int num_col, char sep, const char* col_visible)
 {
   int lin, col;
   int add_sep;
@@ -213,7 +223,7 @@ static void iMatrixExCopyGetDataMarkedLin(ImatExData* matex_data, Iarray* data,
     {
       for(col = 1; col <= num_col; ++col)    /* all columns */
       {
-        if (iupMatrixExIsColumnVisible(matex_data->ih, col))
+        if (col_visible[col])
         {
           if (add_sep)
             iMatrixExArrayAddChar(data, sep);
@@ -228,7 +238,7 @@ static void iMatrixExCopyGetDataMarkedLin(ImatExData* matex_data, Iarray* data,
   }
 }
 
-static void iMatrixExCopyGetDataMarkedCell(ImatExData* matex_data, Iarray* data, const char* marked, int lin1, int col1, int lin2, int col2, int num_col, int keep_struct, char sep)
+static void iMatrixExCopyGetDataMarkedCell(ImatExData* matex_data, Iarray* data, const char* marked, int lin1, int col1, int lin2, int col2, int num_col, int keep_struct, char sep, const char* col_visible)
 {
   int lin, col;
   int add_sep;
@@ -241,7 +251,7 @@ static void iMatrixExCopyGetDataMarkedCell(ImatExData* matex_data, Iarray* data,
     {
       for(col = col1; col <= col2; ++col)
       {
-        if (iupMatrixExIsColumnVisible(matex_data->ih, col))
+        if (col_visible[col])
         {
           int pos = (lin - 1) * num_col + (col - 1);  /* marked array does not include titles */
           if (marked[pos] == '1')
@@ -268,7 +278,7 @@ static void iMatrixExCopyGetDataMarkedCell(ImatExData* matex_data, Iarray* data,
   }
 }
 
-static void iMatrixExCopyGetData(ImatExData* matex_data, Iarray* data, int lin1, int col1, int lin2, int col2, char sep)
+static void iMatrixExCopyGetData(ImatExData* matex_data, Iarray* data, int lin1, int col1, int lin2, int col2, char sep, const char* col_visible)
 {
   int lin, col;
   int add_sep;
@@ -281,7 +291,7 @@ static void iMatrixExCopyGetData(ImatExData* matex_data, Iarray* data, int lin1,
     {
       for(col = col1; col <= col2; ++col)
       {
-        if (iupMatrixExIsColumnVisible(matex_data->ih, col))
+        if (col_visible[col])
         {
           if (add_sep)
             iMatrixExArrayAddChar(data, sep);
@@ -300,7 +310,7 @@ static void iMatrixExCopyGetData(ImatExData* matex_data, Iarray* data, int lin1,
 static void iMatrixExCopyData(ImatExData* matex_data, Iarray* data, const char* value)
 {
   int num_lin, num_col;
-  char sep;
+  char sep, *col_visible;
 
   if (!value)
     return;
@@ -313,12 +323,15 @@ static void iMatrixExCopyData(ImatExData* matex_data, Iarray* data, const char*
   num_lin = IupGetInt(matex_data->ih, "NUMLIN");
   num_col = IupGetInt(matex_data->ih, "NUMCOL");
 
+  col_visible = iMatrixExGetVisibleColumns(matex_data->ih, num_col);
+
   if (iupStrEqualNoCase(value, "MARKED"))
   {
     char *marked = IupGetAttribute(matex_data->ih,"MARKED");
     if (!marked)  /* no marked cells */
     {
       iupAttribSet(matex_data->ih, "LASTERROR", "IUP_ERRORNOSELECTION");
+      free(col_visible);
       return;
     }
 
@@ -326,13 +339,13 @@ static void iMatrixExCopyData(ImatExData* matex_data, Iarray* data, const char*
     {
       marked++;
 
-      iMatrixExCopyGetDataMarkedCol(matex_data, data, marked, num_lin, num_col, sep);
+      iMatrixExCopyGetDataMarkedCol(matex_data, data, marked, num_lin, num_col, sep, col_visible);
     }
     else if (*marked == 'L')
     {
       marked++;
 
-      iMatrixExCopyGetDataMarkedLin(matex_data, data, marked, num_lin, num_col, sep);
+      iMatrixExCopyGetDataMarkedLin(matex_data, data, marked, num_lin, num_col, sep, col_visible);
     }
     else
     {
@@ -345,10 +358,11 @@ static void iMatrixExCopyData(ImatExData* matex_data, Iarray* data, const char*
       if (!keep_struct && !iMatrixExMarkedCellConsistent(marked, num_lin, num_col))
       {
         iupAttribSet(matex_data->ih, "LASTERROR", "IUP_ERRORINVALIDSELECTION");
+        free(col_visible);
         return;
       }
 
-      iMatrixExCopyGetDataMarkedCell(matex_data, data, marked, lin1, col1, lin2, col2, num_col, keep_struct, sep);
+      iMatrixExCopyGetDataMarkedCell(matex_data, data, marked, lin1, col1, lin2, col2, num_col, keep_struct, sep, col_visible);
     }
   }
   else 
@@ -363,14 +377,16 @@ static void iMatrixExCopyData(ImatExData* matex_data, Iarray* data, const char*
       iupMatrixExCheckLimitsOrder(&col1, &col2, 1, num_col);
     }
 
-    iMatrixExCopyGetData(matex_data, data, lin1, col1, lin2, col2, sep);
+    iMatrixExCopyGetData(matex_data, data, lin1, col1, lin2, col2, sep, col_visible);
   }
+
+  free(col_visible);
 }
 
 static int iMatrixExSetCopyAttrib(Ihandle *ih, const char* value)
 {
   ImatExData* matex_data = (ImatExData*)iupAttribGet(ih, "_IUP_MATEX_DATA");
-  Iarray* data =  iupArrayCreate(100, sizeof(char));
+  Iarray* data =  iupArrayCreate(4096, sizeof(char));
 
   iMatrixExCopyData(matex_data, data, value);
 
@@ -397,7 +413,7 @@ static int iMatrixExSetCopyDataAttrib(Ihandle *ih, const char* value)
   else
   {
     ImatExData* matex_data = (ImatExData*)iupAttribGet(ih, "_IUP_MATEX_DATA");
-    Iarray* data =  iupArrayCreate(100, sizeof(char));
+    Iarray* data =  iupArrayCreate(4096, sizeof(char));
 
     iMatrixExCopyData(matex_data, data, value);
 
@@ -413,38 +429,82 @@ static int iMatrixExSetCopyDataAttrib(Ihandle *ih, const char* value)
   return 0;
 }
 
-static int iMatrixExStrGetDataSize(const char* data, int *num_lin, int *num_col, char *sep)
+/* Size of the pasted data, computed in a single pass over the lines, 
+   so it can also be computed for data read from a file in blocks. */
+typedef struct _ImatExPasteSize
+{
+  char sep;           /* TEXTSEPARATOR, or 0 to guess */
+  int line_ends;      /* number of line ends */
+  int sep_count, tab_count, semicolon_count, space_count;
+  char last, before_last;   /* last two characters of the data */
+  int has_data;
+} ImatExPasteSize;
+
+static void iMatrixExPasteSizeAddLine(ImatExPasteSize* size, const char* line, int len, int raw_len)
+{
+  int i;
+
+  for (i = 0; i < len; i++)
+  {
+    char c = line[i];
+    if (c == size->sep) size->sep_count++;
+    if (c == '\t') size->tab_count++;
+    else if (c == ';') size->semicolon_count++;
+    else if (c == ' ') size->space_count++;
+  }
+
+  if (raw_len > len)
+    size->line_ends++;
+
+  if (raw_len >= 2)
+  {
+    size->before_last = line[raw_len - 2];
+    size->last = line[raw_len - 1];
+  }
+  else if (raw_len == 1)
+  {
+    size->before_last = size->last;
+    size->last = line[0];
+  }
+
+  if (raw_len)
+    size->has_data = 1;
+}
+
+static int iMatrixExPasteSizeGet(ImatExPasteSize* size, int *num_lin, int *num_col, char *sep)
 {
-  int len = (int)strlen(data);
-  *num_lin = iupStrLineCount(data, len);
-  if (data[len-1] == '\n')
+  *num_lin = size->line_ends + 1;
+  if (size->last == '\n')
     (*num_lin)--;  /* avoid an empty last line */
 
   if (*num_lin == 0)
     return 0;
 
-  if (*sep != 0)
-    *num_col = iupStrCountChar(data, *sep);
+  if (size->sep != 0)
+  {
+    *sep = size->sep;
+    *num_col = size->sep_count;
+  }
   else
   {
     /* try to guess the separator */
     *sep = '\t';
-    *num_col = iupStrCountChar(data, *sep);
+    *num_col = size->tab_count;
     if (*num_col == 0)
     {
       *sep = ';';
-      *num_col = iupStrCountChar(data, *sep);
+      *num_col = size->semicolon_count;
     }
     if (*num_col == 0)
     {
       *sep = ' ';
-      *num_col = iupStrCountChar(data, *sep);
+      *num_col = size->space_count;
     }
   }
 
   /* If there is no column separator for the last column, so add it */
-  if (!((data[len-1] == '\n' && data[len-2] == *sep) ||
-        (data[len-1] == *sep)))
+  if (!((size->last == '\n' && size->before_last == *sep) ||
+        (size->last == *sep)))
     *num_col += *num_lin;
 
   if (*num_col == 0)
@@ -457,9 +517,143 @@ static int iMatrixExStrGetDataSize(const char* data, int *num_lin, int *num_col,
   return 1;
 }
 
+static int iMatrixExStrGetDataSize(const char* data, int *num_lin, int *num_col, char *sep)
+{
+  ImatExPasteSize size;
+  memset(&size, 0, sizeof(ImatExPasteSize));
+  size.sep = *sep;
+
+  while (*data)
+  {
+    int len;
+    const char* next_line = iupStrNextLine(data, &len);
+    iMatrixExPasteSizeAddLine(&size, data, len, (int)(next_line - data));
+    data = next_line;
+  }
+
+  return iMatrixExPasteSizeGet(&size, num_lin, num_col, sep);
+}
+
+/* Reads a file in blocks and returns one line at a time,
+   only the current block and the incomplete line are kept in memory. */
+#define IMATEX_READ_BLOCK_SIZE (256*1024)
+
+typedef struct _ImatExFileReader
+{
+  FILE* file;
+  char* buffer;
+  int buffer_size;
+  int pos, count;   /* data not returned yet is from pos to count, buffer[count] is always 0 */
+  int eof;
+} ImatExFileReader;
+
+static void iMatrixExFileReaderRewind(ImatExFileReader* reader)
+{
+  fseek(reader->file, 0, SEEK_SET);
+  reader->pos = 0;
+  reader->count = 0;
+  reader->eof = 0;
+  reader->buffer[0] = 0;
+}
+
+static int iMatrixExFileReaderOpen(ImatExFileReader* reader, const char* filename)
+{
+  reader->file = fopen(filename, "rb");
+  if (!reader->file)
+    return 0;
+
+  reader->buffer_size = IMATEX_READ_BLOCK_SIZE + 1;
+  reader->buffer = (char*)malloc(reader->buffer_size);
+  if (!reader->buffer)
+  {
+    fclose(reader->file);
+    return 0;
+  }
+
+  iMatrixExFileReaderRewind(reader);
+  return 1;
+}
+
+static void iMatrixExFileReaderClose(ImatExFileReader* reader)
+{
+  free(reader->buffer);
+  fclose(reader->file);
+}
+
+static const char* iMatrixExFileReaderNextLine(ImatExFileReader* reader, int *len, int *raw_len)
+{
+  for (;;)
+  {
+    char* line = reader->buffer + reader->pos;
+    int avail = reader->count - reader->pos;
+    int read_count;
+    const char* next_line = iupStrNextLine(line, len);
+
+    if (*len < avail && line[*len] == 0)
+    {
+      /* a NUL character ends the data, as for data in memory */
+      reader->count = reader->pos + *len;
+      reader->eof = 1;
+      avail = *len;
+    }
+
+    /* a complete line, a '\r' at the end of the buffer can be the start of a DOS line end */
+    if (*len < avail && 
+        !(reader->eof == 0 && line[*len] == '\r' && *len + 1 == avail))
+    {
+      *raw_len = (int)(next_line - line);
+      reader->pos += *raw_len;
+      return line;
+    }
+
+    if (reader->eof)
+    {
+      if (avail == 0)
+        return NULL;
+
+      /* last line without a line end */
+      *raw_len = avail;
+      reader->pos = reader->count;
+      return line;
+    }
+
+    /* move the incomplete line to the start of the buffer and read the next block after it */
+    memmove(reader->buffer, line, avail);
+    reader->pos = 0;
+    reader->count = avail;
+
+    if (reader->count + IMATEX_READ_BLOCK_SIZE + 1 > reader->buffer_size)
+    {
+      char* buffer;
+      reader->buffer_size = reader->count + IMATEX_READ_BLOCK_SIZE + 1;
+      buffer = (char*)realloc(reader->buffer, reader->buffer_size);
+      if (!buffer)
+        return NULL;
+      reader->buffer = buffer;
+    }
+
+    read_count = (int)fread(reader->buffer + reader->count, 1, IMATEX_READ_BLOCK_SIZE, reader->file);
+    reader->count += read_count;
+    reader->buffer[reader->count] = 0;
+    if (read_count < IMATEX_READ_BLOCK_SIZE)
+      reader->eof = 1;
+  }
+}
+
+static int iMatrixExFileReaderSkipLines(ImatExFileReader* reader, int skip_lines)
+{
+  int i, len, raw_len;
+  for (i = 0; i < skip_lines; i++)
+  {
+    if (!iMatrixExFileReaderNextLine(reader, &len, &raw_len))
+      return 0;
+  }
+  return 1;
+}
+
 static char* iMatrixExStrCopyData(char* value, int *value_max_size, const char* data, int value_len)
 {
-  if (*value_max_size < value_len)
+  if (*value_max_size <= value_len)  /* includes the terminator */
   {
     *value_max_size = value_len+10;
     value = realloc(value, *value_max_size);
@@ -469,75 +663,135 @@ static char* iMatrixExStrCopyData(char* value, int *value_max_size, const char*
   return value;
 }
 
-static void iMatrixExPasteSetData(Ihandle *ih, const char* data, int data_num_lin, int data_num_col, char sep, int start_lin, int start_col, int num_lin, int num_col, const char* busyname)
+/* State of a paste operation, lines are set one at a time */
+typedef struct _ImatExPaste
 {
-  ImatExData* matex_data = (ImatExData*)iupAttribGet(ih, "_IUP_MATEX_DATA");
-  int lin, col, len, l, c;
-  char* value = NULL;
-  int value_max_size = 0, value_len;
+  ImatExData* matex_data;
+  char sep;
+  int data_num_col;
+  int start_col, num_lin, num_col;
+  int lin;             /* next line in the matrix */
+  char* col_visible;
+  char* value;
+  int value_max_size;
+} ImatExPaste;
+
+static int iMatrixExPasteBegin(ImatExPaste* paste, Ihandle *ih, int data_num_lin, int data_num_col, char sep, int start_lin, int start_col, int num_lin, int num_col, const char* busyname)
+{
+  /* no cell can be changed, so avoid parsing the data */
+  if (iupAttribGetBoolean(ih, "READONLY"))
+    return 0;
 
-  iupMatrixExBusyStart(matex_data, data_num_lin*data_num_col, busyname);
+  paste->matex_data = (ImatExData*)iupAttribGet(ih, "_IUP_MATEX_DATA");
+  paste->sep = sep;
+  paste->data_num_col = data_num_col;
+  paste->start_col = start_col;
+  paste->num_lin = num_lin;
+  paste->num_col = num_col;
+  paste->lin = start_lin;
+  paste->col_visible = iMatrixExGetVisibleColumns(ih, num_col);
+  paste->value = NULL;
+  paste->value_max_size = 0;
+
+  /* progress is updated by line, 
+     values are set in the cells without a redraw, there is a single redraw at the end */
+  iupMatrixExBusyStart(paste->matex_data, data_num_lin, busyname);
+  return 1;
+}
 
-  lin = start_lin;
-  l = 0;
-  while (lin <= num_lin && l<data_num_lin && *data)
+static void iMatrixExPasteRelease(ImatExPaste* paste)
+{
+  if (paste->value)
+    free(paste->value);
+  free(paste->col_visible);
+}
+
+static void iMatrixExPasteEnd(ImatExPaste* paste)
+{
+  iupMatrixExBusyEnd(paste->matex_data);
+
+  iMatrixExPasteRelease(paste);
+
+  iupBaseCallValueChangedCb(paste->matex_data->ih);
+}
+
+/* returns 1 to continue, 0 if there are no more lines in the matrix, -1 if aborted */
+static int iMatrixExPasteSetLine(ImatExPaste* paste, const char* data, int len)
+{
+  Ihandle* ih = paste->matex_data->ih;
+  int col, c, value_len;
+
+  while (paste->lin <= paste->num_lin && !iupMatrixExIsLineVisible(ih, paste->lin))
+    paste->lin++;
+
+  if (paste->lin > paste->num_lin)
+    return 0;
+
+  col = paste->start_col;
+  c = 0;
+  while (len && col <= paste->num_col && c < paste->data_num_col)
   {
-    if (iupMatrixExIsLineVisible(ih, lin))
+    if (paste->col_visible[col])
     {
-      const char* next_line = iupStrNextLine(data, &len); l++;
+      const char* next_value = iupStrNextValue(data, len, &value_len, paste->sep);  c++;
 
-      col = start_col;
-      c = 0;
-      while (len && col <= num_col && c<data_num_col)
+      if (value_len)
       {
-        if (iupMatrixExIsColumnVisible(ih, col))
+        if (data[0] == '\"' && data[value_len - 1] == '\"')
         {
-          const char* next_value = iupStrNextValue(data, len, &value_len, sep);  c++;
-
-          if (value_len)
-          {
-            if (data[0] == '\"' && data[value_len - 1] == '\"')
-            {
-              data++;
-              value_len -= 2;
-              len -= 2;
-            }
-
-            if (value_len)
-            {
-              value = iMatrixExStrCopyData(value, &value_max_size, data, value_len);
-              iupMatrixExSetCellValue(matex_data->ih, lin, col, value);
-            }
-          }
-          else
-            iupMatrixExSetCellValue(matex_data->ih, lin, col, "");
-
-          data = next_value;
-          len -= value_len+1;
-
-          if (!iupMatrixExBusyInc(matex_data))
-          {
-            if (value) 
-              free(value);
-            return;
-          }
+          data++;
+          value_len -= 2;
+          len -= 2;
         }
 
-        col++;
+        if (value_len)
+        {
+          paste->value = iMatrixExStrCopyData(paste->value, &(paste->value_max_size), data, value_len);
+          iupMatrixExSetCellValue(ih, paste->lin, col, paste->value);
+        }
       }
+      else
+        iupMatrixExSetCellValue(ih, paste->lin, col, "");
 
-      data = next_line;
+      data = next_value;
+      len -= value_len+1;
     }
 
-    lin++;
+    col++;
   }
 
-  iupMatrixExBusyEnd(matex_data);
+  paste->lin++;
 
-  if (value)
-    free(value);
+  if (!iupMatrixExBusyInc(paste->matex_data))
+    return -1;
+
+  return 1;
+}
+
+static void iMatrixExPasteSetData(Ihandle *ih, const char* data, int data_num_lin, int data_num_col, char sep, int start_lin, int start_col, int num_lin, int num_col, const char* busyname)
+{
+  ImatExPaste paste;
+  int len, l = 0;
+
+  if (!iMatrixExPasteBegin(&paste, ih, data_num_lin, data_num_col, sep, start_lin, start_col, num_lin, num_col, busyname))
+    return;
+
+  while (l < data_num_lin && *data)
+  {
+    const char* next_line = iupStrNextLine(data, &len);
+    int ret = iMatrixExPasteSetLine(&paste, data, len);  l++;
+    if (ret == -1)
+    {
+      iMatrixExPasteRelease(&paste);
+      return;
+    }
+    if (ret == 0)
+      break;
+
+    data = next_line;
+  }
 
-  iupBaseCallValueChangedCb(matex_data->ih);
+  iMatrixExPasteEnd(&paste);
 }
 
 static int iMatrixExGetVisibleNumLin(Ihandle *ih, int start_lin, int data_num_lin)
@@ -562,12 +816,48 @@ static int iMatrixExGetVisibleNumCol(Ihandle *ih, int start_col, int data_num_co
   return vis_num_col;
 }
 
+static int iMatrixExPasteCheckSize(Ihandle *ih, int lin, int col, int data_num_lin, int data_num_col, int *num_lin, int *num_col)
+{
+  IFnii pastesize_cb;
+
+  *num_lin = IupGetInt(ih, "NUMLIN");
+  *num_col = IupGetInt(ih, "NUMCOL");
+
+  pastesize_cb = (IFnii)IupGetCallback(ih, "PASTESIZE_CB");
+  if (pastesize_cb)
+  {
+    int vis_num_lin = iMatrixExGetVisibleNumLin(ih, lin, data_num_lin);
+    int vis_num_col = iMatrixExGetVisibleNumCol(ih, col, data_num_col);
+    if (lin+vis_num_lin>*num_lin ||
+        col+vis_num_col>*num_col)
+    {
+      int ret = pastesize_cb(ih, lin+vis_num_lin, col+vis_num_col);
+      if (ret == IUP_IGNORE)
+        return 0;
+      else if (ret == IUP_CONTINUE)
+      {
+        if (lin+vis_num_lin>*num_lin) IupSetInt(ih, "NUMLIN", lin+vis_num_lin);
+        if (col+vis_num_col>*num_col) IupSetInt(ih, "NUMCOL", col+vis_num_col);
+      }
+    }
+  }
+
+  return 1;
+}
+
+static char iMatrixExGetTextSeparator(Ihandle *ih)
+{
+  char* str_sep = iupAttribGet(ih, "TEXTSEPARATOR");  /* don't check for the default value */
+  if (str_sep) 
+    return *str_sep;
+  return 0;
+}
+
 static void iMatrixExPasteData(Ihandle *ih, const char* data, int lin, int col, const char* busyname)
 {
   int num_lin, num_col, skip_lines,
       data_num_lin, data_num_col;
-  char sep=0, *str_sep;
-  IFnii pastesize_cb;
+  char sep;
 
   /* reset error state */
   iupAttribSet(ih, "LASTERROR", NULL);
@@ -590,15 +880,14 @@ static void iMatrixExPasteData(Ihandle *ih, const char* data, int lin, int col,
       data = (char*)next_line;
     }
 
-    if (i != skip_lines)
+    if (i != skip_lines || *data == 0)
     {
       iupAttribSet(ih, "LASTERROR", "IUP_ERRORNOTEXT");
       return;
     }
   }
 
-  str_sep = iupAttribGet(ih, "TEXTSEPARATOR");  /* don't check for the default value */
-  if (str_sep) sep = *str_sep;
+  sep = iMatrixExGetTextSeparator(ih);
 
   if (!iMatrixExStrGetDataSize(data, &data_num_lin, &data_num_col, &sep))
   {
@@ -606,27 +895,8 @@ static void iMatrixExPasteData(Ihandle *ih, const char* data, int lin, int col,
     return;
   }
 
-  num_lin = IupGetInt(ih, "NUMLIN");
-  num_col = IupGetInt(ih, "NUMCOL");
-
-  pastesize_cb = (IFnii)IupGetCallback(ih, "PASTESIZE_CB");
-  if (pastesize_cb)
-  {
-    int vis_num_lin = iMatrixExGetVisibleNumLin(ih, lin, data_num_lin);
-    int vis_num_col = iMatrixExGetVisibleNumCol(ih, col, data_num_col);
-    if (lin+vis_num_lin>num_lin ||
-        col+vis_num_col>num_col)
-    {
-      int ret = pastesize_cb(ih, lin+vis_num_lin, col+vis_num_col);
-      if (ret == IUP_IGNORE)
-        return;
-      else if (ret == IUP_CONTINUE)
-      {
-        if (lin+vis_num_lin>num_lin) IupSetInt(ih, "NUMLIN", lin+vis_num_lin);
-        if (col+vis_num_col>num_col) IupSetInt(ih, "NUMCOL", col+vis_num_col);
-      }
-    }
-  }
+  if (!iMatrixExPasteCheckSize(ih, lin, col, data_num_lin, data_num_col, &num_lin, &num_col))
+    return;
 
   iMatrixExPasteSetData(ih, data, data_num_lin, data_num_col, sep, lin, col, num_lin, num_col, busyname);
 }
@@ -669,40 +939,71 @@ static int iMatrixExSetPasteDataAttrib(Ihandle *ih, const char* data)
   return 0;
 }
 
-static char* iMatrixReadFile(const char* filename)
+static void iMatrixExPasteFileData(Ihandle *ih, ImatExFileReader* reader, int lin, int col)
 {
-  char* data;
-  long size;
-  FILE *file = fopen(filename, "rb");
-  if (!file)
-    return NULL;
+  ImatExPasteSize size;
+  ImatExPaste paste;
+  int num_lin, num_col, skip_lines, len, raw_len, l,
+      data_num_lin, data_num_col;
+  const char* line;
+  char sep;
+
+  /* first pass, compute the data size */
+  skip_lines = IupGetInt(ih, "TEXTSKIPLINES");
+  if (!iMatrixExFileReaderSkipLines(reader, skip_lines))
+  {
+    iupAttribSet(ih, "LASTERROR", "IUP_ERRORNOTEXT");
+    return;
+  }
+
+  memset(&size, 0, sizeof(ImatExPasteSize));
+  size.sep = iMatrixExGetTextSeparator(ih);
+
+  while ((line = iMatrixExFileReaderNextLine(reader, &len, &raw_len)) != NULL)
+    iMatrixExPasteSizeAddLine(&size, line, len, raw_len);
 
-  fseek(file, 0, SEEK_END);
-  size = ftell(file);
-  if (size <= 0)
+  if (!size.has_data)
   {
-    fclose(file);
-    return NULL;
+    iupAttribSet(ih, "LASTERROR", "IUP_ERRORNOTEXT");
+    return;
   }
 
-  data = (char*)malloc(size + 1);
-  if (!data)
+  if (!iMatrixExPasteSizeGet(&size, &data_num_lin, &data_num_col, &sep))
   {
-    fclose(file);
-    return NULL;
+    iupAttribSet(ih, "LASTERROR", "IUP_ERRORINVALIDDATA");
+    return;
   }
 
-  fseek(file, 0, SEEK_SET);
-  fread(data, size, 1, file);
-  data[size] = 0;
-  fclose(file);
+  if (!iMatrixExPasteCheckSize(ih, lin, col, data_num_lin, data_num_col, &num_lin, &num_col))
+    return;
+
+  /* second pass, set the values */
+  iMatrixExFileReaderRewind(reader);
+  iMatrixExFileReaderSkipLines(reader, skip_lines);
 
-  return data;
+  if (!iMatrixExPasteBegin(&paste, ih, data_num_lin, data_num_col, sep, lin, col, num_lin, num_col, "PASTEFILE"))
+    return;
+
+  l = 0;
+  while (l < data_num_lin && (line = iMatrixExFileReaderNextLine(reader, &len, &raw_len)) != NULL)
+  {
+    int ret = iMatrixExPasteSetLine(&paste, line, len);  l++;
+    if (ret == -1)
+    {
+      iMatrixExPasteRelease(&paste);
+      return;
+    }
+    if (ret == 0)
+      break;
+  }
+
+  iMatrixExPasteEnd(&paste);
 }
 
 static int iMatrixExSetPasteFileAttrib(Ihandle *ih, const char* value)
 {
-  char* data, *paste_at;
+  ImatExFileReader reader;
+  char* paste_at;
   int lin = 0, col = 0;
 
   paste_at = iupAttribGet(ih, "PASTEFILEAT");
@@ -717,16 +1018,19 @@ static int iMatrixExSetPasteFileAttrib(Ihandle *ih, const char* value)
     }
   }
 
-  data = iMatrixReadFile(value);
-  if (!data)
+  /* reset error state */
+  iupAttribSet(ih, "LASTERROR", NULL);
+
+  /* the file is read in blocks twice, so it is never entirely loaded in memory */
+  if (!value || !iMatrixExFileReaderOpen(&reader, value))
   {
     iupAttribSet(ih, "LASTERROR", "IUP_ERRORFILEOPEN");
     return 0;
   }
 
-  iMatrixExPasteData(ih, data, lin, col, "PASTEFILE");
+  iMatrixExPasteFileData(ih, &reader, lin, col);
 
-  free(data);
+  iMatrixExFileReaderClose(&reader);
   return 0;
 }
 
@@ -19,47 +19,92 @@
 #include "iup_matrixex.h"
 
 
-static void iMatrixExStrCopyNoSepHTML(char* buffer, const char* str)
+#define IMATEX_EXPORT_BUFFER_SIZE (256*1024)
+
+static void iMatrixExWriteHTML(FILE* file, const char* str)
 {
+  const char* start = str;
   while (*str)
   {
     if (*str=='\n')
     {
-      *buffer = '<'; buffer++;
-      *buffer = 'B'; buffer++;
-      *buffer = 'R'; buffer++;
-      *buffer = '>'; 
+      fwrite(start, 1, str - start, file);
+      fputs("<BR>", file);
+      start = str + 1;
     }
-    else
-      *buffer = *str;
-
-    buffer++;
     str++;
   }
-  *buffer = 0;
+  fwrite(start, 1, str - start, file);
 }
 
-static void iMatrixExStrCopyNoSepLaTeX(char* buffer, const char* str)
+static void iMatrixExWriteLaTeX(FILE* file, const char* str)
 {
+  const char* start = str;
   while (*str)
   {
-    if (*str=='\n' || *str=='_')
-      *buffer = ' ';
-    else if (*str=='%')
+    if (*str=='\n' || *str=='_' || *str=='%')
     {
-      *buffer = '\\'; buffer++;
-      *buffer = '%'; 
+      fwrite(start, 1, str - start, file);
+      if (*str=='%')
+        fputs("\\%", file);
+      else
+        fputc(' ', file);
+      start = str + 1;
     }
-    else
-      *buffer = *str;
+    str++;
+  }
+  fwrite(start, 1, str - start, file);
+}
+
+static void iMatrixExWriteCSV(FILE* file, const char* str, char sep)
+{
+  /* RFC 4180: fields with separators, quotes or line ends are enclosed in quotes, 
+     and quotes inside the field are doubled */
+  const char* start;
 
-    buffer++;
+  if (!strchr(str, sep) && !strchr(str, '\"') && !strchr(str, '\n') && !strchr(str, '\r'))
+  {
+    fputs(str, file);
+    return;
+  }
+
+  fputc('\"', file);
+  start = str;
+  while (*str)
+  {
+    if (*str=='\"')
+    {
+      fwrite(start, 1, str - start + 1, file);  /* include the quote */
+      fputc('\"', file);
+      start = str + 1;
+    }
     str++;
   }
-  *buffer = 0;
+  fwrite(start, 1, str - start, file);
+  fputc('\"', file);
 }
 
-static void iMatrixExCopyTXT(Ihandle *ih, FILE* file, int num_lin, int num_col, int skip_lin, int skip_col)
+static char* iMatrixExExportVisibleLines(Ihandle* ih, int num_lin, int skip_lin)
+{
+  /* check the visibility only once for each line, 
+     1..skip_lin are also skipped */
+  char* visible = (char*)malloc(num_lin+1);
+  int lin;
+  for (lin = 0; lin <= num_lin; lin++)
+    visible[lin] = (char)((lin == 0 || lin > skip_lin) && iupMatrixExIsLineVisible(ih, lin));
+  return visible;
+}
+
+static char* iMatrixExExportVisibleColumns(Ihandle* ih, int num_col, int skip_col)
+{
+  char* visible = (char*)malloc(num_col+1);
+  int col;
+  for (col = 0; col <= num_col; col++)
+    visible[col] = (char)((col == 0 || col > skip_col) && iupMatrixExIsColumnVisible(ih, col));
+  return visible;
+}
+
+static int iMatrixExCopyTXT(Ihandle *ih, FILE* file, int num_lin, int num_col, const char* lin_visible, const char* col_visible)
 {
   ImatExData* matex_data = (ImatExData*)iupAttribGet(ih, "_IUP_MATEX_DATA");
   int lin, col;
@@ -77,37 +122,82 @@ static void iMatrixExCopyTXT(Ihandle *ih, FILE* file, int num_lin, int num_col,
   {
     add_sep = 0;
 
-    if (iupMatrixExIsLineVisible(ih, lin))
+    if (lin_visible[lin])
     {
       for (col = 0; col <= num_col; ++col)
       {
-        if (iupMatrixExIsColumnVisible(ih, col))
+        if (col_visible[col])
         {
           if (add_sep)
-            fprintf(file, "%c", sep);
+            fputc(sep, file);
 
           str = iupMatrixExGetCellValue(matex_data->ih, lin, col, 1);  /* get displayed value */
           if (str)
           {
             if (strchr(str, sep))
-              fprintf(file, "\"%s\"", str);
+            {
+              fputc('\"', file);
+              fputs(str, file);
+              fputc('\"', file);
+            }
             else
-              fprintf(file, "%s", str);
+              fputs(str, file);
           }
           else
-            fprintf(file, "%s", " ");
+            fputc(' ', file);
 
           add_sep = 1;
         }
+      }
+
+      fputc('\n', file);
+    }
+
+    if (!iupMatrixExBusyInc(matex_data))
+      return 0;
+  }
+
+  return 1;
+}
+
+static int iMatrixExCopyCSV(Ihandle *ih, FILE* file, int num_lin, int num_col, const char* lin_visible, const char* col_visible)
+{
+  ImatExData* matex_data = (ImatExData*)iupAttribGet(ih, "_IUP_MATEX_DATA");
+  int lin, col;
+  int add_sep;
+  char* str;
+  char sep = ',';
 
-        if (col == 0) col += skip_col;
+  /* Here includes the title cells */
+  for (lin = 0; lin <= num_lin; ++lin)
+  {
+    add_sep = 0;
+
+    if (lin_visible[lin])
+    {
+      for (col = 0; col <= num_col; ++col)
+      {
+        if (col_visible[col])
+        {
+          if (add_sep)
+            fputc(sep, file);
+
+          str = iupMatrixExGetCellValue(matex_data->ih, lin, col, 1);  /* get displayed value */
+          if (str)
+            iMatrixExWriteCSV(file, str, sep);
+
+          add_sep = 1;
+        }
       }
 
-      fprintf(file, "%s", "\n");
+      fputs("\r\n", file);
     }
 
-    if (lin == 0) lin += skip_lin;
+    if (!iupMatrixExBusyInc(matex_data))
+      return 0;
   }
+
+  return 1;
 }
 
 static char* iMatrixExGetCellAttrib(Ihandle* ih, const char* attrib, int lin, int col)
@@ -207,7 +297,7 @@ static char* iMatrixExGetCellFormat(Ihandle *ih, int lin, int col, char* format)
   return format;
 }
 
-static void iMatrixExCopyHTML(Ihandle *ih, FILE* file, int num_lin, int num_col, char* buffer, int skip_lin, int skip_col)
+static int iMatrixExCopyHTML(Ihandle *ih, FILE* file, int num_lin, int num_col, const char* lin_visible, const char* col_visible)
 {
   ImatExData* matex_data = (ImatExData*)iupAttribGet(ih, "_IUP_MATEX_DATA");
   int lin, col;
@@ -236,13 +326,13 @@ static void iMatrixExCopyHTML(Ihandle *ih, FILE* file, int num_lin, int num_col,
   /* Here includes the title cells */
   for (lin = 0; lin <= num_lin; ++lin)
   {
-    if (iupMatrixExIsLineVisible(ih, lin))
+    if (lin_visible[lin])
     {
       fprintf(file,"<TR%s> ", tr);
 
       for (col = 0; col <= num_col; ++col)
       {
-        if (iupMatrixExIsColumnVisible(ih, col))
+        if (col_visible[col])
         {           
           if (lin==0||col==0)
             fprintf(file,"<TH%s%s>", th, add_format? iMatrixExGetCellFormat(ih, lin, col, f): "");
@@ -251,29 +341,26 @@ static void iMatrixExCopyHTML(Ihandle *ih, FILE* file, int num_lin, int num_col,
 
           str = iupMatrixExGetCellValue(matex_data->ih, lin, col, 1);  /* get displayed value */
           if (str)
-          {
-            iMatrixExStrCopyNoSepHTML(buffer, str);
-            fprintf(file, "%s", buffer);
-          }
+            iMatrixExWriteHTML(file, str);
           else
-            fprintf(file, "%s", " ");
+            fputc(' ', file);
 
           if (lin==0||col==0)
-            fprintf(file,"</TH> ");
+            fputs("</TH> ", file);
           else
-            fprintf(file,"</TD> ");
+            fputs("</TD> ", file);
         }
-
-        if (col == 0) col += skip_col;
       }
 
-      fprintf(file,"</TR>\n");
+      fputs("</TR>\n", file);
     }
 
-    if (lin == 0) lin += skip_lin;
+    if (!iupMatrixExBusyInc(matex_data))
+      return 0;
   }
 
   fprintf(file,"</TABLE>\n");
+  return 1;
 }
 
 static int iMatrixExIsBoldLine(Ihandle* ih, int lin)
@@ -293,7 +380,7 @@ static int iMatrixExIsBoldLine(Ihandle* ih, int lin)
   return 0;
 }
 
-static void iMatrixExCopyLaTeX(Ihandle *ih, FILE* file, int num_lin, int num_col, char* buffer, int skip_lin, int skip_col)
+static int iMatrixExCopyLaTeX(Ihandle *ih, FILE* file, int num_lin, int num_col, const char* lin_visible, const char* col_visible)
 {
   ImatExData* matex_data = (ImatExData*)iupAttribGet(ih, "_IUP_MATEX_DATA");
   int lin, col;
@@ -308,10 +395,8 @@ static void iMatrixExCopyLaTeX(Ihandle *ih, FILE* file, int num_lin, int num_col
 
   for (col = 0; col <= num_col; ++col)
   {
-    if (iupMatrixExIsColumnVisible(ih, col))
+    if (col_visible[col])
       fprintf(file,"|r");
-
-    if (col == 0) col += skip_col;
   }
   fprintf(file,"|} \\hline\n");
 
@@ -320,42 +405,38 @@ static void iMatrixExCopyLaTeX(Ihandle *ih, FILE* file, int num_lin, int num_col
   {
     add_sep = 0;
 
-    if (iupMatrixExIsLineVisible(ih, lin))
+    if (lin_visible[lin])
     {
       int is_bold = iMatrixExIsBoldLine(ih, lin);
 
       for (col = 0; col <= num_col; ++col)
       {
-        if (iupMatrixExIsColumnVisible(ih, col))
+        if (col_visible[col])
         {    
           if (add_sep)
-            fprintf(file,"& ");
+            fputs("& ", file);
 
           if (is_bold)
-            fprintf(file,"\\bf{");
+            fputs("\\bf{", file);
 
           str = iupMatrixExGetCellValue(matex_data->ih, lin, col, 1);  /* get displayed value */
           if (str)
-          {
-            iMatrixExStrCopyNoSepLaTeX(buffer, str);
-            fprintf(file, "%s", buffer);
-          }
+            iMatrixExWriteLaTeX(file, str);
           else
-            fprintf(file, "%s", " ");
+            fputc(' ', file);
 
           if (is_bold)
-            fprintf(file,"}");
+            fputc('}', file);
 
           add_sep = 1;
         }
-
-        if (col == 0) col += skip_col;
       }
 
-      fprintf(file,"\\\\ \\hline\n");
+      fputs("\\\\ \\hline\n", file);
     }
 
-    if (lin == 0) lin += skip_lin;
+    if (!iupMatrixExBusyInc(matex_data))
+      return 0;
   }
 
   fprintf(file,"\\end{tabular}\n");
@@ -368,12 +449,14 @@ static void iMatrixExCopyLaTeX(Ihandle *ih, FILE* file, int num_lin, int num_col
 
   fprintf(file,"\\end{center}\n");
   fprintf(file,"\\end{table}\n");
+  return 1;
 }
 
 static int iMatrixExSetCopyFileAttrib(Ihandle *ih, const char* value)
 {
-  int num_lin, num_col, skip_lin, skip_col;
-  char buffer[1024];
+  ImatExData* matex_data = (ImatExData*)iupAttribGet(ih, "_IUP_MATEX_DATA");
+  int num_lin, num_col, skip_lin, skip_col, ret, error;
+  char *lin_visible, *col_visible;
   char* format;
 
   FILE *file = fopen(value, "wb");
@@ -383,6 +466,9 @@ static int iMatrixExSetCopyFileAttrib(Ihandle *ih, const char* value)
     return 0;
   }
 
+  /* large buffer, so the file is written in big blocks */
+  setvbuf(file, NULL, _IOFBF, IMATEX_EXPORT_BUFFER_SIZE);
+
   /* reset error state */
   iupAttribSet(ih, "LASTERROR", NULL);
 
@@ -392,15 +478,38 @@ static int iMatrixExSetCopyFileAttrib(Ihandle *ih, const char* value)
   skip_lin = iupAttribGetInt(ih, "SKIPLINES");
   skip_col = iupAttribGetInt(ih, "SKIPCOLUMNS");
 
+  lin_visible = iMatrixExExportVisibleLines(ih, num_lin, skip_lin);
+  col_visible = iMatrixExExportVisibleColumns(ih, num_col, skip_col);
+
+  iupMatrixExBusyStartReadOnly(matex_data, num_lin+1, "COPYFILE");
+
   format = iupAttribGetStr(ih, "FILEFORMAT");
   if (iupStrEqualNoCase(format, "HTML"))
-    iMatrixExCopyHTML(ih, file, num_lin, num_col, buffer, skip_lin, skip_col);
+    ret = iMatrixExCopyHTML(ih, file, num_lin, num_col, lin_visible, col_visible);
   else if (iupStrEqualNoCase(format, "LaTeX"))
-    iMatrixExCopyLaTeX(ih, file, num_lin, num_col, buffer, skip_lin, skip_col);
+    ret = iMatrixExCopyLaTeX(ih, file, num_lin, num_col, lin_visible, col_visible);
+  else if (iupStrEqualNoCase(format, "CSV"))
+    ret = iMatrixExCopyCSV(ih, file, num_lin, num_col, lin_visible, col_visible);
   else
-    iMatrixExCopyTXT(ih, file, num_lin, num_col, skip_lin, skip_col);
+    ret = iMatrixExCopyTXT(ih, file, num_lin, num_col, lin_visible, col_visible);
+
+  if (ret)
+    iupMatrixExBusyEnd(matex_data);
+
+  free(lin_visible);
+  free(col_visible);
+
+  /* the last block is written by fclose, so it must also be checked */
+  error = ferror(file);
+  if (fclose(file) != 0)
+    error = 1;
+
+  if (error)
+    iupAttribSet(ih, "LASTERROR", "IUP_ERRORFILESAVE");
+
+  if (!ret || error)  /* aborted or incomplete */
+    remove(value);
 
-  fclose(file);
   return 0;
 }
 
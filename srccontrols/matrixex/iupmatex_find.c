@@ -19,6 +19,8 @@
 #include "iup_matrixex.h"
 
 
+static IattribSetFunc iMatrixSetFindIndexAttrib = NULL;
+
 static void iMatrixExFindDialogUpdateResult(ImatExData* matex_data, Ihandle* ih_button)
 {
   char* last_found = IupGetAttribute(matex_data->ih, "_IUP_LAST_FOUND");
@@ -210,9 +212,90 @@ void iupMatrixExFindShowDialog(ImatExData* matex_data)
     IupShow(matex_data->find_dlg);
 }
 
-static int iMatrixMatch(Ihandle *ih, const char* findvalue, int lin, int col, int matchcase, int matchwholecell, int utf8)
+/* Displayed values of all cells, so the search does not need to format 
+   or to call the callbacks again. Valid while the matrix values and size do not change. */
+typedef struct _ImatExFindIndex
+{
+  int num_lin, num_col;
+  int change_count;
+  char** values;   /* column by column, titles are not stored */
+} ImatExFindIndex;
+
+void iupMatrixExFindReleaseIndex(ImatExData* matex_data)
+{
+  ImatExFindIndex* find_index = matex_data->find_index;
+  if (find_index)
+  {
+    int i, count = (find_index->num_lin+1)*(find_index->num_col+1);
+    for (i = 0; i < count; i++)
+    {
+      if (find_index->values[i])
+        free(find_index->values[i]);
+    }
+    free(find_index->values);
+    free(find_index);
+    matex_data->find_index = NULL;
+  }
+}
+
+static int iMatrixExFindIndexIsValid(ImatExData* matex_data, int num_lin, int num_col)
+{
+  ImatExFindIndex* find_index = matex_data->find_index;
+  return find_index &&
+         find_index->num_lin == num_lin && find_index->num_col == num_col &&
+         find_index->change_count == iupMatrixExGetValuesChangeCount(matex_data->ih);
+}
+
+static void iMatrixExFindBuildIndex(ImatExData* matex_data, int num_lin, int num_col)
+{
+  ImatExFindIndex* find_index;
+  int lin, col;
+
+  iupMatrixExFindReleaseIndex(matex_data);
+
+  find_index = (ImatExFindIndex*)malloc(sizeof(ImatExFindIndex));
+  find_index->num_lin = num_lin;
+  find_index->num_col = num_col;
+  find_index->change_count = iupMatrixExGetValuesChangeCount(matex_data->ih);
+  find_index->values = (char**)calloc((num_lin+1)*(num_col+1), sizeof(char*));
+  matex_data->find_index = find_index;
+
+  /* the cells are not changed, so it must not open an undo block when UNDOREDO=Yes */
+  iupMatrixExBusyStartReadOnly(matex_data, num_col, "FINDINDEX");
+
+  for (col = 1; col <= num_col; col++)
+  {
+    char** col_values = find_index->values + col*(num_lin+1);
+
+    for (lin = 1; lin <= num_lin; lin++)
+    {
+      char* value = iupMatrixExGetCellValue(matex_data->ih, lin, col, 1);  /* get displayed value */
+      if (value && value[0] != 0)
+        col_values[lin] = iupStrDup(value);
+    }
+
+    if (!iupMatrixExBusyInc(matex_data))
+    {
+      iupMatrixExFindReleaseIndex(matex_data);
+      return;
+    }
+  }
+
+  iupMatrixExBusyEnd(matex_data);
+}
+
+static char* iMatrixExFindGetValue(ImatExData* matex_data, int lin, int col)
+{
+  ImatExFindIndex* find_index = matex_data->find_index;
+  if (find_index)
+    return find_index->values[col*(find_index->num_lin+1) + lin];
+  else
+    return iupMatrixExGetCellValue(matex_data->ih, lin, col, 1);  /* get displayed value */
+}
+
+static int iMatrixMatch(ImatExData* matex_data, const char* findvalue, int lin, int col, int matchcase, int matchwholecell, int utf8)
 {
-  char* value = iupMatrixExGetCellValue(ih, lin, col, 1);  /* get displayed value */
+  char* value = iMatrixExFindGetValue(matex_data, lin, col);
   if (!value || value[0] == 0)
     return 0;
 
@@ -222,8 +305,23 @@ static int iMatrixMatch(Ihandle *ih, const char* findvalue, int lin, int col, in
     return iupStrCompareFind(value, findvalue, matchcase, utf8);  /* search only for the first occurrence */
 }
 
+static void iMatrixExFindUpdateIndex(ImatExData* matex_data, int num_lin, int num_col)
+{
+  if (matex_data->find_index && !iMatrixExFindIndexIsValid(matex_data, num_lin, num_col))
+  {
+    /* values changed since the index was built */
+    if (iupAttribGetBoolean(matex_data->ih, "FINDINDEX"))
+      iMatrixExFindBuildIndex(matex_data, num_lin, num_col);
+    else
+      iupMatrixExFindReleaseIndex(matex_data);
+  }
+  else if (!matex_data->find_index && iupAttribGetBoolean(matex_data->ih, "FINDINDEX"))
+    iMatrixExFindBuildIndex(matex_data, num_lin, num_col);
+}
+
 static int iMatrixExSetFind(Ihandle *ih, const char* value, int inc, int flip, int matchcase, int matchwholecell, int *lin, int *col, int search_cur_cell)
 {
+  ImatExData* matex_data = (ImatExData*)iupAttribGet(ih, "_IUP_MATEX_DATA");
   int utf8 = IupGetInt(NULL, "UTF8MODE");
   int num_lin = IupGetInt(ih, "NUMLIN");
   int num_col = IupGetInt(ih, "NUMCOL");
@@ -233,10 +331,12 @@ static int iMatrixExSetFind(Ihandle *ih, const char* value, int inc, int flip, i
 
   find_value = iupStrDup(value);
 
+  iMatrixExFindUpdateIndex(matex_data, num_lin, num_col);
+
   if (search_cur_cell)  /* search the current cell */
   {
     /* the FOCUSCELL is always visible and not a title */
-    if (iMatrixMatch(ih, find_value, *lin, *col, matchcase, matchwholecell, utf8))
+    if (iMatrixMatch(matex_data, find_value, *lin, *col, matchcase, matchwholecell, utf8))
     {
       free(find_value);
       return 1;
@@ -274,7 +374,7 @@ static int iMatrixExSetFind(Ihandle *ih, const char* value, int inc, int flip, i
     {
       if (!search_cur_cell)
       {
-        if (iMatrixMatch(ih, find_value, *lin, *col, matchcase, matchwholecell, utf8))
+        if (iMatrixMatch(matex_data, find_value, *lin, *col, matchcase, matchwholecell, utf8))
         {
           free(find_value);
           return 1;
@@ -288,7 +388,7 @@ static int iMatrixExSetFind(Ihandle *ih, const char* value, int inc, int flip, i
     if (!iupMatrixExIsLineVisible(ih, *lin) || !iupMatrixExIsColumnVisible(ih, *col))
       continue;
 
-  } while (!iMatrixMatch(ih, find_value, *lin, *col, matchcase, matchwholecell, utf8));
+  } while (!iMatrixMatch(matex_data, find_value, *lin, *col, matchcase, matchwholecell, utf8));
 
   free(find_value);
   return 1;
@@ -352,9 +452,141 @@ static int iMatrixExSetFindAttrib(Ihandle *ih, const char* value)
   return 1;
 }
 
+static int iMatrixExSetFindAllAttrib(Ihandle *ih, const char* value)
+{
+  ImatExData* matex_data = (ImatExData*)iupAttribGet(ih, "_IUP_MATEX_DATA");
+  int utf8 = IupGetInt(NULL, "UTF8MODE");
+  int num_lin = IupGetInt(ih, "NUMLIN");
+  int num_col = IupGetInt(ih, "NUMCOL");
+  int lin, col, found_count = 0, matchcase, matchwholecell, flip;
+  char* direction;
+  char* find_value;
+
+  /* clear the previous result */
+  while (iupAttribGetId(ih, "FINDALLRESULT", found_count+1))
+  {
+    iupAttribSetId(ih, "FINDALLRESULT", found_count+1, NULL);
+    found_count++;
+  }
+  found_count = 0;
+  iupAttribSet(ih, "FINDALLCOUNT", NULL);
+
+  if (!value || value[0]==0)
+    return 0;
+
+  direction = iupAttribGetStr(ih, "FINDDIRECTION");
+  flip = iupStrEqualNoCase(direction, "TOPLEFT") || iupStrEqualNoCase(direction, "BOTTOMRIGHT");  /* search by column */
+  matchcase = iupAttribGetInt(ih, "FINDMATCHCASE");
+  matchwholecell = iupAttribGetInt(ih, "FINDMATCHWHOLECELL");
+
+  find_value = iupStrDup(value);
+
+  iMatrixExFindUpdateIndex(matex_data, num_lin, num_col);
+
+  /* results are always in forward order */
+  if (flip)
+  {
+    for (col = 1; col <= num_col; col++)
+    {
+      if (!iupMatrixExIsColumnVisible(ih, col))
+        continue;
+
+      for (lin = 1; lin <= num_lin; lin++)
+      {
+        if (iupMatrixExIsLineVisible(ih, lin) && iMatrixMatch(matex_data, find_value, lin, col, matchcase, matchwholecell, utf8))
+        {
+          char str[50];
+          sprintf(str, "%d:%d", lin, col);
+          found_count++;
+          iupAttribSetStrId(ih, "FINDALLRESULT", found_count, str);
+        }
+      }
+    }
+  }
+  else
+  {
+    for (lin = 1; lin <= num_lin; lin++)
+    {
+      if (!iupMatrixExIsLineVisible(ih, lin))
+        continue;
+
+      for (col = 1; col <= num_col; col++)
+      {
+        if (iupMatrixExIsColumnVisible(ih, col) && iMatrixMatch(matex_data, find_value, lin, col, matchcase, matchwholecell, utf8))
+        {
+          char str[50];
+          sprintf(str, "%d:%d", lin, col);
+          found_count++;
+          iupAttribSetStrId(ih, "FINDALLRESULT", found_count, str);
+        }
+      }
+    }
+  }
+
+  free(find_value);
+
+  iupAttribSetInt(ih, "FINDALLCOUNT", found_count);
+  return 0;
+}
+
+static int iMatrixExSetFindIndexAttrib(Ihandle *ih, const char* value)
+{
+  ImatExData* matex_data = (ImatExData*)iupAttribGet(ih, "_IUP_MATEX_DATA");
+
+  /* always rebuilt when set, also when the values changed in a way that was not detected */
+  iupMatrixExFindReleaseIndex(matex_data);
+
+  if (iupStrBoolean(value))
+    iMatrixExFindBuildIndex(matex_data, IupGetInt(ih, "NUMLIN"), IupGetInt(ih, "NUMCOL"));
+
+  iMatrixSetFindIndexAttrib(ih, value);  /* so IupMatrix will notify each changed cell */
+  return 1;
+}
+
+static int iMatrixExSetFindIndexCellAttrib(Ihandle *ih, int lin, int col, const char* value)
+{
+  /* called by IupMatrix after a cell value is set, in interactive edit, paste, copy and undo */
+  ImatExData* matex_data = (ImatExData*)iupAttribGet(ih, "_IUP_MATEX_DATA");
+  ImatExFindIndex* find_index = matex_data->find_index;
+
+  /* if the index was valid before this change, update only this cell, 
+     if not it will be rebuilt in the next search */
+  if (find_index && find_index->change_count == iupMatrixExGetValuesChangeCount(ih) - 1)
+  {
+    if (lin > 0 && col > 0 && lin <= find_index->num_lin && col <= find_index->num_col)  /* titles are not stored */
+    {
+      char** cell_value = find_index->values + col*(find_index->num_lin+1) + lin;
+      char* new_value = iupMatrixExGetCellValue(ih, lin, col, 1);  /* get displayed value */
+
+      if (*cell_value)
+        free(*cell_value);
+
+      if (new_value && new_value[0] != 0)
+        *cell_value = iupStrDup(new_value);
+      else
+        *cell_value = NULL;
+    }
+
+    find_index->change_count++;
+  }
+
+  (void)value;
+  return 0;
+}
+
 void iupMatrixExRegisterFind(Iclass* ic)
 {
   iupClassRegisterAttribute(ic, "FIND", NULL, iMatrixExSetFindAttrib, NULL, NULL, IUPAF_NO_INHERIT);
+  iupClassRegisterAttribute(ic, "FINDALL", NULL, iMatrixExSetFindAllAttrib, NULL, NULL, IUPAF_WRITEONLY | IUPAF_NO_INHERIT);
+  iupClassRegisterAttribute(ic, "FINDALLCOUNT", NULL, NULL, NULL, NULL, IUPAF_READONLY | IUPAF_NO_INHERIT);
+  iupClassRegisterAttributeId(ic, "FINDALLRESULT", NULL, NULL, IUPAF_READONLY | IUPAF_NO_INHERIT);
+  /* Already defined in IupMatrix, redefined here */
+  if (!iMatrixSetFindIndexAttrib)
+    iupClassRegisterGetAttribute(ic, "FINDINDEX", NULL, &iMatrixSetFindIndexAttrib, NULL, NULL, NULL);
+  iupClassRegisterReplaceAttribFunc(ic, "FINDINDEX", NULL, iMatrixExSetFindIndexAttrib);
+
+  /* Internal attributes */
+  iupClassRegisterAttributeId2(ic, "FINDINDEXCELL", NULL, iMatrixExSetFindIndexCellAttrib, IUPAF_WRITEONLY|IUPAF_NO_INHERIT);
 
   iupClassRegisterAttribute(ic, "FINDDIRECTION", NULL, NULL, IUPAF_SAMEASSYSTEM, "RIGHTBOTTOM", IUPAF_NO_INHERIT);
   iupClassRegisterAttribute(ic, "FINDMATCHCASE", NULL, NULL, IUPAF_SAMEASSYSTEM, "Yes", IUPAF_NO_INHERIT);
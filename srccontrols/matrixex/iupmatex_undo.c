@@ -24,17 +24,34 @@
 
 static IattribSetFunc iMatrixSetUndoRedoAttrib = NULL;
 
+/* Cells changed in an undo step are stored as ranges of consecutive cells,
+   along a line or along a column. The values of each range are consecutive 
+   in the values array, that has offsets into a string arena.
+   So a pasted block is stored as one range per line. */
+
+typedef struct _IundoRange {
+  int lin, col;      /* first cell */
+  int count;         /* number of consecutive cells */
+  int along_lin;     /* 1 if the range goes along the line (col increments), 0 if it goes along the column (lin increments) */
+  int first_value;   /* index of the first value in the values array */
+} IundoRange;
+
 typedef struct _IundoData {
   int cell_count;
   const char* name;
-  Itable* data_table;
+  Iarray* ranges;   /* of IundoRange */
+  Iarray* values;   /* of int, offset in the arena, or -1 for NULL values */
+  Iarray* arena;    /* of char, NUL terminated strings */
 } IundoData;
 
 static void iMatrixExUndoDataInit(IundoData* undo_data, const char* name)
 {
   undo_data->cell_count = 0;
   undo_data->name = name;
-  undo_data->data_table = iupTableCreate(IUPTABLE_STRINGINDEXED);
+  /* most steps change a single cell, the arrays grow geometrically when more cells are changed */
+  undo_data->ranges = iupArrayCreate(1, sizeof(IundoRange));
+  undo_data->values = iupArrayCreate(4, sizeof(int));
+  undo_data->arena = iupArrayCreate(64, sizeof(char));
 
   if (name)
   {
@@ -48,51 +65,126 @@ static void iMatrixExUndoDataInit(IundoData* undo_data, const char* name)
 
 static void iMatrixExUndoDataClear(IundoData* undo_data)
 {
-  iupTableDestroy(undo_data->data_table);
+  iupArrayDestroy(undo_data->ranges);
+  iupArrayDestroy(undo_data->values);
+  iupArrayDestroy(undo_data->arena);
   memset(undo_data, 0, sizeof(IundoData));
 }
 
-static void iMatrixExUndoDataAddCell(IundoData* undo_data, int lin, int col, const char* value)
+static int iMatrixExUndoDataMemory(IundoData* undo_data)
+{
+  /* allocated memory, not only the used elements */
+  return iupArrayMaxCount(undo_data->ranges)*(int)sizeof(IundoRange) + 
+         iupArrayMaxCount(undo_data->values)*(int)sizeof(int) + 
+         iupArrayMaxCount(undo_data->arena);
+}
+
+static int iMatrixExUndoArenaAdd(Iarray* arena, const char* value)
 {
-  char id[40];
-  sprintf(id, "%d:%d", lin, col);
+  int offset, len;
+  char* arena_data;
+
   if (!value)
-    iupTableSet(undo_data->data_table, id, (void*)"", IUPTABLE_POINTER);  /* store NULL pointers so they can be restored later */
+    return -1;
+
+  len = (int)strlen(value) + 1;
+  offset = iupArrayCount(arena);
+  arena_data = (char*)iupArrayAdd(arena, len);
+  memcpy(arena_data + offset, value, len);
+  return offset;
+}
+
+static void iMatrixExUndoDataAddCell(IundoData* undo_data, int lin, int col, const char* value)
+{
+  int range_count = iupArrayCount(undo_data->ranges);
+  int value_count = iupArrayCount(undo_data->values);
+  int* values = (int*)iupArrayAdd(undo_data->values, 1);
+  IundoRange* ranges = (IundoRange*)iupArrayGetData(undo_data->ranges);
+  IundoRange* last = range_count? &(ranges[range_count - 1]): NULL;
+
+  values[value_count] = iMatrixExUndoArenaAdd(undo_data->arena, value);
+
+  if (last && last->count == 1 && last->lin == lin && last->col + 1 == col)
+  {
+    last->along_lin = 1;
+    last->count++;
+  }
+  else if (last && last->count == 1 && last->col == col && last->lin + 1 == lin)
+  {
+    last->along_lin = 0;
+    last->count++;
+  }
+  else if (last && last->along_lin && last->lin == lin && last->col + last->count == col)
+    last->count++;
+  else if (last && !last->along_lin && last->col == col && last->lin + last->count == lin)
+    last->count++;
   else
-    iupTableSet(undo_data->data_table, id, (void*)value, IUPTABLE_STRING);
+  {
+    IundoRange* range;
+    ranges = (IundoRange*)iupArrayAdd(undo_data->ranges, 1);
+    range = &(ranges[range_count]);
+    range->lin = lin;
+    range->col = col;
+    range->count = 1;
+    range->along_lin = 1;
+    range->first_value = value_count;
+  }
+
   undo_data->cell_count++;
 }
 
-static int iMatrixExUndoDataSwap(ImatExData* matex_data, IundoData* undo_data)
+static int iMatrixExUndoDataSwapCell(ImatExData* matex_data, IundoData* undo_data, Iarray* new_arena, int lin, int col, int v)
 {
-  char* id = iupTableFirst(undo_data->data_table);
-  while (id)
-  {
-    char *value, *old_value;
-    int lin=1, col=1;
-    iupStrToIntInt(id, &lin, &col, ':');
+  int* values = (int*)iupArrayGetData(undo_data->values);
+  char* arena = (char*)iupArrayGetData(undo_data->arena);
+  char* value = values[v] < 0? NULL: arena + values[v];
 
-    value = (char*)iupTableGetCurr(undo_data->data_table);
+  /* store the current value in the new arena, and restore the old value */
+  values[v] = iMatrixExUndoArenaAdd(new_arena, iupMatrixExGetCellValue(matex_data->ih, lin, col, 0));  /* get internal value */
 
-    old_value = iupStrDup(iupMatrixExGetCellValue(matex_data->ih, lin, col, 0));  /* get internal value */
+  iupMatrixExSetCellValue(matex_data->ih, lin, col, value);
 
-    iupMatrixExSetCellValue(matex_data->ih, lin, col, value);
+  return iupMatrixExBusyInc(matex_data);
+}
 
-    if (!old_value)
-      iupTableSetCurr(undo_data->data_table, (void*)"", IUPTABLE_POINTER);
-    else
-    {
-      iupTableSetCurr(undo_data->data_table, (void*)old_value, IUPTABLE_STRING);
-      free(old_value);
-    }
+static int iMatrixExUndoDataSwap(ImatExData* matex_data, IundoData* undo_data, int undo)
+{
+  /* the same cell may be stored more than once in a step,
+     so undo must restore in reverse order, and redo in the original order */
+  int r, i, ret = 1;
+  int range_count = iupArrayCount(undo_data->ranges);
+  IundoRange* ranges = (IundoRange*)iupArrayGetData(undo_data->ranges);
+  int* values = (int*)iupArrayGetData(undo_data->values);
+  Iarray* new_arena = iupArrayCreate(iupArrayCount(undo_data->arena) + 1, sizeof(char));
+
+  for (r = 0; r < range_count; r++)
+  {
+    IundoRange* range = undo? &(ranges[range_count - 1 - r]): &(ranges[r]);
 
-    if (!iupMatrixExBusyInc(matex_data))
-      return 0;
+    for (i = 0; i < range->count; i++)
+    {
+      int c = undo? range->count - 1 - i: i;
+      int v = range->first_value + c;
 
-    id = iupTableNext(undo_data->data_table);
+      if (ret)
+      {
+        int lin = range->along_lin? range->lin: range->lin + c;
+        int col = range->along_lin? range->col + c: range->col;
+        ret = iMatrixExUndoDataSwapCell(matex_data, undo_data, new_arena, lin, col, v);
+      }
+      else if (values[v] >= 0)  
+      {
+        /* aborted, just move the remaining values to the new arena */
+        char* arena = (char*)iupArrayGetData(undo_data->arena);
+        values[v] = iMatrixExUndoArenaAdd(new_arena, arena + values[v]);
+      }
+    }
   }
 
-  return 1;
+  iupArrayDestroy(undo_data->arena);
+  undo_data->arena = new_arena;
+
+  return ret;
 }
 
 static void iMatrixExUndoStackInit(ImatExData* matex_data)
@@ -115,6 +207,46 @@ static void iMatrixUndoStackAdd(ImatExData* matex_data, const char* name)
   iMatrixExUndoDataInit(&(undo_stack_data[matex_data->undo_stack_pos]), name);
 }
 
+static int iMatrixExUndoStackMemory(ImatExData* matex_data)
+{
+  int i, memory = 0, undo_stack_count = iupArrayCount(matex_data->undo_stack);
+  IundoData* undo_stack_data = (IundoData*)iupArrayGetData(matex_data->undo_stack);
+  for (i = 0; i < undo_stack_count; i++)
+    memory += iMatrixExUndoDataMemory(&(undo_stack_data[i]));
+  return memory;
+}
+
+static void iMatrixExUndoStackLimitMemory(ImatExData* matex_data)
+{
+  int i, remove_count, memory, max_memory = iupAttribGetInt(matex_data->ih, "UNDOMAXMEMORY");
+  IundoData* undo_stack_data;
+
+  if (max_memory <= 0)
+    return;
+
+  memory = iMatrixExUndoStackMemory(matex_data);
+  if (memory <= max_memory)
+    return;
+
+  /* remove the oldest undo steps, 
+     but always keep the last one even if it alone is larger than the limit */
+  undo_stack_data = (IundoData*)iupArrayGetData(matex_data->undo_stack);
+  remove_count = 0;
+  while (memory > max_memory && remove_count < matex_data->undo_stack_pos - 1)
+  {
+    memory -= iMatrixExUndoDataMemory(&(undo_stack_data[remove_count]));
+    remove_count++;
+  }
+
+  if (remove_count)
+  {
+    for (i = 0; i < remove_count; i++)
+      iMatrixExUndoDataClear(&(undo_stack_data[i]));
+    iupArrayRemove(matex_data->undo_stack, 0, remove_count);
+    matex_data->undo_stack_pos -= remove_count;
+  }
+}
+
 void iupMatrixExUndoPushBegin(ImatExData* matex_data, const char* name)
 {
   if (!matex_data->undo_stack_hold)
@@ -130,6 +262,8 @@ void iupMatrixExUndoPushEnd(ImatExData* matex_data)
   {
     matex_data->undo_stack_pos++;
     matex_data->undo_stack_hold = 0;
+
+    iMatrixExUndoStackLimitMemory(matex_data);
   }
 }
 
@@ -149,6 +283,8 @@ static int iMatrixSetUndoPushCellAttrib(Ihandle* ih, int lin, int col, const cha
     undo_stack_data = (IundoData*)iupArrayGetData(matex_data->undo_stack);
     iMatrixExUndoDataAddCell(&(undo_stack_data[matex_data->undo_stack_pos]), lin, col, value);
     matex_data->undo_stack_pos++;
+
+    iMatrixExUndoStackLimitMemory(matex_data);
   }
 
   return 0;
@@ -180,6 +316,23 @@ static char* iMatrixGetUndoCountAttrib(Ihandle* ih)
   return NULL; 
 }
 
+static char* iMatrixGetUndoMemoryAttrib(Ihandle* ih)
+{
+  ImatExData* matex_data = (ImatExData*)iupAttribGet(ih, "_IUP_MATEX_DATA");
+  if (matex_data->undo_stack)
+    return iupStrReturnInt(iMatrixExUndoStackMemory(matex_data));
+  return NULL; 
+}
+
+static int iMatrixSetUndoMaxMemoryAttrib(Ihandle* ih, const char* value)
+{
+  ImatExData* matex_data = (ImatExData*)iupAttribGet(ih, "_IUP_MATEX_DATA");
+  iupAttribSetStr(ih, "UNDOMAXMEMORY", value);
+  if (matex_data->undo_stack && !matex_data->undo_stack_hold)
+    iMatrixExUndoStackLimitMemory(matex_data);
+  return 0;
+}
+
 static char* iMatrixGetUndoNameAttrib(Ihandle* ih, int id)
 {
   ImatExData* matex_data = (ImatExData*)iupAttribGet(ih, "_IUP_MATEX_DATA");
@@ -217,7 +370,7 @@ static int iMatrixSetUndoAttrib(Ihandle* ih, const char* value)
 
     for (i=0; i<count; i++)
     {
-      if (!iMatrixExUndoDataSwap(matex_data, &(undo_stack_data[matex_data->undo_stack_pos-1 - i])))
+      if (!iMatrixExUndoDataSwap(matex_data, &(undo_stack_data[matex_data->undo_stack_pos-1 - i]), 1))
       {
         matex_data->undo_stack_pos -= i;
         iMatrixSetUndoRedoAttrib(ih, "Yes");
@@ -273,7 +426,7 @@ static int iMatrixSetRedoAttrib(Ihandle* ih, const char* value)
 
     for (i=0; i<count; i++)
     {
-      if (!iMatrixExUndoDataSwap(matex_data, &(undo_stack_data[matex_data->undo_stack_pos + i])))
+      if (!iMatrixExUndoDataSwap(matex_data, &(undo_stack_data[matex_data->undo_stack_pos + i]), 0))
       {
         matex_data->undo_stack_pos += i;
         iMatrixSetUndoRedoAttrib(ih, "Yes");
@@ -418,6 +571,8 @@ void iupMatrixExRegisterUndo(Iclass* ic)
   iupClassRegisterAttribute(ic, "UNDOCLEAR", NULL, iMatrixSetUndoClearAttrib, NULL, NULL, IUPAF_WRITEONLY|IUPAF_NO_INHERIT);
   iupClassRegisterAttributeId(ic, "UNDONAME", iMatrixGetUndoNameAttrib, NULL, IUPAF_READONLY|IUPAF_NO_INHERIT);
   iupClassRegisterAttribute(ic, "UNDOCOUNT", iMatrixGetUndoCountAttrib, NULL, NULL, NULL, IUPAF_READONLY|IUPAF_NO_INHERIT);
+  iupClassRegisterAttribute(ic, "UNDOMEMORY", iMatrixGetUndoMemoryAttrib, NULL, NULL, NULL, IUPAF_READONLY|IUPAF_NO_INHERIT);
+  iupClassRegisterAttribute(ic, "UNDOMAXMEMORY", NULL, iMatrixSetUndoMaxMemoryAttrib, NULL, NULL, IUPAF_NO_INHERIT);
 
   /* Internal attributes */
   iupClassRegisterAttributeId2(ic, "UNDOPUSHCELL", NULL, iMatrixSetUndoPushCellAttrib, IUPAF_WRITEONLY|IUPAF_NO_INHERIT);
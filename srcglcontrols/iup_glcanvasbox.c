@@ -17,9 +17,11 @@
 #include "iup_attrib.h"
 #include "iup_str.h"
 #include "iup_register.h"
+#include "iup_timer.h"
 
 #include "iup_glcontrols.h"
 #include "iup_glfont.h"
+#include "iup_gldraw.h"
 #include "iup_glsubcanvas.h"
 #include "iup_varg.h"
 
@@ -98,15 +100,22 @@ static void iGLCanvasBoxCallGLChildAction(Ihandle* ih, Ihandle* gl_parent)
 
 static int iGLCanvasBoxSwapBuffers_CB(Ihandle* ih)
 {
+  double start = iupTimerGetWallTime();
+
   /* called before the actual SwapBuffers */
 
   iupGLSubCanvasSaveState(ih);
 
+  iupGLDrawResetDrawCount();
+
   /* redraw all GL children */
   iGLCanvasBoxCallGLChildAction(ih, ih);
 
   iupGLSubCanvasRestoreState(ih);
 
+  iupAttribSetInt(ih, "_IUP_DRAWCOUNT", iupGLDrawGetDrawCount());
+  iupAttribSetDouble(ih, "_IUP_RENDERTIME", iupTimerGetWallTime() - start);
+
   return IUP_DEFAULT;
 }
 
@@ -325,6 +334,16 @@ static int iGLCanvasBoxSetRedrawAttrib(Ihandle* ih, const char* value)
   return 0;
 }
 
+static char* iGLCanvasBoxGetRenderTimeAttrib(Ihandle* ih)
+{
+  return iupStrReturnDouble(iupAttribGetDouble(ih, "_IUP_RENDERTIME"));
+}
+
+static char* iGLCanvasBoxGetDrawCountAttrib(Ihandle* ih)
+{
+  return iupStrReturnInt(iupAttribGetInt(ih, "_IUP_DRAWCOUNT"));
+}
+
 static void iGLCanvasBoxComputeNaturalSizeMethod(Ihandle* ih, int *w, int *h, int *children_expand)
 {
   Ihandle* child;
@@ -465,6 +484,9 @@ static int iGLCanvasBoxMapMethod(Ihandle* ih)
 static void iGLCanvasBoxUnMapMethod(Ihandle* ih)
 {
   iupGLFontRelease(ih);
+
+  IupGLMakeCurrent(ih);
+  iupGLDrawReleaseAtlas(ih);
 }
 
 static int iGLCanvasBoxCreateMethod(Ihandle* ih, void** params)
@@ -525,6 +547,8 @@ Iclass* iupGLCanvasBoxNewClass(void)
 
   iupClassRegisterAttribute(ic, "REDRAW", NULL, iGLCanvasBoxSetRedrawAttrib, NULL, NULL, IUPAF_WRITEONLY | IUPAF_NO_INHERIT);
   iupClassRegisterAttribute(ic, "MARGIN", NULL, NULL, IUPAF_SAMEASSYSTEM, "0x0", IUPAF_NO_INHERIT);
+  iupClassRegisterAttribute(ic, "RENDERTIME", iGLCanvasBoxGetRenderTimeAttrib, NULL, NULL, NULL, IUPAF_READONLY | IUPAF_NOT_MAPPED | IUPAF_NO_INHERIT);
+  iupClassRegisterAttribute(ic, "DRAWCOUNT", iGLCanvasBoxGetDrawCountAttrib, NULL, NULL, NULL, IUPAF_READONLY | IUPAF_NOT_MAPPED | IUPAF_NO_INHERIT);
 
   /* At Children:
        VERTICALALIGN
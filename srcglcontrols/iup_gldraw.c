@@ -37,9 +37,181 @@
 
 #define iupGLDrawCheckSwapCoord(_c1, _c2) { if (_c1 > _c2) { int t = _c2; _c2 = _c1; _c1 = t; } }   /* make sure _c1 is smaller than _c2 */
 
+
+/***************************************************************/
+/* Batch */
+
+/* Primitives are accumulated in a vertex array and drawn with a single glDrawArrays,
+   until the state (primitive, texture, line width or polygon smooth) changes.
+   Primitives are never reordered, so overlapping elements are drawn as before.
+   Must be flushed before the transformation or the clipping changes, 
+   and before anything is drawn directly with OpenGL. */
+
+typedef struct _IglVertex
+{
+  GLfloat x, y;
+  GLfloat s, t;
+  GLubyte r, g, b, a;
+} IglVertex;
+
+typedef struct _IglBatch
+{
+  IglVertex* vertex;
+  int count, max_count;
+
+  GLenum mode;       /* GL_LINES or GL_TRIANGLES */
+  GLuint texture;    /* 0 if not textured */
+  float linewidth;
+  int smooth;        /* GL_POLYGON_SMOOTH enabled */
+
+  int draw_count;    /* number of glDrawArrays since the last reset */
+} IglBatch;
+
+static IglBatch gl_batch = { NULL, 0, 0, GL_LINES, 0, 1.0f, 1, 0 };
+
+void iupGLDrawFlush(void)
+{
+  GLfloat color[4];
+  int smooth;
+
+  if (gl_batch.count == 0)
+    return;
+
+  /* the color array leaves the current color undefined */
+  glGetFloatv(GL_CURRENT_COLOR, color);
+
+  smooth = glIsEnabled(GL_POLYGON_SMOOTH);
+  if (smooth && !gl_batch.smooth) glDisable(GL_POLYGON_SMOOTH);
+  else if (!smooth && gl_batch.smooth) glEnable(GL_POLYGON_SMOOTH);
+
+  if (gl_batch.mode == GL_LINES)
+    glLineWidth(gl_batch.linewidth);
+
+  glPushClientAttrib(GL_CLIENT_VERTEX_ARRAY_BIT);
+
+  glEnableClientState(GL_VERTEX_ARRAY);
+  glVertexPointer(2, GL_FLOAT, sizeof(IglVertex), &gl_batch.vertex->x);
+  glEnableClientState(GL_COLOR_ARRAY);
+  glColorPointer(4, GL_UNSIGNED_BYTE, sizeof(IglVertex), &gl_batch.vertex->r);
+
+  if (gl_batch.texture)
+  {
+    glEnable(GL_TEXTURE_2D);
+    glBindTexture(GL_TEXTURE_2D, gl_batch.texture);
+    glTexEnvi(GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE, GL_REPLACE);
+
+    glEnableClientState(GL_TEXTURE_COORD_ARRAY);
+    glTexCoordPointer(2, GL_FLOAT, sizeof(IglVertex), &gl_batch.vertex->s);
+  }
+
+  glDrawArrays(gl_batch.mode, 0, gl_batch.count);
+
+  if (gl_batch.texture)
+    glDisable(GL_TEXTURE_2D);
+
+  glPopClientAttrib();
+
+  if (smooth && !gl_batch.smooth) glEnable(GL_POLYGON_SMOOTH);
+  else if (!smooth && gl_batch.smooth) glDisable(GL_POLYGON_SMOOTH);
+
+  glColor4fv(color);
+
+  gl_batch.count = 0;
+  gl_batch.draw_count++;
+}
+
+void iupGLDrawResetDrawCount(void)
+{
+  gl_batch.draw_count = 0;
+}
+
+int iupGLDrawGetDrawCount(void)
+{
+  return gl_batch.draw_count;
+}
+
+static IglVertex* iGLDrawBatchAdd(GLenum mode, GLuint texture, float linewidth, int smooth, int count)
+{
+  IglVertex* v;
+
+  if (gl_batch.count && (gl_batch.mode != mode || gl_batch.texture != texture || gl_batch.smooth != smooth ||
+                         (mode == GL_LINES && gl_batch.linewidth != linewidth)))
+    iupGLDrawFlush();
+
+  if (gl_batch.count + count > gl_batch.max_count)
+  {
+    int max_count = gl_batch.max_count + gl_batch.max_count / 2;  /* grow geometrically */
+    if (max_count < 1024) max_count = 1024;
+    if (max_count < gl_batch.count + count) max_count = gl_batch.count + count;
+
+    v = (IglVertex*)realloc(gl_batch.vertex, max_count * sizeof(IglVertex));
+    if (!v)
+      return NULL;
+
+    gl_batch.vertex = v;
+    gl_batch.max_count = max_count;
+  }
+
+  gl_batch.mode = mode;
+  gl_batch.texture = texture;
+  gl_batch.linewidth = linewidth;
+  gl_batch.smooth = smooth;
+
+  v = gl_batch.vertex + gl_batch.count;
+  gl_batch.count += count;
+  return v;
+}
+
+static IglVertex* iGLDrawSetVertex(IglVertex* v, double x, double y, unsigned char r, unsigned char g, unsigned char b, unsigned char a)
+{
+  v->x = (GLfloat)x;
+  v->y = (GLfloat)y;
+  v->s = 0;
+  v->t = 0;
+  v->r = r;
+  v->g = g;
+  v->b = b;
+  v->a = a;
+  return v + 1;
+}
+
+static void iGLDrawBatchLines(const int* points, int count, float linewidth, unsigned char r, unsigned char g, unsigned char b, unsigned char a, int loop)
+{
+  /* GL_LINE_STRIP and GL_LINE_LOOP are converted to GL_LINES, so they can be merged */
+  int i, seg_count = loop ? count : count - 1;
+  IglVertex* v = iGLDrawBatchAdd(GL_LINES, 0, linewidth, 1, 2 * seg_count);
+  if (!v)
+    return;
+
+  for (i = 0; i < seg_count; i++)
+  {
+    int j = (i + 1) % count;
+    v = iGLDrawSetVertex(v, points[2 * i], points[2 * i + 1], r, g, b, a);
+    v = iGLDrawSetVertex(v, points[2 * j], points[2 * j + 1], r, g, b, a);
+  }
+}
+
+static void iGLDrawBatchPolygon(const double* points, int count, int smooth, unsigned char r, unsigned char g, unsigned char b, unsigned char a)
+{
+  /* convex GL_POLYGON is converted to a fan of GL_TRIANGLES, so they can be merged */
+  int i;
+  IglVertex* v = iGLDrawBatchAdd(GL_TRIANGLES, 0, 0, smooth, 3 * (count - 2));
+  if (!v)
+    return;
+
+  for (i = 1; i < count - 1; i++)
+  {
+    v = iGLDrawSetVertex(v, points[0], points[1], r, g, b, a);
+    v = iGLDrawSetVertex(v, points[2 * i], points[2 * i + 1], r, g, b, a);
+    v = iGLDrawSetVertex(v, points[2 * (i + 1)], points[2 * (i + 1) + 1], r, g, b, a);
+  }
+}
+
+
 void iupGLDrawLine(Ihandle* ih, int x1, int y1, int x2, int y2, float linewidth, const char* color, int active)
 {
   unsigned char r = 0, g = 0, b = 0, a = 255;
+  int points[4];
 
   if (!color || linewidth == 0)
     return;
@@ -48,24 +220,20 @@ void iupGLDrawLine(Ihandle* ih, int x1, int y1, int x2, int y2, float linewidth,
   if (!active)
     iupGLColorMakeInactive(&r, &g, &b);
 
-  glColor4ub(r, g, b, a);
-
-  glLineWidth(linewidth);
-
   /* y is oriented top to bottom in IUP */
   y1 = ih->currentheight - 1 - y1;
   y2 = ih->currentheight - 1 - y2;
 
-  glBegin(GL_LINES);
-  glVertex2i(x1, y1);
-  glVertex2i(x2, y2);
-  glEnd();
+  points[0] = x1;  points[1] = y1;
+  points[2] = x2;  points[3] = y2;
+  iGLDrawBatchLines(points, 2, linewidth, r, g, b, a, 0);
 }
 
 void iupGLDrawFrameRect(Ihandle* ih, int xmin, int xmax, int ymin, int ymax, float linewidth, const char* color, int active, int title_x, int title_width, int title_height)
 {
   unsigned char r = 0, g = 0, b = 0, a = 255;
   int d = 2;
+  int points[20];
 
   if (!color || linewidth == 0 || xmin == xmax || ymin == ymax)
     return;
@@ -77,10 +245,6 @@ void iupGLDrawFrameRect(Ihandle* ih, int xmin, int xmax, int ymin, int ymax, flo
   if (!active)
     iupGLColorMakeInactive(&r, &g, &b);
 
-  glColor4ub(r, g, b, a);
-
-  glLineWidth(linewidth);
-
   /* y is oriented top to bottom in IUP */
   ymin = ih->currentheight - 1 - ymin;
   ymax = ih->currentheight - 1 - ymax;
@@ -89,30 +253,29 @@ void iupGLDrawFrameRect(Ihandle* ih, int xmin, int xmax, int ymin, int ymax, flo
   /* position frame title at left-center */
   ymax -= title_height / 2;
 
-  glBegin(GL_LINE_STRIP);
-
-  glVertex2i(xmin + title_x + title_width, ymax);
+  points[0] = xmin + title_x + title_width;  points[1] = ymax;
 
-  glVertex2i(xmax - d, ymax);
-  glVertex2i(xmax, ymax - d);
+  points[2] = xmax - d;  points[3] = ymax;
+  points[4] = xmax;      points[5] = ymax - d;
 
-  glVertex2i(xmax, ymin + d);
-  glVertex2i(xmax - d, ymin);
+  points[6] = xmax;      points[7] = ymin + d;
+  points[8] = xmax - d;  points[9] = ymin;
 
-  glVertex2i(xmin + d, ymin);
-  glVertex2i(xmin, ymin + d);
+  points[10] = xmin + d;  points[11] = ymin;
+  points[12] = xmin;      points[13] = ymin + d;
 
-  glVertex2i(xmin, ymax - d);
-  glVertex2i(xmin + d, ymax);
+  points[14] = xmin;      points[15] = ymax - d;
+  points[16] = xmin + d;  points[17] = ymax;
 
-  glVertex2i(xmin + title_x, ymax);
+  points[18] = xmin + title_x;  points[19] = ymax;
 
-  glEnd();
+  iGLDrawBatchLines(points, 10, linewidth, r, g, b, a, 0);
 }
 
 void iupGLDrawRect(Ihandle* ih, int xmin, int xmax, int ymin, int ymax, float linewidth, const char* color, int active, int round)
 {
   unsigned char r = 0, g = 0, b = 0, a = 255;
+  int points[16];
 
   if (!color || linewidth == 0 || xmin == xmax || ymin == ymax)
     return;
@@ -124,49 +287,47 @@ void iupGLDrawRect(Ihandle* ih, int xmin, int xmax, int ymin, int ymax, float li
   if (!active)
     iupGLColorMakeInactive(&r, &g, &b);
 
-  glColor4ub(r, g, b, a);
-
-  glLineWidth(linewidth);
-
   /* y is oriented top to bottom in IUP */
   ymin = ih->currentheight - 1 - ymin;
   ymax = ih->currentheight - 1 - ymax;
   iupGLDrawCheckSwapCoord(ymin, ymax);
 
-  glBegin(GL_LINE_LOOP);
-
   if (round)
   {
     int rd = 2;
 
-    glVertex2i(xmin, ymax-rd);
-    glVertex2i(xmin+rd, ymax);
+    points[0] = xmin;       points[1] = ymax-rd;
+    points[2] = xmin+rd;    points[3] = ymax;
 
-    glVertex2i(xmax-rd, ymax);
-    glVertex2i(xmax, ymax-rd);
+    points[4] = xmax-rd;    points[5] = ymax;
+    points[6] = xmax;       points[7] = ymax-rd;
 
-    glVertex2i(xmax, ymin+rd);
-    glVertex2i(xmax-rd, ymin);
+    points[8] = xmax;       points[9] = ymin+rd;
+    points[10] = xmax-rd;   points[11] = ymin;
 
-    glVertex2i(xmin+rd, ymin);
-    glVertex2i(xmin, ymin+rd);
+    points[12] = xmin+rd;   points[13] = ymin;
+    points[14] = xmin;      points[15] = ymin+rd;
+
+    iGLDrawBatchLines(points, 8, linewidth, r, g, b, a, 1);
   }
   else
   {
-    glVertex2i(xmin, ymin);
-    glVertex2i(xmax, ymin);
-    glVertex2i(xmax, ymax);
-    glVertex2i(xmin, ymax);
-  }
+    points[0] = xmin;  points[1] = ymin;
+    points[2] = xmax;  points[3] = ymin;
+    points[4] = xmax;  points[5] = ymax;
+    points[6] = xmin;  points[7] = ymax;
 
-  glEnd();
+    iGLDrawBatchLines(points, 4, linewidth, r, g, b, a, 1);
+  }
 }
 
-static void iGLDrawBuildSmallCircle(int cx, int cy, int rd)
+#define IGL_CIRCLE_SEGMENTS 16
+
+static void iGLDrawBuildSmallCircle(double* points, int cx, int cy, int rd)
 {
   /* Reference: http://slabode.exofire.net/circle_draw.shtml
   Copyright SiegeLord's Abode */
-  int i, num_segments = 16;
+  int i, num_segments = IGL_CIRCLE_SEGMENTS;
   double theta = 2 * 3.1415926 / (double)num_segments;
   double c = cos(theta);  /* pre-calculate the sine and cosine */
   double s = sin(theta);
@@ -177,7 +338,8 @@ static void iGLDrawBuildSmallCircle(int cx, int cy, int rd)
 
   for (i = 0; i < num_segments; i++)
   {
-    glVertex2d(x + cx, y + cy);
+    points[2 * i + 0] = x + cx;
+    points[2 * i + 1] = y + cy;
 
     /* apply the rotation matrix */
     t = x;
@@ -189,6 +351,9 @@ static void iGLDrawBuildSmallCircle(int cx, int cy, int rd)
 void iupGLDrawSmallCircle(Ihandle* ih, int cx, int cy, int rd, float linewidth, const char* color, int active)
 {
   unsigned char r = 0, g = 0, b = 0, a = 255;
+  double points[2 * IGL_CIRCLE_SEGMENTS];
+  IglVertex* v;
+  int i;
 
   if (!color || linewidth == 0 || rd == 0)
     return;
@@ -197,23 +362,27 @@ void iupGLDrawSmallCircle(Ihandle* ih, int cx, int cy, int rd, float linewidth,
   if (!active)
     iupGLColorMakeInactive(&r, &g, &b);
 
-  glColor4ub(r, g, b, a);
-
-  glLineWidth(linewidth);
-
   /* y is oriented top to bottom in IUP */
   cy = ih->currentheight - 1 - cy;
 
-  glBegin(GL_LINE_LOOP);
+  iGLDrawBuildSmallCircle(points, cx, cy, rd);
 
-  iGLDrawBuildSmallCircle(cx, cy, rd);
+  v = iGLDrawBatchAdd(GL_LINES, 0, linewidth, 1, 2 * IGL_CIRCLE_SEGMENTS);
+  if (!v)
+    return;
 
-  glEnd();
+  for (i = 0; i < IGL_CIRCLE_SEGMENTS; i++)
+  {
+    int j = (i + 1) % IGL_CIRCLE_SEGMENTS;
+    v = iGLDrawSetVertex(v, points[2 * i], points[2 * i + 1], r, g, b, a);
+    v = iGLDrawSetVertex(v, points[2 * j], points[2 * j + 1], r, g, b, a);
+  }
 }
 
 void iupGLDrawSmallDisc(Ihandle* ih, int cx, int cy, int rd, const char* color, int active)
 {
   unsigned char r = 0, g = 0, b = 0, a = 255;
+  double points[2 * IGL_CIRCLE_SEGMENTS];
 
   if (!color || rd == 0)
     return;
@@ -222,22 +391,18 @@ void iupGLDrawSmallDisc(Ihandle* ih, int cx, int cy, int rd, const char* color,
   if (!active)
     iupGLColorMakeInactive(&r, &g, &b);
 
-  glColor4ub(r, g, b, a);
-
   /* y is oriented top to bottom in IUP */
   cy = ih->currentheight - 1 - cy;
 
-  glBegin(GL_POLYGON);
-
-  iGLDrawBuildSmallCircle(cx, cy, rd);
+  iGLDrawBuildSmallCircle(points, cx, cy, rd);
 
-  glEnd();
+  iGLDrawBatchPolygon(points, IGL_CIRCLE_SEGMENTS, 1, r, g, b, a);
 }
 
 void iupGLDrawBox(Ihandle* ih, int xmin, int xmax, int ymin, int ymax, const char* color, int active)
 {
   unsigned char r = 0, g = 0, b = 0, a = 255;
-  int smooth;
+  double points[8];
 
   if (!color || xmin == xmax || ymin == ymax)
     return;
@@ -249,29 +414,26 @@ void iupGLDrawBox(Ihandle* ih, int xmin, int xmax, int ymin, int ymax, const cha
   if (!active)
     iupGLColorMakeInactive(&r, &g, &b);
 
-  glColor4ub(r, g, b, a);
-
   /* y is oriented top to bottom in IUP */
   ymin = ih->currentheight - 1 - ymin;
   ymax = ih->currentheight - 1 - ymax;
   iupGLDrawCheckSwapCoord(ymin, ymax);
 
+  points[0] = xmin;      points[1] = ymin;
+  points[2] = xmax + 1;  points[3] = ymin;     /* fill the last pixel */
+  points[4] = xmax + 1;  points[5] = ymax + 1;
+  points[6] = xmin;      points[7] = ymax + 1;
+
   /* must disable polygon smooth or fill may get diagonal lines */
-  smooth = glIsEnabled(GL_POLYGON_SMOOTH);
-  if (smooth) glDisable(GL_POLYGON_SMOOTH);
-  glBegin(GL_QUADS);
-  glVertex2i(xmin,   ymin);
-  glVertex2i(xmax+1, ymin);     /* fill the last pixel */
-  glVertex2i(xmax+1, ymax+1);
-  glVertex2i(xmin,   ymax+1);
-  glEnd();
-  if (smooth) glEnable(GL_POLYGON_SMOOTH);
+  iGLDrawBatchPolygon(points, 4, 0, r, g, b, a);
 }
 
 void iupGLDrawPolygon(Ihandle* ih, const int* points, int count, const char* color, int active)
 {
   unsigned char r = 0, g = 0, b = 0, a = 255;
-  int i, x, y;
+  double local_points[2 * IGL_CIRCLE_SEGMENTS];
+  double* gl_points = local_points;
+  int i;
 
   if (!color || count < 3)
     return;
@@ -280,28 +442,33 @@ void iupGLDrawPolygon(Ihandle* ih, const int* points, int count, const char* col
   if (!active)
     iupGLColorMakeInactive(&r, &g, &b);
 
-  glColor4ub(r, g, b, a);
-
-  glBegin(GL_POLYGON);
+  if (count > IGL_CIRCLE_SEGMENTS)
+  {
+    gl_points = (double*)malloc(2 * count * sizeof(double));
+    if (!gl_points)
+      return;
+  }
 
   for (i = 0; i < count; i++)
   {
-    x = points[2 * i + 0];
-    y = points[2 * i + 1];
+    gl_points[2 * i + 0] = points[2 * i + 0];
 
     /* y is oriented top to bottom in IUP */
-    y = ih->currentheight - 1 - y;
-
-    glVertex2i(x, y);
+    gl_points[2 * i + 1] = ih->currentheight - 1 - points[2 * i + 1];
   }
 
-  glEnd();
+  iGLDrawBatchPolygon(gl_points, count, 1, r, g, b, a);
+
+  if (gl_points != local_points)
+    free(gl_points);
 }
 
 void iupGLDrawPolyline(Ihandle* ih, const int* points, int count, float linewidth, const char* color, int active, int loop)
 {
   unsigned char r = 0, g = 0, b = 0, a = 255;
-  int i, x, y;
+  int local_points[2 * IGL_CIRCLE_SEGMENTS];
+  int* gl_points = local_points;
+  int i;
 
   if (!color || count < 3)
     return;
@@ -310,27 +477,25 @@ void iupGLDrawPolyline(Ihandle* ih, const int* points, int count, float linewidt
   if (!active)
     iupGLColorMakeInactive(&r, &g, &b);
 
-  glColor4ub(r, g, b, a);
-
-  glLineWidth(linewidth);
-
-  if (loop)
-    glBegin(GL_LINE_LOOP);
-  else
-    glBegin(GL_LINE_STRIP);
+  if (count > IGL_CIRCLE_SEGMENTS)
+  {
+    gl_points = (int*)malloc(2 * count * sizeof(int));
+    if (!gl_points)
+      return;
+  }
 
   for (i = 0; i < count; i++)
   {
-    x = points[2 * i + 0];
-    y = points[2 * i + 1];
+    gl_points[2 * i + 0] = points[2 * i + 0];
 
     /* y is oriented top to bottom in IUP */
-    y = ih->currentheight - 1 - y;
-
-    glVertex2i(x, y);
+    gl_points[2 * i + 1] = ih->currentheight - 1 - points[2 * i + 1];
   }
 
-  glEnd();
+  iGLDrawBatchLines(gl_points, count, linewidth, r, g, b, a, loop);
+
+  if (gl_points != local_points)
+    free(gl_points);
 }
 
 void iupGLDrawArrow(Ihandle *ih, int x, int y, int size, const char* color, int active, int dir)
@@ -392,6 +557,8 @@ static int iGLIsOpenGL2orMore(void)
     return 0;
 }
 
+static void iGLDrawAtlasRemoveImage(Ihandle* image);
+
 static int iGLDestroyTexture_CB(Ihandle* image)
 {
   GLuint texture = (GLuint)iupAttribGetInt(image, "GL_TEXTURE");
@@ -402,14 +569,16 @@ static int iGLDestroyTexture_CB(Ihandle* image)
   if (texture)
     glDeleteTextures(1, &texture);
 
+  iGLDrawAtlasRemoveImage(image);
+
   return IUP_DEFAULT;
 }
 
-static GLuint iGLDrawGenTexture(Ihandle* ih, Ihandle* image, int active)
+static GLuint iGLDrawGenTexture(Ihandle* image, int active)
 {
   GLuint texture;
   const char *texture_name = "GL_TEXTURE";
-  int make_inactive = !active && iupAttribGetInt(ih, "MAKEINACTIVE");
+  int make_inactive = !active && iupAttribGetInt(image, "MAKEINACTIVE");
   if (make_inactive)
     texture_name = "GL_TEXTURE_INACTIVE";
 
@@ -418,7 +587,7 @@ static GLuint iGLDrawGenTexture(Ihandle* ih, Ihandle* image, int active)
     return texture;
   else
   {
-    unsigned char* gldata = iupGLImageGetData(image, 1);
+    unsigned char* gldata = iupGLImageGetData(image, active);
     int depth = iupAttribGetInt(image, "GL_DEPTH");
     int format = GL_RGB;
     if (depth == 4)
@@ -440,34 +609,265 @@ static GLuint iGLDrawGenTexture(Ihandle* ih, Ihandle* image, int active)
   }
 }
 
+/***************************************************************/
+/* Texture Atlas */
+
+/* Small images are packed in a single texture for each IupGLCanvasBox,
+   so consecutive images are drawn in the same batch. 
+   Images are added in rows (shelves), when full the atlas is cleared. 
+   The same image can be in several atlases, so the placements are stored in the atlas. */
+
+#define IGL_ATLAS_SIZE 1024
+#define IGL_ATLAS_MAX_IMAGE 128  /* larger images use their own texture */
+
+typedef struct _IglAtlasPlace
+{
+  int x, y;
+} IglAtlasPlace;
+
+typedef struct _IglAtlas
+{
+  GLuint texture;
+  int size;
+  int shelf_x, shelf_y, shelf_height;
+  Itable* places;           /* of IglAtlasPlace*, indexed by the image */
+  Itable* inactive_places;  /* same for the images made inactive */
+  struct _IglAtlas* next;
+} IglAtlas;
+
+static IglAtlas* gl_atlas_list = NULL;  /* all the atlases, so destroyed images can be removed */
+
+static void iGLDrawAtlasClearPlaces(Itable* places)
+{
+  char* key = iupTableFirst(places);
+  while (key)
+  {
+    free(iupTableGetCurr(places));
+    key = iupTableNext(places);
+  }
+  iupTableClear(places);
+}
+
+static void iGLDrawAtlasClear(IglAtlas* atlas)
+{
+  iGLDrawAtlasClearPlaces(atlas->places);
+  iGLDrawAtlasClearPlaces(atlas->inactive_places);
+  atlas->shelf_x = 0;
+  atlas->shelf_y = 0;
+  atlas->shelf_height = 0;
+}
+
+static void iGLDrawAtlasRemovePlace(Itable* places, Ihandle* image)
+{
+  IglAtlasPlace* place = (IglAtlasPlace*)iupTableGet(places, (const char*)image);
+  if (place)
+  {
+    free(place);
+    iupTableRemove(places, (const char*)image);
+  }
+}
+
+static void iGLDrawAtlasRemoveImage(Ihandle* image)
+{
+  /* the space is not reused, but a new image with the same address will not get this placement */
+  IglAtlas* atlas = gl_atlas_list;
+  while (atlas)
+  {
+    iGLDrawAtlasRemovePlace(atlas->places, image);
+    iGLDrawAtlasRemovePlace(atlas->inactive_places, image);
+    atlas = atlas->next;
+  }
+}
+
+static IglAtlas* iGLDrawGetAtlas(Ihandle* gl_parent)
+{
+  IglAtlas* atlas = (IglAtlas*)iupAttribGet(gl_parent, "_IUP_GLATLAS");
+  if (!atlas)
+  {
+    GLint max_size = 0;
+    glGetIntegerv(GL_MAX_TEXTURE_SIZE, &max_size);
+
+    atlas = (IglAtlas*)calloc(1, sizeof(IglAtlas));
+    if (!atlas)
+      return NULL;
+
+    atlas->size = max_size < IGL_ATLAS_SIZE ? (int)max_size : IGL_ATLAS_SIZE;
+    atlas->places = iupTableCreate(IUPTABLE_POINTERINDEXED);
+    atlas->inactive_places = iupTableCreate(IUPTABLE_POINTERINDEXED);
+
+    glGenTextures(1, &atlas->texture);
+
+    glBindTexture(GL_TEXTURE_2D, atlas->texture);
+
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, atlas->size, atlas->size, 0, GL_RGBA, GL_UNSIGNED_BYTE, NULL);
+
+    atlas->next = gl_atlas_list;
+    gl_atlas_list = atlas;
+
+    iupAttribSet(gl_parent, "_IUP_GLATLAS", (char*)atlas);
+  }
+  return atlas;
+}
+
+void iupGLDrawReleaseAtlas(Ihandle* gl_parent)
+{
+  IglAtlas* atlas = (IglAtlas*)iupAttribGet(gl_parent, "_IUP_GLATLAS");
+  if (atlas)
+  {
+    IglAtlas* *prev = &gl_atlas_list;
+    while (*prev != atlas)
+      prev = &((*prev)->next);
+    *prev = atlas->next;
+
+    if (atlas->texture)
+      glDeleteTextures(1, &atlas->texture);
+
+    iGLDrawAtlasClearPlaces(atlas->places);
+    iGLDrawAtlasClearPlaces(atlas->inactive_places);
+    iupTableDestroy(atlas->places);
+    iupTableDestroy(atlas->inactive_places);
+    free(atlas);
+
+    iupAttribSet(gl_parent, "_IUP_GLATLAS", NULL);
+  }
+}
+
+static int iGLDrawAtlasAdd(IglAtlas* atlas, int w, int h, int *x, int *y)
+{
+  /* one pixel of space between images, so they do not bleed into each other */
+  w++;
+  h++;
+
+  if (atlas->shelf_x + w > atlas->size)
+  {
+    /* start a new shelf */
+    atlas->shelf_x = 0;
+    atlas->shelf_y += atlas->shelf_height;
+    atlas->shelf_height = 0;
+  }
+
+  if (w > atlas->size || atlas->shelf_y + h > atlas->size)
+    return 0;
+
+  *x = atlas->shelf_x;
+  *y = atlas->shelf_y;
+
+  atlas->shelf_x += w;
+  if (h > atlas->shelf_height)
+    atlas->shelf_height = h;
+
+  return 1;
+}
+
+static GLuint iGLDrawGetAtlasTexture(Ihandle* ih, Ihandle* image, int active, double *s0, double *t0, double *s1, double *t1)
+{
+  Ihandle* gl_parent = (Ihandle*)iupAttribGet(ih, "_IUP_GLCANVAS_PARENT");
+  int make_inactive = !active && iupAttribGetInt(image, "MAKEINACTIVE");
+  int w = image->currentwidth;
+  int h = image->currentheight;
+  IglAtlas* atlas;
+  Itable* places;
+  IglAtlasPlace* place;
+  int x, y;
+
+  if (!gl_parent || w > IGL_ATLAS_MAX_IMAGE || h > IGL_ATLAS_MAX_IMAGE)
+    return 0;
+
+  atlas = iGLDrawGetAtlas(gl_parent);
+  if (!atlas || !atlas->texture)
+    return 0;
+
+  places = make_inactive ? atlas->inactive_places : atlas->places;
+  place = (IglAtlasPlace*)iupTableGet(places, (const char*)image);
+  if (place)
+  {
+    x = place->x;
+    y = place->y;
+  }
+  else
+  {
+    unsigned char* gldata;
+    int depth, format = GL_RGB;
+
+    gldata = iupGLImageGetData(image, active);
+    if (!gldata)
+      return 0;
+
+    place = (IglAtlasPlace*)malloc(sizeof(IglAtlasPlace));
+    if (!place)
+      return 0;
+
+    if (!iGLDrawAtlasAdd(atlas, w, h, &x, &y))
+    {
+      iupGLDrawFlush();  /* pending images still use the current contents */
+      iGLDrawAtlasClear(atlas);
+
+      if (!iGLDrawAtlasAdd(atlas, w, h, &x, &y))
+      {
+        free(place);
+        return 0;
+      }
+    }
+
+    depth = iupAttribGetInt(image, "GL_DEPTH");
+    if (depth == 4)
+      format = GL_RGBA;
+
+    glBindTexture(GL_TEXTURE_2D, atlas->texture);
+    glTexSubImage2D(GL_TEXTURE_2D, 0, x, y, w, h, format, GL_UNSIGNED_BYTE, gldata);
+
+    place->x = x;
+    place->y = y;
+    iupTableSet(places, (const char*)image, place, IUPTABLE_POINTER);
+
+    /* removes the placements when the image is destroyed */
+    IupSetCallback(image, "DESTROY_CB", iGLDestroyTexture_CB);
+  }
+
+  *s0 = (double)x / (double)atlas->size;
+  *t0 = (double)y / (double)atlas->size;
+  *s1 = (double)(x + w) / (double)atlas->size;
+  *t1 = (double)(y + h) / (double)atlas->size;
+  return atlas->texture;
+}
+
 static void iGLDrawImage(Ihandle* ih, int xmin, int xmax, int ymin, int ymax, Ihandle* image, int active)
 {
   if (iGLIsOpenGL2orMore())
   {
-    GLuint texture = iGLDrawGenTexture(ih, image, active);
+    double s0 = 0, t0 = 0, s1 = 1, t1 = 1;
+    GLuint texture = iGLDrawGetAtlasTexture(ih, image, active, &s0, &t0, &s1, &t1);
+    if (!texture)
+      texture = iGLDrawGenTexture(image, active);
+
     if (texture)
     {
-      int smooth = glIsEnabled(GL_POLYGON_SMOOTH);
-      if (smooth) glDisable(GL_POLYGON_SMOOTH);
-      glEnable(GL_TEXTURE_2D);
-
-      glBindTexture(GL_TEXTURE_2D, texture);
-      glTexEnvi(GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE, GL_REPLACE);
+      /* must disable polygon smooth or images may get diagonal lines */
+      IglVertex* v = iGLDrawBatchAdd(GL_TRIANGLES, texture, 0, 0, 6);
+      if (!v)
+        return;
 
       /* y is oriented top to bottom in IUP */
       ymin = ih->currentheight - 1 - ymin;
       ymax = ih->currentheight - 1 - ymax;
       iupGLDrawCheckSwapCoord(ymin, ymax);
 
-      glBegin(GL_QUADS);
-      glTexCoord2d(0.0, 0.0); glVertex2d(xmin, ymin);
-      glTexCoord2d(1.0, 0.0); glVertex2d(xmax + 0.375, ymin);
-      glTexCoord2d(1.0, 1.0); glVertex2d(xmax + 0.375, ymax + 0.375);
-      glTexCoord2d(0.0, 1.0); glVertex2d(xmin, ymax + 0.375);
-      glEnd();
-
-      glDisable(GL_TEXTURE_2D);
-      if (smooth) glEnable(GL_POLYGON_SMOOTH);
+      iGLDrawSetVertex(v + 0, xmin,         ymin,         255, 255, 255, 255);
+      iGLDrawSetVertex(v + 1, xmax + 0.375, ymin,         255, 255, 255, 255);
+      iGLDrawSetVertex(v + 2, xmax + 0.375, ymax + 0.375, 255, 255, 255, 255);
+      iGLDrawSetVertex(v + 3, xmin,         ymin,         255, 255, 255, 255);
+      iGLDrawSetVertex(v + 4, xmax + 0.375, ymax + 0.375, 255, 255, 255, 255);
+      iGLDrawSetVertex(v + 5, xmin,         ymax + 0.375, 255, 255, 255, 255);
+
+      v[0].s = (GLfloat)s0;  v[0].t = (GLfloat)t0;
+      v[1].s = (GLfloat)s1;  v[1].t = (GLfloat)t0;
+      v[2].s = (GLfloat)s1;  v[2].t = (GLfloat)t1;
+      v[3].s = (GLfloat)s0;  v[3].t = (GLfloat)t0;
+      v[4].s = (GLfloat)s1;  v[4].t = (GLfloat)t1;
+      v[5].s = (GLfloat)s0;  v[5].t = (GLfloat)t1;
     }
   }
   else
@@ -490,6 +890,8 @@ static void iGLDrawImage(Ihandle* ih, int xmin, int xmax, int ymin, int ymax, Ih
     /* y is oriented top to bottom in IUP */
     ymin = ih->currentheight - 1 - ymin;
 
+    iupGLDrawFlush();  /* drawn directly */
+
     if (image->currentwidth != rw || image->currentheight != rh)
       glPixelZoom((GLfloat)rw / (GLfloat)image->currentwidth, (GLfloat)rh / (GLfloat)image->currentheight);
 
@@ -536,6 +938,8 @@ static void iGLDrawText(Ihandle* ih, const char* str, int max_len, int x, int y)
   /* y is oriented top to bottom in IUP */
   y = ih->currentheight - 1 - y;
 
+  iupGLDrawFlush();  /* text is drawn directly */
+
   if (underline)
     glLineWidth(1.0f);
 
@@ -610,6 +1014,9 @@ void IupGLDrawImage(Ihandle* ih, const char* name, int x, int y, int active)
     return;
 
   iupGLDrawIconImage(ih, x, y, NULL, name, active);
+
+  /* the application may draw directly after this */
+  iupGLDrawFlush();
 }
 
 void IupGLDrawText(Ihandle* ih, const char* str, int len, int x, int y)
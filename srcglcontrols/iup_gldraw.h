@@ -27,6 +27,12 @@ void iupGLDrawArrow(Ihandle *ih, int x, int y, int size, const char* color, int
 void iupGLDrawSmallCircle(Ihandle* ih, int cx, int cy, int r, float linewidth, const char* color, int active);
 void iupGLDrawSmallDisc(Ihandle* ih, int cx, int cy, int rd, const char* color, int active);
 
+/* Primitives are batched, flush before the transformation changes or before drawing directly */
+void iupGLDrawFlush(void);
+void iupGLDrawResetDrawCount(void);
+int  iupGLDrawGetDrawCount(void);
+void iupGLDrawReleaseAtlas(Ihandle* gl_parent);
+
 
 #ifdef __cplusplus
 }
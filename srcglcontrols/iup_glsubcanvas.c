@@ -29,6 +29,7 @@
 
 #include "iup_glcontrols.h"
 #include "iup_glfont.h"
+#include "iup_gldraw.h"
 #include "iup_glsubcanvas.h"
 
 
@@ -135,6 +136,9 @@ int iupGLSubCanvasSetTransform(Ihandle* ih, Ihandle* gl_parent)
   int w = ih->currentwidth;
   int h = ih->currentheight;
 
+  /* draw what was batched with the previous transformation */
+  iupGLDrawFlush();
+
   /* crop to parent's rectangle */
   if (!iGLSetClipping(ih, x, y, w, h, gl_parent))
     return 0;
@@ -213,6 +217,8 @@ void iupGLSubCanvasRestoreState(Ihandle* gl_parent)
   if (!saved)
     return;
 
+  iupGLDrawFlush();
+
   /* restore transformation matrix */
   glMatrixMode(GL_MODELVIEW);
   glPopMatrix();
@@ -3,7 +3,7 @@ APPNAME = ledc
 APPTYPE = console
 OPT = YES
 
-INCLUDES = .
+INCLUDES = . ../src
 
 SRC = lex.yy.c y.tab.c ledc.c
 
@@ -12,6 +12,7 @@
 #include <errno.h>
 
 #include "ledc.h"
+#include "iup_ledbin.h"
 
 #define alloc(type)  ((type*)malloc(sizeof(type)))
 
@@ -24,6 +25,7 @@ char *outname = 0;
 char *funcname = 0;
 int   nocode = 0;
 int   static_image = 0;
+int   binary = 0;
 
 typedef struct {
   char* name;
@@ -799,6 +801,196 @@ static void code_string_elem( Telem* elem )
   fprintf( outfile, ")" );
 }
 
+/****************************************************************/
+/* precompiled LED, see iup_ledbin.h                            */
+
+static struct {
+  char*  strings;
+  int    strings_size, strings_max;
+  unsigned int* offsets;
+  int    nstrings, offsets_max;
+  int*   code;
+  int    ncode, code_max;
+  int    nslots;
+} bin = { 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 };
+
+static void bin_code( int value )
+{
+  if (bin.ncode == bin.code_max)
+  {
+    bin.code_max += 1024;
+    bin.code = (int*)realloc( bin.code, bin.code_max*sizeof(int) );
+  }
+  bin.code[bin.ncode++] = value;
+}
+
+/* the same escape sequences of the LED lexer */
+static char* bin_unescape( char* str )
+{
+  char *dst = (char*)malloc( strlen(str)+1 ), *p = dst;
+  while (*str)
+  {
+    if (*str == '\\' && str[1])
+    {
+      str++;
+      *p++ = (*str == 'n')? '\n': *str;
+    }
+    else
+      *p++ = *str;
+    str++;
+  }
+  *p = 0;
+  return dst;
+}
+
+static int bin_string( char* value )
+{
+  char* str = bin_unescape( value );
+  int i, len = (int)strlen(str)+1;
+
+  for (i=0; i<bin.nstrings; i++)
+  {
+    if (!strcmp( bin.strings + bin.offsets[i], str ))
+    {
+      free( str );
+      return i;
+    }
+  }
+
+  if (bin.nstrings == bin.offsets_max)
+  {
+    bin.offsets_max += 100;
+    bin.offsets = (unsigned int*)realloc( bin.offsets, bin.offsets_max*sizeof(unsigned int) );
+  }
+  while (bin.strings_size+len > bin.strings_max)
+  {
+    bin.strings_max += 4096;
+    bin.strings = (char*)realloc( bin.strings, bin.strings_max );
+  }
+
+  bin.offsets[bin.nstrings] = (unsigned int)bin.strings_size;
+  memcpy( bin.strings+bin.strings_size, str, len );
+  bin.strings_size += len;
+  free( str );
+  return bin.nstrings++;
+}
+
+/* children are created before their parent, returns the slot of the element */
+static int bin_elem( Telem* elem )
+{
+  int i, slot, nattrs = 0;
+  int* params = 0;
+  int isimage = elem->elemidx == IMAGE ||
+                elem->elemidx == IMAGERGB ||
+                elem->elemidx == IMAGERGBA;
+
+  if (elem->nparams)
+    params = (int*)malloc( 2*elem->nparams*sizeof(int) );
+
+  for (i=0; i<elem->nparams; i++)
+  {
+    Tparam* p = elem->params[i];
+    switch (p->tag)
+    {
+      case ELEM_PARAM:
+        params[2*i] = ILEDB_PARAM_ELEM;
+        params[2*i+1] = bin_elem( p->data.elem );
+        break;
+      case STRING_PARAM:
+        params[2*i] = ILEDB_PARAM_STR;
+        params[2*i+1] = bin_string( p->data.name );
+        break;
+      case NAME_PARAM:
+        if (isimage)
+        {
+          /* image size and pixels are stored as numbers */
+          params[2*i] = ILEDB_PARAM_INT;
+          params[2*i+1] = atoi( p->data.name );
+        }
+        else
+        {
+          params[2*i] = ILEDB_PARAM_WORD;
+          params[2*i+1] = bin_string( p->data.name );
+        }
+        break;
+    }
+  }
+
+  bin_code( ILEDB_OP_ELEM );
+  bin_code( bin_string( elem->elemname ) );
+  bin_code( elem->nparams );
+  for (i=0; i<2*elem->nparams; i++)
+    bin_code( params[i] );
+  if (params) free( params );
+
+  if (elem->attrs)
+    nattrs = elem->attrs->size;
+  bin_code( nattrs );
+  if (elem->attrs)
+  {
+    Telemlist *p = elem->attrs->first;
+    while (p)
+    {
+      Tattr* a = (Tattr*)p->data;
+      bin_code( bin_string( a->name ) );
+      bin_code( a->value? bin_string( a->value ): ILEDB_NONE );
+      p = p->next;
+    }
+  }
+
+  slot = bin.nslots++;
+
+  if (elem->name)
+  {
+    bin_code( ILEDB_OP_NAME );
+    bin_code( slot );
+    bin_code( bin_string( elem->name ) );
+  }
+
+  return slot;
+}
+
+static void bin_finish( void )
+{
+  IledbHeader header;
+  Telemlist *p;
+  int pad;
+  char zeros[4] = { 0, 0, 0, 0 };
+
+  revertlist( all_elems );
+  p = all_elems->first;
+  while (p)
+  {
+    bin_elem( (Telem*)(p->data) );
+    p = p->next;
+  }
+
+  pad = (4 - bin.strings_size%4)%4;
+
+  memset( &header, 0, sizeof(IledbHeader) );
+  memcpy( header.magic, ILEDB_MAGIC, sizeof(header.magic) );
+  header.byte_order = ILEDB_BYTE_ORDER;
+  header.version = ILEDB_VERSION;
+  header.string_count = (unsigned int)bin.nstrings;
+  header.string_size = (unsigned int)(bin.strings_size+pad);
+  header.code_count = (unsigned int)bin.ncode;
+
+  outfile = fopen( outname, "wb" );
+  if (!outfile) 
+  {
+    perror( outname );
+    exit(-1);
+  }
+
+  fwrite( &header, sizeof(IledbHeader), 1, outfile );
+  fwrite( bin.offsets, sizeof(unsigned int), bin.nstrings, outfile );
+  fwrite( bin.strings, 1, bin.strings_size, outfile );
+  fwrite( zeros, 1, pad, outfile );
+  fwrite( bin.code, sizeof(int), bin.ncode, outfile );
+
+  fclose( outfile );
+}
+
 /****************************************************************/
 
 static char* strlower( char* str )
@@ -894,7 +1086,12 @@ void decl( Telem* e )
   else
   {
     if (nerrors || nocode) return;
-    if (e->elemidx == IMAGE || e->elemidx == IMAGERGB || e->elemidx == IMAGERGBA)
+    if (binary)
+    {
+      /* all elements in the declaration order */
+      addlist( all_elems, e );
+    }
+    else if (e->elemidx == IMAGE || e->elemidx == IMAGERGB || e->elemidx == IMAGERGBA)
     {
       code_image( e );
       addlist( all_images, e );
@@ -957,7 +1154,7 @@ void init(void)
   all_named = list();
   all_late = list();
 
-  if (nocode) return;
+  if (nocode || binary) return;
   outfile = stdout;
 
   outfile = fopen( outname, "wb" );
@@ -988,6 +1185,12 @@ void finish(void)
 
   if (nerrors || nocode) return;
 
+  if (binary)
+  {
+    bin_finish();
+    return;
+  }
+
   for (i=1; i<nheaders; i++)
   {
     if (headerfile[i].used)
@@ -76,6 +76,7 @@ extern char* outname;
 extern char* funcname;
 extern int   nocode;
 extern int   static_image;
+extern int   binary;
 
 #ifdef __cplusplus
 }
@@ -163,10 +163,11 @@ void yyerror(char *str)
 static int usage(void)
 {
   fprintf( stderr, 
-    "ledc [-v] [-c] [-f funcname] [-o file] files\n"
+    "ledc [-v] [-c] [-b] [-f funcname] [-o file] files\n"
     "  -v            print the version number\n"
     "  -c            only perform checking, do not generate code\n"
     "  -s            declarate image data as static\n"
+    "  -b            generate a precompiled LED file, loaded by IupLoad (default: led.ledb)\n"
     "  -f funcname   generate exported function <funcname> (default: led_load)\n"
     "  -o file       place output in file <file> (default: led.c)\n"
   );
@@ -216,12 +217,15 @@ int main(int argc, char *argv[])
       case 's':
         static_image = 1;
         break;
+      case 'b':
+        binary = 1;
+        break;
       default:
         return usage();
     }
   }
 
-  if (!outname)  outname  = "led.c";
+  if (!outname)  outname  = binary? "led.ledb": "led.c";
   if (!funcname) funcname = "led_load";
 
   init();
@@ -91,6 +91,45 @@ static int PlotInsert3D(lua_State *L)
   return 0;
 }
 
+static int PlotAddSamples1D(lua_State *L)
+{
+  double *py;
+  char* *px;
+  int count = luaL_checkinteger(L, 5);
+  px = iuplua_checkstring_array(L, 3, count);
+  py = iuplua_checkdouble_array(L, 4, count);
+  IupMglPlotAddSamples1D(iuplua_checkihandle(L,1), luaL_checkinteger(L,2), px, py, count);
+  free(px);
+  free(py);
+  return 0;
+}
+
+static int PlotAddSamples2D(lua_State *L)
+{
+  double *px, *py;
+  int count = luaL_checkinteger(L, 5);
+  px = iuplua_checkdouble_array(L, 3, count);
+  py = iuplua_checkdouble_array(L, 4, count);
+  IupMglPlotAddSamples2D(iuplua_checkihandle(L,1), luaL_checkinteger(L,2), px, py, count);
+  free(px);
+  free(py);
+  return 0;
+}
+
+static int PlotAddSamples3D(lua_State *L)
+{
+  double *px, *py, *pz;
+  int count = luaL_checkinteger(L, 6);
+  px = iuplua_checkdouble_array(L, 3, count);
+  py = iuplua_checkdouble_array(L, 4, count);
+  pz = iuplua_checkdouble_array(L, 5, count);
+  IupMglPlotAddSamples3D(iuplua_checkihandle(L,1), luaL_checkinteger(L,2), px, py, pz, count);
+  free(px);
+  free(py);
+  free(pz);
+  return 0;
+}
+
 static int PlotSet1D(lua_State *L)
 {
   double *py;
@@ -142,6 +181,14 @@ static int PlotLoadData(lua_State *L)
   return 0;
 }
 
+static int PlotLoadRawData(lua_State *L)
+{
+  int ret = IupMglPlotLoadRawData(iuplua_checkihandle(L,1), luaL_checkinteger(L,2), luaL_checkstring(L,3), luaL_optstring(L,4,NULL), 
+                                  luaL_optinteger(L,5,0), luaL_optinteger(L,6,0), luaL_optinteger(L,7,0), luaL_optinteger(L,8,1));
+  lua_pushinteger(L, ret);
+  return 1;
+}
+
 static int PlotSetFromFormula(lua_State *L)
 {
   IupMglPlotSetFromFormula(iuplua_checkihandle(L,1), luaL_checkinteger(L,2), luaL_checkstring(L,3), luaL_checkinteger(L,4), luaL_checkinteger(L,5), luaL_checkinteger(L,6));
@@ -246,12 +293,16 @@ void iuplua_mglplotfuncs_open(lua_State *L)
   iuplua_register(L, PlotInsert1D    ,"MglPlotInsert1D");
   iuplua_register(L, PlotInsert2D    ,"MglPlotInsert2D");
   iuplua_register(L, PlotInsert3D    ,"MglPlotInsert3D");
+  iuplua_register(L, PlotAddSamples1D,"MglPlotAddSamples1D");
+  iuplua_register(L, PlotAddSamples2D,"MglPlotAddSamples2D");
+  iuplua_register(L, PlotAddSamples3D,"MglPlotAddSamples3D");
   iuplua_register(L, PlotSet1D       ,"MglPlotSet1D");
   iuplua_register(L, PlotSet2D       ,"MglPlotSet2D");
   iuplua_register(L, PlotSet3D       ,"MglPlotSet3D");
   iuplua_register(L, PlotSetFormula  ,"MglPlotSetFormula");
   iuplua_register(L, PlotSetData     ,"MglPlotSetData");
   iuplua_register(L, PlotLoadData    ,"MglPlotLoadData");
+  iuplua_register(L, PlotLoadRawData ,"MglPlotLoadRawData");
   iuplua_register(L, PlotSetFromFormula,"MglPlotSetFromFormula");
   iuplua_register(L, PlotTransform   ,"MglPlotTransform");
   iuplua_register(L, PlotTransformTo ,"MglPlotTransformTo");
@@ -28,11 +28,15 @@ ctrl.NewDataSet  = iup.MglPlotNewDataSet
 ctrl.Insert1D    = iup.MglPlotInsert1D
 ctrl.Insert2D    = iup.MglPlotInsert2D
 ctrl.Insert3D    = iup.MglPlotInsert3D
+ctrl.AddSamples1D = iup.MglPlotAddSamples1D
+ctrl.AddSamples2D = iup.MglPlotAddSamples2D
+ctrl.AddSamples3D = iup.MglPlotAddSamples3D
 ctrl.Set1D       = iup.MglPlotSet1D
 ctrl.Set2D       = iup.MglPlotSet2D
 ctrl.Set3D       = iup.MglPlotSet3D
 ctrl.SetFormula  = iup.MglPlotSetFormula
 ctrl.LoadData    = iup.MglPlotLoadData
+ctrl.LoadRawData = iup.MglPlotLoadRawData
 ctrl.SetFromFormula  = iup.MglPlotSetFromFormula
 ctrl.SetData      = iup.MglPlotSetData
 ctrl.Transform    = iup.MglPlotTransform
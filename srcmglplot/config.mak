@@ -18,6 +18,10 @@ DEF_FILE = iup_mglplot.def
 INCLUDES = ../include ../src . 
 LDIR = ../lib/$(TEC_UNAME) $(CD)/lib/$(TEC_UNAME)
 LIBS := iup iupgl $(LIBS)
+ifeq ($(findstring Win, $(TEC_SYSNAME)), )
+  # MGL_HAVE_PTHREAD is enabled in mgl2/config.h for non Windows systems
+  LIBS += pthread
+endif
 DEFINES += MGL_STATIC_DEFINE MGL_SRC
 
 # File config.h modified for IUP
@@ -11,6 +11,7 @@
 #include <string.h>
 #include <ctype.h>
 #include <float.h>
+#include <limits.h>
 
 #include "iup.h"
 #include "iupcbs.h"
@@ -32,15 +33,28 @@
 
 #ifdef WIN32
 #include <windows.h>
+#else
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
 #endif
 #include <GL/gl.h>
 
 #pragma warning(push, 0)
 #include "mgl2/mgl.h"
+#include "mgl2/thread.h"
 #pragma warning(pop)
 
 
 enum {IUP_MGLPLOT_BOTTOMLEFT, IUP_MGLPLOT_BOTTOMRIGHT, IUP_MGLPLOT_TOPLEFT, IUP_MGLPLOT_TOPRIGHT};
+enum {IUP_MGLPLOT_RENDER_IDLE, IUP_MGLPLOT_RENDER_BUSY, IUP_MGLPLOT_RENDER_DONE};
+enum {IUP_MGLPLOT_RAW_DOUBLE, IUP_MGLPLOT_RAW_FLOAT, IUP_MGLPLOT_RAW_INT, IUP_MGLPLOT_RAW_SHORT, IUP_MGLPLOT_RAW_USHORT, IUP_MGLPLOT_RAW_CHAR, IUP_MGLPLOT_RAW_UCHAR};
+
+#define IUP_MGLPLOT_RENDER_POLL 10      // ms, checks if the background render is done
+#define IUP_MGLPLOT_REFINE_DELAY 250    // ms without interaction before the full quality render
+#define IUP_MGLPLOT_RAW_CHUNK 65536     // values read at once when streaming a raw file
 
 #define MAX_FONTSTYLE 32 // Same as MathGL
 
@@ -63,6 +77,10 @@ typedef struct _IdataSet
   mglData* dsY;  /* Linear Only (dsDim=2,3) */
   mglData* dsZ;  /* Linear Only (dsDim=3) */
   int dsCount;
+
+  int dsCapacity;   /* samples allocated by IupMglPlotAddSamples*, reset by iMglPlotDataSetChanged */
+  void* dsMapData;  /* raw file mapped by IupMglPlotLoadRawData, linked in dsX */
+  size_t dsMapSize;
 } IdataSet;
 
 typedef struct _Iaxis
@@ -103,6 +121,18 @@ struct _IcontrolData
   bool redraw;
   bool opengl;
 
+  /* Background Render (only when OPENGL=No) */
+  bool render_background;
+  mglGraph* mgl_back;      // scene rendered by the thread, swapped with mgl when done
+  Ihandle* render_thread;
+  Ihandle* render_timer;   // polls the thread while it is rendering
+  Ihandle* refine_timer;   // full quality render after the interaction stops
+  volatile int render_state;
+  bool render_preview,     // the last started render used the preview quality
+       render_cancel,      // the running render was stopped, its result will be discarded
+       render_pending,     // the scene changed while rendering
+       interacting;        // mouse or keyboard interaction in progress, use preview quality
+
   /* Obtained from FONT */
   double FontSizeDef;
   char FontStyleDef[MAX_FONTSTYLE];
@@ -1747,8 +1777,201 @@ static void iMglPlotDrawPlot(Ihandle* ih, mglGraph *gr)
   iupAttribSet(ih, "_IUP_MGLPLOT_GRAPH", NULL);
 }
 
+static bool iMglPlotIsBackgroundRender(Ihandle* ih)
+{
+  // OpenGL rendering must be done in the thread of the context
+  return ih->data->render_background && !ih->data->opengl;
+}
+
+static void iMglPlotRenderFlush(Ihandle* ih)
+{
+  // The displayed graph was already rendered, GetRGB will not render it again.
+  // Its size may be different from the canvas size while a new render is not done.
+  mglGraph* gr = ih->data->mgl;
+
+  if (!ih->handle)
+    return;
+
+  IupGLMakeCurrent(ih);
+
+  const unsigned char *rgb = gr->GetRGB();
+  if (rgb)
+    glDrawPixels(gr->GetWidth(), gr->GetHeight(), GL_RGB, GL_UNSIGNED_BYTE, rgb);
+
+  IupGLSwapBuffers(ih);
+}
+
+static int iMglPlotRenderThread_CB(Ihandle* thread)
+{
+  Ihandle* ih = (Ihandle*)iupAttribGet(thread, "_IUP_MGLPLOT");
+
+  // Only the rasterization is done here, the scene was built in the main thread
+  ih->data->mgl_back->Finish();
+
+  ih->data->render_state = IUP_MGLPLOT_RENDER_DONE;
+  return IUP_DEFAULT;
+}
+
+static int iMglPlotRenderTimer_CB(Ihandle* timer);
+
+static void iMglPlotRenderStart(Ihandle* ih)
+{
+  if (!ih->data->mgl_back)
+    ih->data->mgl_back = new mglGraph(0, ih->data->w, ih->data->h);
+  else if (ih->data->mgl_back->GetWidth() != ih->data->w || ih->data->mgl_back->GetHeight() != ih->data->h)
+    ih->data->mgl_back->SetSize(ih->data->w, ih->data->h);
+
+  if (!ih->data->render_thread)
+  {
+    ih->data->render_thread = IupThread();
+    IupSetCallback(ih->data->render_thread, "THREAD_CB", (Icallback)iMglPlotRenderThread_CB);
+    iupAttribSet(ih->data->render_thread, "_IUP_MGLPLOT", (char*)ih);
+
+    ih->data->render_timer = IupTimer();
+    IupSetCallback(ih->data->render_timer, "ACTION_CB", (Icallback)iMglPlotRenderTimer_CB);
+    IupSetInt(ih->data->render_timer, "TIME", IUP_MGLPLOT_RENDER_POLL);
+    iupAttribSet(ih->data->render_timer, "_IUP_MGLPLOT", (char*)ih);
+  }
+
+  mglGraph* gr = ih->data->mgl_back;
+  gr->Stop(false);
+
+  // The preview does not interpolate colors inside primitives
+  gr->SetQuality(ih->data->interacting? MGL_DRAW_FAST: MGL_DRAW_NORM);
+
+  // Build the scene in the main thread, it calls the application callbacks
+  iMglPlotDrawPlot(ih, gr);
+
+  ih->data->redraw = false;
+  ih->data->render_preview = ih->data->interacting;
+  ih->data->render_cancel = false;
+  ih->data->render_pending = false;
+  ih->data->render_state = IUP_MGLPLOT_RENDER_BUSY;
+
+  IupSetAttribute(ih->data->render_thread, "START", "Yes");
+  if (!iupAttribGet(ih->data->render_thread, "THREAD"))
+  {
+    // threads are not supported by the driver
+    gr->Finish();
+    ih->data->render_state = IUP_MGLPLOT_RENDER_DONE;
+  }
+
+  IupSetAttribute(ih->data->render_timer, "RUN", "Yes");
+}
+
+static void iMglPlotRenderJoin(Ihandle* ih)
+{
+  IupSetAttribute(ih->data->render_timer, "RUN", "No");
+  IupSetAttribute(ih->data->render_thread, "JOIN", "Yes");
+  ih->data->render_state = IUP_MGLPLOT_RENDER_IDLE;
+}
+
+static int iMglPlotRenderTimer_CB(Ihandle* timer)
+{
+  Ihandle* ih = (Ihandle*)iupAttribGet(timer, "_IUP_MGLPLOT");
+
+  if (ih->data->render_state != IUP_MGLPLOT_RENDER_DONE)
+    return IUP_DEFAULT;
+
+  iMglPlotRenderJoin(ih);
+
+  if (!ih->data->render_cancel)
+  {
+    // Swap the buffers, the rendered graph will be displayed
+    mglGraph* gr = ih->data->mgl;
+    ih->data->mgl = ih->data->mgl_back;
+    ih->data->mgl_back = gr;
+
+    iMglPlotRenderFlush(ih);
+  }
+
+  if (ih->data->render_pending)
+    iMglPlotRenderStart(ih);
+
+  return IUP_DEFAULT;
+}
+
+static void iMglPlotRenderRequest(Ihandle* ih)
+{
+  if (ih->data->render_state != IUP_MGLPLOT_RENDER_IDLE)
+  {
+    ih->data->render_pending = true;
+
+    // A full quality render is stale when the interaction starts, 
+    // but previews are not stopped so something is displayed while interacting
+    if (ih->data->interacting && !ih->data->render_preview && !ih->data->render_cancel)
+    {
+      ih->data->render_cancel = true;
+      ih->data->mgl_back->Stop(true);
+    }
+    return;
+  }
+
+  iMglPlotRenderStart(ih);
+}
+
+static void iMglPlotRenderCancel(Ihandle* ih)
+{
+  if (ih->data->refine_timer)
+    IupSetAttribute(ih->data->refine_timer, "RUN", "No");
+  ih->data->interacting = false;
+
+  if (ih->data->render_state != IUP_MGLPLOT_RENDER_IDLE)
+  {
+    ih->data->mgl_back->Stop(true);
+    iMglPlotRenderJoin(ih);
+  }
+
+  ih->data->render_pending = false;
+}
+
+static void iMglPlotInteractEnd(Ihandle* ih)
+{
+  IupSetAttribute(ih->data->refine_timer, "RUN", "No");
+  ih->data->interacting = false;
+
+  iMglPlotRenderRequest(ih);  // full quality
+}
+
+static int iMglPlotRefineTimer_CB(Ihandle* timer)
+{
+  Ihandle* ih = (Ihandle*)iupAttribGet(timer, "_IUP_MGLPLOT");
+  iMglPlotInteractEnd(ih);
+  return IUP_DEFAULT;
+}
+
+static void iMglPlotInteract(Ihandle* ih)
+{
+  if (!iMglPlotIsBackgroundRender(ih))
+    return;
+
+  if (!ih->data->refine_timer)
+  {
+    ih->data->refine_timer = IupTimer();
+    IupSetCallback(ih->data->refine_timer, "ACTION_CB", (Icallback)iMglPlotRefineTimer_CB);
+    IupSetInt(ih->data->refine_timer, "TIME", IUP_MGLPLOT_REFINE_DELAY);
+    iupAttribSet(ih->data->refine_timer, "_IUP_MGLPLOT", (char*)ih);
+  }
+
+  ih->data->interacting = true;
+
+  // restart the delay
+  IupSetAttribute(ih->data->refine_timer, "RUN", "No");
+  IupSetAttribute(ih->data->refine_timer, "RUN", "Yes");
+}
+
 static void iMglPlotRepaint(Ihandle* ih, int force, int flush)
 {
+  if (iMglPlotIsBackgroundRender(ih))
+  {
+    if (force || ih->data->redraw)
+      iMglPlotRenderRequest(ih);
+
+    if (flush)
+      iMglPlotRenderFlush(ih);  // the last rendered scene, updated when the new render is done
+    return;
+  }
+
   if (!IupGLIsCurrent(ih))
     force = 1;
 
@@ -2208,6 +2431,102 @@ static char* iMglPlotGetCurrentAttrib(Ihandle* ih)
   return iupStrReturnInt(ih->data->dataSetCurrent);
 }
 
+static void* iMglPlotMapFile(const char* filename, size_t *size)
+{
+  /* Mapped copy-on-write, so functions that change the data in place do not change the file */
+#ifdef WIN32
+  HANDLE hFile = CreateFileA(filename, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+  if (hFile == INVALID_HANDLE_VALUE)
+    return NULL;
+
+  LARGE_INTEGER file_size;
+  if (!GetFileSizeEx(hFile, &file_size) || file_size.QuadPart <= 0 || (unsigned long long)file_size.QuadPart > (SIZE_T)-1)
+  {
+    CloseHandle(hFile);
+    return NULL;
+  }
+
+  HANDLE hMap = CreateFileMappingA(hFile, NULL, PAGE_WRITECOPY, 0, 0, NULL);
+  CloseHandle(hFile);
+  if (!hMap)
+    return NULL;
+
+  void* data = MapViewOfFile(hMap, FILE_MAP_COPY, 0, 0, 0);
+  CloseHandle(hMap);  /* the view keeps the mapping */
+  if (!data)
+    return NULL;
+
+  *size = (size_t)file_size.QuadPart;
+  return data;
+#else
+  int fd = open(filename, O_RDONLY);
+  if (fd < 0)
+    return NULL;
+
+  struct stat st;
+  if (fstat(fd, &st) != 0 || st.st_size <= 0 || (unsigned long long)st.st_size > (size_t)-1)
+  {
+    close(fd);
+    return NULL;
+  }
+
+  void* data = mmap(NULL, (size_t)st.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+  close(fd);  /* the mapping keeps the file */
+  if (data == MAP_FAILED)
+    return NULL;
+
+  *size = (size_t)st.st_size;
+  return data;
+#endif
+}
+
+static void iMglPlotUnmapFile(void* data, size_t size)
+{
+#ifdef WIN32
+  UnmapViewOfFile(data);
+  (void)size;
+#else
+  munmap(data, size);
+#endif
+}
+
+static long long iMglPlotFileSize(const char* filename)
+{
+  /* ftell is limited to 2GB in Windows */
+#ifdef WIN32
+  WIN32_FILE_ATTRIBUTE_DATA attr;
+  if (!GetFileAttributesExA(filename, GetFileExInfoStandard, &attr))
+    return -1;
+  return ((long long)attr.nFileSizeHigh << 32) | attr.nFileSizeLow;
+#else
+  struct stat st;
+  if (stat(filename, &st) != 0)
+    return -1;
+  return (long long)st.st_size;
+#endif
+}
+
+static void iMglPlotUnmapDataSet(IdataSet* ds)
+{
+  if (!ds->dsMapData)
+    return;
+
+  iMglPlotUnmapFile(ds->dsMapData, ds->dsMapSize);
+
+  ds->dsMapData = NULL;
+  ds->dsMapSize = 0;
+}
+
+static void iMglPlotDataSetChanged(IdataSet* ds)
+{
+  // Must be called after any function that replaces or resizes the arrays,
+  // they have no extra space and dsX may no longer use the mapped file
+  ds->dsCapacity = 0;
+
+  if (ds->dsMapData && !ds->dsX->link)
+    iMglPlotUnmapDataSet(ds);
+}
+
 static void iMglPlotRemoveDataSet(IdataSet* ds)
 {
   free(ds->dsLegend);
@@ -2231,6 +2550,8 @@ static void iMglPlotRemoveDataSet(IdataSet* ds)
   if (ds->dsZ)
     delete ds->dsZ;
 
+  iMglPlotUnmapDataSet(ds);  /* after dsX, it may be linked to the mapping */
+
   memset(ds, 0, sizeof(IdataSet));
 }
 
@@ -2351,6 +2672,8 @@ static int iMglPlotSetDSRearrangeAttrib(Ihandle* ih, const char* value)
     ds->dsX->ny = 1;
   }
 
+  iMglPlotDataSetChanged(ds);
+
   (void)value;
   return 0;
 }
@@ -2393,6 +2716,7 @@ static int iMglPlotSetDSSplitAttrib(Ihandle* ih, const char* value)
 
     ds->dsDim = 1;
     ds->dsX->ny = 1;
+    iMglPlotDataSetChanged(ds);
   }
 
   ih->data->dataSetCurrent = old_current;
@@ -2691,6 +3015,7 @@ static int iMglPlotSetDSRemoveAttrib(Ihandle* ih, const char* value)
       ds->dsY->Crop(ds->dsCount, 1, 'y');
     if (ds->dsZ)
       ds->dsZ->Crop(ds->dsCount, 1, 'z');
+    iMglPlotDataSetChanged(ds);
 
     ds->dsCount -= remove_count;
 
@@ -3739,6 +4064,7 @@ static int iMglPlotSetOpenGLAttrib(Ihandle* ih, const char* value)
   if (old_opengl != ih->data->opengl)
   {
     // No need to reset attrib since mgl will be used only in ACTION
+    iMglPlotRenderCancel(ih);
     delete ih->data->mgl;
     ih->data->redraw = 1;
 
@@ -3756,6 +4082,35 @@ static char* iMglPlotGetOpenGLAttrib(Ihandle* ih)
   return iupStrReturnBoolean(ih->data->opengl);
 }
 
+static int iMglPlotSetBackgroundRenderAttrib(Ihandle* ih, const char* value)
+{
+#if !MGL_HAVE_PTHREAD
+  // Without pthreads MathGL does not lock its globals,
+  // like mgl_qsort_gr used by Finish, so it can not render in another thread.
+  (void)ih;
+  (void)value;
+  return 0;
+#else
+  bool old_render_background = ih->data->render_background;
+  iMglPlotSetBoolean(ih, value, ih->data->render_background);
+
+  if (old_render_background && !ih->data->render_background)
+  {
+    iMglPlotRenderCancel(ih);
+
+    // the displayed graph is not resized while rendering in background
+    ih->data->mgl->SetSize(ih->data->w, ih->data->h);
+  }
+
+  return 0;
+#endif
+}
+
+static char* iMglPlotGetBackgroundRenderAttrib(Ihandle* ih)
+{
+  return iupStrReturnBoolean(ih->data->render_background);
+}
+
 static int iMglPlotSetAntialiasAttrib(Ihandle* ih, const char* value)
 {
   if (!ih->data->opengl)
@@ -3865,6 +4220,26 @@ static int iMglPlotSetSuppressWarningAttrib(Ihandle*, const char* value)
   return 0;
 }
 
+static int iMglPlotSetThreadsAttrib(Ihandle* ih, const char* value)
+{
+  int num_thr;
+  if (!iupStrToInt(value, &num_thr) || num_thr < 0)
+    num_thr = 0;  // automatic, one thread per processor
+
+  // Global to MathGL, used by the rasterizer and by the data processing functions
+  mgl_set_num_thr(num_thr);
+
+  ih->data->redraw = 1;
+  return 0;
+}
+
+static char* iMglPlotGetThreadsAttrib(Ihandle*)
+{
+  if (mglNumThr < 1)
+    mgl_set_num_thr(0);
+  return iupStrReturnInt(mglNumThr);
+}
+
 
 /******************************************************************************
 Additional Functions
@@ -4047,12 +4422,12 @@ void IupMglPlotAdd1D(Ihandle* ih, const char* inName, double inX)
 
     if (inNames)
     {
-      char** names = (char**)iupArrayInc(inNames);
+      char** names = (char**)iupArrayAdd(inNames, 1);
       names[sample_index] = iupStrDup(inName);
     }
   }
 
-  double* x = (double*)iupArrayInc(inXData);
+  double* x = (double*)iupArrayAdd(inXData, 1);  /* grows geometrically */
   x[sample_index] = inX;
 }
 
@@ -4078,8 +4453,8 @@ void IupMglPlotAdd2D(Ihandle* ih, double inX, double inY)
 
   int sample_index = iupArrayCount(inXData);  /* get before incrementing the array */
 
-  double* x = (double*)iupArrayInc(inXData);
-  double* y = (double*)iupArrayInc(inYData);
+  double* x = (double*)iupArrayAdd(inXData, 1);  /* grows geometrically */
+  double* y = (double*)iupArrayAdd(inYData, 1);
   x[sample_index] = inX;
   y[sample_index] = inY;
 }
@@ -4106,9 +4481,9 @@ void IupMglPlotAdd3D(Ihandle *ih, double inX, double inY, double inZ)
 
   int sample_index = iupArrayCount(inXData);  /* get before incrementing the array */
 
-  double* x = (double*)iupArrayInc(inXData);
-  double* y = (double*)iupArrayInc(inYData);
-  double* z = (double*)iupArrayInc(inZData);
+  double* x = (double*)iupArrayAdd(inXData, 1);  /* grows geometrically */
+  double* y = (double*)iupArrayAdd(inYData, 1);
+  double* z = (double*)iupArrayAdd(inZData, 1);
   x[sample_index] = inX;
   y[sample_index] = inY;
   z[sample_index] = inZ;
@@ -4134,6 +4509,7 @@ void IupMglPlotInsert1D(Ihandle* ih, int inIndex, int inSampleIndex, const char*
 
   ds->dsCount += inCount;
   ds->dsX->Extend(ds->dsCount);
+  iMglPlotDataSetChanged(ds);
   if (inSampleIndex < ds->dsCount-1)  // insert in the middle, open space first
     memmove(ds->dsX->a + inSampleIndex + inCount, ds->dsX->a + inSampleIndex, inCount*sizeof(double));
   memcpy(ds->dsX->a + inSampleIndex, inX, inCount*sizeof(double));
@@ -4172,6 +4548,7 @@ void IupMglPlotInsert2D(Ihandle* ih, int inIndex, int inSampleIndex, const doubl
   ds->dsCount += inCount;
   ds->dsX->Extend(ds->dsCount);
   ds->dsY->Extend(ds->dsCount);
+  iMglPlotDataSetChanged(ds);
   if (inSampleIndex < ds->dsCount-1)  // insert in the middle, open space first
   {
     memmove(ds->dsX->a + inSampleIndex + inCount, ds->dsX->a + inSampleIndex, inCount*sizeof(double));
@@ -4205,6 +4582,7 @@ void IupMglPlotInsert3D(Ihandle* ih, int inIndex, int inSampleIndex, const doubl
   ds->dsX->Extend(ds->dsCount);
   ds->dsY->Extend(ds->dsCount);
   ds->dsZ->Extend(ds->dsCount);
+  iMglPlotDataSetChanged(ds);
   if (inSampleIndex < ds->dsCount-1)  // insert in the middle, open space first
   {
     memmove(ds->dsX->a + inSampleIndex + inCount, ds->dsX->a + inSampleIndex, inCount*sizeof(double));
@@ -4216,6 +4594,143 @@ void IupMglPlotInsert3D(Ihandle* ih, int inIndex, int inSampleIndex, const doubl
   memcpy(ds->dsZ->a + inSampleIndex, inZ, inCount*sizeof(double));
 }
 
+static int iMglPlotDataSetIsLinear(IdataSet* ds)
+{
+  return ds->dsX->ny == 1 && ds->dsX->nz == 1;
+}
+
+static void iMglPlotDataSetReserve(IdataSet* ds, int count)
+{
+  mglData* dsData[3] = {ds->dsX, ds->dsY, ds->dsZ};
+  int i, capacity = ds->dsCapacity;
+
+  if (capacity < ds->dsCount)  // reset by iMglPlotDataSetChanged
+    capacity = ds->dsCount;
+
+  if (count <= capacity)
+    return;
+
+  // Grow geometrically, so successive appends do not copy the data each time
+  capacity += capacity / 2;
+  if (capacity < count)
+    capacity = count;
+  if (capacity < 10)
+    capacity = 10;
+
+  for (i = 0; i < 3; i++)
+  {
+    mglData* d = dsData[i];
+    if (!d)
+      continue;
+
+    mreal* a = new mreal[capacity];
+    if (ds->dsCount)
+      memcpy(a, d->a, ds->dsCount*sizeof(mreal));
+
+    // mglData does not use the array size, so it can be larger than nx
+    if (!d->link)
+      delete[] d->a;
+    d->a = a;
+    d->link = false;
+  }
+
+  iMglPlotUnmapDataSet(ds);  /* dsX was copied out of the mapping */
+
+  ds->dsCapacity = capacity;
+}
+
+static void iMglPlotDataSetAppend(IdataSet* ds, mglData* d, const double* inData, int inCount)
+{
+  if (!d)
+    return;
+
+  memcpy(d->a + ds->dsCount, inData, inCount*sizeof(double));
+  d->nx = ds->dsCount + inCount;
+}
+
+void IupMglPlotAddSamples1D(Ihandle* ih, int inIndex, const char** inNames, const double* inX, int inCount)
+{
+  iupASSERT(iupObjectCheck(ih));
+  if (!iupObjectCheck(ih))
+    return;
+
+  if (ih->iclass->nativetype != IUP_TYPECANVAS || 
+    !IupClassMatch(ih, "mglplot"))
+    return;
+
+  if(inIndex > (ih->data->dataSetCount-1) || inIndex < 0 || inCount<=0 || !inX)
+    return;
+
+  IdataSet* ds = &ih->data->dataSet[inIndex];
+  if (!iMglPlotDataSetIsLinear(ds))
+    return;
+
+  if (inNames && ds->dsNames && inIndex==0)  // Allow names only for the first dataset
+  {
+    int sample_index = iupArrayCount(ds->dsNames);
+    char** dsNames = (char**)iupArrayAdd(ds->dsNames, inCount);
+    for (int i = 0; i < inCount; i++)
+      dsNames[sample_index + i] = iupStrDup(inNames[i]!=NULL? inNames[i]: "");
+  }
+
+  iMglPlotDataSetReserve(ds, ds->dsCount + inCount);
+  iMglPlotDataSetAppend(ds, ds->dsX, inX, inCount);
+  ds->dsCount += inCount;
+
+  ih->data->redraw = true;
+}
+
+void IupMglPlotAddSamples2D(Ihandle* ih, int inIndex, const double* inX, const double* inY, int inCount)
+{
+  iupASSERT(iupObjectCheck(ih));
+  if (!iupObjectCheck(ih))
+    return;
+
+  if (ih->iclass->nativetype != IUP_TYPECANVAS || 
+    !IupClassMatch(ih, "mglplot"))
+    return;
+
+  if(inIndex > (ih->data->dataSetCount-1) || inIndex < 0 || inCount<=0 || !inX || !inY)
+    return;
+
+  IdataSet* ds = &ih->data->dataSet[inIndex];
+  if (!ds->dsY || !iMglPlotDataSetIsLinear(ds))
+    return;
+
+  iMglPlotDataSetReserve(ds, ds->dsCount + inCount);
+  iMglPlotDataSetAppend(ds, ds->dsX, inX, inCount);
+  iMglPlotDataSetAppend(ds, ds->dsY, inY, inCount);
+  ds->dsCount += inCount;
+
+  ih->data->redraw = true;
+}
+
+void IupMglPlotAddSamples3D(Ihandle* ih, int inIndex, const double* inX, const double* inY, const double* inZ, int inCount)
+{
+  iupASSERT(iupObjectCheck(ih));
+  if (!iupObjectCheck(ih))
+    return;
+
+  if (ih->iclass->nativetype != IUP_TYPECANVAS || 
+    !IupClassMatch(ih, "mglplot"))
+    return;
+
+  if(inIndex > (ih->data->dataSetCount-1) || inIndex < 0 || inCount<=0 || !inX || !inY || !inZ)
+    return;
+
+  IdataSet* ds = &ih->data->dataSet[inIndex];
+  if (!ds->dsY || !ds->dsZ || !iMglPlotDataSetIsLinear(ds))
+    return;
+
+  iMglPlotDataSetReserve(ds, ds->dsCount + inCount);
+  iMglPlotDataSetAppend(ds, ds->dsX, inX, inCount);
+  iMglPlotDataSetAppend(ds, ds->dsY, inY, inCount);
+  iMglPlotDataSetAppend(ds, ds->dsZ, inZ, inCount);
+  ds->dsCount += inCount;
+
+  ih->data->redraw = true;
+}
+
 void IupMglPlotSet1D(Ihandle* ih, int inIndex, const char** inNames, const double* inX, int inCount)
 {
   iupASSERT(iupObjectCheck(ih));
@@ -4262,6 +4777,7 @@ void IupMglPlotSet1D(Ihandle* ih, int inIndex, const char** inNames, const doubl
 
   ds->dsX->Set(inX, inCount);
   ds->dsCount = inCount;
+  iMglPlotDataSetChanged(ds);
 
   ih->data->redraw = true;
 }
@@ -4286,6 +4802,7 @@ void IupMglPlotSet2D(Ihandle* ih, int inIndex, const double *inX, const double *
   ds->dsX->Set(inX, inCount);
   ds->dsY->Set(inY, inCount);
   ds->dsCount = inCount;
+  iMglPlotDataSetChanged(ds);
 
   ih->data->redraw = true;
 }
@@ -4311,6 +4828,7 @@ void IupMglPlotSet3D(Ihandle* ih, int inIndex, const double* inX, const double*
   ds->dsY->Set(inY, inCount);
   ds->dsZ->Set(inZ, inCount);
   ds->dsCount = inCount;
+  iMglPlotDataSetChanged(ds);
 
   ih->data->redraw = true;
 }
@@ -4332,6 +4850,7 @@ void IupMglPlotSetData(Ihandle* ih, int inIndex, const double* data, int count_x
   IdataSet* ds = &ih->data->dataSet[inIndex];
   ds->dsX->Set(data, count_x, count_y, count_z);
   ds->dsCount = count_x*count_y*count_z;
+  iMglPlotDataSetChanged(ds);
 
   ih->data->redraw = true;
 }
@@ -4356,10 +4875,255 @@ void IupMglPlotLoadData(Ihandle* ih, int inIndex, const char* filename, int coun
   else
     ds->dsX->Read(filename, count_x, count_y, count_z);
   ds->dsCount = ds->dsX->nx*ds->dsX->ny*ds->dsX->nz;
+  iMglPlotDataSetChanged(ds);
 
   ih->data->redraw = true;
 }
 
+static int iMglPlotRawDataType(const char* data_type, int *type_size)
+{
+  if (!data_type || iupStrEqualNoCase(data_type, "DOUBLE"))
+  {
+    *type_size = sizeof(double);
+    return IUP_MGLPLOT_RAW_DOUBLE;
+  }
+  if (iupStrEqualNoCase(data_type, "FLOAT"))
+  {
+    *type_size = sizeof(float);
+    return IUP_MGLPLOT_RAW_FLOAT;
+  }
+  if (iupStrEqualNoCase(data_type, "INT"))
+  {
+    *type_size = sizeof(int);
+    return IUP_MGLPLOT_RAW_INT;
+  }
+  if (iupStrEqualNoCase(data_type, "SHORT"))
+  {
+    *type_size = sizeof(short);
+    return IUP_MGLPLOT_RAW_SHORT;
+  }
+  if (iupStrEqualNoCase(data_type, "USHORT"))
+  {
+    *type_size = sizeof(unsigned short);
+    return IUP_MGLPLOT_RAW_USHORT;
+  }
+  if (iupStrEqualNoCase(data_type, "CHAR"))
+  {
+    *type_size = sizeof(signed char);
+    return IUP_MGLPLOT_RAW_CHAR;
+  }
+  if (iupStrEqualNoCase(data_type, "UCHAR"))
+  {
+    *type_size = sizeof(unsigned char);
+    return IUP_MGLPLOT_RAW_UCHAR;
+  }
+  return -1;
+}
+
+static void iMglPlotRawConvert(const void* buffer, int type, double* values, int count)
+{
+  int i;
+  switch (type)
+  {
+  case IUP_MGLPLOT_RAW_DOUBLE:
+    memcpy(values, buffer, count*sizeof(double));
+    break;
+  case IUP_MGLPLOT_RAW_FLOAT:
+    for (i = 0; i < count; i++) values[i] = ((const float*)buffer)[i];
+    break;
+  case IUP_MGLPLOT_RAW_INT:
+    for (i = 0; i < count; i++) values[i] = ((const int*)buffer)[i];
+    break;
+  case IUP_MGLPLOT_RAW_SHORT:
+    for (i = 0; i < count; i++) values[i] = ((const short*)buffer)[i];
+    break;
+  case IUP_MGLPLOT_RAW_USHORT:
+    for (i = 0; i < count; i++) values[i] = ((const unsigned short*)buffer)[i];
+    break;
+  case IUP_MGLPLOT_RAW_CHAR:
+    for (i = 0; i < count; i++) values[i] = ((const signed char*)buffer)[i];
+    break;
+  case IUP_MGLPLOT_RAW_UCHAR:
+    for (i = 0; i < count; i++) values[i] = ((const unsigned char*)buffer)[i];
+    break;
+  }
+}
+
+static mglData* iMglPlotRawStream(FILE* file, int type, int type_size, int nx, int ny, int nz, int step)
+{
+  // Reads a few values at a time, so the file does not need to fit in memory.
+  // Each output value is the average of a step x step x step block of the file.
+  int ox = (nx + step - 1) / step;
+  int oy = (ny + step - 1) / step;
+  int oz = (nz + step - 1) / step;
+  int chunk = step * ((IUP_MGLPLOT_RAW_CHUNK + step - 1) / step);  /* a multiple of step, so blocks are not split */
+  if (chunk > nx)
+    chunk = nx;
+
+  mglData* data = new mglData(ox, oy, oz);  /* filled with zeros, used as accumulator */
+  unsigned char* buffer = new unsigned char[(size_t)chunk*type_size];
+  double* values = new double[chunk];
+  bool ok = true;
+
+  for (int z = 0; z < nz && ok; z++)
+  {
+    mreal* slice = data->a + (size_t)(z / step)*ox*oy;
+
+    for (int y = 0; y < ny && ok; y++)
+    {
+      mreal* line = slice + (size_t)(y / step)*ox;
+
+      for (int x = 0; x < nx; x += chunk)
+      {
+        int count = nx - x < chunk ? nx - x : chunk;
+        if ((int)fread(buffer, type_size, count, file) != count)
+        {
+          ok = false;
+          break;
+        }
+
+        iMglPlotRawConvert(buffer, type, values, count);
+
+        mreal* out = line + x / step;
+        for (int i = 0; i < count; i += step, out++)
+        {
+          int end = i + step < count ? i + step : count;
+          double sum = 0;
+          for (int j = i; j < end; j++)
+            sum += values[j];
+          *out += sum;
+        }
+      }
+    }
+
+    if (ok && step > 1 && (z % step == step - 1 || z == nz - 1))
+    {
+      // The slice is complete, divide by the number of values in each block (smaller at the borders)
+      int bz = z % step + 1;
+      for (int j = 0; j < oy; j++)
+      {
+        int by = ny - j*step < step ? ny - j*step : step;
+        for (int i = 0; i < ox; i++)
+        {
+          int bx = nx - i*step < step ? nx - i*step : step;
+          slice[i + j*ox] /= (double)bx*by*bz;
+        }
+      }
+    }
+  }
+
+  delete[] values;
+  delete[] buffer;
+
+  if (!ok)
+  {
+    delete data;
+    return NULL;
+  }
+
+  return data;
+}
+
+int IupMglPlotLoadRawData(Ihandle* ih, int inIndex, const char* filename, const char* data_type, int count_x, int count_y, int count_z, int step)
+{
+  iupASSERT(iupObjectCheck(ih));
+  if (!iupObjectCheck(ih))
+    return 0;
+
+  if (ih->iclass->nativetype != IUP_TYPECANVAS || 
+    !IupClassMatch(ih, "mglplot"))
+    return 0;
+
+  if(inIndex > (ih->data->dataSetCount-1) || inIndex < 0 ||
+     !filename)
+    return 0;
+
+  int type_size;
+  int type = iMglPlotRawDataType(data_type, &type_size);
+  if (type < 0)
+    return 0;
+
+  if (count_y <= 0) count_y = 1;
+  if (count_z <= 0) count_z = 1;
+
+  long long file_size = iMglPlotFileSize(filename);
+  if (file_size <= 0)
+    return 0;
+
+  if (count_x <= 0)  // use the whole file
+  {
+    long long nx = file_size / type_size / ((long long)count_y*count_z);
+    count_x = nx > INT_MAX ? INT_MAX : (int)nx;
+  }
+
+  long long total = (long long)count_x*count_y;
+  if (count_x <= 0 || total > LLONG_MAX / count_z / type_size ||
+      total*count_z*type_size > file_size)
+    return 0;
+
+  if (step <= 0)  // downsample to the view resolution
+  {
+    int view = ih->currentwidth > ih->currentheight ? ih->currentwidth : ih->currentheight;
+    int max_count = count_x;
+    if (count_y > max_count) max_count = count_y;
+    if (count_z > max_count) max_count = count_z;
+    step = view > 0 ? (max_count + view - 1) / view : 1;
+    if (step < 1) step = 1;
+  }
+
+  IdataSet* ds = &ih->data->dataSet[inIndex];
+  void* map_data = NULL;
+  size_t map_size = 0;
+
+  if (step == 1 && type == IUP_MGLPLOT_RAW_DOUBLE && sizeof(mreal) == sizeof(double) && total*count_z <= INT_MAX)
+  {
+    // Use the file contents directly, without copying it
+    map_data = iMglPlotMapFile(filename, &map_size);
+    if (map_data && (unsigned long long)total*count_z*sizeof(double) > map_size)  /* file changed */
+    {
+      iMglPlotUnmapFile(map_data, map_size);
+      map_data = NULL;
+    }
+  }
+
+  mglData* data = NULL;
+  if (!map_data)
+  {
+    // Not mapped, converted or downsampled
+    long long out_count = (long long)((count_x + step - 1) / step) * ((count_y + step - 1) / step) * ((count_z + step - 1) / step);
+    if (out_count > INT_MAX)
+      return 0;
+
+    FILE* file = fopen(filename, "rb");
+    if (!file)
+      return 0;
+
+    data = iMglPlotRawStream(file, type, type_size, count_x, count_y, count_z, step);
+    fclose(file);
+
+    if (!data)
+      return 0;
+  }
+
+  if (map_data)
+  {
+    data = new mglData();
+    data->Link((mreal*)map_data, count_x, count_y, count_z);
+  }
+
+  delete ds->dsX;  /* before the old mapping is released */
+  ds->dsX = data;
+  ds->dsCount = (int)(data->nx*data->ny*data->nz);
+
+  iMglPlotUnmapDataSet(ds);
+  ds->dsMapData = map_data;
+  ds->dsMapSize = map_size;
+  iMglPlotDataSetChanged(ds);
+
+  ih->data->redraw = true;
+  return 1;
+}
+
 void IupMglPlotSetFormula(Ihandle* ih, int inIndex, const char* formulaX, const char* formulaY, const char* formulaZ, int count)
 {
   iupASSERT(iupObjectCheck(ih));
@@ -4387,6 +5151,7 @@ void IupMglPlotSetFormula(Ihandle* ih, int inIndex, const char* formulaX, const
     ds->dsX->Create(count);
     if (ds->dsY) ds->dsY->Create(count);
     if (ds->dsZ) ds->dsZ->Create(count);
+    iMglPlotDataSetChanged(ds);
   }
 
   mglGraph* gr = new mglGraph(0, 10, 10);
@@ -4431,7 +5196,10 @@ void IupMglPlotSetFromFormula(Ihandle* ih, int inIndex, const char* formula, int
   int ny = count_y>0? count_y: ds->dsX->ny;
   int nz = count_z>0? count_z: ds->dsX->nz;
   if (nx != ds->dsX->nx || ny != ds->dsX->ny || nz != ds->dsX->nz)
+  {
     ds->dsX->Create(nx, ny, nz);
+    iMglPlotDataSetChanged(ds);
+  }
 
   mglGraph* gr = new mglGraph(0, 10, 10);
 
@@ -4722,7 +5490,9 @@ static int iMglPlotResize_CB(Ihandle* ih, int width, int height)
 
   iMglPlotInitOpenGL2D(ih);
 
-  ih->data->mgl->SetSize(width, height);
+  // When rendering in background the last scene is displayed until the new one is done
+  if (!iMglPlotIsBackgroundRender(ih))
+    ih->data->mgl->SetSize(width, height);
 
   return IUP_DEFAULT;
 }
@@ -4741,6 +5511,8 @@ static int iMglPlotMouseButton_CB(Ihandle* ih, int b, int press, int x, int y, c
     ih->data->last_x = (double)x;
     ih->data->last_y = (double)y;
   }
+  else if (ih->data->interacting)  /* Button released: full quality */
+    iMglPlotInteractEnd(ih);
 
   if (iup_isdouble(status))  /* Double-click: restore interaction default values */
   {
@@ -4767,6 +5539,7 @@ static int iMglPlotMouseMove_CB(Ihandle* ih, int x, int y, char *status)
     iMglPlotRotate(ih->data->rotX, deltaX);
     iMglPlotRotate(ih->data->rotZ, deltaZ);
 
+    iMglPlotInteract(ih);
     iMglPlotRepaint(ih, 1, 1);
   }
   else if(iup_isbutton1(status))
@@ -4787,6 +5560,7 @@ static int iMglPlotMouseMove_CB(Ihandle* ih, int x, int y, char *status)
       iMglPlotPanY(ih, yoffset);
     }
 
+    iMglPlotInteract(ih);
     iMglPlotRepaint(ih, 1, 1);
   }
 
@@ -4801,11 +5575,13 @@ static int iMglPlotWheel_CB(Ihandle* ih, float delta)
   if(delta < 0)  /* Zoom In */
   {
     iMglPlotZoom(ih, 50.0);
+    iMglPlotInteract(ih);
     iMglPlotRepaint(ih, 1, 1);
   }
   else if(delta > 0)  /* Zoom Out */
   {
     iMglPlotZoom(ih, -50.0);
+    iMglPlotInteract(ih);
     iMglPlotRepaint(ih, 1, 1);
   }
 
@@ -4882,6 +5658,8 @@ static int iMglPlotKeyPress_CB(Ihandle* ih, int c, int press)
     return IUP_DEFAULT;
   }
 
+  if (c != K_HOME)
+    iMglPlotInteract(ih);
   iMglPlotRepaint(ih, 1, 1);
   return IUP_IGNORE;  /* ignore processed keys */
 } 
@@ -4900,6 +5678,16 @@ static void iMglPlotDestroyMethod(Ihandle* ih)
 
   free(ih->data->dataSet);
 
+  iMglPlotRenderCancel(ih);
+  if (ih->data->render_thread)
+  {
+    IupDestroy(ih->data->render_thread);
+    IupDestroy(ih->data->render_timer);
+  }
+  if (ih->data->refine_timer)
+    IupDestroy(ih->data->refine_timer);
+
+  delete ih->data->mgl_back;
   delete ih->data->mgl;
 }
 
@@ -4966,10 +5754,12 @@ static Iclass* iMglPlotNewClass(void)
   iupClassRegisterAttribute(ic, "ALPHA", iMglPlotGetAlphaAttrib, iMglPlotSetAlphaAttrib, NULL, NULL, IUPAF_NOT_MAPPED | IUPAF_NO_INHERIT);
   iupClassRegisterAttribute(ic, "TRANSPARENT", iMglPlotGetTransparentAttrib, iMglPlotSetTransparentAttrib, IUPAF_SAMEASSYSTEM, "No", IUPAF_NOT_MAPPED|IUPAF_NO_INHERIT);
   iupClassRegisterAttribute(ic, "OPENGL", iMglPlotGetOpenGLAttrib, iMglPlotSetOpenGLAttrib, IUPAF_SAMEASSYSTEM, "No", IUPAF_NOT_MAPPED|IUPAF_NO_INHERIT);
+  iupClassRegisterAttribute(ic, "BACKGROUNDRENDER", iMglPlotGetBackgroundRenderAttrib, iMglPlotSetBackgroundRenderAttrib, IUPAF_SAMEASSYSTEM, "No", IUPAF_NOT_MAPPED|IUPAF_NO_INHERIT);
   iupClassRegisterAttribute(ic, "ANTIALIAS", iMglPlotGetAntialiasAttrib, iMglPlotSetAntialiasAttrib, IUPAF_SAMEASSYSTEM, "No", IUPAF_NO_INHERIT);
   iupClassRegisterAttribute(ic, "RESET", NULL, iMglPlotSetResetAttrib, NULL, NULL, IUPAF_WRITEONLY|IUPAF_NOT_MAPPED|IUPAF_NO_INHERIT);
   iupClassRegisterAttribute(ic, "ERRORMESSAGE", iMglPlotGetErrorMessageAttrib, NULL, NULL, NULL, IUPAF_READONLY|IUPAF_NOT_MAPPED|IUPAF_NO_INHERIT);
   iupClassRegisterAttribute(ic, "SUPPRESSWARNING", NULL, iMglPlotSetSuppressWarningAttrib, NULL, NULL, IUPAF_WRITEONLY | IUPAF_NOT_MAPPED | IUPAF_NO_INHERIT);
+  iupClassRegisterAttribute(ic, "THREADS", iMglPlotGetThreadsAttrib, iMglPlotSetThreadsAttrib, NULL, NULL, IUPAF_NOT_MAPPED | IUPAF_NO_INHERIT);
   
   iupClassRegisterAttribute(ic, "MGLGRAPH", iMglPlotGetMglGraphAttrib, NULL, NULL, NULL, IUPAF_NO_STRING | IUPAF_READONLY | IUPAF_NOT_MAPPED | IUPAF_NO_INHERIT);
 
@@ -450,6 +450,7 @@ private:
 	long forg;			///< original point (for directions)
 	size_t grp_counter;	///< Counter for StartGroup(); EndGroup();
 	mglMatrix Bt;		///< temporary matrix for text
+	mglMatrix Bf;		///< matrix used in last Finish() (IUP: was a static, shared by all canvases and threads)
 	float pen_delta;	///< delta pen width (dpw) -- the size of semi-transparent region for lines, marks, ...
 
 	/// Draw generic colorbar
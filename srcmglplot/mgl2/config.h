@@ -21,7 +21,11 @@
 #else
 #define MGL_HAVE_TYPEOF	0
 #define MGL_SYS_NAN		0
+#ifdef WIN32	// pthread is not always available in MinGW/Cygwin
 #define MGL_HAVE_PTHREAD	0
+#else
+#define MGL_HAVE_PTHREAD	1
+#endif
 #define MGL_HAVE_PTHR_WIDGET	0
 #define MGL_HAVE_ATTRIBUTE	0
 #define MGL_HAVE_C99_COMPLEX	0
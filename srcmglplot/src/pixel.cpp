@@ -483,6 +483,10 @@ void mglCanvas::pxl_setz(long id, long n, const void *)
 }
 //-----------------------------------------------------------------------------
 HMGL mgl_qsort_gr=0;
+#if MGL_HAVE_PTHREAD
+// IUP: mgl_qsort_gr is global, so canvases finished in different threads must not sort at the same time
+static pthread_mutex_t mutexQsort = PTHREAD_MUTEX_INITIALIZER;
+#endif
 int mglBase::PrmCmp(long i, long j) const
 {
 	const mglPrim &a = Prm[i];
@@ -505,6 +509,9 @@ void mglCanvas::PreparePrim(int fast)
 		mglStartThread(&mglCanvas::pxl_transform,this,Pnt.size());
 		if(fast==0)	mglStartThread(&mglCanvas::pxl_setz,this,Prm.size());
 		else	mglStartThread(&mglCanvas::pxl_setz_adv,this,Prm.size());
+#if MGL_HAVE_PTHREAD
+		pthread_mutex_lock(&mutexQsort);
+#endif
 #pragma omp critical
 		{
 			ClearPrmInd();	mgl_qsort_gr = this;
@@ -514,6 +521,9 @@ void mglCanvas::PreparePrim(int fast)
 			qsort(PrmInd,n,sizeof(long),mgl_prm_cmp);
 			clr(MGL_FINISHED);
 		}
+#if MGL_HAVE_PTHREAD
+		pthread_mutex_unlock(&mutexQsort);
+#endif
 	}
 	if(fast>0)
 	{
@@ -668,7 +678,6 @@ void mglCanvas::pxl_dotsdr(long id, long n, const void *)
 //-----------------------------------------------------------------------------
 void mglCanvas::Finish()
 {
-	static mglMatrix bp;
 	if(Quality==MGL_DRAW_NONE)	return;
 #if MGL_HAVE_PTHREAD
 	pthread_mutex_lock(&mutexPrm);
@@ -685,13 +694,13 @@ void mglCanvas::Finish()
 	}
 	else
 	{
-		if((Quality&MGL_DRAW_LMEM) || (memcmp(&Bp,&bp,sizeof(mglMatrix)) && !(Quality&MGL_DRAW_LMEM) && Prm.size()>0))
+		if((Quality&MGL_DRAW_LMEM) || (memcmp(&Bp,&Bf,sizeof(mglMatrix)) && !(Quality&MGL_DRAW_LMEM) && Prm.size()>0))
 			clr(MGL_FINISHED);
 		if(!get(MGL_FINISHED))
 		{
 			if(!(Quality&MGL_DRAW_LMEM) && Prm.size()>0)
 			{
-				PreparePrim(0);	bp=Bp;
+				PreparePrim(0);	Bf=Bp;
 				clr(MGL_FINISHED);
 				mglStartThread(&mglCanvas::pxl_primdr,this,Prm.size());
 			}
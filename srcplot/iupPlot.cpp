@@ -22,11 +22,12 @@ static inline void iPlotCheckMinMax(double &inoutMin, double &inoutMax)
 
 
 iupPlot::iupPlot(Ihandle* _ih, int inDefaultFontStyle, int inDefaultFontSize)
-  :ih(_ih), mCurrentDataSet(-1), mRedraw(true), mDataSetListCount(0), mCrossHairH(false), mCrossHairV(false),
+  :ih(_ih), mCurrentDataSet(-1), mRedraw(true), mRedrawOverlay(false), mRenderTime(0), mDataSetListCount(0), mCrossHairH(false), mCrossHairV(false),
    mGrid(true), mGridMinor(false), mViewportSquare(false), mScaleEqual(false), mHighlightMode(IUP_PLOT_HIGHLIGHT_NONE),
    mDefaultFontSize(inDefaultFontSize), mDefaultFontStyle(inDefaultFontStyle), mScreenTolerance(5),
    mAxisX(inDefaultFontStyle, inDefaultFontSize), mAxisY(inDefaultFontStyle, inDefaultFontSize),
-   mCrossHairX(0), mCrossHairY(0), mShowSelectionBand(false), mDataSetListMax(20), mDataSetClipping(IUP_PLOT_CLIPAREA)
+   mCrossHairX(0), mCrossHairY(0), mShowSelectionBand(false), mDataSetListMax(20), mDataSetClipping(IUP_PLOT_CLIPAREA),
+   mLayerImage(NULL), mLayerWidth(0), mLayerHeight(0), mLayerValid(false)
 {
   mDataSetList = (iupPlotDataSet**)malloc(sizeof(iupPlotDataSet*)* mDataSetListMax); /* use malloc because we will use realloc */
   memset(mDataSetList, 0, sizeof(iupPlotDataSet*)* mDataSetListMax);
@@ -34,6 +35,7 @@ iupPlot::iupPlot(Ihandle* _ih, int inDefaultFontStyle, int inDefaultFontSize)
 
 iupPlot::~iupPlot()
 {
+  ReleaseLayer();
   RemoveAllDataSets();
   free(mDataSetList);  /* use free because we used malloc */
 }
@@ -74,6 +76,74 @@ void iupPlot::SetViewport(int x, int y, int w, int h)
   mRedraw = true;
 }
 
+iupPlotRenderAttrib::~iupPlotRenderAttrib()
+{
+  if (mFont) free(mFont);
+  if (mDecimalSymbol) free(mDecimalSymbol);
+  if (mSampleColor) free(mSampleColor);
+}
+
+static void iPlotRenderAttribSetStr(char* &ioStr, const char* inValue)
+{
+  if (ioStr && inValue && iupStrEqual(ioStr, inValue))
+    return;
+
+  if (ioStr) free(ioStr);
+  ioStr = inValue ? iupStrDup(inValue) : NULL;
+}
+
+void iupPlot::UpdateRenderAttrib()
+{
+  // must be called in the main thread before PrepareRender and Render
+  iPlotRenderAttribSetStr(mRenderAttrib.mFont, IupGetAttribute(ih, "FONT"));
+  mRenderAttrib.mFontSize = IupGetInt(ih, "FONTSIZE");
+  mRenderAttrib.mActive = IupGetInt(ih, "ACTIVE") ? true : false;
+  iPlotRenderAttribSetStr(mRenderAttrib.mDecimalSymbol, IupGetGlobal("DEFAULTDECIMALSYMBOL"));
+
+  mRenderAttrib.mPreDrawCB = (IFnC)IupGetCallback(ih, "PREDRAW_CB");
+  mRenderAttrib.mPostDrawCB = (IFnC)IupGetCallback(ih, "POSTDRAW_CB");
+  mRenderAttrib.mDrawSampleCB = (IFniiddi)IupGetCallback(ih, "DRAWSAMPLE_CB");
+  mRenderAttrib.mXTickFormatNumberCB = (IFnssds)IupGetCallback(ih, "XTICKFORMATNUMBER_CB");
+  mRenderAttrib.mYTickFormatNumberCB = (IFnssds)IupGetCallback(ih, "YTICKFORMATNUMBER_CB");
+
+  int theCount = 0;
+  for (int ds = 0; ds < mDataSetListCount; ds++)
+  {
+    iupPlotDataSet* dataset = mDataSetList[ds];
+    if (dataset->mMode == IUP_PLOT_PIE || dataset->mBarMulticolor)
+      theCount = iupPlotMax(theCount, dataset->GetCount());
+  }
+
+  if (theCount > mRenderAttrib.mSampleColorMax)
+  {
+    long* theSampleColor = (long*)realloc(mRenderAttrib.mSampleColor, theCount * sizeof(long));
+    if (!theSampleColor)
+      theCount = mRenderAttrib.mSampleColorMax;  // the remaining samples use the default colors
+    else
+    {
+      mRenderAttrib.mSampleColor = theSampleColor;
+      mRenderAttrib.mSampleColorMax = theCount;
+    }
+  }
+
+  for (int i = 0; i < theCount; i++)
+    mRenderAttrib.mSampleColor[i] = iupPlotDrawGetSampleColorTable(ih, i);
+  mRenderAttrib.mSampleColorCount = theCount;
+}
+
+bool iupPlot::IsRenderThreadSafe() const
+{
+  // the tick numbers must be formatted without changing the locale,
+  // the automatic formats have a single floating point conversion
+  if (!iupStrPrintfDoubleLocaleIsThreadSafe(mAxisX.mTick.mFormatAuto ? "%.1f" : mAxisX.mTick.mFormatString, mRenderAttrib.mDecimalSymbol))
+    return false;
+
+  if (!iupStrPrintfDoubleLocaleIsThreadSafe(mAxisY.mTick.mFormatAuto ? "%.1f" : mAxisY.mTick.mFormatString, mRenderAttrib.mDecimalSymbol))
+    return false;
+
+  return true;
+}
+
 void iupPlot::SetFont(cdCanvas* canvas, int inFontStyle, int inFontSize) const
 {
   if (inFontStyle == -1) inFontStyle = mDefaultFontStyle;
@@ -300,7 +370,7 @@ void iupPlot::SelectDataSetSamples(double inMinX, double inMaxX, double inMinY,
   for (int ds = 0; ds < mDataSetListCount; ds++)
   {
     iupPlotDataSet* dataset = mDataSetList[ds];
-    iupPlotSampleNotify theNotify = { ih, ds, select_cb };
+    iupPlotSampleNotify theNotify = { ih, ds, select_cb, NULL };
     if (dataset->SelectSamples(inMinX, inMaxX, inMinY, inMaxY, &theNotify))
       theChanged = true;
   }
@@ -331,7 +401,7 @@ void iupPlot::ClearDataSetSelection()
   for (int ds = 0; ds < mDataSetListCount; ds++)
   {
     iupPlotDataSet* dataset = mDataSetList[ds];
-    iupPlotSampleNotify theNotify = { ih, ds, select_cb };
+    iupPlotSampleNotify theNotify = { ih, ds, select_cb, NULL };
     if (dataset->ClearSelection(&theNotify))
       theChanged = true;
   }
@@ -362,7 +432,7 @@ void iupPlot::DeleteSelectedDataSetSamples()
   for (int ds = 0; ds < mDataSetListCount; ds++)
   {
     iupPlotDataSet* dataset = mDataSetList[ds];
-    iupPlotSampleNotify theNotify = { ih, ds, delete_cb };
+    iupPlotSampleNotify theNotify = { ih, ds, delete_cb, NULL };
     if (dataset->DeleteSelectedSamples(&theNotify))
       theChanged = true;
   }
@@ -442,7 +512,7 @@ void iupPlot::DataSetClipArea(cdCanvas* canvas, int xmin, int xmax, int ymin, in
 
 bool iupPlot::PrepareRender(cdCanvas* canvas)
 {
-  cdCanvasNativeFont(canvas, IupGetAttribute(ih, "FONT"));
+  cdCanvasNativeFont(canvas, mRenderAttrib.mFont);
 
   ConfigureAxis();
 
@@ -458,19 +528,87 @@ bool iupPlot::PrepareRender(cdCanvas* canvas)
   CalculateTitlePos();
 
   // Must be before calculate margins
-  CalculateTickSize(canvas, mAxisX.mTick);
-  CalculateTickSize(canvas, mAxisY.mTick);
+  CalculateTickSize(canvas, mAxisX);
+  CalculateTickSize(canvas, mAxisY);
 
   CalculateMargins(canvas);
 
   return true;
 }
 
-bool iupPlot::Render(cdCanvas* canvas)
+void iupPlot::ReleaseLayer()
 {
-  if (!mRedraw)
+  // must be called before the canvas is destroyed
+  if (mLayerImage)
+  {
+    cdKillImage(mLayerImage);
+    mLayerImage = NULL;
+  }
+  mLayerValid = false;
+}
+
+void iupPlot::SaveLayer(cdCanvas* canvas)
+{
+  if (mLayerImage && (mLayerWidth != mViewport.mWidth || mLayerHeight != mViewport.mHeight))
+    ReleaseLayer();
+
+  if (!mLayerImage)
+  {
+    mLayerImage = cdCanvasCreateImage(canvas, mViewport.mWidth, mViewport.mHeight);
+    if (!mLayerImage)
+      return;
+
+    mLayerWidth = mViewport.mWidth;
+    mLayerHeight = mViewport.mHeight;
+  }
+
+  cdCanvasOrigin(canvas, 0, 0);
+  cdCanvasGetImage(canvas, mLayerImage, mViewport.mX, mViewport.mY);
+  cdCanvasOrigin(canvas, mViewport.mX, mViewport.mY);
+
+  mLayerValid = true;
+}
+
+void iupPlot::RestoreLayer(cdCanvas* canvas) const
+{
+  cdCanvasOrigin(canvas, 0, 0);
+  cdCanvasClip(canvas, CD_CLIPOFF);
+  cdCanvasPutImageRect(canvas, mLayerImage, mViewport.mX, mViewport.mY, 0, mLayerWidth - 1, 0, mLayerHeight - 1);
+}
+
+void iupPlot::GetDataSetArea(iupPlotRect &outRect) const
+{
+  /* Viewport - Margin (size only, no need for viewport offset) */
+  outRect.mX = mBack.mMargin.mLeft + mBack.mHorizPadding;
+  outRect.mY = mBack.mMargin.mBottom + mBack.mVertPadding;
+  outRect.mWidth = mViewport.mWidth - mBack.mMargin.mLeft - mBack.mMargin.mRight - 2 * mBack.mHorizPadding;
+  outRect.mHeight = mViewport.mHeight - mBack.mMargin.mTop - mBack.mMargin.mBottom - 2 * mBack.mVertPadding;
+}
+
+bool iupPlot::Render(cdCanvas* canvas, bool inLayerCache)
+{
+  if (!mRedraw && !mRedrawOverlay)
     return true;
 
+  iupPlotRect theDataSetArea;  /* Viewport - Margin (size only, no need for viewport offset) */
+  iupPlotDataSet* pie_dataset = HasPie();
+
+  if (!mRedraw && inLayerCache && mLayerValid)
+  {
+    // only the overlays changed, the cached layer has the rest
+    RestoreLayer(canvas);
+
+    cdCanvasOrigin(canvas, mViewport.mX, mViewport.mY);
+    cdCanvasClip(canvas, CD_CLIPAREA);
+    cdCanvasNativeFont(canvas, mRenderAttrib.mFont);
+
+    GetDataSetArea(theDataSetArea);
+
+    return RenderOverlay(canvas, theDataSetArea, pie_dataset);
+  }
+
+  mLayerValid = false;
+
   // draw entire plot viewport
   DrawBackground(canvas);
 
@@ -488,13 +626,9 @@ bool iupPlot::Render(cdCanvas* canvas)
   if (!mDataSetListCount)
     return true;
 
-  cdCanvasNativeFont(canvas, IupGetAttribute(ih, "FONT"));
+  cdCanvasNativeFont(canvas, mRenderAttrib.mFont);
 
-  iupPlotRect theDataSetArea;  /* Viewport - Margin (size only, no need for viewport offset) */
-  theDataSetArea.mX = mBack.mMargin.mLeft + mBack.mHorizPadding;
-  theDataSetArea.mY = mBack.mMargin.mBottom + mBack.mVertPadding;
-  theDataSetArea.mWidth = mViewport.mWidth - mBack.mMargin.mLeft - mBack.mMargin.mRight - 2 * mBack.mHorizPadding;
-  theDataSetArea.mHeight = mViewport.mHeight - mBack.mMargin.mTop - mBack.mMargin.mBottom - 2 * mBack.mVertPadding;
+  GetDataSetArea(theDataSetArea);
 
   if (!CalculateTickSpacing(theDataSetArea, canvas))
     return false;
@@ -505,9 +639,8 @@ bool iupPlot::Render(cdCanvas* canvas)
   if (!CalculateYTransformation(theDataSetArea))
     return false;
 
-  IFnC pre_cb = (IFnC)IupGetCallback(ih, "PREDRAW_CB");
-  if (pre_cb)
-    pre_cb(ih, canvas);
+  if (mRenderAttrib.mPreDrawCB)
+    mRenderAttrib.mPreDrawCB(ih, canvas);
 
   if (mBack.GetImage())
     DrawBackgroundImage(canvas);
@@ -524,10 +657,10 @@ bool iupPlot::Render(cdCanvas* canvas)
   if (mGrid.mShowY)
     mGridMinor.DrawY(mAxisY.mTickIter, mAxisY.mTrafo, theDataSetArea, canvas);
 
-  if (!mAxisX.DrawX(theDataSetArea, canvas, mAxisY, ih))
+  if (!mAxisX.DrawX(theDataSetArea, canvas, mAxisY, ih, mRenderAttrib))
     return false;
 
-  if (!mAxisY.DrawY(theDataSetArea, canvas, mAxisX, ih))
+  if (!mAxisY.DrawY(theDataSetArea, canvas, mAxisX, ih, mRenderAttrib))
     return false;
 
   if (mBox.mShow)
@@ -536,14 +669,10 @@ bool iupPlot::Render(cdCanvas* canvas)
   // draw the datasets restricted to the dataset area with options
   DataSetClipArea(canvas, theDataSetArea.mX, theDataSetArea.mX + theDataSetArea.mWidth - 1, theDataSetArea.mY, theDataSetArea.mY + theDataSetArea.mHeight - 1);
 
-  IFniiddi drawsample_cb = (IFniiddi)IupGetCallback(ih, "DRAWSAMPLE_CB");
-
-  iupPlotDataSet* pie_dataset = HasPie();
-
   for (int ds = 0; ds < mDataSetListCount; ds++)
   {
     iupPlotDataSet* dataset = mDataSetList[ds];
-    iupPlotSampleNotify theNotify = { ih, ds, drawsample_cb };
+    iupPlotSampleNotify theNotify = { ih, ds, mRenderAttrib.mDrawSampleCB, &mRenderAttrib };
 
     if (pie_dataset)
     {
@@ -556,41 +685,67 @@ bool iupPlot::Render(cdCanvas* canvas)
     dataset->DrawData(mAxisX.mTrafo, mAxisY.mTrafo, canvas, &theNotify);
   }
 
+  if (inLayerCache)
+    SaveLayer(canvas);
+
+  return RenderOverlay(canvas, theDataSetArea, pie_dataset);
+}
+
+bool iupPlot::RenderOffscreen(cdCanvas* canvas)
+{
+  // render in a canvas that has the size of the plot background viewport,
+  // the result is identical to Render but moved to the canvas origin
+  iupPlotRect theViewport = mViewport;
+  iupPlotRect theViewportBack = mViewportBack;
+
+  mViewport.mX -= mViewportBack.mX;
+  mViewport.mY -= mViewportBack.mY;
+  mViewportBack.mX = 0;
+  mViewportBack.mY = 0;
+
+  bool ret = Render(canvas);
+
+  mViewport = theViewport;
+  mViewportBack = theViewportBack;
+  return ret;
+}
+
+bool iupPlot::RenderOverlay(cdCanvas* canvas, const iupPlotRect &inDataSetArea, iupPlotDataSet* inPieDataSet)
+{
   // draw the legend, crosshair and selection restricted to the dataset area
-  cdCanvasClipArea(canvas, theDataSetArea.mX, theDataSetArea.mX + theDataSetArea.mWidth - 1, theDataSetArea.mY, theDataSetArea.mY + theDataSetArea.mHeight - 1);
+  cdCanvasClipArea(canvas, inDataSetArea.mX, inDataSetArea.mX + inDataSetArea.mWidth - 1, inDataSetArea.mY, inDataSetArea.mY + inDataSetArea.mHeight - 1);
 
   if (mCrossHairH)
-    DrawCrossHairH(theDataSetArea, canvas);
+    DrawCrossHairH(inDataSetArea, canvas);
   else if (mCrossHairV)
-    DrawCrossHairV(theDataSetArea, canvas);
+    DrawCrossHairV(inDataSetArea, canvas);
 
   if (mShowSelectionBand)
   {
-    if (mSelectionBand.mX < theDataSetArea.mX)
+    if (mSelectionBand.mX < inDataSetArea.mX)
     {
-      mSelectionBand.mWidth = mSelectionBand.mX + mSelectionBand.mWidth - theDataSetArea.mX;
-      mSelectionBand.mX = theDataSetArea.mX;
+      mSelectionBand.mWidth = mSelectionBand.mX + mSelectionBand.mWidth - inDataSetArea.mX;
+      mSelectionBand.mX = inDataSetArea.mX;
     }
-    if (mSelectionBand.mY < theDataSetArea.mY)
+    if (mSelectionBand.mY < inDataSetArea.mY)
     {
-      mSelectionBand.mHeight = mSelectionBand.mY + mSelectionBand.mHeight - theDataSetArea.mY;
-      mSelectionBand.mY = theDataSetArea.mY;
+      mSelectionBand.mHeight = mSelectionBand.mY + mSelectionBand.mHeight - inDataSetArea.mY;
+      mSelectionBand.mY = inDataSetArea.mY;
     }
-    if (mSelectionBand.mX + mSelectionBand.mWidth > theDataSetArea.mX + theDataSetArea.mWidth)
-      mSelectionBand.mWidth = theDataSetArea.mX + theDataSetArea.mWidth - mSelectionBand.mX;
-    if (mSelectionBand.mY + mSelectionBand.mHeight > theDataSetArea.mY + theDataSetArea.mHeight)
-      mSelectionBand.mHeight = theDataSetArea.mY + theDataSetArea.mHeight - mSelectionBand.mY;
+    if (mSelectionBand.mX + mSelectionBand.mWidth > inDataSetArea.mX + inDataSetArea.mWidth)
+      mSelectionBand.mWidth = inDataSetArea.mX + inDataSetArea.mWidth - mSelectionBand.mX;
+    if (mSelectionBand.mY + mSelectionBand.mHeight > inDataSetArea.mY + inDataSetArea.mHeight)
+      mSelectionBand.mHeight = inDataSetArea.mY + inDataSetArea.mHeight - mSelectionBand.mY;
 
     mBox.Draw(mSelectionBand, canvas);
   }
 
-  IFnC post_cb = (IFnC)IupGetCallback(ih, "POSTDRAW_CB");
-  if (post_cb)
-    post_cb(ih, canvas);
+  if (mRenderAttrib.mPostDrawCB)
+    mRenderAttrib.mPostDrawCB(ih, canvas);
 
-  if (pie_dataset)
-    DrawSampleColorLegend(pie_dataset, theDataSetArea, canvas, mLegend.mPos);
-  else if (!DrawLegend(theDataSetArea, canvas, mLegend.mPos))
+  if (inPieDataSet)
+    DrawSampleColorLegend(inPieDataSet, inDataSetArea, canvas, mLegend.mPos);
+  else if (!DrawLegend(inDataSetArea, canvas, mLegend.mPos))
     return false;
 
   // Draw title restricted only by the viewport
@@ -598,10 +753,11 @@ bool iupPlot::Render(cdCanvas* canvas)
 
   DrawTitle(canvas);
 
-  if (!IupGetInt(ih, "ACTIVE"))
+  if (!mRenderAttrib.mActive)
     DrawInactive(canvas);
 
   mRedraw = false;
+  mRedrawOverlay = false;
   return true;
 }
 
@@ -32,6 +32,7 @@ const double kFloatSmall = 1e-20;
 const double kLogMinClipValue = 1e-10;  // pragmatism to avoid problems with small values in log plot
 
 long iupPlotDrawGetSampleColorTable(Ihandle* ih, int index);
+long iupPlotDrawGetSampleColorDefault(int index);
 
 int iupPlotCalcPrecision(double inValue);
 
@@ -154,7 +155,7 @@ public:
 class iupPlotData
 {
 public:
-  iupPlotData(int inSize) : mCount(0), mIsString(false) { mArray = iupArrayCreate(20, inSize); }
+  iupPlotData(int inSize) : mCount(0), mFirst(0), mSize(inSize), mIsString(false) { mArray = iupArrayCreate(20, inSize); }
   virtual ~iupPlotData() { iupArrayDestroy(mArray); }
 
   bool IsString() const { return mIsString; }
@@ -163,41 +164,110 @@ public:
   virtual bool CalculateRange(double &outMin, double &outMax) const = 0;
   virtual double GetSample(int inSampleIndex) const = 0;
 
-  void RemoveSample(int inSampleIndex) {
-    if (inSampleIndex < 0) inSampleIndex = 0; if (inSampleIndex > mCount) inSampleIndex = mCount;
-    iupArrayRemove(mArray, inSampleIndex, 1); mCount--;
+  virtual void RemoveSample(int inSampleIndex) {
+    if (mCount == 0) return;
+    if (inSampleIndex < 0) inSampleIndex = 0; if (inSampleIndex >= mCount) inSampleIndex = mCount - 1;
+    if (inSampleIndex == 0) 
+    {
+      // removing from the start only skips the sample, 
+      // the array is compacted when the skipped samples outnumber the used ones, so the cost is amortized O(1)
+      mFirst++; mCount--;
+      if (mFirst >= mCount) { iupArrayRemove(mArray, 0, mFirst); mFirst = 0; }
+    }
+    else
+    { 
+      iupArrayRemove(mArray, mFirst + inSampleIndex, 1); mCount--; 
+    }
   }
 
 protected:
   int mCount;
+  int mFirst;  // samples removed from the start of the array but not compacted yet
+  int mSize;
   Iarray* mArray;
   bool mIsString;
+
+  void* GetArrayData() const { return (unsigned char*)iupArrayGetData(mArray) + mFirst*mSize; }
+  void* IncArray() { iupArrayInc(mArray); return GetArrayData(); }
+  void* InsertArray(int inSampleIndex) { iupArrayInsert(mArray, mFirst + inSampleIndex, 1); return GetArrayData(); }
+};
+
+// Sample indices of a sliding window, kept in monotonic order of their values,
+// so the minimum (or maximum) of the window is always the first one.
+// Indices are absolute, they do not change when samples are removed from the start.
+class iupPlotDataQueue
+{
+public:
+  iupPlotDataQueue() : mFirst(0) { mArray = iupArrayCreate(20, sizeof(int)); }
+  ~iupPlotDataQueue() { iupArrayDestroy(mArray); }
+
+  void Clear() { iupArrayRemove(mArray, 0, iupArrayCount(mArray)); mFirst = 0; }
+  bool IsEmpty() const { return iupArrayCount(mArray) == mFirst; }
+  int GetFirst() const { return ((int*)iupArrayGetData(mArray))[mFirst]; }
+  int GetLast() const { return ((int*)iupArrayGetData(mArray))[iupArrayCount(mArray) - 1]; }
+  void RemoveFirst() { 
+    mFirst++; 
+    if (mFirst >= iupArrayCount(mArray) - mFirst) { iupArrayRemove(mArray, 0, mFirst); mFirst = 0; }
+  }
+  void RemoveLast() { iupArrayRemove(mArray, iupArrayCount(mArray) - 1, 1); }
+  void AddLast(int inIndex) { int* theData = (int*)iupArrayInc(mArray); theData[iupArrayCount(mArray) - 1] = inIndex; }
+
+protected:
+  Iarray* mArray;
+  int mFirst;
 };
 
 class iupPlotDataReal : public iupPlotData
 {
 public:
-  iupPlotDataReal() :iupPlotData(sizeof(double)) { mData = (double*)iupArrayGetData(mArray); }
+  iupPlotDataReal() :iupPlotData(sizeof(double)), mRangeValid(false), mRangeFirst(0), mMinMaxValid(false), mMin(0), mMax(0) { mData = (double*)GetArrayData(); }
 
   double GetSample(int inSampleIndex) const { return mData[inSampleIndex]; }
-  void SetSample(int inSampleIndex, double inReal) const { mData[inSampleIndex] = inReal; }
+  void SetSample(int inSampleIndex, double inReal) const;
 
-  void AddSample(double inReal) { mData = (double*)iupArrayInc(mArray); mData[mCount] = inReal; mCount++; }
+  void AddSample(double inReal) { 
+    mData = (double*)IncArray(); mData[mCount] = inReal; mCount++; 
+    if (mRangeValid) AddRangeSample(mCount - 1);
+    else if (mMinMaxValid) UpdateMinMax(inReal);
+  }
   void InsertSample(int inSampleIndex, double inReal) {
     if (inSampleIndex < 0) inSampleIndex = 0; if (inSampleIndex > mCount) inSampleIndex = mCount;
-    mData = (double*)iupArrayInsert(mArray, inSampleIndex, 1); mData[inSampleIndex] = inReal; mCount++;
+    if (inSampleIndex != mCount) QueueToMinMax();  // before the samples move
+    mData = (double*)InsertArray(inSampleIndex); mData[inSampleIndex] = inReal; mCount++;
+    if (mRangeValid) AddRangeSample(inSampleIndex);
+    else if (mMinMaxValid) UpdateMinMax(inReal);
   }
+  void RemoveSample(int inSampleIndex);
 
   bool CalculateRange(double &outMin, double &outMax) const;
 
 protected:
   double* mData;
+
+  // incremental range, valid while samples are only added at the end and removed from the start
+  mutable bool mRangeValid;
+  mutable int mRangeFirst;  // absolute index of the first sample
+  mutable iupPlotDataQueue mMinQueue;
+  mutable iupPlotDataQueue mMaxQueue;
+
+  // incremental range for the other changes, 
+  // valid until an extreme is removed or replaced
+  mutable bool mMinMaxValid;
+  mutable double mMin, mMax;
+
+  void AddRangeSample(int inSampleIndex) const;
+  void QueueToMinMax() const;
+  void UpdateMinMax(double inReal) const {
+    if (inReal != inReal) return;  // NaN is not ordered
+    if (inReal < mMin) mMin = inReal;
+    if (inReal > mMax) mMax = inReal;
+  }
 };
 
 class iupPlotDataString : public iupPlotData
 {
 public:
-  iupPlotDataString() :iupPlotData(sizeof(char*)) { mIsString = true; mData = (char**)iupArrayGetData(mArray); }
+  iupPlotDataString() :iupPlotData(sizeof(char*)) { mIsString = true; mData = (char**)GetArrayData(); }
   ~iupPlotDataString();
 
   double GetSample(int inSampleIndex) const { return inSampleIndex; }
@@ -209,10 +279,15 @@ public:
     mData[inSampleIndex] = iupStrDup(inString); 
   }
 
-  void AddSample(const char *inString) { mData = (char**)iupArrayInc(mArray); mData[mCount] = iupStrDup(inString); mCount++; }
+  void AddSample(const char *inString) { mData = (char**)IncArray(); mData[mCount] = iupStrDup(inString); mCount++; }
   void InsertSample(int inSampleIndex, const char *inString) {
     if (inSampleIndex < 0) inSampleIndex = 0; if (inSampleIndex > mCount) inSampleIndex = mCount;
-    mData = (char**)iupArrayInsert(mArray, inSampleIndex, 1); mData[inSampleIndex] = iupStrDup(inString); mCount++;
+    mData = (char**)InsertArray(inSampleIndex); mData[inSampleIndex] = iupStrDup(inString); mCount++;
+  }
+  void RemoveSample(int inSampleIndex) {
+    if (inSampleIndex < 0 || inSampleIndex >= mCount) return;
+    free(mData[inSampleIndex]);
+    iupPlotData::RemoveSample(inSampleIndex); mData = (char**)GetArrayData();
   }
 
   bool CalculateRange(double &outMin, double &outMax) const;
@@ -224,18 +299,19 @@ protected:
 class iupPlotDataBool : public iupPlotData
 {
 public:
-  iupPlotDataBool() :iupPlotData(sizeof(bool)) { mData = (bool*)iupArrayGetData(mArray); }
+  iupPlotDataBool() :iupPlotData(sizeof(bool)) { mData = (bool*)GetArrayData(); }
 
   double GetSample(int inSampleIndex) const { return (int)mData[inSampleIndex]; }
 
   bool GetSampleBool(int inSampleIndex) const { return mData[inSampleIndex]; }
   void SetSampleBool(int inSampleIndex, bool inBool) { mData[inSampleIndex] = inBool; }
 
-  void AddSample(bool inBool) { mData = (bool*)iupArrayInc(mArray); mData[mCount] = inBool; mCount++; }
+  void AddSample(bool inBool) { mData = (bool*)IncArray(); mData[mCount] = inBool; mCount++; }
   void InsertSample(int inSampleIndex, bool inBool) {
     if (inSampleIndex < 0) inSampleIndex = 0; if (inSampleIndex > mCount) inSampleIndex = mCount;
-    mData = (bool*)iupArrayInsert(mArray, inSampleIndex, 1); mData[inSampleIndex] = inBool; mCount++;
+    mData = (bool*)InsertArray(inSampleIndex); mData[inSampleIndex] = inBool; mCount++;
   }
+  void RemoveSample(int inSampleIndex) { iupPlotData::RemoveSample(inSampleIndex); mData = (bool*)GetArrayData(); }
 
   bool CalculateRange(double &outMin, double &outMax) const;
 
@@ -243,11 +319,39 @@ protected:
   bool* mData;
 };
 
+// attributes of the element used during render, 
+// updated in the main thread by iupPlot::UpdateRenderAttrib, so the render threads do not call the IUP API
+class iupPlotRenderAttrib
+{
+public:
+  iupPlotRenderAttrib()
+    :mFont(NULL), mFontSize(0), mActive(true), mDecimalSymbol(NULL), 
+     mPreDrawCB(NULL), mPostDrawCB(NULL), mDrawSampleCB(NULL), mXTickFormatNumberCB(NULL), mYTickFormatNumberCB(NULL),
+     mSampleColor(NULL), mSampleColorCount(0), mSampleColorMax(0) {}
+  ~iupPlotRenderAttrib();
+
+  long GetSampleColor(int index) const { return index < mSampleColorCount ? mSampleColor[index] : iupPlotDrawGetSampleColorDefault(index); }
+
+  char* mFont;            // FONT
+  int mFontSize;          // FONTSIZE
+  bool mActive;           // ACTIVE
+  char* mDecimalSymbol;   // global DEFAULTDECIMALSYMBOL
+  IFnC mPreDrawCB;
+  IFnC mPostDrawCB;
+  IFniiddi mDrawSampleCB;
+  IFnssds mXTickFormatNumberCB;
+  IFnssds mYTickFormatNumberCB;
+  long* mSampleColor;     // SAMPLECOLORid, for the pie and multicolor bar datasets
+  int mSampleColorCount;
+  int mSampleColorMax;
+};
+
 struct iupPlotSampleNotify
 {
   Ihandle* ih;
   int ds;
   IFniiddi cb;
+  const iupPlotRenderAttrib* attrib;
 };
 
 class iupPlotDataSet
@@ -278,6 +382,8 @@ public:
   void AddSample(const char* inX, double inY);
   void InsertSample(int inSampleIndex, const char* inX, double inY);
   void RemoveSample(int inSampleIndex);
+  void SetMaxCount(int inMaxCount) { mMaxCount = inMaxCount; CheckMaxCount(); }
+  int GetMaxCount() const { return mMaxCount; }
   void GetSample(int inSampleIndex, double *inX, double *inY);
   void GetSample(int inSampleIndex, const char* *inX, double *inY);
   bool GetSampleSelection(int inSampleIndex);
@@ -333,9 +439,11 @@ protected:
   iupPlotDataReal* mExtra;
   iupPlotDataBool* mSegment;
   bool mHasSelected;
+  int mMaxCount;  // when the count is larger, samples are removed from the start, 0 means no limit
 
   void InitSegment();
   void InitExtra();
+  void CheckMaxCount();
 
   void DrawDataLine(const iupPlotTrafo *inTrafoX, const iupPlotTrafo *inTrafoY, cdCanvas* canvas, const iupPlotSampleNotify* inNotify, bool inShowMark, bool inErrorBar) const;
   void DrawDataMark(const iupPlotTrafo *inTrafoX, const iupPlotTrafo *inTrafoY, cdCanvas* canvas, const iupPlotSampleNotify* inNotify) const;
@@ -451,11 +559,42 @@ public:
   int mMinorSize;
 };
 
+// text metrics of the tick numbers, measured again only when the font changes
+struct iupPlotTickMetrics
+{
+  cdCanvas* mCanvas;
+  char mTypeface[1024];
+  int mStyle;
+  int mSize;
+
+  int mFontHeight;
+  int mSpanWidth;  // width of "12345", used to estimate the tick spacing
+  int mNumberWidth;  // average width of a number character
+  int mNumberHeight;
+};
+
+// last automatic tick spacing, calculated again only when the range, the viewport or the font change
+struct iupPlotTickSpacing
+{
+  bool mValid;
+
+  double mRange;
+  double mDivGuess;
+  double mLogBase;
+  const iupPlotTickIter* mTickIter;
+  bool mFormatAuto;
+  bool mReverseTicksLabel;
+
+  double mMajorSpan;
+  int mMinorDivision;
+  char mFormatString[30];
+};
+
 class iupPlotAxis
 {
 public:
   iupPlotAxis(int inDefaultFontStyle, int inDefaultFontSize, bool inVertical)
-    : mShow(true), mMin(0), mMax(0), mAutoScaleMin(true), mAutoScaleMax(true),
+    : mShow(true), mMin(0), mMax(0), mAutoScaleMin(true), mAutoScaleMax(true), mAutoScaleWindow(0),
     mReverse(false), mLogScale(false), mPosition(IUP_PLOT_START), mColor(CD_BLACK),
     mMaxDecades(-1), mLogBase(10), mLabelCentered(true), mHasZoom(false),
     mDiscrete(false), mLabel(NULL), mShowArrow(true), mLineWidth(1), mLabelSpacing(-1),
@@ -465,6 +604,7 @@ public:
     mPanMin(0), mReverseTicksLabel(false), mVertical(inVertical)
   {
     strcpy(mTipFormatString, IUP_PLOT_DEF_TIPFORMAT);
+    ResetTickCache();
   }
   ~iupPlotAxis() { SetLabel(NULL); }
 
@@ -478,6 +618,10 @@ public:
   int GetTickNumberWidth(cdCanvas* canvas) const;
   int GetArrowSize() const;
 
+  const iupPlotTickMetrics& GetTickMetrics(cdCanvas* canvas) const;
+  bool CalculateTickSpacing(double inRange, double inDivGuess);
+  void ResetTickCache() { mTickMetrics.mCanvas = NULL; mTickSpacing.mValid = false; }
+
   bool HasZoom() const { return mHasZoom; }
   bool ResetZoom();
   bool ZoomIn(double inCenter);
@@ -497,6 +641,7 @@ public:
   double mMax;
   bool mAutoScaleMin;
   bool mAutoScaleMax;
+  double mAutoScaleWindow;  // when larger than 0 and auto scaling the maximum, the minimum follows it by this length
   bool mReverse;
   iupPlotAxisPosition mPosition;
   bool mShowArrow;
@@ -541,6 +686,9 @@ protected:
   bool mNoZoomAutoScaleMin;
   bool mNoZoomAutoScaleMax;
   double mPanMin;
+
+  mutable iupPlotTickMetrics mTickMetrics;
+  iupPlotTickSpacing mTickSpacing;
 };
 
 class iupPlotAxisX : public iupPlotAxis
@@ -549,9 +697,9 @@ public:
   iupPlotAxisX(int inDefaultFontStyle, int inDefaultFontSize) :
     iupPlotAxis(inDefaultFontStyle, inDefaultFontSize, false) {}
 
-  bool DrawX(const iupPlotRect &inRect, cdCanvas* canvas, const iupPlotAxis& inAxisY, Ihandle* ih) const;
+  bool DrawX(const iupPlotRect &inRect, cdCanvas* canvas, const iupPlotAxis& inAxisY, Ihandle* ih, const iupPlotRenderAttrib& inAttrib) const;
 protected:
-  void DrawXTick(double inX, double inScreenY, bool inMajor, const char* inFormatString, cdCanvas* canvas, Ihandle* ih, IFnssds formatticknumber_cb) const;
+  void DrawXTick(double inX, double inScreenY, bool inMajor, const char* inFormatString, cdCanvas* canvas, Ihandle* ih, IFnssds formatticknumber_cb, const char* inDecimalSymbol) const;
   double GetScreenYOriginX(const iupPlotAxis& inAxisY) const;
 };
 
@@ -561,10 +709,10 @@ public:
   iupPlotAxisY(int inDefaultFontStyle, int inDefaultFontSize) :
     iupPlotAxis(inDefaultFontStyle, inDefaultFontSize, true) {}
 
-  bool DrawY(const iupPlotRect &inRect, cdCanvas* canvas, const iupPlotAxis& inAxisX, Ihandle* ih) const;
+  bool DrawY(const iupPlotRect &inRect, cdCanvas* canvas, const iupPlotAxis& inAxisX, Ihandle* ih, const iupPlotRenderAttrib& inAttrib) const;
 
 protected:
-  void DrawYTick(double inY, double inScreenX, bool inMajor, const char* inFormatString, cdCanvas* canvas, Ihandle* ih, IFnssds formatticknumber_cb) const;
+  void DrawYTick(double inY, double inScreenX, bool inMajor, const char* inFormatString, cdCanvas* canvas, Ihandle* ih, IFnssds formatticknumber_cb, const char* inDecimalSymbol) const;
   double GetScreenXOriginY(const iupPlotAxis& inAxisX) const;
 };
 
@@ -679,6 +827,8 @@ public:
   /*********************************/
 
   bool mRedraw;
+  bool mRedrawOverlay;  // only crosshair, selection, legend and title changed
+  double mRenderTime;  // duration of the last render, in milliseconds
   iupPlotRect mViewport;
   bool mViewportSquare;
   int mDefaultFontSize;
@@ -707,9 +857,14 @@ public:
   int mDataSetListMax;
   int mCurrentDataSet;
 
+  void UpdateRenderAttrib();
+  bool IsRenderThreadSafe() const;
   bool PrepareRender(cdCanvas* canvas);
-  bool Render(cdCanvas* canvas);
+  bool Render(cdCanvas* canvas, bool inLayerCache = false);
+  bool RenderOffscreen(cdCanvas* canvas);
   void SetViewport(int x, int y, int w, int h);
+  const iupPlotRect& GetViewportBack() const { return mViewportBack; }
+  void ReleaseLayer();
 
   void ResetZoom() { if (mAxisX.ResetZoom()) mRedraw = true; if (mAxisY.ResetZoom()) mRedraw = true; }
   void ZoomIn(double inCenterX, double inCenterY) { if (mAxisX.ZoomIn(inCenterX)) mRedraw = true; if (mAxisY.ZoomIn(inCenterY)) mRedraw = true; }
@@ -745,6 +900,18 @@ public:
 protected:
   Ihandle* ih;
   iupPlotRect mViewportBack;
+  iupPlotRenderAttrib mRenderAttrib;
+
+  // background, grid, axis and datasets of the last render, 
+  // restored when only the overlays must be redrawn
+  cdImage* mLayerImage;
+  int mLayerWidth, mLayerHeight;
+  bool mLayerValid;
+
+  void SaveLayer(cdCanvas* canvas);
+  void RestoreLayer(cdCanvas* canvas) const;
+  bool RenderOverlay(cdCanvas* canvas, const iupPlotRect &inDataSetArea, iupPlotDataSet* inPieDataSet);
+  void GetDataSetArea(iupPlotRect &outRect) const;
 
   void DataSetClipArea(cdCanvas* canvas, int xmin, int xmax, int ymin, int ymax) const;
   void ConfigureAxis();
@@ -780,7 +947,7 @@ protected:
   bool CalculateLinTransformation(int inBegin, int inEnd, const iupPlotAxis& inAxis, iupPlotTrafoLinear* outTrafo);
   bool CalculateLogTransformation(int inBegin, int inEnd, const iupPlotAxis& inAxis, iupPlotTrafoLog* outTrafo);
   bool CalculateTickSpacing(const iupPlotRect &inRect, cdCanvas* canvas);
-  void CalculateTickSize(cdCanvas* canvas, iupPlotTick &ioTick);
+  void CalculateTickSize(cdCanvas* canvas, iupPlotAxis &ioAxis);
 
   int CalcYTickVerticalMargin(cdCanvas* canvas, bool start) const;
   int CalcXTickHorizontalMargin(cdCanvas* canvas, bool start) const;
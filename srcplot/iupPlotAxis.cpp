@@ -70,13 +70,11 @@ static int iPlotEstimateNumberCharCount(bool inFormatAuto, const char* inFormatS
   return thePrecision;
 }
 
-static bool iPlotGetTickFormat(Ihandle* ih, IFnssds formatticknumber_cb, char* inBuf, const char *inFormatString, double inValue)
+static bool iPlotGetTickFormat(Ihandle* ih, IFnssds formatticknumber_cb, char* inBuf, const char *inFormatString, double inValue, const char* decimal_symbol)
 {
-  char* decimal_symbol = IupGetGlobal("DEFAULTDECIMALSYMBOL");
-
   if (formatticknumber_cb)
   {
-    int ret = formatticknumber_cb(ih, inBuf, (char*)inFormatString, inValue, decimal_symbol);
+    int ret = formatticknumber_cb(ih, inBuf, (char*)inFormatString, inValue, (char*)decimal_symbol);
     if (ret == IUP_IGNORE)
       return false;
     else if (ret == IUP_CONTINUE)
@@ -202,12 +200,68 @@ void iupPlotAxis::Init()
 
 void iupPlotAxis::GetTickNumberSize(cdCanvas* canvas, int *outWitdh, int *outHeight) const
 {
-  int theTickFontWidth, theTickFontHeight;
+  const iupPlotTickMetrics& theMetrics = GetTickMetrics(canvas);
+  if (outHeight) *outHeight = theMetrics.mNumberHeight;
+  if (outWitdh)  *outWitdh  = theMetrics.mNumberWidth * iPlotEstimateNumberCharCount(mTick.mFormatAuto, mTick.mFormatString, mHasZoom? mNoZoomMin: mMin, mHasZoom? mNoZoomMax: mMax);
+}
+
+const iupPlotTickMetrics& iupPlotAxis::GetTickMetrics(cdCanvas* canvas) const
+{
+  char theTypeface[1024];
+  int theStyle, theSize;
+
   SetFont(canvas, mTick.mFontStyle, mTick.mFontSize);
-  cdCanvasGetTextSize(canvas, "1234567890.", &theTickFontWidth, &theTickFontHeight);
-  theTickFontWidth /= 11;
-  if (outHeight) *outHeight = theTickFontHeight;
-  if (outWitdh)  *outWitdh  = theTickFontWidth * iPlotEstimateNumberCharCount(mTick.mFormatAuto, mTick.mFormatString, mHasZoom? mNoZoomMin: mMin, mHasZoom? mNoZoomMax: mMax);
+  cdCanvasGetFont(canvas, theTypeface, &theStyle, &theSize);
+
+  if (mTickMetrics.mCanvas != canvas || mTickMetrics.mStyle != theStyle || mTickMetrics.mSize != theSize || 
+      strcmp(mTickMetrics.mTypeface, theTypeface) != 0)
+  {
+    cdCanvasGetFontDim(canvas, NULL, &mTickMetrics.mFontHeight, NULL, NULL);
+    cdCanvasGetTextSize(canvas, "12345", &mTickMetrics.mSpanWidth, NULL);
+    cdCanvasGetTextSize(canvas, "1234567890.", &mTickMetrics.mNumberWidth, &mTickMetrics.mNumberHeight);
+    mTickMetrics.mNumberWidth /= 11;
+
+    mTickMetrics.mCanvas = canvas;
+    mTickMetrics.mStyle = theStyle;
+    mTickMetrics.mSize = theSize;
+    strcpy(mTickMetrics.mTypeface, theTypeface);
+  }
+
+  return mTickMetrics;
+}
+
+bool iupPlotAxis::CalculateTickSpacing(double inRange, double inDivGuess)
+{
+  if (mTickSpacing.mValid && mTickSpacing.mRange == inRange && mTickSpacing.mDivGuess == inDivGuess &&
+      mTickSpacing.mTickIter == mTickIter && mTickSpacing.mLogBase == mLogBase &&
+      mTickSpacing.mFormatAuto == mTick.mFormatAuto && mTickSpacing.mReverseTicksLabel == mReverseTicksLabel)
+  {
+    mTick.mMajorSpan = mTickSpacing.mMajorSpan;
+    mTick.mMinorDivision = mTickSpacing.mMinorDivision;
+    if (mTick.mFormatAuto)  // else the format was set by the application, and may have changed since
+      strcpy(mTick.mFormatString, mTickSpacing.mFormatString);
+    return true;
+  }
+
+  mTickSpacing.mValid = false;
+
+  if (!mTickIter->CalculateSpacing(inRange, inDivGuess, mTick))
+    return false;
+
+  mTickSpacing.mRange = inRange;
+  mTickSpacing.mDivGuess = inDivGuess;
+  mTickSpacing.mTickIter = mTickIter;
+  mTickSpacing.mLogBase = mLogBase;
+  mTickSpacing.mFormatAuto = mTick.mFormatAuto;
+  mTickSpacing.mReverseTicksLabel = mReverseTicksLabel;
+
+  mTickSpacing.mMajorSpan = mTick.mMajorSpan;
+  mTickSpacing.mMinorDivision = mTick.mMinorDivision;
+  if (mTick.mFormatAuto)
+    strcpy(mTickSpacing.mFormatString, mTick.mFormatString);
+  mTickSpacing.mValid = true;
+
+  return true;
 }
 
 void iupPlotAxis::SetNamedTickIter(const iupPlotDataString *inStringData)
@@ -515,7 +569,7 @@ double iupPlotAxisX::GetScreenYOriginX(const iupPlotAxis& inAxisY) const
   return inAxisY.mTrafo->Transform(theTargetY);
 }
 
-bool iupPlotAxisX::DrawX(const iupPlotRect &inRect, cdCanvas* canvas, const iupPlotAxis& inAxisY, Ihandle* ih) const
+bool iupPlotAxisX::DrawX(const iupPlotRect &inRect, cdCanvas* canvas, const iupPlotAxis& inAxisY, Ihandle* ih, const iupPlotRenderAttrib& inAttrib) const
 {
   if (!mShow)
     return true;
@@ -547,13 +601,11 @@ bool iupPlotAxisX::DrawX(const iupPlotRect &inRect, cdCanvas* canvas, const iupP
     char theFormatString[30];
     strcpy(theFormatString, mTick.mFormatString);
 
-    IFnssds formatticknumber_cb = (IFnssds)IupGetCallback(ih, "XTICKFORMATNUMBER_CB");
-
     if (mTick.mShowNumber)
       SetFont(canvas, mTick.mFontStyle, mTick.mFontSize);
 
     while (mTickIter->GetNextTick(theX, theIsMajorTick, theFormatString))
-      DrawXTick(theX, theScreenY, theIsMajorTick, theFormatString, canvas, ih, formatticknumber_cb);
+      DrawXTick(theX, theScreenY, theIsMajorTick, theFormatString, canvas, ih, inAttrib.mXTickFormatNumberCB, inAttrib.mDecimalSymbol);
 
     int theTickSpace = mTick.mMajorSize;  // skip major tick
     if (mTick.mShowNumber)
@@ -597,7 +649,7 @@ bool iupPlotAxisX::DrawX(const iupPlotRect &inRect, cdCanvas* canvas, const iupP
   return true;
 }
 
-void iupPlotAxisX::DrawXTick(double inX, double inScreenY, bool inMajor, const char*inFormatString, cdCanvas* canvas, Ihandle* ih, IFnssds formatticknumber_cb) const
+void iupPlotAxisX::DrawXTick(double inX, double inScreenY, bool inMajor, const char*inFormatString, cdCanvas* canvas, Ihandle* ih, IFnssds formatticknumber_cb, const char* inDecimalSymbol) const
 {
   int theTickSize;
   double theScreenX = mTrafo->Transform(inX);
@@ -608,7 +660,7 @@ void iupPlotAxisX::DrawXTick(double inX, double inScreenY, bool inMajor, const c
     if (mTick.mShowNumber)
     {
       char theBuf[128];
-      if (iPlotGetTickFormat(ih, formatticknumber_cb, theBuf, inFormatString, inX))
+      if (iPlotGetTickFormat(ih, formatticknumber_cb, theBuf, inFormatString, inX, inDecimalSymbol))
       {
         double theScreenY;
         if (mReverseTicksLabel)
@@ -663,7 +715,7 @@ double iupPlotAxisY::GetScreenXOriginY(const iupPlotAxis& inAxisX) const
   return inAxisX.mTrafo->Transform(theTargetX);
 }
 
-bool iupPlotAxisY::DrawY(const iupPlotRect &inRect, cdCanvas* canvas, const iupPlotAxis& inAxisX, Ihandle* ih) const
+bool iupPlotAxisY::DrawY(const iupPlotRect &inRect, cdCanvas* canvas, const iupPlotAxis& inAxisX, Ihandle* ih, const iupPlotRenderAttrib& inAttrib) const
 {
   if (!mShow)
     return true;
@@ -695,13 +747,11 @@ bool iupPlotAxisY::DrawY(const iupPlotRect &inRect, cdCanvas* canvas, const iupP
     char theFormatString[30];
     strcpy(theFormatString, mTick.mFormatString);
 
-    IFnssds formatticknumber_cb = (IFnssds)IupGetCallback(ih, "YTICKFORMATNUMBER_CB");
-
     if (mTick.mShowNumber)
       SetFont(canvas, mTick.mFontStyle, mTick.mFontSize);
 
     while (mTickIter->GetNextTick(theY, theIsMajorTick, theFormatString))
-      DrawYTick(theY, theScreenX, theIsMajorTick, theFormatString, canvas, ih, formatticknumber_cb);
+      DrawYTick(theY, theScreenX, theIsMajorTick, theFormatString, canvas, ih, inAttrib.mYTickFormatNumberCB, inAttrib.mDecimalSymbol);
 
     int theTickSpace = mTick.mMajorSize;  // skip major tick
     if (mTick.mShowNumber)
@@ -745,7 +795,7 @@ bool iupPlotAxisY::DrawY(const iupPlotRect &inRect, cdCanvas* canvas, const iupP
   return true;
 }
 
-void iupPlotAxisY::DrawYTick(double inY, double inScreenX, bool inMajor, const char* inFormatString, cdCanvas* canvas, Ihandle* ih, IFnssds formatticknumber_cb) const
+void iupPlotAxisY::DrawYTick(double inY, double inScreenX, bool inMajor, const char* inFormatString, cdCanvas* canvas, Ihandle* ih, IFnssds formatticknumber_cb, const char* inDecimalSymbol) const
 {
   int theTickSize;
   double theScreenY = mTrafo->Transform(inY);
@@ -756,7 +806,7 @@ void iupPlotAxisY::DrawYTick(double inY, double inScreenX, bool inMajor, const c
     if (mTick.mShowNumber)
     {
       char theBuf[128];
-      if (iPlotGetTickFormat(ih, formatticknumber_cb, theBuf, inFormatString, inY))
+      if (iPlotGetTickFormat(ih, formatticknumber_cb, theBuf, inFormatString, inY, inDecimalSymbol))
       {
         double theScreenX;
         if (mReverseTicksLabel)
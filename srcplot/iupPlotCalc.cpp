@@ -284,6 +284,9 @@ bool iupPlot::CalculateAxisRange()
     if (mAxisX.mAutoScaleMax) 
       mAxisX.mMax = theXMax;
 
+    if (mAxisX.mAutoScaleMax && mAxisX.mAutoScaleWindow > 0)
+      mAxisX.mMin = mAxisX.mMax - mAxisX.mAutoScaleWindow;  // scrolling window, shows only the latest samples
+
     if (!mAxisX.mTickIter->AdjustRange(mAxisX.mMin, mAxisX.mMax)) 
       return false;
   }
@@ -304,6 +307,9 @@ bool iupPlot::CalculateAxisRange()
     if (mAxisY.mAutoScaleMax)
       mAxisY.mMax = theYMax;
 
+    if (mAxisY.mAutoScaleMax && mAxisY.mAutoScaleWindow > 0)
+      mAxisY.mMin = mAxisY.mMax - mAxisY.mAutoScaleWindow;
+
     if (!mAxisY.mTickIter->AdjustRange(mAxisY.mMin, mAxisY.mMax))
       return false;
   }
@@ -369,16 +375,14 @@ bool iupPlot::CalculateYTransformation(const iupPlotRect &inRect)
   return mAxisY.mTrafo->Calculate(inRect.mY, inRect.mY + inRect.mHeight, mAxisY);
 }
 
-void iupPlot::CalculateTickSize(cdCanvas* canvas, iupPlotTick &ioTick)
+void iupPlot::CalculateTickSize(cdCanvas* canvas, iupPlotAxis &ioAxis)
 {
-  if (ioTick.mAutoSize)
+  if (ioAxis.mTick.mAutoSize)
   {
-    int theFontHeight;
-    SetFont(canvas, ioTick.mFontStyle, ioTick.mFontSize);
-    cdCanvasGetFontDim(canvas, NULL, &theFontHeight, NULL, NULL);
+    int theFontHeight = ioAxis.GetTickMetrics(canvas).mFontHeight;
 
-    ioTick.mMajorSize = theFontHeight / 2;
-    ioTick.mMinorSize = theFontHeight / 4;
+    ioAxis.mTick.mMajorSize = theFontHeight / 2;
+    ioAxis.mTick.mMinorSize = theFontHeight / 4;
   }
 }
 
@@ -403,26 +407,19 @@ bool iupPlot::CalculateTickSpacing(const iupPlotRect &inRect, cdCanvas* canvas)
 
   if (mAxisX.mTick.mAutoSpacing)
   {
-    int theXFontHeight;
-    SetFont(canvas, mAxisX.mTick.mFontStyle, mAxisX.mTick.mFontSize);
-    cdCanvasGetFontDim(canvas, NULL, &theXFontHeight, NULL, NULL);
-
-    int theTextWidth;
-    cdCanvasGetTextSize(canvas, "12345", &theTextWidth, NULL);
+    int theTextWidth = mAxisX.GetTickMetrics(canvas).mSpanWidth;
 
     double theDivGuess = inRect.mWidth / (kMajorTickXInitialFac*theTextWidth);
-    if (!mAxisX.mTickIter->CalculateSpacing(theXRange, theDivGuess, mAxisX.mTick))
+    if (!mAxisX.CalculateTickSpacing(theXRange, theDivGuess))
       return false;
   }
 
   if (mAxisY.mTick.mAutoSpacing)
   {
-    int theYFontHeight;
-    SetFont(canvas, mAxisY.mTick.mFontStyle, mAxisY.mTick.mFontSize);
-    cdCanvasGetFontDim(canvas, NULL, &theYFontHeight, NULL, NULL);
+    int theYFontHeight = mAxisY.GetTickMetrics(canvas).mFontHeight;
 
     double theDivGuess = inRect.mHeight / (kMajorTickYInitialFac*theYFontHeight);
-    if (!mAxisY.mTickIter->CalculateSpacing(theYRange, theDivGuess, mAxisY.mTick))
+    if (!mAxisY.CalculateTickSpacing(theYRange, theDivGuess))
       return false;
   }
 
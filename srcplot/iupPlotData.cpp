@@ -19,19 +19,130 @@ static inline bool iPlotCheckInsideBox(double x, double y, double boxMinX, doubl
 /************************************************************************************************/
 
 
+void iupPlotDataReal::AddRangeSample(int inSampleIndex) const
+{
+  double theValue = mData[inSampleIndex];
+  if (theValue != theValue)  // NaN is not ordered
+    return;
+
+  int theIndex = mRangeFirst + inSampleIndex;
+
+  while (!mMinQueue.IsEmpty() && mData[mMinQueue.GetLast() - mRangeFirst] >= theValue)
+    mMinQueue.RemoveLast();
+  mMinQueue.AddLast(theIndex);
+
+  while (!mMaxQueue.IsEmpty() && mData[mMaxQueue.GetLast() - mRangeFirst] <= theValue)
+    mMaxQueue.RemoveLast();
+  mMaxQueue.AddLast(theIndex);
+}
+
+void iupPlotDataReal::QueueToMinMax() const
+{
+  // the queues can not follow changes in the middle, keep only their extremes
+  if (mRangeValid)
+  {
+    mRangeValid = false;
+
+    if (mMinQueue.IsEmpty())  // all samples are NaN
+      mMinMaxValid = false;
+    else
+    {
+      mMin = mData[mMinQueue.GetFirst() - mRangeFirst];
+      mMax = mData[mMaxQueue.GetFirst() - mRangeFirst];
+      mMinMaxValid = true;
+    }
+  }
+}
+
+void iupPlotDataReal::SetSample(int inSampleIndex, double inReal) const
+{
+  double theOldReal = mData[inSampleIndex];
+  if (theOldReal == inReal)
+    return;
+
+  QueueToMinMax();
+
+  mData[inSampleIndex] = inReal;
+
+  if (mMinMaxValid)
+  {
+    // replacing an extreme by a value inside the range requires a rescan
+    if ((theOldReal == mMin && !(inReal <= theOldReal)) || (theOldReal == mMax && !(inReal >= theOldReal)))
+      mMinMaxValid = false;
+    else
+      UpdateMinMax(inReal);
+  }
+}
+
+void iupPlotDataReal::RemoveSample(int inSampleIndex)
+{
+  if (mCount == 0)
+    return;
+
+  if (mRangeValid && inSampleIndex <= 0)
+  {
+    if (!mMinQueue.IsEmpty() && mMinQueue.GetFirst() == mRangeFirst)
+      mMinQueue.RemoveFirst();
+    if (!mMaxQueue.IsEmpty() && mMaxQueue.GetFirst() == mRangeFirst)
+      mMaxQueue.RemoveFirst();
+
+    mRangeFirst++;
+    if (mRangeFirst > 0x3FFFFFFF)  // rebuild before the absolute indices overflow
+      mRangeValid = false;
+  }
+  else
+  {
+    QueueToMinMax();
+
+    if (mMinMaxValid)
+    {
+      if (inSampleIndex < 0) inSampleIndex = 0;
+      if (inSampleIndex >= mCount) inSampleIndex = mCount - 1;
+
+      // removing an extreme requires a rescan
+      double theReal = mData[inSampleIndex];
+      if (theReal == mMin || theReal == mMax)
+        mMinMaxValid = false;
+    }
+  }
+
+  iupPlotData::RemoveSample(inSampleIndex);
+  mData = (double*)GetArrayData();
+
+  if (mCount == 0)
+    mMinMaxValid = false;
+}
+
 bool iupPlotDataReal::CalculateRange(double &outMin, double &outMax) const
 {
-  int theCount = iupArrayCount(mArray);
-  if (theCount > 0)
+  if (mCount > 0)
   {
-    double* theData = (double*)iupArrayGetData(mArray);
-    outMax = outMin = theData[0];
-    for (int i = 1; i < theCount; i++)
+    if (mMinMaxValid && !mRangeValid)
+    {
+      outMin = mMin;
+      outMax = mMax;
+      return true;
+    }
+
+    if (!mRangeValid)
+    {
+      mMinQueue.Clear();
+      mMaxQueue.Clear();
+      mRangeFirst = 0;
+
+      for (int i = 0; i < mCount; i++)
+        AddRangeSample(i);
+
+      mRangeValid = true;
+      mMinMaxValid = false;
+    }
+
+    if (mMinQueue.IsEmpty())  // all samples are NaN
+      outMax = outMin = mData[0];
+    else
     {
-      if (theData[i] > outMax)
-        outMax = theData[i];
-      if (theData[i] < outMin)
-        outMin = theData[i];
+      outMin = mData[mMinQueue.GetFirst() - mRangeFirst];
+      outMax = mData[mMaxQueue.GetFirst() - mRangeFirst];
     }
     return true;
   }
@@ -77,7 +188,7 @@ iupPlotDataSet::iupPlotDataSet(bool strXdata)
 : mColor(CD_BLACK), mLineStyle(CD_CONTINUOUS), mLineWidth(1), mAreaTransparency(255), mMarkStyle(CD_X), mMarkSize(7),
   mMultibarIndex(-1), mMultibarCount(0), mBarOutlineColor(0), mBarShowOutline(false), mBarSpacingPercent(10),
   mPieStartAngle(0), mPieRadius(0.95), mPieContour(false), mPieHole(0), mPieSliceLabelPos(0.95),
-  mHighlightedSample(-1), mHighlightedCurve(false), mBarMulticolor(false), mOrderedX(false), mSelectedCurve(false),
+  mHighlightedSample(-1), mHighlightedCurve(false), mBarMulticolor(false), mOrderedX(false), mSelectedCurve(false), mMaxCount(0),
   mPieSliceLabel(IUP_PLOT_NONE), mMode(IUP_PLOT_LINE), mName(NULL), mHasSelected(false), mUserData(0)
 {
   if (strXdata)
@@ -620,6 +731,8 @@ void iupPlotDataSet::AddSample(double inX, double inY)
     mSegment->AddSample(false);
   if (mExtra)
     mExtra->AddSample(0);
+
+  CheckMaxCount();
 }
 
 void iupPlotDataSet::InsertSample(int inSampleIndex, double inX, double inY)
@@ -637,6 +750,8 @@ void iupPlotDataSet::InsertSample(int inSampleIndex, double inX, double inY)
     mSegment->InsertSample(inSampleIndex, false);
   if (mExtra)
     mExtra->InsertSample(inSampleIndex, 0);
+
+  CheckMaxCount();
 }
 
 void iupPlotDataSet::InitSegment()
@@ -674,6 +789,8 @@ void iupPlotDataSet::AddSampleSegment(double inX, double inY, bool inSegment)
   mSegment->AddSample(inSegment);
   if (mExtra)
     mExtra->AddSample(0);
+
+  CheckMaxCount();
 }
 
 void iupPlotDataSet::InsertSampleSegment(int inSampleIndex, double inX, double inY, bool inSegment)
@@ -693,6 +810,8 @@ void iupPlotDataSet::InsertSampleSegment(int inSampleIndex, double inX, double i
   mSegment->InsertSample(inSampleIndex, inSegment);
   if (mExtra)
     mExtra->InsertSample(inSampleIndex, 0);
+
+  CheckMaxCount();
 }
 
 void iupPlotDataSet::AddSample(const char* inX, double inY)
@@ -710,6 +829,8 @@ void iupPlotDataSet::AddSample(const char* inX, double inY)
     mSegment->AddSample(false);
   if (mExtra)
     mExtra->AddSample(0);
+
+  CheckMaxCount();
 }
 
 void iupPlotDataSet::InsertSample(int inSampleIndex, const char* inX, double inY)
@@ -727,6 +848,24 @@ void iupPlotDataSet::InsertSample(int inSampleIndex, const char* inX, double inY
     mSegment->InsertSample(inSampleIndex, false);
   if (mExtra)
     mExtra->InsertSample(inSampleIndex, 0);
+
+  CheckMaxCount();
+}
+
+void iupPlotDataSet::CheckMaxCount()
+{
+  if (mMaxCount <= 0)
+    return;
+
+  // remove the oldest samples, removing from the start does not move the data
+  int theCount = mDataX->GetCount();
+  for (int i = theCount; i > mMaxCount; i--)
+  {
+    if (mHighlightedSample >= 0)
+      mHighlightedSample--;
+
+    RemoveSample(0);
+  }
 }
 
 void iupPlotDataSet::RemoveSample(int inSampleIndex)
@@ -1205,7 +1344,7 @@ void iupPlotDataSet::DrawDataBar(const iupPlotTrafo *inTrafoX, const iupPlotTraf
       continue;
 
     if (mBarMulticolor)
-      cdCanvasSetForeground(canvas, iupPlotDrawGetSampleColorTable(inNotify->ih, i));
+      cdCanvasSetForeground(canvas, inNotify->attrib->GetSampleColor(i));
 
     iupPlotDrawBox(canvas, theBarX, theScreenY0, theBarWidth, theBarHeight);
 
@@ -1254,7 +1393,7 @@ void iupPlotDataSet::DrawDataHorizontalBar(const iupPlotTrafo *inTrafoX, const i
       continue;
 
     if (mBarMulticolor)
-      cdCanvasSetForeground(canvas, iupPlotDrawGetSampleColorTable(inNotify->ih, i));
+      cdCanvasSetForeground(canvas, inNotify->attrib->GetSampleColor(i));
 
     iupPlotDrawBox(canvas, theScreenX0, theBarY, theBarWidth, theBarHeight);
 
@@ -1449,7 +1588,7 @@ void iupPlotDataSet::DrawDataPie(const iupPlotTrafo *inTrafoX, const iupPlotTraf
     if (inNotify->cb)
       inNotify->cb(inNotify->ih, inNotify->ds, i, theX, theY, (int)mSelection->GetSampleBool(i));
 
-    cdCanvasSetForeground(canvas, iupPlotDrawGetSampleColorTable(inNotify->ih, i));
+    cdCanvasSetForeground(canvas, inNotify->attrib->GetSampleColor(i));
 
     cdfCanvasSector(canvas, xc, yc, w, h, startAngle, startAngle + angle);
 
@@ -187,7 +187,7 @@ void iupPlot::SetTitleFont(cdCanvas* canvas) const
   int theFontSize = mTitle.mFontSize;
   if (theFontSize == 0)
   {
-    int size = IupGetInt(ih, "FONTSIZE");
+    int size = mRenderAttrib.mFontSize;
     if (size > 0) size += 6;
     else size -= 8;
 
@@ -381,6 +381,11 @@ long iupPlotDrawGetSampleColorTable(Ihandle* ih, int index)
   if (iupStrToColor(value, &color))
     return color;
 
+  return iupPlotDrawGetSampleColorDefault(index);
+}
+
+long iupPlotDrawGetSampleColorDefault(int index)
+{
   switch (index % 12)
   {
   case  0: return cdEncodeColor(220, 60, 20);
@@ -487,7 +492,7 @@ bool iupPlot::DrawSampleColorLegend(iupPlotDataSet *dataset, const iupPlotRect &
 
     for (int i = 0; i < theCount; i++)
     {
-      cdCanvasSetForeground(canvas, iupPlotDrawGetSampleColorTable(ih, i));
+      cdCanvasSetForeground(canvas, mRenderAttrib.GetSampleColor(i));
 
       int theLegendX = ioPos.mX + theMargin;
       int theLegendY = ioPos.mY + (theCount - 1 - i)*theFontHeight + theMargin;
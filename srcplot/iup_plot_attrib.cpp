@@ -264,11 +264,100 @@ static int iPlotSetRedrawAttrib(Ihandle* ih, const char* value)
     only_current = 1;
   }
 
+  if (ih->data->redraw_timer)
+  {
+    // redraw at most once per interval, 
+    // intermediate requests are merged in a single redraw done by the timer
+    if (IupGetInt(ih->data->redraw_timer, "RUN"))
+    {
+      ih->data->redraw_pending = 1;
+      return 0;
+    }
+
+    IupSetAttribute(ih->data->redraw_timer, "RUN", "YES");
+  }
+
   iupPlotRedraw(ih, flush, only_current, reset_redraw);
 
   return 0;
 }
 
+static int iPlotRedrawTimer_CB(Ihandle* timer)
+{
+  Ihandle* ih = (Ihandle*)iupAttribGet(timer, "_IUP_PLOT");
+
+  if (ih->data->redraw_pending && ih->data->cd_canvas)
+  {
+    ih->data->redraw_pending = 0;
+    iupPlotRedraw(ih, 1, 0, 1);
+  }
+  else
+    IupSetAttribute(timer, "RUN", "NO");
+
+  return IUP_DEFAULT;
+}
+
+static int iPlotSetRedrawIntervalAttrib(Ihandle* ih, const char* value)
+{
+  int interval;
+  if (!iupStrToInt(value, &interval))
+    interval = 0;
+
+  if (interval > 0)
+  {
+    if (!ih->data->redraw_timer)
+    {
+      ih->data->redraw_timer = IupTimer();
+      IupSetCallback(ih->data->redraw_timer, "ACTION_CB", (Icallback)iPlotRedrawTimer_CB);
+      iupAttribSet(ih->data->redraw_timer, "_IUP_PLOT", (char*)ih);
+    }
+
+    IupSetInt(ih->data->redraw_timer, "TIME", interval);
+  }
+  else if (ih->data->redraw_timer)
+  {
+    IupDestroy(ih->data->redraw_timer);
+    ih->data->redraw_timer = NULL;
+
+    if (ih->data->redraw_pending && ih->data->cd_canvas)
+      iupPlotRedraw(ih, 1, 0, 1);
+    ih->data->redraw_pending = 0;
+  }
+
+  return 0;
+}
+
+static char* iPlotGetRedrawIntervalAttrib(Ihandle* ih)
+{
+  if (ih->data->redraw_timer)
+    return IupGetAttribute(ih->data->redraw_timer, "TIME");
+  else
+    return "0";
+}
+
+static int iPlotSetRenderThreadsAttrib(Ihandle* ih, const char* value)
+{
+  int threads;
+  if (!iupStrToInt(value, &threads))
+    threads = 0;
+
+  if (threads > IUP_PLOT_MAX_PLOTS)
+    threads = IUP_PLOT_MAX_PLOTS;
+
+  ih->data->render_threads = threads;
+  return 0;
+}
+
+static char* iPlotGetRenderThreadsAttrib(Ihandle* ih)
+{
+  return iupStrReturnInt(ih->data->render_threads);
+}
+
+static char* iPlotGetRenderTimeAttrib(Ihandle* ih)
+{
+  return iupStrReturnDouble(ih->data->current_plot->mRenderTime);
+}
+
 static char* iPlotGetCountAttrib(Ihandle* ih)
 {
   return iupStrReturnInt(ih->data->current_plot->mDataSetListCount);
@@ -2074,6 +2163,32 @@ static char* iPlotGetDSOrderedXAttrib(Ihandle* ih)
   return iupStrReturnBoolean(dataset->mOrderedX ? 1 : 0);
 }
 
+static int iPlotSetDSMaxCountAttrib(Ihandle* ih, const char* value)
+{
+  if (ih->data->current_plot->mCurrentDataSet < 0 ||
+      ih->data->current_plot->mCurrentDataSet >= ih->data->current_plot->mDataSetListCount)
+      return 0;
+
+  int max_count;
+  if (iupStrToInt(value, &max_count))
+  {
+    iupPlotDataSet* dataset = ih->data->current_plot->mDataSetList[ih->data->current_plot->mCurrentDataSet];
+    dataset->SetMaxCount(max_count);
+    ih->data->current_plot->mRedraw = true;
+  }
+  return 0;
+}
+
+static char* iPlotGetDSMaxCountAttrib(Ihandle* ih)
+{
+  if (ih->data->current_plot->mCurrentDataSet < 0 ||
+      ih->data->current_plot->mCurrentDataSet >= ih->data->current_plot->mDataSetListCount)
+      return NULL;
+
+  iupPlotDataSet* dataset = ih->data->current_plot->mDataSetList[ih->data->current_plot->mCurrentDataSet];
+  return iupStrReturnInt(dataset->GetMaxCount());
+}
+
 static int iPlotSetDSSelectedAttrib(Ihandle* ih, const char* value)
 {
   if (ih->data->current_plot->mCurrentDataSet < 0 ||
@@ -2526,6 +2641,46 @@ static char* iPlotGetAxisYAutoMaxAttrib(Ihandle* ih)
   return iupStrReturnBoolean(axis->mAutoScaleMax);
 }
 
+static int iPlotSetAxisXAutoWindowAttrib(Ihandle* ih, const char* value)
+{
+  double xx;
+  if (iupStrToDouble(value, &xx))
+  {
+    iupPlotResetZoom(ih, 0);
+
+    iupPlotAxis* axis = &ih->data->current_plot->mAxisX;
+    axis->mAutoScaleWindow = xx;
+    ih->data->current_plot->mRedraw = true;
+  }
+  return 0;
+}
+
+static int iPlotSetAxisYAutoWindowAttrib(Ihandle* ih, const char* value)
+{
+  double xx;
+  if (iupStrToDouble(value, &xx))
+  {
+    iupPlotResetZoom(ih, 0);
+
+    iupPlotAxis* axis = &ih->data->current_plot->mAxisY;
+    axis->mAutoScaleWindow = xx;
+    ih->data->current_plot->mRedraw = true;
+  }
+  return 0;
+}
+
+static char* iPlotGetAxisXAutoWindowAttrib(Ihandle* ih)
+{
+  iupPlotAxis* axis = &ih->data->current_plot->mAxisX;
+  return iupStrReturnDouble(axis->mAutoScaleWindow);
+}
+
+static char* iPlotGetAxisYAutoWindowAttrib(Ihandle* ih)
+{
+  iupPlotAxis* axis = &ih->data->current_plot->mAxisY;
+  return iupStrReturnDouble(axis->mAutoScaleWindow);
+}
+
 static int iPlotSetAxisXMinAttrib(Ihandle* ih, const char* value)
 {
   double xx;
@@ -3599,6 +3754,9 @@ void iupPlotRegisterAttributes(Iclass* ic)
 
   iupClassRegisterAttribute(ic, "ANTIALIAS", iPlotGetAntialiasAttrib, iPlotSetAntialiasAttrib, IUPAF_SAMEASSYSTEM, "No", IUPAF_NO_INHERIT);
   iupClassRegisterAttribute(ic, "REDRAW", NULL, iPlotSetRedrawAttrib, NULL, NULL, IUPAF_WRITEONLY | IUPAF_NO_INHERIT);
+  iupClassRegisterAttribute(ic, "REDRAWINTERVAL", iPlotGetRedrawIntervalAttrib, iPlotSetRedrawIntervalAttrib, IUPAF_SAMEASSYSTEM, "0", IUPAF_NOT_MAPPED | IUPAF_NO_INHERIT);
+  iupClassRegisterAttribute(ic, "RENDERTHREADS", iPlotGetRenderThreadsAttrib, iPlotSetRenderThreadsAttrib, IUPAF_SAMEASSYSTEM, "0", IUPAF_NOT_MAPPED | IUPAF_NO_INHERIT);
+  iupClassRegisterAttribute(ic, "RENDERTIME", iPlotGetRenderTimeAttrib, NULL, NULL, NULL, IUPAF_READONLY | IUPAF_NOT_MAPPED | IUPAF_NO_INHERIT);
   iupClassRegisterAttribute(ic, "SYNCVIEW", iPlotGetSyncViewAttrib, iPlotSetSyncViewAttrib, NULL, NULL, IUPAF_NOT_MAPPED | IUPAF_NO_INHERIT);
   iupClassRegisterAttribute(ic, "MERGEVIEW", iPlotGetMergeViewAttrib, iPlotSetMergeViewAttrib, NULL, NULL, IUPAF_NOT_MAPPED | IUPAF_NO_INHERIT);
   iupClassRegisterAttribute(ic, "READONLY", iPlotGetReadOnlyAttrib, iPlotSetReadOnlyAttrib, IUPAF_SAMEASSYSTEM, "Yes", IUPAF_NOT_MAPPED | IUPAF_NO_INHERIT);
@@ -3694,6 +3852,7 @@ void iupPlotRegisterAttributes(Iclass* ic)
   iupClassRegisterAttribute(ic, "DS_STRXDATA", iPlotGetDSStrXDataAttrib, NULL, NULL, NULL, IUPAF_READONLY | IUPAF_NOT_MAPPED | IUPAF_NO_INHERIT);
   iupClassRegisterAttribute(ic, "DS_EXTRA", iPlotGetDSExtraAttrib, NULL, NULL, NULL, IUPAF_READONLY | IUPAF_NOT_MAPPED | IUPAF_NO_INHERIT);
   iupClassRegisterAttribute(ic, "DS_ORDEREDX", iPlotGetDSOrderedXAttrib, iPlotSetDSOrderedXAttrib, NULL, NULL, IUPAF_NOT_MAPPED | IUPAF_NO_INHERIT);
+  iupClassRegisterAttribute(ic, "DS_MAXCOUNT", iPlotGetDSMaxCountAttrib, iPlotSetDSMaxCountAttrib, IUPAF_SAMEASSYSTEM, "0", IUPAF_NOT_MAPPED | IUPAF_NO_INHERIT);
   iupClassRegisterAttribute(ic, "DS_SELECTED", iPlotGetDSSelectedAttrib, iPlotSetDSSelectedAttrib, NULL, NULL, IUPAF_NOT_MAPPED | IUPAF_NO_INHERIT);
 
   iupClassRegisterAttribute(ic, "VIEWPORTSQUARE", iPlotGetViewportSquareAttrib, iPlotSetViewportSquareAttrib, IUPAF_SAMEASSYSTEM, "NO", IUPAF_NOT_MAPPED | IUPAF_NO_INHERIT);
@@ -3724,6 +3883,8 @@ void iupPlotRegisterAttributes(Iclass* ic)
   iupClassRegisterAttribute(ic, "AXS_YAUTOMIN", iPlotGetAxisYAutoMinAttrib, iPlotSetAxisYAutoMinAttrib, IUPAF_SAMEASSYSTEM, "YES", IUPAF_NOT_MAPPED | IUPAF_NO_INHERIT);
   iupClassRegisterAttribute(ic, "AXS_XAUTOMAX", iPlotGetAxisXAutoMaxAttrib, iPlotSetAxisXAutoMaxAttrib, IUPAF_SAMEASSYSTEM, "YES", IUPAF_NOT_MAPPED | IUPAF_NO_INHERIT);
   iupClassRegisterAttribute(ic, "AXS_YAUTOMAX", iPlotGetAxisYAutoMaxAttrib, iPlotSetAxisYAutoMaxAttrib, IUPAF_SAMEASSYSTEM, "YES", IUPAF_NOT_MAPPED | IUPAF_NO_INHERIT);
+  iupClassRegisterAttribute(ic, "AXS_XAUTOWINDOW", iPlotGetAxisXAutoWindowAttrib, iPlotSetAxisXAutoWindowAttrib, IUPAF_SAMEASSYSTEM, "0", IUPAF_NOT_MAPPED | IUPAF_NO_INHERIT);
+  iupClassRegisterAttribute(ic, "AXS_YAUTOWINDOW", iPlotGetAxisYAutoWindowAttrib, iPlotSetAxisYAutoWindowAttrib, IUPAF_SAMEASSYSTEM, "0", IUPAF_NOT_MAPPED | IUPAF_NO_INHERIT);
   iupClassRegisterAttribute(ic, "AXS_XMIN", iPlotGetAxisXMinAttrib, iPlotSetAxisXMinAttrib, NULL, NULL, IUPAF_NOT_MAPPED | IUPAF_NO_INHERIT);
   iupClassRegisterAttribute(ic, "AXS_YMIN", iPlotGetAxisYMinAttrib, iPlotSetAxisYMinAttrib, NULL, NULL, IUPAF_NOT_MAPPED | IUPAF_NO_INHERIT);
   iupClassRegisterAttribute(ic, "AXS_XMAX", iPlotGetAxisXMaxAttrib, iPlotSetAxisXMaxAttrib, NULL, NULL, IUPAF_NOT_MAPPED | IUPAF_NO_INHERIT);
@@ -36,6 +36,7 @@
 #include "iup_assert.h"
 #include "iup_predialogs.h"
 #include "iup_linefile.h"
+#include "iup_timer.h"
 #include "iup_image.h"
 
 #include "iup_plot_ctrl.h"
@@ -1424,6 +1425,209 @@ void iupPlotSetPlotCurrent(Ihandle* ih, int p)
   ih->data->current_plot = ih->data->plot_list[ih->data->current_plot_index];
 }
 
+static void iPlotRender(iupPlot* plot, cdCanvas* canvas, bool layer_cache)
+{
+  if (!plot->mRedraw && !plot->mRedrawOverlay)
+    return;
+
+  double start = iupTimerGetWallTime();
+  plot->Render(canvas, layer_cache);
+  plot->mRenderTime = iupTimerGetWallTime() - start;
+}
+
+static void iPlotReleaseRenderImage(Ihandle* ih, int p)
+{
+  IplotRenderImage* image = ih->data->render_image + p;
+
+  if (image->canvas)
+  {
+    cdKillCanvas(image->canvas);
+    free(image->buffer);
+
+    image->canvas = NULL;
+    image->buffer = NULL;
+  }
+}
+
+static int iPlotCheckRenderImage(Ihandle* ih, int p, double res)
+{
+  const iupPlotRect& viewport = ih->data->plot_list[p]->GetViewportBack();
+  IplotRenderImage* image = ih->data->render_image + p;
+  int size;
+
+  if (viewport.mWidth <= 0 || viewport.mHeight <= 0)
+    return 0;
+
+  if (image->canvas && (image->width != viewport.mWidth || image->height != viewport.mHeight))
+    iPlotReleaseRenderImage(ih, p);
+
+  if (image->canvas)
+    return 1;
+
+  size = viewport.mWidth * viewport.mHeight;
+  image->buffer = (unsigned char*)malloc(3 * size);
+  if (!image->buffer)
+    return 0;
+
+  image->canvas = cdCreateCanvasf(CD_IMAGERGB, "%dx%d %p %p %p -r%g", viewport.mWidth, viewport.mHeight, 
+                                  image->buffer, image->buffer + size, image->buffer + 2 * size, res);
+  if (!image->canvas)
+  {
+    free(image->buffer);
+    image->buffer = NULL;
+    return 0;
+  }
+
+  image->width = viewport.mWidth;
+  image->height = viewport.mHeight;
+  return 1;
+}
+
+static void iPlotUpdateRenderImageAttrib(Ihandle* ih, cdCanvas* canvas)
+{
+  /* draw with the same options of the display canvas, checked at every render because they can be changed */
+  char* antialias = cdCanvasGetAttribute(ih->data->cd_canvas, "ANTIALIAS");
+  if (antialias)
+    cdCanvasSetAttribute(canvas, "ANTIALIAS", antialias);
+
+  /* same as the CD_IUPDBUFFERRGB driver */
+  cdCanvasSetAttribute(canvas, "UTF8MODE", IupGetInt(NULL, "UTF8MODE") ? (char*)"1" : (char*)"0");
+}
+
+static int iPlotRenderThread_CB(Ihandle* thread)
+{
+  Ihandle* ih = (Ihandle*)iupAttribGet(thread, "_IUP_PLOT");
+  int index = iupAttribGetInt(thread, "_IUP_PLOT_THREAD_INDEX");
+  int job = 0;
+
+  /* pending plots are distributed in order among the threads, 
+     each plot is rendered only by one thread in its own canvas */
+  for (int p = 0; p < ih->data->plot_list_count; p++)
+  {
+    if (ih->data->render_job[p] != IUP_PLOT_RENDER_PENDING)
+      continue;
+
+    if (job % ih->data->render_threads_active == index)
+    {
+      iupPlot* plot = ih->data->plot_list[p];
+      cdCanvas* canvas = ih->data->render_image[p].canvas;
+
+      double start = iupTimerGetWallTime();
+      cdCanvasActivate(canvas);
+      plot->RenderOffscreen(canvas);
+      plot->mRenderTime = iupTimerGetWallTime() - start;
+
+      ih->data->render_job[p] = IUP_PLOT_RENDER_DONE;
+    }
+
+    job++;
+  }
+
+  return IUP_DEFAULT;
+}
+
+static int iPlotRenderParallel(Ihandle* ih)
+{
+  int p, t, count = 0;
+
+  /* only the software rasterizer of IMAGERGB produces in an off-screen canvas the same result as in the display canvas,
+     in merge view the plots are drawn over each other */
+  if (ih->data->render_threads < 2 || ih->data->plot_list_count < 2 ||
+      ih->data->graphics_mode != IUP_PLOT_IMAGERGB || ih->data->merge_view)
+    return 0;
+
+  /* callbacks are never called from the render threads */
+  if (IupGetCallback(ih, "PREDRAW_CB") || IupGetCallback(ih, "POSTDRAW_CB") || IupGetCallback(ih, "DRAWSAMPLE_CB") ||
+      IupGetCallback(ih, "XTICKFORMATNUMBER_CB") || IupGetCallback(ih, "YTICKFORMATNUMBER_CB"))
+    return 0;
+
+  /* same resolution of the display canvas, so fonts have the same size */
+  int canvas_width, canvas_height;
+  double canvas_width_mm, canvas_height_mm, res;
+  cdCanvasGetSize(ih->data->cd_canvas, &canvas_width, &canvas_height, &canvas_width_mm, &canvas_height_mm);
+  if (canvas_width_mm > 0)
+    res = (double)canvas_width / canvas_width_mm;
+  else
+    res = IupGetDouble(NULL, "SCREENDPI") / 25.4;
+
+  for (p = 0; p < ih->data->plot_list_count; p++)
+  {
+    iupPlot* plot = ih->data->plot_list[p];
+
+    ih->data->render_job[p] = IUP_PLOT_RENDER_NONE;
+
+    if (!plot->mRedraw && !plot->mRedrawOverlay)
+      continue;
+
+    /* the background image buffer is cached in the image attributes, 
+       so this plot is rendered in the main thread */
+    if (plot->mBack.GetImage())
+      continue;
+
+    /* the tick numbers of this plot would change the locale */
+    if (!plot->IsRenderThreadSafe())
+      continue;
+
+    if (!iPlotCheckRenderImage(ih, p, res))
+      continue;
+
+    iPlotUpdateRenderImageAttrib(ih, ih->data->render_image[p].canvas);
+
+    ih->data->render_job[p] = IUP_PLOT_RENDER_PENDING;
+    count++;
+  }
+
+  if (count < 2)
+    return 0;
+
+  ih->data->render_threads_active = ih->data->render_threads;
+  if (ih->data->render_threads_active > count)
+    ih->data->render_threads_active = count;
+
+  for (t = 0; t < ih->data->render_threads_active; t++)
+  {
+    Ihandle* thread = ih->data->render_thread[t];
+    if (!thread)
+    {
+      thread = IupThread();
+      IupSetCallback(thread, "THREAD_CB", (Icallback)iPlotRenderThread_CB);
+      iupAttribSet(thread, "_IUP_PLOT", (char*)ih);
+      iupAttribSetInt(thread, "_IUP_PLOT_THREAD_INDEX", t);
+      ih->data->render_thread[t] = thread;
+    }
+
+    IupSetAttribute(thread, "START", "Yes");
+  }
+
+  for (t = 0; t < ih->data->render_threads_active; t++)
+    IupSetAttribute(ih->data->render_thread[t], "JOIN", "Yes");
+
+  /* composite in the plot order, 
+     and render in the main thread the plots not rendered by the threads */
+  for (p = 0; p < ih->data->plot_list_count; p++)
+  {
+    iupPlotSetPlotCurrent(ih, p);
+
+    if (ih->data->render_job[p] == IUP_PLOT_RENDER_DONE)
+    {
+      const iupPlotRect& viewport = ih->data->current_plot->GetViewportBack();
+      IplotRenderImage* image = ih->data->render_image + p;
+      int size = image->width * image->height;
+
+      cdCanvasOrigin(ih->data->cd_canvas, 0, 0);
+      cdCanvasClip(ih->data->cd_canvas, CD_CLIPOFF);
+      cdCanvasPutImageRectRGB(ih->data->cd_canvas, image->width, image->height, image->buffer, image->buffer + size, image->buffer + 2 * size,
+                              viewport.mX, viewport.mY, image->width, image->height, 0, 0, 0, 0);
+    }
+    else
+      iPlotRender(ih->data->current_plot, ih->data->cd_canvas, false);
+
+    ih->data->render_job[p] = IUP_PLOT_RENDER_NONE;
+  }
+
+  return 1;
+}
+
 void iupPlotRedraw(Ihandle* ih, int flush, int only_current, int reset_redraw)
 {
   if (ih->data->graphics_mode == IUP_PLOT_OPENGL)
@@ -1439,6 +1643,9 @@ void iupPlotRedraw(Ihandle* ih, int flush, int only_current, int reset_redraw)
   if (ih->data->sync_view || ih->data->merge_view)
     only_current = 0;  // draw all plots
 
+  // in merge view the plots are drawn over each other, can not restore only one of them
+  bool layer_cache = ih->data->layer_cache && !ih->data->merge_view;
+
   cdCanvasActivate(ih->data->cd_canvas);
 
   if (only_current)
@@ -1446,8 +1653,11 @@ void iupPlotRedraw(Ihandle* ih, int flush, int only_current, int reset_redraw)
     if (reset_redraw)
       ih->data->current_plot->mRedraw = true;
 
-    ih->data->current_plot->PrepareRender(ih->data->cd_canvas);
-    ih->data->current_plot->Render(ih->data->cd_canvas);
+    ih->data->current_plot->UpdateRenderAttrib();
+
+    if (ih->data->current_plot->mRedraw)
+      ih->data->current_plot->PrepareRender(ih->data->cd_canvas);
+    iPlotRender(ih->data->current_plot, ih->data->cd_canvas, layer_cache);
   }
   else
   {
@@ -1461,7 +1671,12 @@ void iupPlotRedraw(Ihandle* ih, int flush, int only_current, int reset_redraw)
       if (reset_redraw)
         ih->data->current_plot->mRedraw = true;
 
-      ih->data->current_plot->PrepareRender(ih->data->cd_canvas);
+      // also used by the render threads, that can not call the IUP API
+      ih->data->current_plot->UpdateRenderAttrib();
+
+      // margins are shared in merge view, so always compute them
+      if (ih->data->current_plot->mRedraw || ih->data->merge_view)
+        ih->data->current_plot->PrepareRender(ih->data->cd_canvas);
 
       ih->data->current_plot->mBack.mTransparent = false;
     }
@@ -1506,11 +1721,14 @@ void iupPlotRedraw(Ihandle* ih, int flush, int only_current, int reset_redraw)
       }
     }
 
-    for (p = 0; p < ih->data->plot_list_count; p++)
+    if (!iPlotRenderParallel(ih))
     {
-      iupPlotSetPlotCurrent(ih, p);
+      for (p = 0; p < ih->data->plot_list_count; p++)
+      {
+        iupPlotSetPlotCurrent(ih, p);
 
-      ih->data->current_plot->Render(ih->data->cd_canvas);
+        iPlotRender(ih->data->current_plot, ih->data->cd_canvas, layer_cache);
+      }
     }
 
     iupPlotSetPlotCurrent(ih, old_current);
@@ -1590,7 +1808,7 @@ static void iPlotRedrawInteract(Ihandle *ih)
     only_current = 1, 
     reset_redraw = 0;  // render only if necessary
 
-  if (ih->data->current_plot->mRedraw)
+  if (ih->data->current_plot->mRedraw || ih->data->current_plot->mRedrawOverlay)
     flush = 1;
 
   iupPlotRedraw(ih, flush, only_current, reset_redraw);
@@ -1990,7 +2208,7 @@ static int iPlotMotion_CB(Ihandle* ih, int x, int y, char *status)
   {
     if (iup_iscontrol(status) || iup_isshift(status))
     {
-      ih->data->current_plot->mRedraw = true;
+      ih->data->current_plot->mRedrawOverlay = true;
       ih->data->current_plot->mShowSelectionBand = true;
       ih->data->current_plot->mSelectionBand.mX = ih->data->last_click_x < x ? ih->data->last_click_x : x;
       ih->data->current_plot->mSelectionBand.mY = ih->data->last_click_y < y ? ih->data->last_click_y : y;
@@ -2010,7 +2228,7 @@ static int iPlotMotion_CB(Ihandle* ih, int x, int y, char *status)
         {
           ih->data->current_plot->mTitle.mPosX = ih->data->last_pos_x + (x - ih->data->last_click_x);
           ih->data->current_plot->mTitle.mPosY = ih->data->last_pos_y + (y - ih->data->last_click_y);
-          ih->data->current_plot->mRedraw = true;
+          ih->data->current_plot->mRedrawOverlay = true;
 
           iPlotRedrawInteract(ih);
           return IUP_DEFAULT;
@@ -2020,7 +2238,7 @@ static int iPlotMotion_CB(Ihandle* ih, int x, int y, char *status)
         {
           ih->data->current_plot->mLegend.mPos.mX = ih->data->last_pos_x + (x - ih->data->last_click_x);
           ih->data->current_plot->mLegend.mPos.mY = ih->data->last_pos_y + (y - ih->data->last_click_y);
-          ih->data->current_plot->mRedraw = true;
+          ih->data->current_plot->mRedrawOverlay = true;
 
           iPlotRedrawInteract(ih);
           return IUP_DEFAULT;
@@ -2036,7 +2254,8 @@ static int iPlotMotion_CB(Ihandle* ih, int x, int y, char *status)
 
   bool changed = false;
   bool found = false;
-  bool redraw = false;
+  bool redraw = false;  // highlight is drawn with the datasets
+  bool redraw_overlay = false;
   int ds, sample, sample1, sample2;
   double rx, ry, rx1, ry1, rx2, ry2;
   const char* ds_name;
@@ -2140,7 +2359,7 @@ static int iPlotMotion_CB(Ihandle* ih, int x, int y, char *status)
 
   if (ih->data->show_cross_hair)
   {
-    redraw = true;
+    redraw_overlay = true;
 
     if (ih->data->show_cross_hair == IUP_PLOT_CROSSHAIR_HORIZ)
     {
@@ -2154,9 +2373,13 @@ static int iPlotMotion_CB(Ihandle* ih, int x, int y, char *status)
     }
   }
 
-  if (redraw)
+  if (redraw || redraw_overlay)
   {
-    ih->data->current_plot->mRedraw = true;
+    if (redraw)
+      ih->data->current_plot->mRedraw = true;
+    else
+      ih->data->current_plot->mRedrawOverlay = true;
+
     iPlotRedrawInteract(ih);
   }
 
@@ -2213,12 +2436,12 @@ static int iPlotKeyPress_CB(Ihandle* ih, int c, int press)
     {
       if (ih->data->plot_list[p]->mCrossHairH)
       {
-        ih->data->plot_list[p]->mRedraw = true;
+        ih->data->plot_list[p]->mRedrawOverlay = true;
         ih->data->plot_list[p]->mCrossHairH = false;
       }
       if (ih->data->plot_list[p]->mCrossHairV)
       {
-        ih->data->plot_list[p]->mRedraw = true;
+        ih->data->plot_list[p]->mRedrawOverlay = true;
         ih->data->plot_list[p]->mCrossHairV = false;
       }
     }
@@ -2697,8 +2920,10 @@ void IupPlotPaintTo(Ihandle* ih, cdCanvas* cnv)
     return;
 
   cdCanvas *old_cd_canvas = ih->data->cd_canvas;
+  int old_layer_cache = ih->data->layer_cache;
 
   ih->data->cd_canvas = (cdCanvas*)cnv;
+  ih->data->layer_cache = 0;
   iupPlotUpdateViewports(ih);
 
   // when drawing to an external canvas
@@ -2709,6 +2934,7 @@ void IupPlotPaintTo(Ihandle* ih, cdCanvas* cnv)
   iupPlotRedraw(ih, flush, only_current, reset_redraw);
 
   ih->data->cd_canvas = old_cd_canvas;
+  ih->data->layer_cache = old_layer_cache;
   iupPlotUpdateViewports(ih);
 }
 
@@ -2960,6 +3186,9 @@ static int iPlotMapMethod(Ihandle* ih)
   if (!ih->data->cd_canvas)
     return IUP_ERROR;
 
+  /* server images are not available in OpenGL and the RGB image is already in memory */
+  ih->data->layer_cache = (ih->data->graphics_mode == IUP_PLOT_NATIVE || ih->data->graphics_mode == IUP_PLOT_NATIVEPLUS);
+
   for (int p = 0; p < ih->data->plot_list_count; p++)
     ih->data->plot_list[p]->mRedraw = true;
 
@@ -2972,6 +3201,20 @@ static void iPlotUnMapMethod(Ihandle* ih)
 {
   if (ih->data->cd_canvas != NULL)
   {
+    for (int p = 0; p < IUP_PLOT_MAX_PLOTS; p++)
+    {
+      if (p < ih->data->plot_list_count)
+      {
+        ih->data->plot_list[p]->ReleaseLayer();
+
+        // the tick metrics were measured in the canvas
+        ih->data->plot_list[p]->mAxisX.ResetTickCache();
+        ih->data->plot_list[p]->mAxisY.ResetTickCache();
+      }
+
+      iPlotReleaseRenderImage(ih, p);
+    }
+
     cdKillCanvas(ih->data->cd_canvas);
     ih->data->cd_canvas = NULL;
   }
@@ -2979,6 +3222,15 @@ static void iPlotUnMapMethod(Ihandle* ih)
 
 static void iPlotDestroyMethod(Ihandle* ih)
 {
+  if (ih->data->redraw_timer)
+    IupDestroy(ih->data->redraw_timer);
+
+  for (int t = 0; t < IUP_PLOT_MAX_PLOTS; t++)
+  {
+    if (ih->data->render_thread[t])
+      IupDestroy(ih->data->render_thread[t]);
+  }
+
   for (int p = 0; p < ih->data->plot_list_count; p++)
     delete ih->data->plot_list[p];
 
@@ -6,6 +6,15 @@
 
 enum { IUP_PLOT_NATIVE, IUP_PLOT_NATIVEPLUS, IUP_PLOT_IMAGERGB, IUP_PLOT_OPENGL };
 enum { IUP_PLOT_CROSSHAIR_NONE, IUP_PLOT_CROSSHAIR_VERT, IUP_PLOT_CROSSHAIR_HORIZ };
+enum { IUP_PLOT_RENDER_NONE, IUP_PLOT_RENDER_PENDING, IUP_PLOT_RENDER_DONE };
+
+/* off-screen image of a plot, used by the parallel rendering */
+struct IplotRenderImage
+{
+  cdCanvas* canvas;
+  unsigned char* buffer;
+  int width, height;
+};
 
 struct _IcontrolData
 {
@@ -24,6 +33,15 @@ struct _IcontrolData
 
   cdCanvas* cd_canvas;
   int graphics_mode;
+  int layer_cache;  /* cache the static layers of each plot in a server image */
+  Ihandle* redraw_timer;  /* REDRAWINTERVAL, coalesce the redraws of streaming data */
+  int redraw_pending;
+
+  int render_threads;  /* RENDERTHREADS, maximum number of threads used to render the plots */
+  int render_threads_active;
+  Ihandle* render_thread[IUP_PLOT_MAX_PLOTS];
+  int render_job[IUP_PLOT_MAX_PLOTS];
+  IplotRenderImage render_image[IUP_PLOT_MAX_PLOTS];
   int default_font_size;
   int default_font_style;
 
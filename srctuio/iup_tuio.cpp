@@ -16,6 +16,11 @@
 #include <stdio.h>
 #include <string.h>
 
+#include <atomic>
+#include <mutex>
+#include <vector>
+#include <map>
+
 #include "iup_object.h"
 #include "iup_assert.h"
 #include "iup_str.h"
@@ -26,39 +31,102 @@
 
 using namespace TUIO;
 
-struct iTuioCursorEnvent{
+/* Events are produced by the TUIO receiver thread and consumed by the IUP main loop.
+   A single-producer/single-consumer ring is used so neither side ever blocks,
+   and the cursor list of the TuioClient is never locked while callbacks are called. */
+
+#define ITUIO_RING_SIZE 4096  /* must be a power of 2 */
+
+struct iTuioCursorEvent
+{
   int id;
   float x, y;
-  char state;
+  char state;   /* 'D', 'M', 'U', or 'F' for end of frame */
+};
+
+class iTuioEventRing
+{
+  iTuioCursorEvent events[ITUIO_RING_SIZE];
+  std::atomic<unsigned int> head;  /* written only by the consumer */
+  std::atomic<unsigned int> tail;  /* written only by the producer */
+
+  public:
+    iTuioEventRing() :head(0), tail(0) {}
+
+    bool push(int id, float x, float y, char state)
+    {
+      unsigned int t = tail.load(std::memory_order_relaxed);
+      if (t - head.load(std::memory_order_acquire) == ITUIO_RING_SIZE)
+        return false;  /* full */
+
+      iTuioCursorEvent& evt = events[t & (ITUIO_RING_SIZE - 1)];
+      evt.id = id;
+      evt.x = x;
+      evt.y = y;
+      evt.state = state;
+
+      tail.store(t + 1, std::memory_order_release);
+      return true;
+    }
 
-  iTuioCursorEnvent(int _id, float _x, float _y, char _state);
+    bool pop(iTuioCursorEvent& evt)
+    {
+      unsigned int h = head.load(std::memory_order_relaxed);
+      if (h == tail.load(std::memory_order_acquire))
+        return false;  /* empty */
+
+      evt = events[h & (ITUIO_RING_SIZE - 1)];
+
+      head.store(h + 1, std::memory_order_release);
+      return true;
+    }
 };
 
-iTuioCursorEnvent::iTuioCursorEnvent(int _id, float _x, float _y, char _state)
-:id(_id), x(_x), y(_y), state(_state)
+/* cursor state kept by the main loop side, built only from the received events */
+struct iTuioActiveCursor
 {
-}
+  int id;
+  float x, y;
+  char state;   /* state in the current frame, 0 if not changed */
+};
+
+/* The wakeup messages are posted to a hidden element shared by all clients that lives until
+   IupClose, so a message still queued when a client is destroyed never reaches a destroyed
+   element. The message carries only the client serial number, which is looked up in the
+   table of live listeners, accessed only in the main loop thread.
+   The receiver threads post to it while holding iTuioNotifyLock, so it is not destroyed
+   between the pointer load and the post. */
+static Ihandle* iTuioNotify = NULL;
+static std::mutex iTuioNotifyLock;
+static int iTuioLastSerial = 0;
+
+class IupTuioListener;
+static std::map<int, IupTuioListener*> iTuioListeners;
 
 class IupTuioListener : public TuioListener 
 {
-  int changed, locked;
-  TuioClient* client;
+  int changed;
   Ihandle* ih;
-  std::list<iTuioCursorEnvent> cursor_events;
+  iTuioEventRing ring;
+  std::atomic<int> wakeup_pending;
+  int wakeup_stale;
+  std::vector<iTuioActiveCursor> active_cursors;
 
   void processCursor(TuioCursor *tcur, const char* state, const char* action);
-  void initCursorInfo(std::list<TuioCursor*> &cursorList, int cursor_count, int* pid, int* pstate);
-  void finishCursorInfo(std::list<TuioCursor*> &cursorList, int cursor_count, int* px, int* py, int* pstate, int w, int h, int use_client_coord, Ihandle* ih_canvas);
-  void updateCursorInfo(int *cursor_count, int* pid, int* px, int* py, int* pstate, int id, int x, int y, int state);
-  int GetMainCursor(std::list<TuioCursor*> &cursorList);
+  void updateActiveCursor(const iTuioCursorEvent& evt);
+  int getMainCursor();
+  void processFrame(Ihandle* ih_canvas, int use_client_coord, int w, int h, IFniIIII mcb);
 
   static int timer_action_cb(Ihandle *timer);
 
   public:
     int debug;
+    int serial;
+    std::atomic<int> dropped;
     Ihandle* timer;
 
-    IupTuioListener(Ihandle* _ih, TuioClient* _client);
+    IupTuioListener(Ihandle* _ih);
+    ~IupTuioListener();
 
     void addTuioObject(TuioObject *tobj);
     void updateTuioObject(TuioObject *tobj);
@@ -73,17 +141,32 @@ class IupTuioListener : public TuioListener
     void removeTuioBlob(TuioBlob *tblb);
 
     void refresh(TuioTime frameTime);
+
+    void processEvents();
 };
 
-IupTuioListener::IupTuioListener(Ihandle* _ih, TuioClient* _client)
-  :changed(0), locked(0), client(_client), ih(_ih), debug(0)
+IupTuioListener::IupTuioListener(Ihandle* _ih)
+  :changed(0), ih(_ih), wakeup_pending(0), wakeup_stale(0), debug(0), dropped(0)
 {
+  serial = ++iTuioLastSerial;
+  iTuioListeners[serial] = this;
+
+  /* fallback for a lost wakeup, for instance PostThreadMessage inside a modal loop in Windows,
+     that would keep wakeup_pending set and the ring would fill */
   timer = IupTimer();
-  IupSetAttribute(timer, "TIME", "50");
+  IupSetAttribute(timer, "TIME", "100");
   IupSetAttribute(timer, "_IUP_TUIOLISTENER", (char*)this);
   IupSetCallback(timer, "ACTION_CB", timer_action_cb);
 }
 
+IupTuioListener::~IupTuioListener()
+{
+  /* wakeups still queued for this listener will be ignored */
+  iTuioListeners.erase(serial);
+
+  IupDestroy(timer);
+}
+
 void IupTuioListener::addTuioObject(TuioObject*) 
 {
   /* unused */
@@ -131,10 +214,13 @@ void IupTuioListener::removeTuioCursor(TuioCursor *tcur)
 
 void IupTuioListener::processCursor(TuioCursor *tcur, const char* state, const char* action) 
 {
+  /* called in the TUIO receiver thread */
   float x = tcur->getX();
   float y = tcur->getY();
   int id = (int)tcur->getSessionID();
-  cursor_events.push_back(iTuioCursorEnvent(id, x, y, state[0]));
+
+  if (!ring.push(id, x, y, state[0]))
+    dropped++;
 
   this->changed = 1;
 
@@ -144,20 +230,19 @@ void IupTuioListener::processCursor(TuioCursor *tcur, const char* state, const c
 
 void  IupTuioListener::refresh(TuioTime frameTime) 
 {
+  /* called in the TUIO receiver thread */
   if (this->changed)
   {
-    Ihandle* ih_canvas = IupGetAttributeHandle(this->ih, "TARGETCANVAS");
-    if (!ih_canvas)
-      ih_canvas = this->ih;
-
     this->changed = 0;
 
-    IFniiis cb = (IFniiis)IupGetCallback(ih_canvas, "TOUCH_CB");
-    IFniIIII mcb = (IFniIIII)IupGetCallback(ih_canvas, "MULTITOUCH_CB");
-    if (cb || mcb)
+    if (!ring.push(0, 0, 0, 'F'))
+      dropped++;
+
+    /* wake up the main loop only once until it consumes the events */
     {
-      this->client->lockCursorList();
-      this->locked = 1;
+      std::lock_guard<std::mutex> lock(iTuioNotifyLock);
+      if (iTuioNotify && wakeup_pending.exchange(1) == 0)
+        IupPostMessage(iTuioNotify, NULL, this->serial, 0, NULL);
     }
 
     if (this->debug)
@@ -165,110 +250,103 @@ void  IupTuioListener::refresh(TuioTime frameTime)
   }
 }
 
-void IupTuioListener::initCursorInfo(std::list<TuioCursor*> &cursorList, int cursor_count, int* pid, int* pstate)
+void IupTuioListener::updateActiveCursor(const iTuioCursorEvent& evt)
 {
-  std::list <TuioCursor*>::iterator iter;
-  int i;
+  std::vector<iTuioActiveCursor>::iterator iter;
+
+  for (iter = active_cursors.begin(); iter != active_cursors.end(); iter++)
+  {
+    if (iter->id == evt.id)
+    {
+      iter->x = evt.x;
+      iter->y = evt.y;
+      if (iter->state != 'D' || evt.state == 'U')  /* keep DOWN when moved in the same frame */
+        iter->state = evt.state;
+      return;
+    }
+  }
 
-  for (i = 0, iter = cursorList.begin() ; i<cursor_count; iter++, i++) 
+  if (evt.state != 'U')
   {
-    TuioCursor* tcur = (*iter);
-    pid[i] = (int)tcur->getSessionID();
-    pstate[i] = 0;  /* mark to be updated later */
+    iTuioActiveCursor cursor;
+    cursor.id = evt.id;
+    cursor.x = evt.x;
+    cursor.y = evt.y;
+    cursor.state = evt.state;
+    active_cursors.push_back(cursor);
   }
 }
 
-int IupTuioListener::GetMainCursor(std::list<TuioCursor*> &cursorList)
+int IupTuioListener::getMainCursor()
 {
-  std::list <TuioCursor*>::iterator iter;
-  std::list <TuioCursor*>::iterator end = cursorList.end();
+  std::vector<iTuioActiveCursor>::iterator iter;
   int min_id = -1;
 
-  for (iter = cursorList.begin(); iter!=end; iter++) 
+  for (iter = active_cursors.begin(); iter != active_cursors.end(); iter++)
   {
-    TuioCursor* tcur = (*iter);
-    int id = (int)tcur->getSessionID();
-    if (min_id == -1 || id < min_id)
-      min_id = id;
+    if (min_id == -1 || iter->id < min_id)
+      min_id = iter->id;
   }
 
   return min_id;
 }
 
-void IupTuioListener::finishCursorInfo(std::list<TuioCursor*> &cursorList, int cursor_count, int* px, int* py, int* pstate, int w, int h, int use_client_coord, Ihandle* ih_canvas)
+void IupTuioListener::processFrame(Ihandle* ih_canvas, int use_client_coord, int w, int h, IFniIIII mcb)
 {
-  std::list <TuioCursor*>::iterator iter;
-  std::list <TuioCursor*>::iterator end = cursorList.end();
-  int i;
+  int count = (int)active_cursors.size();
 
-  for (i = 0, iter = cursorList.begin(); i<cursor_count && iter!=end; iter++, i++) 
+  if (mcb && count)
   {
-    if (pstate[i] == 0) /* if still 0, then it was not updated, must fill it here */
-    {
-      TuioCursor* tcur = (*iter);
+    int *px = new int[4 * count];
+    int *py = px + count;
+    int *pid = py + count;
+    int *pstate = pid + count;
 
-      int x = tcur->getScreenX(w);
-      int y = tcur->getScreenY(h);
+    for (int i = 0; i < count; i++)
+    {
+      const iTuioActiveCursor& cursor = active_cursors[i];
+      int x = (int)floor(cursor.x*w + 0.5f);
+      int y = (int)floor(cursor.y*h + 0.5f);
 
       if (use_client_coord)
         iupdrvScreenToClient(ih_canvas, &x, &y);
 
+      pid[i] = cursor.id;
       px[i] = x;
       py[i] = y;
-      pstate[i] = 'M';  /* mark as MOVE */
+      pstate[i] = cursor.state ? cursor.state : 'M';
     }
-  }
-}
 
-void IupTuioListener::updateCursorInfo(int *cursor_count, int* pid, int* px, int* py, int* pstate, int id, int x, int y, int state)
-{
-  int i;
+    if (mcb(ih_canvas, count, pid, px, py, pstate) == IUP_CLOSE)
+      IupExitLoop();
 
-  for(i = 0; i < *cursor_count; i++)
-  {
-    if (pid[i] == id)
-    {
-      px[i] = x;
-      py[i] = y;
-      pstate[i] = state;
-      return;
-    }
+    delete[] px;
   }
 
-  if (state == 'U')  /* UP - not in the cursorList, add it */
+  /* cursors that went UP are reported only once */
+  for (int i = count - 1; i >= 0; i--)
   {
-    pid[i] = id;
-    px[i] = x;
-    py[i] = y;
-    pstate[i] = state;
-    (*cursor_count)++;
+    if (active_cursors[i].state == 'U')
+      active_cursors.erase(active_cursors.begin() + i);
+    else
+      active_cursors[i].state = 0;
   }
 }
 
-int IupTuioListener::timer_action_cb(Ihandle *timer)
+void IupTuioListener::processEvents()
 {
-  IupTuioListener* listener = reinterpret_cast<IupTuioListener*>(IupGetAttribute(timer, "_IUP_TUIOLISTENER"));
-
-  if (!listener->locked)
-    return IUP_DEFAULT;
+  /* called in the main loop thread */
+  iTuioCursorEvent evt;
 
-  std::list<TuioCursor*> cursorList = listener->client->getTuioCursors();
-  int events_count = (int)listener->cursor_events.size();
-  int cursor_count = (int)cursorList.size();
-  int total_count = events_count+cursor_count;
-  if (!total_count)
-  {
-    listener->locked = 0;
-    listener->client->unlockCursorList();
-    return IUP_DEFAULT;
-  }
+  wakeup_pending = 0;
+  wakeup_stale = 0;
 
   int use_client_coord = 0;
-  Ihandle* ih_canvas = IupGetAttributeHandle(listener->ih, "TARGETCANVAS");
+  Ihandle* ih_canvas = IupGetAttributeHandle(this->ih, "TARGETCANVAS");
   if (ih_canvas)
     use_client_coord = 1;
   else
-    ih_canvas = listener->ih;
+    ih_canvas = this->ih;
 
   IFniiis cb = (IFniiis)IupGetCallback(ih_canvas, "TOUCH_CB");
   IFniIIII mcb = (IFniIIII)IupGetCallback(ih_canvas, "MULTITOUCH_CB");
@@ -276,62 +354,66 @@ int IupTuioListener::timer_action_cb(Ihandle *timer)
   int w, h, x, y;
   iupdrvGetFullSize(&w, &h);
 
-  int *px=NULL, *py=NULL, *pid=NULL, *pstate=NULL;
-  if (mcb)
-  {
-    px = new int[total_count];
-    py = new int[total_count];
-    pid = new int[total_count];
-    pstate = new int[total_count];
-
-    listener->initCursorInfo(cursorList, cursor_count, pid, pstate);
-  }
-
-  int min_id = -1;
-  if (cb)
-    min_id = listener->GetMainCursor(cursorList);
-
-  for (int i = 0; i<events_count; i++) 
+  while (ring.pop(evt))
   {
-    const iTuioCursorEnvent& evt = listener->cursor_events.front();
-
-    const char* state = (evt.state=='D')? "DOWN": ((evt.state=='U')? "UP": "MOVE");
-    x = (int)floor(evt.x*w+0.5f);
-    y = (int)floor(evt.y*h+0.5f);
+    if (evt.state == 'F')
+    {
+      /* MULTITOUCH_CB is called once per frame */
+      processFrame(ih_canvas, use_client_coord, w, h, mcb);
+      continue;
+    }
 
-    if (use_client_coord)
-      iupdrvScreenToClient(ih_canvas, &x, &y);
+    updateActiveCursor(evt);
 
     if (cb)
     {
-      if (min_id == evt.id)
+      const char* state;
+
+      if (getMainCursor() == evt.id)
         state = (evt.state=='D')? "DOWN-PRIMARY": ((evt.state=='U')? "UP-PRIMARY": "MOVE-PRIMARY");
+      else
+        state = (evt.state=='D')? "DOWN": ((evt.state=='U')? "UP": "MOVE");
+
+      x = (int)floor(evt.x*w+0.5f);
+      y = (int)floor(evt.y*h+0.5f);
+
+      if (use_client_coord)
+        iupdrvScreenToClient(ih_canvas, &x, &y);
 
       if (cb(ih_canvas, evt.id, x, y, (char*)state)==IUP_CLOSE)
         IupExitLoop();
     }
+  }
+}
 
-    if (mcb)
-      listener->updateCursorInfo(&cursor_count, pid, px, py, pstate, evt.id, x, y, state[0]);
+int IupTuioListener::timer_action_cb(Ihandle *timer)
+{
+  IupTuioListener* listener = reinterpret_cast<IupTuioListener*>(IupGetAttribute(timer, "_IUP_TUIOLISTENER"));
 
-    listener->cursor_events.pop_front();
+  /* the wakeup is considered lost only if still pending after a full timer period */
+  if (listener->wakeup_pending)
+  {
+    if (listener->wakeup_stale)
+      listener->processEvents();
+    else
+      listener->wakeup_stale = 1;
   }
 
-  if (mcb)
-  {
-    listener->finishCursorInfo(cursorList, cursor_count, px, py, pstate, w, h, use_client_coord, ih_canvas);
+  return IUP_DEFAULT;
+}
 
-    if (mcb(ih_canvas, cursor_count, pid, px, py, pstate)==IUP_CLOSE)
-      IupExitLoop();
-     
-    delete[] px;
-    delete[] py;
-    delete[] pid;
-    delete[] pstate;
-  }
+static int iTuioPostMessage_CB(Ihandle*, char*, int serial, double, void*)
+{
+  std::map<int, IupTuioListener*>::iterator iter = iTuioListeners.find(serial);
+  if (iter != iTuioListeners.end())
+    iter->second->processEvents();
+  return IUP_DEFAULT;
+}
 
-  listener->locked = 0;
-  listener->client->unlockCursorList();
+static int iTuioNotifyDestroy_CB(Ihandle*)
+{
+  std::lock_guard<std::mutex> lock(iTuioNotifyLock);
+  iTuioNotify = NULL;
   return IUP_DEFAULT;
 }
 
@@ -347,8 +429,8 @@ static int iTuioSetConnectAttrib(Ihandle* ih, const char* value)
 {
   if (ih->data->client->isConnected())
   {
-    IupSetAttribute(ih->data->listener->timer, "RUN", "NO");
     ih->data->client->disconnect();
+    IupSetAttribute(ih->data->listener->timer, "RUN", "NO");
   }
 
   if (iupStrEqualNoCase(value, "YES"))
@@ -387,6 +469,11 @@ static char* iTuioGetDebugAttrib(Ihandle *ih)
     return (char*)"No";
 }
 
+static char* iTuioGetDroppedEventsAttrib(Ihandle *ih)
+{
+  return iupStrReturnInt(ih->data->listener->dropped);
+}
+
 static int iTuioCreateMethod(Ihandle* ih, void** params)
 {
   int port = 3333;
@@ -397,9 +484,22 @@ static int iTuioCreateMethod(Ihandle* ih, void** params)
     port = (int)(long)(params[0]); /* must cast to long first to avoid 64bit C++ compiler error */
 #endif
   ih->data = iupALLOCCTRLDATA();
+
+  if (!iTuioNotify)
+  {
+    /* hidden element used only to receive the main loop wakeup,
+       named so it is destroyed by IupClose */
+    Ihandle* notify = IupUser();
+    IupSetCallback(notify, "POSTMESSAGE_CB", (Icallback)iTuioPostMessage_CB);
+    IupSetCallback(notify, "DESTROY_CB", iTuioNotifyDestroy_CB);
+    IupSetHandle("_IUP_TUIO_NOTIFY", notify);
+
+    std::lock_guard<std::mutex> lock(iTuioNotifyLock);
+    iTuioNotify = notify;
+  }
   
   ih->data->client = new TuioClient(port);
-  ih->data->listener = new IupTuioListener(ih, ih->data->client);
+  ih->data->listener = new IupTuioListener(ih);
   ih->data->client->addTuioListener(ih->data->listener);
 
   return IUP_NOERROR;
@@ -407,11 +507,12 @@ static int iTuioCreateMethod(Ihandle* ih, void** params)
 
 static void iTuioDestroyMethod(Ihandle* ih)
 {
-  IupDestroy(ih->data->listener->timer);
+  /* stop the receiver thread before releasing the listener */
   delete ih->data->client;
   delete ih->data->listener;
 }
 
+
 Ihandle* IupTuioClient(int port)
 {
   void *params[2];
@@ -443,6 +544,7 @@ static Iclass* iTuioNewClass(void)
 
   iupClassRegisterAttribute(ic, "CONNECT", iTuioGetConnectAttrib, iTuioSetConnectAttrib, NULL, NULL, IUPAF_NOT_MAPPED|IUPAF_NO_INHERIT);
   iupClassRegisterAttribute(ic, "DEBUG", iTuioGetDebugAttrib, iTuioSetDebugAttrib, NULL, NULL, IUPAF_NOT_MAPPED|IUPAF_NO_INHERIT);
+  iupClassRegisterAttribute(ic, "DROPPEDEVENTS", iTuioGetDroppedEventsAttrib, NULL, NULL, NULL, IUPAF_READONLY|IUPAF_NOT_MAPPED|IUPAF_NO_INHERIT);
 
   return ic;
 }